@@ -174,6 +174,15 @@ elif [[ "${BUILD_NAME}" = "cxx17" ]]; then
   export CC=gcc
   export CXX=g++
   in_docker_script="ci/kokoro/docker/build-in-docker-cmake.sh"
+elif [[ "${BUILD_NAME}" = "cxx20" ]]; then
+  # GCC >= 11 enables coroutines with -std=c++20, this build compiles and runs
+  # the tests for the adapters in google/cloud/spanner/coroutine.h.
+  export GOOGLE_CLOUD_CPP_CXX_STANDARD=20
+  export DISTRO=fedora-install
+  export DISTRO_VERSION=34
+  export CC=gcc
+  export CXX=g++
+  in_docker_script="ci/kokoro/docker/build-in-docker-cmake.sh"
 elif [[ "${BUILD_NAME}" = "bazel-dependency" ]]; then
   export DISTRO=ubuntu
   export DISTRO_VERSION=18.04
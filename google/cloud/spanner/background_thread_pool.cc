@@ -0,0 +1,104 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/background_thread_pool.h"
+#include <algorithm>
+#include <future>
+#include <string>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif  // __linux__
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+namespace {
+
+Status PinCurrentThread(std::vector<int> const& cpus) {
+  if (cpus.empty()) return Status();
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (auto cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+      return Status(StatusCode::kInvalidArgument,
+                    "invalid CPU number " + std::to_string(cpu));
+    }
+    CPU_SET(cpu, &set);
+  }
+  auto const result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  if (result != 0) {
+    return Status(StatusCode::kInvalidArgument,
+                  "pthread_setaffinity_np() failed with error " +
+                      std::to_string(result));
+  }
+  return Status();
+#else
+  return Status(StatusCode::kUnimplemented,
+                "CPU affinity is not supported on this platform");
+#endif  // __linux__
+}
+
+}  // namespace
+
+BackgroundThreadPool::BackgroundThreadPool(
+    BackgroundThreadPoolOptions options) {
+  auto const count = (std::max)(options.thread_count(), std::size_t{1});
+  auto const& affinity = options.cpu_affinity();
+  std::vector<std::future<Status>> pinned;
+  pinned.reserve(count);
+  threads_.reserve(count);
+  for (std::size_t i = 0; i != count; ++i) {
+    std::vector<int> cpus;
+    if (!affinity.empty()) cpus = affinity[i % affinity.size()];
+    std::promise<Status> p;
+    pinned.push_back(p.get_future());
+    // Each thread holds its own copy of the queue, see the destructor.
+    auto cq = cq_;
+    threads_.emplace_back(
+        [cq, cpus](std::promise<Status> p) mutable {
+          p.set_value(PinCurrentThread(cpus));
+          cq.Run();
+        },
+        std::move(p));
+  }
+  for (auto& f : pinned) {
+    auto status = f.get();
+    if (affinity_status_.ok()) affinity_status_ = std::move(status);
+  }
+}
+
+BackgroundThreadPool::~BackgroundThreadPool() {
+  // Any pending operations cannot complete once the threads stop.
+  cq_.CancelAll();
+  cq_.Shutdown();
+  for (auto& t : threads_) {
+    // The pool may be destroyed by a callback running on one of its threads,
+    // which cannot join itself. That thread returns once
+    // the callback, and any other work left in its copy of the queue, is done.
+    if (t.get_id() == std::this_thread::get_id()) {
+      t.detach();
+      continue;
+    }
+    t.join();
+  }
+}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
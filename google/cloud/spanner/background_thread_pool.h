@@ -0,0 +1,137 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_BACKGROUND_THREAD_POOL_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_BACKGROUND_THREAD_POOL_H
+
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/completion_queue.h"
+#include "google/cloud/status.h"
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+/**
+ * Controls the threads of a `BackgroundThreadPool`.
+ */
+class BackgroundThreadPoolOptions {
+ public:
+  /**
+   * Set the number of threads running the `CompletionQueue`.
+   * A value of 0 is treated as 1.
+   */
+  BackgroundThreadPoolOptions& set_thread_count(std::size_t count) {
+    thread_count_ = count;
+    return *this;
+  }
+
+  /// Return the number of threads running the `CompletionQueue`.
+  std::size_t thread_count() const { return thread_count_; }
+
+  /**
+   * Set the CPUs each thread may run on.
+   *
+   * Thread `i` is pinned to the CPUs (numbered as in `sched_setaffinity(2)`)
+   * in `cpus[i % cpus.size()]`, for example, `{{0, 1}, {2, 3}}` pins the even
+   * threads to the first two CPUs, and the odd threads to the next two. An
+   * empty list, or an empty entry, leaves the corresponding threads unpinned.
+   *
+   * @note CPU affinity is only supported on Linux, on other platforms the
+   *     threads are never pinned.
+   */
+  BackgroundThreadPoolOptions& set_cpu_affinity(
+      std::vector<std::vector<int>> cpus) {
+    cpu_affinity_ = std::move(cpus);
+    return *this;
+  }
+
+  /// Return the CPUs each thread may run on.
+  std::vector<std::vector<int>> const& cpu_affinity() const {
+    return cpu_affinity_;
+  }
+
+ private:
+  std::size_t thread_count_ = 1;
+  std::vector<std::vector<int>> cpu_affinity_;
+};
+
+/**
+ * A pool of threads running a `CompletionQueue`.
+ *
+ * By default each `Connection` creates its own background threads, which run
+ * its asynchronous operations, and the maintenance of its session pool. An
+ * application that connects to many databases can instead create one
+ * `BackgroundThreadPool`, sized and pinned for the machine, and share it
+ * between all those connections, including the admin connections, with
+ * `ConnectionOptions::DisableBackgroundThreads()`.
+ *
+ * The destructor cancels any pending operations and stops the threads, so the
+ * pool must outlive the connections that use it.
+ *
+ * @par Example
+ * @code
+ * namespace spanner = ::google::cloud::spanner;
+ * spanner::BackgroundThreadPool pool(
+ *     spanner::BackgroundThreadPoolOptions{}.set_thread_count(4));
+ * auto options =
+ *     spanner::ConnectionOptions{}.DisableBackgroundThreads(pool.cq());
+ * std::vector<spanner::Client> clients;
+ * for (auto const& db : databases) {
+ *   clients.emplace_back(spanner::MakeConnection(db, options));
+ * }
+ * spanner::DatabaseAdminClient admin(options);
+ * @endcode
+ */
+class BackgroundThreadPool {
+ public:
+  explicit BackgroundThreadPool(
+      BackgroundThreadPoolOptions options = BackgroundThreadPoolOptions());
+  ~BackgroundThreadPool();
+
+  // This class is neither copyable nor movable.
+  BackgroundThreadPool(BackgroundThreadPool const&) = delete;
+  BackgroundThreadPool& operator=(BackgroundThreadPool const&) = delete;
+
+  /// The `CompletionQueue` run by the threads.
+  CompletionQueue cq() const { return cq_; }
+
+  /// The number of threads in the pool.
+  std::size_t size() const { return threads_.size(); }
+
+  /**
+   * The result of pinning the threads to their CPUs.
+   *
+   * The threads keep running, unpinned, if that fails. The constructor waits
+   * for all the threads to start, this is the first error, if any.
+   */
+  Status cpu_affinity_status() const { return affinity_status_; }
+
+ private:
+  CompletionQueue cq_;
+  std::vector<std::thread> threads_;
+  Status affinity_status_;
+};
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_BACKGROUND_THREAD_POOL_H
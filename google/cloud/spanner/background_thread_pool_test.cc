@@ -0,0 +1,144 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/background_thread_pool.h"
+#include "google/cloud/spanner/connection_options.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include <gmock/gmock.h>
+#include <chrono>
+#include <memory>
+#include <set>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif  // __linux__
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+using TimerResult = StatusOr<std::chrono::system_clock::time_point>;
+
+// Returns the id of the thread that runs a callback on @p cq. The timer is long
+// enough to attach the callback before it expires, otherwise the callback runs
+// in the calling thread.
+future<std::thread::id> RunningThread(CompletionQueue cq) {
+  return cq.MakeRelativeTimer(std::chrono::milliseconds(10))
+      .then([](future<TimerResult>) { return std::this_thread::get_id(); });
+}
+
+TEST(BackgroundThreadPoolOptionsTest, Defaults) {
+  BackgroundThreadPoolOptions options;
+  EXPECT_EQ(1, options.thread_count());
+  EXPECT_TRUE(options.cpu_affinity().empty());
+}
+
+TEST(BackgroundThreadPoolOptionsTest, Setters) {
+  auto options = BackgroundThreadPoolOptions{}.set_thread_count(4);
+  options.set_cpu_affinity({{0, 1}, {2}});
+  EXPECT_EQ(4, options.thread_count());
+  EXPECT_EQ((std::vector<std::vector<int>>{{0, 1}, {2}}),
+            options.cpu_affinity());
+}
+
+TEST(BackgroundThreadPoolTest, Default) {
+  BackgroundThreadPool pool;
+  EXPECT_EQ(1, pool.size());
+  EXPECT_STATUS_OK(pool.cpu_affinity_status());
+  auto id = RunningThread(pool.cq()).get();
+  EXPECT_NE(std::this_thread::get_id(), id);
+}
+
+TEST(BackgroundThreadPoolTest, ThreadCount) {
+  BackgroundThreadPool pool(BackgroundThreadPoolOptions{}.set_thread_count(3));
+  EXPECT_EQ(3, pool.size());
+  EXPECT_NE(std::this_thread::get_id(), RunningThread(pool.cq()).get());
+
+  BackgroundThreadPool minimum(
+      BackgroundThreadPoolOptions{}.set_thread_count(0));
+  EXPECT_EQ(1, minimum.size());
+}
+
+#ifdef __linux__
+TEST(BackgroundThreadPoolTest, CpuAffinity) {
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  ASSERT_EQ(0, sched_getaffinity(0, sizeof(allowed), &allowed));
+  int cpu = 0;
+  while (cpu < CPU_SETSIZE && !CPU_ISSET(cpu, &allowed)) ++cpu;
+  ASSERT_LT(cpu, CPU_SETSIZE);
+
+  BackgroundThreadPool pool(BackgroundThreadPoolOptions{}.set_cpu_affinity(
+      {std::vector<int>{cpu}}));
+  EXPECT_STATUS_OK(pool.cpu_affinity_status());
+  auto pinned = pool.cq()
+                    .MakeRelativeTimer(std::chrono::milliseconds(10))
+                    .then([](future<TimerResult>) {
+                      cpu_set_t set;
+                      CPU_ZERO(&set);
+                      pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+                      std::set<int> cpus;
+                      for (int i = 0; i != CPU_SETSIZE; ++i) {
+                        if (CPU_ISSET(i, &set)) cpus.insert(i);
+                      }
+                      return cpus;
+                    })
+                    .get();
+  EXPECT_EQ(std::set<int>{cpu}, pinned);
+}
+
+TEST(BackgroundThreadPoolTest, InvalidCpuAffinity) {
+  BackgroundThreadPool pool(
+      BackgroundThreadPoolOptions{}.set_thread_count(2).set_cpu_affinity(
+          {{}, {-1}}));
+  EXPECT_EQ(StatusCode::kInvalidArgument, pool.cpu_affinity_status().code());
+  // The threads run anyway.
+  EXPECT_NE(std::this_thread::get_id(), RunningThread(pool.cq()).get());
+}
+#endif  // __linux__
+
+TEST(BackgroundThreadPoolTest, SharedThroughConnectionOptions) {
+  BackgroundThreadPool pool;
+  auto options = ConnectionOptions{}.DisableBackgroundThreads(pool.cq());
+  auto c1 = options.background_threads_factory()();
+  auto c2 = options.background_threads_factory()();
+  auto const id = RunningThread(pool.cq()).get();
+  EXPECT_EQ(id, RunningThread(c1->cq()).get());
+  EXPECT_EQ(id, RunningThread(c2->cq()).get());
+}
+
+TEST(BackgroundThreadPoolTest, ReleasedOnPoolThread) {
+  auto pool = std::make_shared<BackgroundThreadPool>();
+  auto cq = pool->cq();
+  promise<void> released;
+  auto done = released.get_future();
+  // The last reference is released by a callback running on the pool.
+  auto holder = std::make_shared<std::shared_ptr<BackgroundThreadPool>>(
+      std::move(pool));
+  cq.MakeRelativeTimer(std::chrono::milliseconds(10))
+      .then([holder, &released](future<TimerResult>) {
+        holder->reset();
+        released.set_value();
+      });
+  holder.reset();
+  done.get();
+}
+
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -793,13 +793,20 @@ class ReadExperiment : public Experiment {
  *   - Then for `config.iteration_duration` seconds SELECT random ranges of
  *     `config.query_size` rows
  *   - Measure the CPU time required by the previous step
+ *
+ * With `projection` the client library only reads the first and last column
+ * of each row, by name, instead of converting the full row to a `std::tuple`.
  */
 template <typename Traits>
 class SelectExperiment : public Experiment {
  public:
-  explicit SelectExperiment(google::cloud::internal::DefaultPRNG generator)
+  explicit SelectExperiment(google::cloud::internal::DefaultPRNG generator,
+                            bool projection = false)
       : impl_(generator),
-        table_name_("SelectExperiment_" + Traits::TableSuffix()) {}
+        projection_(projection),
+        table_name_(std::string(projection ? "SelectProjectionExperiment_"
+                                           : "SelectExperiment_") +
+                    Traits::TableSuffix()) {}
 
   std::string AdditionalDdlStatement() override {
     return impl_.CreateTableStatement(table_name_);
@@ -985,12 +992,31 @@ class SelectExperiment : public Experiment {
                       {"end", spanner::Value(key + config.query_size)}}));
       int row_count = 0;
       Status status;
-      for (auto& row : spanner::StreamOf<RowType>(rows)) {
-        if (!row) {
-          status = std::move(row).status();
-          break;
+      if (projection_) {
+        // Only access the first and last columns, by name, so most columns
+        // are never decoded.
+        for (auto& row : rows) {
+          if (!row) {
+            status = std::move(row).status();
+            break;
+          }
+          auto first = row->get<T>("Data0");
+          auto last = row->get<T>("Data9");
+          if (!first || !last) {
+            status = !first ? std::move(first).status()
+                            : std::move(last).status();
+            break;
+          }
+          ++row_count;
+        }
+      } else {
+        for (auto& row : spanner::StreamOf<RowType>(rows)) {
+          if (!row) {
+            status = std::move(row).status();
+            break;
+          }
+          ++row_count;
         }
-        ++row_count;
       }
       timer.Stop();
       samples.push_back(RowCpuSample{client_count, thread_count, false,
@@ -1015,6 +1041,7 @@ class SelectExperiment : public Experiment {
   }
 
   ExperimentImpl<Traits> impl_;
+  bool projection_;
   std::string table_name_;
 };
 
@@ -1601,6 +1628,15 @@ ExperimentFactory MakeSelectFactory() {
   };
 }
 
+template <typename Trait>
+ExperimentFactory MakeSelectProjectionFactory() {
+  using G = ::google::cloud::internal::DefaultPRNG;
+  return [](G g) {
+    return google::cloud::internal::make_unique<SelectExperiment<Trait>>(g,
+                                                                         true);
+  };
+}
+
 template <typename Trait>
 ExperimentFactory MakeUpdateFactory() {
   using G = ::google::cloud::internal::DefaultPRNG;
@@ -1638,6 +1674,10 @@ std::map<std::string, ExperimentFactory> AvailableExperiments() {
       {"select-int64", MakeSelectFactory<Int64Traits>()},
       {"select-string", MakeSelectFactory<StringTraits>()},
       {"select-timestamp", MakeSelectFactory<TimestampTraits>()},
+      {"select-projection-bytes", MakeSelectProjectionFactory<BytesTraits>()},
+      {"select-projection-int64", MakeSelectProjectionFactory<Int64Traits>()},
+      {"select-projection-string",
+       MakeSelectProjectionFactory<StringTraits>()},
       {"update-bool", MakeUpdateFactory<BoolTraits>()},
       {"update-bytes", MakeUpdateFactory<BytesTraits>()},
       {"update-date", MakeUpdateFactory<DateTraits>()},
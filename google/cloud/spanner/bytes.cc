@@ -18,6 +18,7 @@
 #include <cctype>
 #include <climits>
 #include <cstdio>
+#include <string>
 
 namespace google {
 namespace cloud {
@@ -50,6 +51,40 @@ constexpr std::array<unsigned char, UCHAR_MAX + 1> kCharToIndexExcessOne = {{
     38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52,
 }};
 
+// Maps each 12-bit value to its two base64 characters, so each group of three
+// octets is encoded with two lookups.
+std::array<std::array<char, 2>, 4096> const& IndexPairToChars() {
+  static auto const* const kTable = [] {
+    auto* table = new std::array<std::array<char, 2>, 4096>;
+    for (std::size_t i = 0; i != table->size(); ++i) {
+      (*table)[i] = {{kIndexToChar[i >> 6], kIndexToChar[i & 0x3f]}};
+    }
+    return table;
+  }();
+  return *kTable;
+}
+
+// Appends the encoding of `n` octets, where `n` is a multiple of 3.
+void AppendTriples(unsigned char const* p, std::size_t n, std::string& rep) {
+  auto const& pairs = IndexPairToChars();
+  auto const pos = rep.size();
+  rep.resize(pos + n / 3 * 4);
+  auto* out = &rep[pos];
+  for (auto const* const end = p + n; p != end; p += 3, out += 4) {
+    unsigned int const v = p[0] << 16 | p[1] << 8 | p[2];
+    auto const& hi = pairs[v >> 12];
+    auto const& lo = pairs[v & 0xfff];
+    out[0] = hi[0];
+    out[1] = hi[1];
+    out[2] = lo[0];
+    out[3] = lo[1];
+  }
+}
+
+unsigned int CharToIndex(unsigned char c) {
+  return static_cast<unsigned int>(kCharToIndexExcessOne[c] - 1);
+}
+
 // kCharToIndexExcessOne[] assumes an ASCII execution character set.
 static_assert('A' == 65, "required by base64 decoder");
 
@@ -87,18 +122,17 @@ std::ostream& operator<<(std::ostream& os, Bytes const& bytes) {
 }
 
 void Bytes::Encoder::Flush() {
-  unsigned int const v = buf_[0] << 16 | buf_[1] << 8 | buf_[2];
-  rep_.push_back(kIndexToChar[v >> 18]);
-  rep_.push_back(kIndexToChar[v >> 12 & 0x3f]);
-  rep_.push_back(kIndexToChar[v >> 6 & 0x3f]);
-  rep_.push_back(kIndexToChar[v & 0x3f]);
+  AppendTriples(buf_.data(), len_, rep_);
   len_ = 0;
 }
 
 void Bytes::Encoder::FlushAndPad() {
-  switch (len_) {
+  auto const tail = len_ % 3;
+  AppendTriples(buf_.data(), len_ - tail, rep_);
+  auto const* p = buf_.data() + (len_ - tail);
+  switch (tail) {
     case 2: {
-      unsigned int const v = buf_[0] << 16 | buf_[1] << 8;
+      unsigned int const v = p[0] << 16 | p[1] << 8;
       rep_.push_back(kIndexToChar[v >> 18]);
       rep_.push_back(kIndexToChar[v >> 12 & 0x3f]);
       rep_.push_back(kIndexToChar[v >> 6 & 0x3f]);
@@ -106,13 +140,14 @@ void Bytes::Encoder::FlushAndPad() {
       break;
     }
     case 1: {
-      unsigned int const v = buf_[0] << 16;
+      unsigned int const v = p[0] << 16;
       rep_.push_back(kIndexToChar[v >> 18]);
       rep_.push_back(kIndexToChar[v >> 12 & 0x3f]);
       rep_.append(2, kPadding);
       break;
     }
   }
+  len_ = 0;
 }
 
 void Bytes::Decoder::Iterator::Fill() {
@@ -141,12 +176,56 @@ void Bytes::Decoder::Iterator::Fill() {
   }
 }
 
+std::string Bytes::Decode(std::string const& rep) {
+  // `rep` is valid base64, so its size is a multiple of 4, and only the last
+  // chunk may be padded.
+  auto size = rep.size() / 4 * 3;
+  if (!rep.empty() && rep[rep.size() - 1] == kPadding) --size;
+  if (!rep.empty() && rep[rep.size() - 2] == kPadding) --size;
+  std::string decoded(size, '\0');
+  if (size == 0) return decoded;
+
+  auto const* p = reinterpret_cast<unsigned char const*>(rep.data());
+  auto* out = &decoded[0];
+  for (auto n = size / 3; n != 0; --n, p += 4, out += 3) {
+    unsigned int const v = CharToIndex(p[0]) << 18 | CharToIndex(p[1]) << 12 |
+                           CharToIndex(p[2]) << 6 | CharToIndex(p[3]);
+    out[0] = static_cast<char>(v >> 16);
+    out[1] = static_cast<char>(v >> 8 & 0xff);
+    out[2] = static_cast<char>(v & 0xff);
+  }
+  switch (size % 3) {
+    case 2: {
+      unsigned int const v = CharToIndex(p[0]) << 18 |
+                             CharToIndex(p[1]) << 12 | CharToIndex(p[2]) << 6;
+      out[0] = static_cast<char>(v >> 16);
+      out[1] = static_cast<char>(v >> 8 & 0xff);
+      break;
+    }
+    case 1: {
+      unsigned int const v = CharToIndex(p[0]) << 18 | CharToIndex(p[1]) << 12;
+      out[0] = static_cast<char>(v >> 16);
+      break;
+    }
+  }
+  return decoded;
+}
+
 namespace internal {
 
 // Construction from a base64-encoded US-ASCII `std::string`.
 StatusOr<Bytes> BytesFromBase64(std::string input) {
   auto* p = reinterpret_cast<unsigned char const*>(input.data());
   auto* ep = p + input.size();
+  // All but the last chunk must be free of padding, so they are validated with
+  // a single branch each.
+  while (ep - p > 4) {
+    if ((CharToIndex(p[0]) | CharToIndex(p[1]) | CharToIndex(p[2]) |
+         CharToIndex(p[3])) >= 64) {
+      break;
+    }
+    p += 4;
+  }
   while (ep - p >= 4) {
     auto i0 = kCharToIndexExcessOne[p[0]];
     auto i1 = kCharToIndexExcessOne[p[1]];
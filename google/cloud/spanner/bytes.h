@@ -51,6 +51,8 @@ class Bytes {
   ///@{
   template <typename InputIt>
   Bytes(InputIt first, InputIt last) {
+    Reserve(first, last,
+            typename std::iterator_traits<InputIt>::iterator_category{});
     Encoder encoder(base64_rep_);
     while (first != last) {
       encoder.buf_[encoder.len_++] = *first++;
@@ -66,8 +68,8 @@ class Bytes {
   /// construction from a range specified as a pair of input iterators.
   template <typename Container>
   Container get() const {
-    Decoder decoder(base64_rep_);
-    return Container(decoder.begin(), decoder.end());
+    auto const decoded = Decode(base64_rep_);
+    return Container(decoded.begin(), decoded.end());
   }
 
   /// @name Relational operators
@@ -90,6 +92,19 @@ class Bytes {
   friend StatusOr<Bytes> internal::BytesFromBase64(std::string input);
   friend std::string internal::BytesToBase64(Bytes b);
 
+  // Reserves space for the encoding, when the input size is known up front.
+  template <typename ForwardIt>
+  void Reserve(ForwardIt first, ForwardIt last, std::forward_iterator_tag) {
+    auto const n = static_cast<std::size_t>(std::distance(first, last));
+    base64_rep_.reserve((n + 2) / 3 * 4);
+  }
+  template <typename InputIt>
+  void Reserve(InputIt, InputIt, std::input_iterator_tag) {}
+
+  // Decodes a valid base64 representation, a block at a time.
+  static std::string Decode(std::string const& rep);
+
+  // Buffers the input so it can be encoded a block at a time.
   struct Encoder {
     explicit Encoder(std::string& rep) : rep_(rep), len_(0) {}
     void Flush();
@@ -97,7 +112,7 @@ class Bytes {
 
     std::string& rep_;  // encoded
     std::size_t len_;   // buf_[0 .. len_-1] pending encode
-    std::array<unsigned char, 3> buf_;
+    std::array<unsigned char, 3 * 256> buf_;  // a multiple of 3
   };
 
   struct Decoder {
@@ -154,6 +169,12 @@ class Bytes {
   std::string base64_rep_;  // valid base64 representation
 };
 
+// Decoding to a `std::string` needs no intermediate copy.
+template <>
+inline std::string Bytes::get<std::string>() const {
+  return Decode(base64_rep_);
+}
+
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner
 }  // namespace cloud
@@ -17,6 +17,7 @@
 #include <gmock/gmock.h>
 #include <cstdint>
 #include <deque>
+#include <iterator>
 #include <limits>
 #include <sstream>
 #include <string>
@@ -235,6 +236,31 @@ TEST(Bytes, Conversions) {
   EXPECT_EQ(v_plain, bytes->get<std::vector<std::uint8_t>>());
 }
 
+TEST(Bytes, BlockBoundaries) {
+  // The encoder works on blocks of 768 octets, check the sizes around them,
+  // and also input iterators, where the size is not known up front.
+  for (std::size_t size :
+       std::vector<std::size_t>{767, 768, 769, 1535, 1536, 1537, 100000}) {
+    std::string plain(size, '\0');
+    for (std::size_t i = 0; i != size; ++i) {
+      plain[i] = static_cast<char>(i * 7 + i / 256);
+    }
+    Bytes const bytes(plain);
+    auto const coded = internal::BytesToBase64(bytes);
+    EXPECT_EQ((size + 2) / 3 * 4, coded.size()) << size;
+    EXPECT_EQ(plain, bytes.get<std::string>()) << size;
+
+    std::istringstream is(plain);
+    EXPECT_EQ(bytes, Bytes(std::istreambuf_iterator<char>(is),
+                           std::istreambuf_iterator<char>()))
+        << size;
+
+    auto decoded = internal::BytesFromBase64(coded);
+    ASSERT_STATUS_OK(decoded) << size;
+    EXPECT_EQ(plain, decoded->get<std::string>()) << size;
+  }
+}
+
 TEST(Bytes, RelationalOperators) {
   std::string const s_plain = "The quick brown fox jumps over the lazy dog.";
   std::deque<char> const d_plain(s_plain.begin(), s_plain.end());
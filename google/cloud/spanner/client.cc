@@ -286,11 +286,75 @@ Status Client::Rollback(Transaction transaction) {
   return conn_->Rollback({std::move(transaction)});
 }
 
+future<RowStream> Client::AsyncRead(std::string table, KeySet keys,
+                                    std::vector<std::string> columns,
+                                    ReadOptions read_options) {
+  return conn_->AsyncRead(
+      {internal::MakeSingleUseTransaction(Transaction::ReadOnlyOptions()),
+       std::move(table),
+       std::move(keys),
+       std::move(columns),
+       std::move(read_options),
+       {}});
+}
+
+future<RowStream> Client::AsyncRead(Transaction transaction, std::string table,
+                                    KeySet keys,
+                                    std::vector<std::string> columns,
+                                    ReadOptions read_options) {
+  return conn_->AsyncRead({std::move(transaction),
+                           std::move(table),
+                           std::move(keys),
+                           std::move(columns),
+                           std::move(read_options),
+                           {}});
+}
+
+future<RowStream> Client::AsyncExecuteQuery(SqlStatement statement,
+                                            QueryOptions const& opts) {
+  return conn_->AsyncExecuteQuery(
+      {internal::MakeSingleUseTransaction(Transaction::ReadOnlyOptions()),
+       std::move(statement),
+       OverlayQueryOptions(opts),
+       {}});
+}
+
+future<RowStream> Client::AsyncExecuteQuery(Transaction transaction,
+                                            SqlStatement statement,
+                                            QueryOptions const& opts) {
+  return conn_->AsyncExecuteQuery({std::move(transaction),
+                                   std::move(statement),
+                                   OverlayQueryOptions(opts),
+                                   {}});
+}
+
+future<StatusOr<DmlResult>> Client::AsyncExecuteDml(Transaction transaction,
+                                                    SqlStatement statement,
+                                                    QueryOptions const& opts) {
+  return conn_->AsyncExecuteDml({std::move(transaction),
+                                 std::move(statement),
+                                 OverlayQueryOptions(opts),
+                                 {}});
+}
+
+future<StatusOr<CommitResult>> Client::AsyncCommit(Transaction transaction,
+                                                   Mutations mutations) {
+  return conn_->AsyncCommit({std::move(transaction), std::move(mutations)});
+}
+
+future<Status> Client::AsyncRollback(Transaction transaction) {
+  return conn_->AsyncRollback({std::move(transaction)});
+}
+
 StatusOr<PartitionedDmlResult> Client::ExecutePartitionedDml(
     SqlStatement statement) {
   return conn_->ExecutePartitionedDml({std::move(statement)});
 }
 
+StatusOr<SessionPoolMetrics> Client::GetSessionPoolMetrics() {
+  return conn_->GetSessionPoolMetrics();
+}
+
 // Returns a QueryOptions struct that has each field set according to the
 // hierarchy that options specified as to the function call (i.e., `preferred`)
 // are preferred, followed by options set at the Client level, followed by an
@@ -314,6 +378,13 @@ QueryOptions Client::OverlayQueryOptions(QueryOptions const& preferred) {
     opts.set_optimizer_version(*kOptimizerVersionEnvValue);
   }
 
+  // Choose the `prefetch_buffer_bytes` option.
+  if (preferred.prefetch_buffer_bytes().has_value()) {
+    opts.set_prefetch_buffer_bytes(preferred.prefetch_buffer_bytes());
+  } else if (fallback.prefetch_buffer_bytes().has_value()) {
+    opts.set_prefetch_buffer_bytes(fallback.prefetch_buffer_bytes());
+  }
+
   return opts;
 }
 
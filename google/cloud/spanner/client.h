@@ -31,9 +31,11 @@
 #include "google/cloud/spanner/read_partition.h"
 #include "google/cloud/spanner/results.h"
 #include "google/cloud/spanner/retry_policy.h"
+#include "google/cloud/spanner/session_pool_metrics.h"
 #include "google/cloud/spanner/session_pool_options.h"
 #include "google/cloud/spanner/sql_statement.h"
 #include "google/cloud/spanner/transaction.h"
+#include "google/cloud/future.h"
 #include "google/cloud/optional.h"
 #include "google/cloud/status.h"
 #include "google/cloud/status_or.h"
@@ -599,6 +601,44 @@ class Client {
    */
   Status Rollback(Transaction transaction);
 
+  //@{
+  /**
+   * @name Asynchronous operations
+   *
+   * These are the asynchronous versions of `Read()`, `ExecuteQuery()`,
+   * `ExecuteDml()`, `Commit()`, and `Rollback()`. They return immediately,
+   * and the RPCs run on the background threads of the `Connection`, so a
+   * single thread can drive many concurrent operations.
+   *
+   * Operations that use the same `Transaction` are still serialized while the
+   * transaction is being started. The futures may be satisfied on one of the
+   * background threads, so any callbacks attached to them should not block.
+   *
+   * @warning The `RowStream` returned by `AsyncRead()` and
+   *     `AsyncExecuteQuery()` holds the results of the first response.
+   *     Iterating over it blocks while waiting for the rest of the results, so
+   *     it must not be iterated on one of the background threads, e.g., inside
+   *     a `.then()` callback.
+   */
+  future<RowStream> AsyncRead(std::string table, KeySet keys,
+                              std::vector<std::string> columns,
+                              ReadOptions read_options = {});
+  future<RowStream> AsyncRead(Transaction transaction, std::string table,
+                              KeySet keys, std::vector<std::string> columns,
+                              ReadOptions read_options = {});
+  future<RowStream> AsyncExecuteQuery(SqlStatement statement,
+                                      QueryOptions const& opts = {});
+  future<RowStream> AsyncExecuteQuery(Transaction transaction,
+                                      SqlStatement statement,
+                                      QueryOptions const& opts = {});
+  future<StatusOr<DmlResult>> AsyncExecuteDml(Transaction transaction,
+                                              SqlStatement statement,
+                                              QueryOptions const& opts = {});
+  future<StatusOr<CommitResult>> AsyncCommit(Transaction transaction,
+                                             Mutations mutations);
+  future<Status> AsyncRollback(Transaction transaction);
+  //@}
+
   /**
    * Executes a Partitioned DML SQL query.
    *
@@ -619,6 +659,20 @@ class Client {
    */
   StatusOr<PartitionedDmlResult> ExecutePartitionedDml(SqlStatement statement);
 
+  /**
+   * Returns a snapshot of the session pool used by the `Connection`.
+   *
+   * The snapshot includes the number of sessions in the pool (per channel,
+   * and in total), the number of callers waiting for a session, and latency
+   * histograms for allocating and creating sessions. The counters are
+   * cumulative, so monitoring code should call this periodically and export
+   * the difference between snapshots.
+   *
+   * @return The metrics, or a `kUnimplemented` error if the `Connection`
+   *     does not use a session pool.
+   */
+  StatusOr<SessionPoolMetrics> GetSessionPoolMetrics();
+
  private:
   QueryOptions OverlayQueryOptions(QueryOptions const&);
 
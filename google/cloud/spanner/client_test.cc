@@ -52,6 +52,7 @@ using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::Field;
 using ::testing::HasSubstr;
+using ::testing::Invoke;
 using ::testing::Return;
 using ::testing::SaveArg;
 
@@ -384,6 +385,106 @@ TEST(ClientTest, RollbackError) {
   EXPECT_THAT(rollback.message(), HasSubstr("oops"));
 }
 
+TEST(ClientTest, AsyncExecuteQuerySuccess) {
+  auto conn = std::make_shared<MockConnection>();
+  Client client(conn);
+
+  auto source = make_unique<MockResultSetSource>();
+  auto constexpr kText = R"pb(
+    row_type: {
+      fields: {
+        name: "Name",
+        type: { code: STRING }
+      }
+    }
+  )pb";
+  spanner_proto::ResultSetMetadata metadata;
+  ASSERT_TRUE(TextFormat::ParseFromString(kText, &metadata));
+  EXPECT_CALL(*source, Metadata()).WillRepeatedly(Return(metadata));
+  EXPECT_CALL(*source, NextRow())
+      .WillOnce(Return(MakeTestRow("Steve")))
+      .WillOnce(Return(Row()));
+
+  EXPECT_CALL(*conn, AsyncExecuteQuery(_))
+      .WillOnce(Invoke([&source](Connection::SqlParams const& params) {
+        EXPECT_EQ("select * from table;", params.statement.sql());
+        return make_ready_future(RowStream(std::move(source)));
+      }));
+
+  auto f = client.AsyncExecuteQuery(SqlStatement("select * from table;"));
+  auto rows = f.get();
+  std::vector<std::string> names;
+  for (auto& row : StreamOf<std::tuple<std::string>>(rows)) {
+    ASSERT_STATUS_OK(row);
+    names.push_back(std::get<0>(*row));
+  }
+  EXPECT_THAT(names, ElementsAre("Steve"));
+}
+
+TEST(ClientTest, AsyncExecuteDmlError) {
+  auto conn = std::make_shared<MockConnection>();
+  Client client(conn);
+
+  auto txn = MakeReadWriteTransaction();
+  EXPECT_CALL(*conn, AsyncExecuteDml(_))
+      .WillOnce(Invoke([&txn](Connection::SqlParams const& params) {
+        EXPECT_EQ(txn, params.transaction);
+        return make_ready_future(StatusOr<DmlResult>(
+            Status(StatusCode::kPermissionDenied, "blah")));
+      }));
+
+  auto dml = client.AsyncExecuteDml(txn, SqlStatement("delete * from table;"))
+                 .get();
+  EXPECT_EQ(StatusCode::kPermissionDenied, dml.status().code());
+  EXPECT_THAT(dml.status().message(), HasSubstr("blah"));
+}
+
+TEST(ClientTest, AsyncCommitSuccess) {
+  auto conn = std::make_shared<MockConnection>();
+
+  auto ts = MakeTimestamp(std::chrono::system_clock::from_time_t(123)).value();
+  CommitResult result;
+  result.commit_timestamp = ts;
+
+  Client client(conn);
+  EXPECT_CALL(*conn, AsyncCommit(_))
+      .WillOnce(Return(ByMove(make_ready_future(make_status_or(result)))));
+
+  auto txn = MakeReadWriteTransaction();
+  auto commit = client.AsyncCommit(txn, {}).get();
+  EXPECT_STATUS_OK(commit);
+  EXPECT_EQ(ts, commit->commit_timestamp);
+}
+
+TEST(ClientTest, AsyncRollbackError) {
+  auto conn = std::make_shared<MockConnection>();
+
+  Client client(conn);
+  EXPECT_CALL(*conn, AsyncRollback(_))
+      .WillOnce(Return(ByMove(make_ready_future(
+          Status(StatusCode::kInvalidArgument, "oops")))));
+
+  auto txn = MakeReadWriteTransaction();
+  auto rollback = client.AsyncRollback(txn).get();
+  EXPECT_EQ(StatusCode::kInvalidArgument, rollback.code());
+  EXPECT_THAT(rollback.message(), HasSubstr("oops"));
+}
+
+TEST(ClientTest, GetSessionPoolMetrics) {
+  auto conn = std::make_shared<MockConnection>();
+
+  SessionPoolMetrics metrics;
+  metrics.total_sessions = 3;
+  metrics.idle_sessions = 2;
+  EXPECT_CALL(*conn, GetSessionPoolMetrics()).WillOnce(Return(metrics));
+
+  Client client(conn);
+  auto actual = client.GetSessionPoolMetrics();
+  ASSERT_STATUS_OK(actual);
+  EXPECT_EQ(3, actual->total_sessions);
+  EXPECT_EQ(2, actual->idle_sessions);
+}
+
 TEST(ClientTest, MakeConnectionOptionalArguments) {
   Database db("foo", "bar", "baz");
   auto conn = MakeConnection(db);
@@ -1043,6 +1144,35 @@ TEST(ClientTest, QueryOptionsOverlayPrecedence) {
   }
 }
 
+TEST(ClientTest, QueryOptionsOverlayPrefetch) {
+  struct Levels {
+    google::cloud::optional<std::size_t> client;
+    google::cloud::optional<std::size_t> function;
+    google::cloud::optional<std::size_t> expected;
+  };
+  std::vector<Levels> levels = {
+      {{}, {}, {}},
+      {1024, {}, 1024},
+      {{}, 2048, 2048},
+      {1024, 0, 0},
+  };
+
+  auto constexpr kQueryOptionsField = &Connection::SqlParams::query_options;
+  google::cloud::testing_util::ScopedEnvironment env(
+      "SPANNER_OPTIMIZER_VERSION", {});
+  auto conn = std::make_shared<MockConnection>();
+  for (auto const& level : levels) {
+    auto client_qo = QueryOptions().set_prefetch_buffer_bytes(level.client);
+    Client client(conn, ClientOptions().set_query_options(client_qo));
+    auto expected = QueryOptions().set_prefetch_buffer_bytes(level.expected);
+    EXPECT_CALL(*conn, ExecuteQuery(Field(kQueryOptionsField, Eq(expected))))
+        .Times(1);
+
+    auto const qo = QueryOptions().set_prefetch_buffer_bytes(level.function);
+    client.ExecuteQuery(SqlStatement{}, qo);
+  }
+}
+
 }  // namespace
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner
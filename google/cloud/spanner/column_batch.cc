@@ -0,0 +1,235 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/column_batch.h"
+#include "google/cloud/spanner/bytes.h"
+#include "google/cloud/spanner/internal/date.h"
+#include "google/cloud/spanner/internal/numeric_parse.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+namespace {
+
+bool IsSupported(google::spanner::v1::TypeCode code) {
+  switch (code) {
+    case google::spanner::v1::TypeCode::BOOL:
+    case google::spanner::v1::TypeCode::INT64:
+    case google::spanner::v1::TypeCode::FLOAT64:
+    case google::spanner::v1::TypeCode::TIMESTAMP:
+    case google::spanner::v1::TypeCode::DATE:
+    case google::spanner::v1::TypeCode::STRING:
+    case google::spanner::v1::TypeCode::BYTES:
+      return true;
+    default:
+      return false;
+  }
+}
+
+Status MissingValue(google::spanner::v1::TypeCode code) {
+  return Status(StatusCode::kUnknown,
+                "missing " + google::spanner::v1::TypeCode_Name(code));
+}
+
+}  // namespace
+
+ColumnVector::ColumnVector(google::spanner::v1::TypeCode type_code)
+    : type_code_(type_code) {
+  if (type_code_ == google::spanner::v1::TypeCode::STRING ||
+      type_code_ == google::spanner::v1::TypeCode::BYTES) {
+    string_offsets_.push_back(0);
+  }
+}
+
+void ColumnVector::AppendNull() {
+  nulls_.push_back(1);
+  ++null_count_;
+  switch (type_code_) {
+    case google::spanner::v1::TypeCode::BOOL:
+      bool_values_.push_back(0);
+      break;
+    case google::spanner::v1::TypeCode::INT64:
+      int64_values_.push_back(0);
+      break;
+    case google::spanner::v1::TypeCode::FLOAT64:
+      float64_values_.push_back(0.0);
+      break;
+    case google::spanner::v1::TypeCode::TIMESTAMP:
+      timestamp_values_.emplace_back();
+      break;
+    case google::spanner::v1::TypeCode::DATE:
+      date_values_.emplace_back();
+      break;
+    default:
+      string_offsets_.push_back(string_data_.size());
+      break;
+  }
+}
+
+Status ColumnVector::Append(google::protobuf::Value const& value) {
+  if (value.kind_case() == google::protobuf::Value::kNullValue) {
+    AppendNull();
+    return Status();
+  }
+  switch (type_code_) {
+    case google::spanner::v1::TypeCode::BOOL:
+      if (value.kind_case() != google::protobuf::Value::kBoolValue) {
+        return MissingValue(type_code_);
+      }
+      bool_values_.push_back(value.bool_value() ? 1 : 0);
+      break;
+
+    case google::spanner::v1::TypeCode::INT64: {
+      if (value.kind_case() != google::protobuf::Value::kStringValue) {
+        return MissingValue(type_code_);
+      }
+      auto x = internal::ParseInt64(value.string_value());
+      if (!x) return std::move(x).status();
+      int64_values_.push_back(*x);
+      break;
+    }
+
+    case google::spanner::v1::TypeCode::FLOAT64: {
+      if (value.kind_case() == google::protobuf::Value::kNumberValue) {
+        float64_values_.push_back(value.number_value());
+        break;
+      }
+      if (value.kind_case() != google::protobuf::Value::kStringValue) {
+        return MissingValue(type_code_);
+      }
+      auto x = internal::ParseFloat64(value.string_value());
+      if (!x) return std::move(x).status();
+      float64_values_.push_back(*x);
+      break;
+    }
+
+    case google::spanner::v1::TypeCode::TIMESTAMP: {
+      if (value.kind_case() != google::protobuf::Value::kStringValue) {
+        return MissingValue(type_code_);
+      }
+      auto x = internal::TimestampFromRFC3339(value.string_value());
+      if (!x) return std::move(x).status();
+      timestamp_values_.push_back(*x);
+      break;
+    }
+
+    case google::spanner::v1::TypeCode::DATE: {
+      if (value.kind_case() != google::protobuf::Value::kStringValue) {
+        return MissingValue(type_code_);
+      }
+      auto x = internal::DateFromString(value.string_value());
+      if (!x) return std::move(x).status();
+      date_values_.push_back(*x);
+      break;
+    }
+
+    case google::spanner::v1::TypeCode::STRING:
+      if (value.kind_case() != google::protobuf::Value::kStringValue) {
+        return MissingValue(type_code_);
+      }
+      string_data_ += value.string_value();
+      string_offsets_.push_back(string_data_.size());
+      break;
+
+    case google::spanner::v1::TypeCode::BYTES: {
+      if (value.kind_case() != google::protobuf::Value::kStringValue) {
+        return MissingValue(type_code_);
+      }
+      auto x = internal::BytesFromBase64(value.string_value());
+      if (!x) return std::move(x).status();
+      string_data_ += x->get<std::string>();
+      string_offsets_.push_back(string_data_.size());
+      break;
+    }
+
+    default:
+      return Status(StatusCode::kUnknown, "unsupported column type");
+  }
+  nulls_.push_back(0);
+  return Status();
+}
+
+void ColumnVector::Truncate(std::size_t size) {
+  if (size >= nulls_.size()) return;
+  null_count_ -= static_cast<std::size_t>(
+      std::count(nulls_.begin() + size, nulls_.end(), std::uint8_t{1}));
+  nulls_.resize(size);
+  switch (type_code_) {
+    case google::spanner::v1::TypeCode::BOOL:
+      bool_values_.resize(size);
+      break;
+    case google::spanner::v1::TypeCode::INT64:
+      int64_values_.resize(size);
+      break;
+    case google::spanner::v1::TypeCode::FLOAT64:
+      float64_values_.resize(size);
+      break;
+    case google::spanner::v1::TypeCode::TIMESTAMP:
+      timestamp_values_.resize(size);
+      break;
+    case google::spanner::v1::TypeCode::DATE:
+      date_values_.resize(size);
+      break;
+    default:
+      string_data_.resize(string_offsets_[size]);
+      string_offsets_.resize(size + 1);
+      break;
+  }
+}
+
+ColumnBatch::ColumnBatch(std::shared_ptr<std::vector<std::string> const> names,
+                         std::vector<ColumnVector> columns)
+    : names_(std::move(names)), columns_(std::move(columns)) {
+  size_ = columns_.empty() ? 0 : columns_.back().size();
+}
+
+namespace internal {
+
+StatusOr<ColumnBatchBuilder> ColumnBatchBuilder::Create(
+    std::shared_ptr<std::vector<std::string> const> names,
+    std::vector<google::spanner::v1::TypeCode> const& type_codes) {
+  std::vector<ColumnVector> columns;
+  columns.reserve(type_codes.size());
+  for (std::size_t i = 0; i != type_codes.size(); ++i) {
+    auto const code = type_codes[i];
+    if (!IsSupported(code)) {
+      auto const name = i < names->size() ? (*names)[i] : std::to_string(i);
+      return Status(StatusCode::kInvalidArgument,
+                    "column \"" + name + "\" has type " +
+                        google::spanner::v1::TypeCode_Name(code) +
+                        ", which is not supported by ColumnBatch");
+    }
+    columns.push_back(ColumnVector(code));
+  }
+  return ColumnBatchBuilder(std::move(names), std::move(columns));
+}
+
+void ColumnBatchBuilder::DiscardPartialRow(std::size_t column) {
+  // The value for `column` was not appended, so it holds the complete rows.
+  auto const size = columns_[column].size();
+  for (std::size_t i = 0; i != column; ++i) columns_[i].Truncate(size);
+}
+
+ColumnBatch ColumnBatchBuilder::Build() && {
+  return ColumnBatch(std::move(names_), std::move(columns_));
+}
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
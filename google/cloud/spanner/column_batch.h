@@ -0,0 +1,222 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_COLUMN_BATCH_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_COLUMN_BATCH_H
+
+#include "google/cloud/spanner/date.h"
+#include "google/cloud/spanner/timestamp.h"
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/status.h"
+#include "google/cloud/status_or.h"
+#include <google/protobuf/struct.pb.h>
+#include <google/spanner/v1/type.pb.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+namespace internal {
+class ColumnBatchBuilder;
+}  // namespace internal
+
+/**
+ * The values of a single column in a `ColumnBatch`.
+ *
+ * The values are stored contiguously, in a container that depends on the
+ * column type:
+ *
+ * - `BOOL` columns use `bool_values()`, one byte (0 or 1) per value.
+ * - `INT64` columns use `int64_values()`.
+ * - `FLOAT64` columns use `float64_values()`.
+ * - `TIMESTAMP` columns use `timestamp_values()`.
+ * - `DATE` columns use `date_values()`.
+ * - `STRING` and `BYTES` columns use a single "arena", `string_data()`. The
+ *   value in row `i` is the range `[string_offsets()[i],
+ *   string_offsets()[i + 1])` of the arena. `BYTES` values are stored decoded.
+ *
+ * The containers for the other types are empty. Null values are recorded in
+ * `nulls()`, one byte per row (1 if the value is null). Their slot in the
+ * value container holds a value-initialized element (or an empty string) so
+ * the rows line up.
+ */
+class ColumnVector {
+ public:
+  /// Returns the Spanner type of the column.
+  google::spanner::v1::TypeCode type_code() const { return type_code_; }
+
+  /// Returns the number of rows in the column.
+  std::size_t size() const { return nulls_.size(); }
+
+  /// Returns true if the value in row @p i is null.
+  bool is_null(std::size_t i) const { return nulls_[i] != 0; }
+
+  /// Returns one byte per row, 1 if the value in that row is null, else 0.
+  std::vector<std::uint8_t> const& nulls() const { return nulls_; }
+
+  /// Returns the number of null values in the column.
+  std::size_t null_count() const { return null_count_; }
+
+  /// @name Value containers, see the class description.
+  ///@{
+  std::vector<std::uint8_t> const& bool_values() const {
+    return bool_values_;
+  }
+  std::vector<std::int64_t> const& int64_values() const {
+    return int64_values_;
+  }
+  std::vector<double> const& float64_values() const { return float64_values_; }
+  std::vector<Timestamp> const& timestamp_values() const {
+    return timestamp_values_;
+  }
+  std::vector<Date> const& date_values() const { return date_values_; }
+  std::string const& string_data() const { return string_data_; }
+  std::vector<std::size_t> const& string_offsets() const {
+    return string_offsets_;
+  }
+  ///@}
+
+  /// Returns a copy of the `STRING` or `BYTES` value in row @p i.
+  std::string string_value(std::size_t i) const {
+    return string_data_.substr(string_offsets_[i],
+                               string_offsets_[i + 1] - string_offsets_[i]);
+  }
+
+ private:
+  friend class internal::ColumnBatchBuilder;
+  explicit ColumnVector(google::spanner::v1::TypeCode type_code);
+
+  Status Append(google::protobuf::Value const& value);
+  void AppendNull();
+  // Removes the rows after the first @p size rows.
+  void Truncate(std::size_t size);
+
+  google::spanner::v1::TypeCode type_code_;
+  std::vector<std::uint8_t> nulls_;
+  std::size_t null_count_ = 0;
+  std::vector<std::uint8_t> bool_values_;
+  std::vector<std::int64_t> int64_values_;
+  std::vector<double> float64_values_;
+  std::vector<Timestamp> timestamp_values_;
+  std::vector<Date> date_values_;
+  std::string string_data_;
+  std::vector<std::size_t> string_offsets_;
+};
+
+/**
+ * A batch of rows from a `RowStream`, stored column by column.
+ *
+ * `ColumnBatch` is returned by `RowStream::NextBatch()`. Applications that
+ * process whole columns (aggregations, scans, conversion to other columnar
+ * formats) can iterate over the contiguous values of each column, without
+ * creating a `Row` or `Value` per row.
+ *
+ * @par Example
+ * @code
+ * auto rows = client.ExecuteQuery(SqlStatement("SELECT Id FROM Singers"));
+ * std::int64_t sum = 0;
+ * for (;;) {
+ *   auto batch = rows.NextBatch(1024);
+ *   if (!batch) throw std::runtime_error(batch.status().message());
+ *   if (batch->empty()) break;
+ *   for (auto id : batch->column(0).int64_values()) sum += id;
+ * }
+ * @endcode
+ */
+class ColumnBatch {
+ public:
+  /// Default constructs an empty batch with no columns nor rows.
+  ColumnBatch() = default;
+
+  /// Returns the number of rows in the batch.
+  std::size_t size() const { return size_; }
+
+  /// Returns true if the batch has no rows.
+  bool empty() const { return size_ == 0; }
+
+  /// Returns the column names.
+  std::vector<std::string> const& column_names() const { return *names_; }
+
+  /// Returns all the columns, in the same order as `column_names()`.
+  std::vector<ColumnVector> const& columns() const { return columns_; }
+
+  /// Returns the column at position @p i.
+  ColumnVector const& column(std::size_t i) const { return columns_[i]; }
+
+ private:
+  friend class internal::ColumnBatchBuilder;
+  ColumnBatch(std::shared_ptr<std::vector<std::string> const> names,
+              std::vector<ColumnVector> columns);
+
+  std::shared_ptr<std::vector<std::string> const> names_ =
+      std::make_shared<std::vector<std::string>>();
+  std::vector<ColumnVector> columns_;
+  std::size_t size_ = 0;
+};
+
+namespace internal {
+
+/**
+ * Decodes the `Value` protos of a result set directly into a `ColumnBatch`.
+ *
+ * The protos are appended in row-major order, i.e., the values of the first
+ * row, then the values of the second row, and so on. If a value cannot be
+ * decoded the values already appended for its row are discarded, so the
+ * batch only holds complete rows.
+ */
+class ColumnBatchBuilder {
+ public:
+  /// Returns an error if some column type is not supported by `ColumnBatch`.
+  static StatusOr<ColumnBatchBuilder> Create(
+      std::shared_ptr<std::vector<std::string> const> names,
+      std::vector<google::spanner::v1::TypeCode> const& type_codes);
+
+  /// Appends the value for @p column in the current row.
+  Status Append(std::size_t column, google::protobuf::Value const& value) {
+    auto status = columns_[column].Append(value);
+    if (!status.ok()) DiscardPartialRow(column);
+    return status;
+  }
+
+  /// Returns the number of complete rows appended so far.
+  std::size_t size() const {
+    return columns_.empty() ? 0 : columns_.back().size();
+  }
+
+  ColumnBatch Build() &&;
+
+ private:
+  ColumnBatchBuilder(std::shared_ptr<std::vector<std::string> const> names,
+                     std::vector<ColumnVector> columns)
+      : names_(std::move(names)), columns_(std::move(columns)) {}
+
+  // Removes the values of the current row from the columns before @p column.
+  void DiscardPartialRow(std::size_t column);
+
+  std::shared_ptr<std::vector<std::string> const> names_;
+  std::vector<ColumnVector> columns_;
+};
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_COLUMN_BATCH_H
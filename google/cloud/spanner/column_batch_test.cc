@@ -0,0 +1,195 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/column_batch.h"
+#include "google/cloud/spanner/value.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include <gmock/gmock.h>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+namespace spanner_proto = ::google::spanner::v1;
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+std::shared_ptr<std::vector<std::string> const> Names(std::size_t n) {
+  auto names = std::make_shared<std::vector<std::string>>();
+  for (std::size_t i = 0; i != n; ++i) names->push_back(std::to_string(i));
+  return names;
+}
+
+// Appends a row made of the given `Value`s.
+template <typename... Ts>
+void AppendRow(internal::ColumnBatchBuilder& builder, Ts&&... ts) {
+  std::vector<Value> values{Value(std::forward<Ts>(ts))...};
+  for (std::size_t i = 0; i != values.size(); ++i) {
+    ASSERT_STATUS_OK(builder.Append(i, internal::ToProto(values[i]).second));
+  }
+}
+
+TEST(ColumnBatch, DefaultConstructed) {
+  ColumnBatch batch;
+  EXPECT_TRUE(batch.empty());
+  EXPECT_EQ(0, batch.size());
+  EXPECT_TRUE(batch.column_names().empty());
+  EXPECT_TRUE(batch.columns().empty());
+}
+
+TEST(ColumnBatch, ScalarColumns) {
+  auto builder = internal::ColumnBatchBuilder::Create(
+      Names(4), {spanner_proto::TypeCode::BOOL, spanner_proto::TypeCode::INT64,
+                 spanner_proto::TypeCode::FLOAT64,
+                 spanner_proto::TypeCode::DATE});
+  ASSERT_STATUS_OK(builder);
+  AppendRow(*builder, true, std::int64_t{42}, 1.5, Date(2020, 1, 2));
+  AppendRow(*builder, MakeNullValue<bool>(), std::int64_t{-7},
+            std::numeric_limits<double>::infinity(), MakeNullValue<Date>());
+  EXPECT_EQ(2, builder->size());
+  auto batch = std::move(*builder).Build();
+
+  EXPECT_EQ(2, batch.size());
+  EXPECT_THAT(batch.column_names(), ElementsAre("0", "1", "2", "3"));
+  ASSERT_EQ(4, batch.columns().size());
+
+  auto const& bools = batch.column(0);
+  EXPECT_EQ(spanner_proto::TypeCode::BOOL, bools.type_code());
+  EXPECT_THAT(bools.nulls(), ElementsAre(0, 1));
+  EXPECT_EQ(1, bools.null_count());
+  EXPECT_THAT(bools.bool_values(), ElementsAre(1, 0));
+  EXPECT_TRUE(bools.int64_values().empty());
+
+  EXPECT_THAT(batch.column(1).int64_values(), ElementsAre(42, -7));
+  EXPECT_EQ(0, batch.column(1).null_count());
+  EXPECT_THAT(batch.column(2).float64_values(),
+              ElementsAre(1.5, std::numeric_limits<double>::infinity()));
+  EXPECT_THAT(batch.column(3).date_values(),
+              ElementsAre(Date(2020, 1, 2), Date()));
+  EXPECT_TRUE(batch.column(3).is_null(1));
+}
+
+TEST(ColumnBatch, StringArena) {
+  auto builder = internal::ColumnBatchBuilder::Create(
+      Names(2),
+      {spanner_proto::TypeCode::STRING, spanner_proto::TypeCode::BYTES});
+  ASSERT_STATUS_OK(builder);
+  AppendRow(*builder, "foo", Bytes(std::string("\x01\x02")));
+  AppendRow(*builder, MakeNullValue<std::string>(), Bytes(std::string()));
+  AppendRow(*builder, "barbaz", MakeNullValue<Bytes>());
+  auto batch = std::move(*builder).Build();
+  ASSERT_EQ(3, batch.size());
+
+  auto const& strings = batch.column(0);
+  EXPECT_EQ("foobarbaz", strings.string_data());
+  EXPECT_EQ((std::vector<std::size_t>{0, 3, 3, 9}), strings.string_offsets());
+  EXPECT_EQ("foo", strings.string_value(0));
+  EXPECT_TRUE(strings.is_null(1));
+  EXPECT_EQ("", strings.string_value(1));
+  EXPECT_EQ("barbaz", strings.string_value(2));
+
+  // BYTES are stored decoded, not in their base64 wire format.
+  auto const& bytes = batch.column(1);
+  EXPECT_EQ(std::string("\x01\x02"), bytes.string_data());
+  EXPECT_EQ((std::vector<std::size_t>{0, 2, 2, 2}), bytes.string_offsets());
+  EXPECT_THAT(bytes.nulls(), ElementsAre(0, 0, 1));
+}
+
+TEST(ColumnBatch, Timestamps) {
+  auto builder = internal::ColumnBatchBuilder::Create(
+      Names(1), {spanner_proto::TypeCode::TIMESTAMP});
+  ASSERT_STATUS_OK(builder);
+  auto const ts = internal::TimestampFromRFC3339("2020-02-03T04:05:06.789Z");
+  ASSERT_STATUS_OK(ts);
+  AppendRow(*builder, *ts);
+  auto batch = std::move(*builder).Build();
+  EXPECT_THAT(batch.column(0).timestamp_values(), ElementsAre(*ts));
+}
+
+TEST(ColumnBatch, UnsupportedType) {
+  auto names = std::make_shared<std::vector<std::string>>(
+      std::vector<std::string>{"Id", "Tags"});
+  auto builder = internal::ColumnBatchBuilder::Create(
+      names, {spanner_proto::TypeCode::INT64, spanner_proto::TypeCode::ARRAY});
+  EXPECT_EQ(StatusCode::kInvalidArgument, builder.status().code());
+  EXPECT_THAT(builder.status().message(), HasSubstr("\"Tags\""));
+  EXPECT_THAT(builder.status().message(), HasSubstr("ARRAY"));
+}
+
+TEST(ColumnBatch, BadValue) {
+  auto builder = internal::ColumnBatchBuilder::Create(
+      Names(1), {spanner_proto::TypeCode::INT64});
+  ASSERT_STATUS_OK(builder);
+  google::protobuf::Value v;
+  v.set_string_value("12x");
+  EXPECT_FALSE(builder->Append(0, v).ok());
+  v.set_bool_value(true);
+  EXPECT_FALSE(builder->Append(0, v).ok());
+  v.set_string_value("12");
+  EXPECT_STATUS_OK(builder->Append(0, v));
+  EXPECT_EQ(1, builder->size());
+}
+
+TEST(ColumnBatch, BadValueDiscardsPartialRow) {
+  auto builder = internal::ColumnBatchBuilder::Create(
+      Names(4),
+      {spanner_proto::TypeCode::BOOL, spanner_proto::TypeCode::STRING,
+       spanner_proto::TypeCode::DATE, spanner_proto::TypeCode::INT64});
+  ASSERT_STATUS_OK(builder);
+  AppendRow(*builder, true, "foo", Date(2020, 1, 2), std::int64_t{42});
+
+  // The first three values of the second row are appended, the last one fails.
+  google::protobuf::Value v;
+  v.set_bool_value(false);
+  ASSERT_STATUS_OK(builder->Append(0, v));
+  v.set_string_value("barbaz");
+  ASSERT_STATUS_OK(builder->Append(1, v));
+  v.set_null_value(google::protobuf::NULL_VALUE);
+  ASSERT_STATUS_OK(builder->Append(2, v));
+  v.set_string_value("12x");
+  EXPECT_FALSE(builder->Append(3, v).ok());
+  EXPECT_EQ(1, builder->size());
+
+  // The columns only hold the first row, and more rows can be appended.
+  AppendRow(*builder, MakeNullValue<bool>(), "x", Date(2021, 3, 4),
+            std::int64_t{7});
+  auto batch = std::move(*builder).Build();
+  ASSERT_EQ(2, batch.size());
+  for (auto const& column : batch.columns()) {
+    EXPECT_EQ(2, column.size());
+  }
+  EXPECT_THAT(batch.column(0).bool_values(), ElementsAre(1, 0));
+  EXPECT_THAT(batch.column(0).nulls(), ElementsAre(0, 1));
+  EXPECT_EQ("foox", batch.column(1).string_data());
+  EXPECT_EQ((std::vector<std::size_t>{0, 3, 4}),
+            batch.column(1).string_offsets());
+  EXPECT_EQ(0, batch.column(2).null_count());
+  EXPECT_THAT(batch.column(2).date_values(),
+              ElementsAre(Date(2020, 1, 2), Date(2021, 3, 4)));
+  EXPECT_THAT(batch.column(3).int64_values(), ElementsAre(42, 7));
+}
+
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
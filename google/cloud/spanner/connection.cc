@@ -0,0 +1,83 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/connection.h"
+#include "google/cloud/internal/make_unique.h"
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+class StatusOnlyResultSetSource : public internal::ResultSourceInterface {
+ public:
+  explicit StatusOnlyResultSetSource(Status status)
+      : status_(std::move(status)) {}
+  ~StatusOnlyResultSetSource() override = default;
+
+  StatusOr<Row> NextRow() override { return status_; }
+  optional<google::spanner::v1::ResultSetMetadata> Metadata() override {
+    return {};
+  }
+  optional<google::spanner::v1::ResultSetStats> Stats() const override {
+    return {};
+  }
+
+ private:
+  Status status_;
+};
+
+}  // namespace
+
+// NOLINTNEXTLINE(performance-unnecessary-value-param)
+future<RowStream> Connection::AsyncRead(ReadParams) {
+  return google::cloud::make_ready_future(
+      RowStream(google::cloud::internal::make_unique<StatusOnlyResultSetSource>(
+          Status(StatusCode::kUnimplemented, "not implemented"))));
+}
+
+// NOLINTNEXTLINE(performance-unnecessary-value-param)
+future<RowStream> Connection::AsyncExecuteQuery(SqlParams) {
+  return google::cloud::make_ready_future(
+      RowStream(google::cloud::internal::make_unique<StatusOnlyResultSetSource>(
+          Status(StatusCode::kUnimplemented, "not implemented"))));
+}
+
+// NOLINTNEXTLINE(performance-unnecessary-value-param)
+future<StatusOr<DmlResult>> Connection::AsyncExecuteDml(SqlParams) {
+  return google::cloud::make_ready_future(StatusOr<DmlResult>(
+      Status(StatusCode::kUnimplemented, "not implemented")));
+}
+
+// NOLINTNEXTLINE(performance-unnecessary-value-param)
+future<StatusOr<CommitResult>> Connection::AsyncCommit(CommitParams) {
+  return google::cloud::make_ready_future(StatusOr<CommitResult>(
+      Status(StatusCode::kUnimplemented, "not implemented")));
+}
+
+// NOLINTNEXTLINE(performance-unnecessary-value-param)
+future<Status> Connection::AsyncRollback(RollbackParams) {
+  return google::cloud::make_ready_future(
+      Status(StatusCode::kUnimplemented, "not implemented"));
+}
+
+StatusOr<SessionPoolMetrics> Connection::GetSessionPoolMetrics() {
+  return Status(StatusCode::kUnimplemented, "not implemented");
+}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -25,9 +25,11 @@
 #include "google/cloud/spanner/query_options.h"
 #include "google/cloud/spanner/read_options.h"
 #include "google/cloud/spanner/results.h"
+#include "google/cloud/spanner/session_pool_metrics.h"
 #include "google/cloud/spanner/sql_statement.h"
 #include "google/cloud/spanner/transaction.h"
 #include "google/cloud/spanner/version.h"
+#include "google/cloud/future.h"
 #include "google/cloud/optional.h"
 #include "google/cloud/status_or.h"
 #include <string>
@@ -161,6 +163,37 @@ class Connection {
 
   /// Defines the interface for `Client::Rollback()`
   virtual Status Rollback(RollbackParams) = 0;
+
+  //@{
+  /**
+   * @name Asynchronous operations.
+   *
+   * These are not pure-virtual, so existing implementations continue to
+   * compile. The default implementations return a `kUnimplemented` error.
+   */
+  /// Defines the interface for `Client::AsyncRead()`
+  virtual future<RowStream> AsyncRead(ReadParams);
+
+  /// Defines the interface for `Client::AsyncExecuteQuery()`
+  virtual future<RowStream> AsyncExecuteQuery(SqlParams);
+
+  /// Defines the interface for `Client::AsyncExecuteDml()`
+  virtual future<StatusOr<DmlResult>> AsyncExecuteDml(SqlParams);
+
+  /// Defines the interface for `Client::AsyncCommit()`
+  virtual future<StatusOr<CommitResult>> AsyncCommit(CommitParams);
+
+  /// Defines the interface for `Client::AsyncRollback()`
+  virtual future<Status> AsyncRollback(RollbackParams);
+  //@}
+
+  /**
+   * Defines the interface for `Client::GetSessionPoolMetrics()`.
+   *
+   * The default implementation returns a `kUnimplemented` error, as not all
+   * implementations use a session pool.
+   */
+  virtual StatusOr<SessionPoolMetrics> GetSessionPoolMetrics();
 };
 
 }  // namespace SPANNER_CLIENT_NS
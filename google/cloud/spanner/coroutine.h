@@ -0,0 +1,218 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_COROUTINE_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_COROUTINE_H
+
+#include "google/cloud/spanner/results.h"
+#include "google/cloud/spanner/row.h"
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/future.h"
+#include "google/cloud/internal/make_unique.h"
+#include "google/cloud/optional.h"
+#include "google/cloud/status_or.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <utility>
+
+// Some compilers ship <coroutine> but reject it unless coroutines are enabled.
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#endif  // __has_include(<coroutine>)
+#endif  // defined(__cpp_impl_coroutine) && defined(__has_include)
+
+/**
+ * Defined to 1 when the compiler and the standard library support C++20
+ * coroutines, and the adapters in this file are available.
+ */
+#if defined(__cpp_impl_coroutine) && defined(__cpp_lib_coroutine)
+#define GOOGLE_CLOUD_CPP_SPANNER_HAVE_COROUTINES 1
+#else
+#define GOOGLE_CLOUD_CPP_SPANNER_HAVE_COROUTINES 0
+#endif
+
+#if GOOGLE_CLOUD_CPP_SPANNER_HAVE_COROUTINES
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+/**
+ * Decides who resumes a coroutine suspended on a future callback.
+ *
+ * Both `await_suspend()`, once the callback is attached, and the callback call
+ * `Arrive()`, and only the second caller gets `true`. If the callback runs
+ * first, it must not resume the coroutine, instead `await_suspend()` returns
+ * `false` so the coroutine continues on the current thread. Otherwise
+ * `await_suspend()` returns `true` and the callback resumes the coroutine.
+ */
+class ResumeOnce {
+ public:
+  bool Arrive() { return arrived_.exchange(true); }
+
+ private:
+  std::atomic<bool> arrived_{false};
+};
+
+}  // namespace internal
+
+/**
+ * Awaits a `google::cloud::future<T>` from a C++20 coroutine.
+ *
+ * The coroutine is resumed on the thread that satisfies the future, for the
+ * asynchronous operations of a `Client` this is a thread running its
+ * `CompletionQueue`, so there is no extra hop to another thread. Coroutines
+ * should not block those threads, in particular they should consume the rows
+ * of a `RowStream` with `AsyncRowGenerator`.
+ *
+ * @par Example
+ * @code
+ * auto result = co_await spanner::Await(client.AsyncCommit(txn, mutations));
+ * @endcode
+ */
+template <typename T>
+class FutureAwaiter {
+ public:
+  explicit FutureAwaiter(future<T> f) : future_(std::move(f)) {}
+
+  bool await_ready() {
+    return future_.wait_for(std::chrono::seconds(0)) ==
+           std::future_status::ready;
+  }
+
+  // The future may become ready before `.then()` attaches the callback, which
+  // then runs immediately. In that case the coroutine is not suspended, see
+  // `internal::ResumeOnce` for details.
+  bool await_suspend(std::coroutine_handle<> handle) {
+    future_.then([this, handle](future<T> f) {
+      ready_ = std::move(f);
+      if (resume_.Arrive()) handle.resume();
+    });
+    return !resume_.Arrive();
+  }
+
+  T await_resume() { return ready_.valid() ? ready_.get() : future_.get(); }
+
+ private:
+  future<T> future_;
+  future<T> ready_;
+  internal::ResumeOnce resume_;
+};
+
+/// Returns an awaitable for @p f, see `FutureAwaiter` for details.
+template <typename T>
+FutureAwaiter<T> Await(future<T> f) {
+  return FutureAwaiter<T>(std::move(f));
+}
+
+/**
+ * Consumes the rows of a `RowStream` from a C++20 coroutine.
+ *
+ * Each `co_await` on `Next()` suspends the coroutine until the next row has
+ * been received, using `RowStream::WhenRowReady()`, and resumes it with that
+ * row, or with an empty `optional` at the end of the stream. The streams
+ * returned by `Client::AsyncRead()` and `Client::AsyncExecuteQuery()`, or
+ * using the `prefetch_buffer_bytes` option, are consumed without blocking,
+ * even when they resume after a transient failure. Other streams block the
+ * coroutine's thread while the rows arrive, see `RowStream::WhenRowReady()`
+ * for details.
+ *
+ * @par Example
+ * @code
+ * auto rows = co_await spanner::Await(client.AsyncExecuteQuery(statement));
+ * spanner::AsyncRowGenerator generator(std::move(rows));
+ * while (auto row = co_await generator.Next()) {
+ *   if (!*row) co_return std::move(*row).status();
+ *   // Use `**row` here.
+ * }
+ * @endcode
+ */
+class AsyncRowGenerator {
+ public:
+  explicit AsyncRowGenerator(RowStream rows)
+      : rows_(google::cloud::internal::make_unique<RowStream>(
+            std::move(rows))) {}
+
+  // This class is movable but not copyable. It must outlive the awaitable
+  // returned by `Next()`.
+  AsyncRowGenerator(AsyncRowGenerator&&) = default;
+  AsyncRowGenerator& operator=(AsyncRowGenerator&&) = default;
+
+  /// The awaitable returned by `Next()`.
+  class NextAwaiter {
+   public:
+    explicit NextAwaiter(AsyncRowGenerator& generator)
+        : generator_(generator) {}
+
+    bool await_ready() {
+      if (generator_.Done()) return true;
+      ready_ = generator_.rows_->WhenRowReady();
+      return ready_.wait_for(std::chrono::seconds(0)) ==
+             std::future_status::ready;
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+      ready_.then([this, handle](future<void>) {
+        if (resume_.Arrive()) handle.resume();
+      });
+      return !resume_.Arrive();
+    }
+
+    optional<StatusOr<Row>> await_resume() { return generator_.Advance(); }
+
+   private:
+    AsyncRowGenerator& generator_;
+    future<void> ready_;
+    internal::ResumeOnce resume_;
+  };
+
+  /// Returns an awaitable for the next row.
+  NextAwaiter Next() { return NextAwaiter(*this); }
+
+ private:
+  // Returns true if the stream has ended, or will end after the last row,
+  // which was an error.
+  bool Done() { return started_ && (it_ == rows_->end() || !*it_); }
+
+  // Moves to the next row, which has been received already.
+  optional<StatusOr<Row>> Advance() {
+    if (!started_) {
+      started_ = true;
+      it_ = rows_->begin();
+    } else if (it_ != rows_->end()) {
+      ++it_;
+    }
+    if (it_ == rows_->end()) return {};
+    return *it_;
+  }
+
+  // The iterator refers to the stream, which must not move.
+  std::unique_ptr<RowStream> rows_;
+  RowStreamIterator it_;
+  bool started_ = false;
+};
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_SPANNER_HAVE_COROUTINES
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_COROUTINE_H
@@ -0,0 +1,196 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/coroutine.h"
+#include "google/cloud/spanner/value.h"
+#include "google/cloud/internal/make_unique.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include <gmock/gmock.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+#if __cplusplus >= 202002L && !GOOGLE_CLOUD_CPP_SPANNER_HAVE_COROUTINES
+#error "C++20 builds are expected to compile and test the coroutine adapters"
+#endif
+
+#if GOOGLE_CLOUD_CPP_SPANNER_HAVE_COROUTINES
+
+/// A coroutine type that starts eagerly and is not awaited by its caller.
+struct Task {
+  struct promise_type {
+    Task get_return_object() { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+};
+
+Task AwaitInt(future<int> f, int& result) {
+  result = co_await Await(std::move(f));
+}
+
+TEST(CoroutineTest, AwaitReady) {
+  int result = 0;
+  AwaitInt(make_ready_future(42), result);
+  EXPECT_EQ(42, result);
+}
+
+TEST(CoroutineTest, AwaitPending) {
+  promise<int> p;
+  int result = 0;
+  AwaitInt(p.get_future(), result);
+  EXPECT_EQ(0, result);
+  p.set_value(42);
+  EXPECT_EQ(42, result);
+}
+
+TEST(CoroutineTest, AwaitReadyAfterCheck) {
+  promise<int> p;
+  auto awaiter = Await(p.get_future());
+  EXPECT_FALSE(awaiter.await_ready());
+  // The future is satisfied before the coroutine suspends, so it must not
+  // suspend, nor be resumed from within `await_suspend()`.
+  p.set_value(42);
+  EXPECT_FALSE(awaiter.await_suspend(std::noop_coroutine()));
+  EXPECT_EQ(42, awaiter.await_resume());
+}
+
+Task AwaitVoid(future<void> f, bool& done) {
+  co_await Await(std::move(f));
+  done = true;
+}
+
+TEST(CoroutineTest, AwaitVoid) {
+  promise<void> p;
+  bool done = false;
+  AwaitVoid(p.get_future(), done);
+  EXPECT_FALSE(done);
+  p.set_value();
+  EXPECT_TRUE(done);
+}
+
+/// A source whose rows arrive when the test satisfies `ready`.
+class FakeSource : public internal::ResultSourceInterface {
+ public:
+  explicit FakeSource(std::deque<StatusOr<Row>>* rows) : rows_(rows) {}
+
+  StatusOr<Row> NextRow() override {
+    EXPECT_FALSE(rows_->empty());
+    auto row = std::move(rows_->front());
+    rows_->pop_front();
+    return row;
+  }
+  future<void> WhenRowReady() override {
+    ready = promise<void>();
+    return ready.get_future();
+  }
+  optional<google::spanner::v1::ResultSetMetadata> Metadata() override {
+    return {};
+  }
+  optional<google::spanner::v1::ResultSetStats> Stats() const override {
+    return {};
+  }
+
+  promise<void> ready;
+
+ private:
+  std::deque<StatusOr<Row>>* rows_;
+};
+
+Task ConsumeRows(AsyncRowGenerator& generator,
+                 std::vector<StatusOr<Row>>& consumed, bool& done) {
+  while (auto row = co_await generator.Next()) {
+    consumed.push_back(*std::move(row));
+  }
+  done = true;
+}
+
+TEST(CoroutineTest, AsyncRowGenerator) {
+  std::deque<StatusOr<Row>> rows;
+  auto source = google::cloud::internal::make_unique<FakeSource>(&rows);
+  auto* fake = source.get();
+  AsyncRowGenerator generator{RowStream(std::move(source))};
+
+  std::vector<StatusOr<Row>> consumed;
+  bool done = false;
+  ConsumeRows(generator, consumed, done);
+  EXPECT_TRUE(consumed.empty());
+
+  rows.push_back(MakeTestRow({{"c", Value(1)}}));
+  fake->ready.set_value();
+  ASSERT_EQ(1, consumed.size());
+  EXPECT_EQ(MakeTestRow({{"c", Value(1)}}), *consumed[0]);
+
+  rows.push_back(MakeTestRow({{"c", Value(2)}}));
+  fake->ready.set_value();
+  ASSERT_EQ(2, consumed.size());
+  EXPECT_EQ(MakeTestRow({{"c", Value(2)}}), *consumed[1]);
+  EXPECT_FALSE(done);
+
+  // An empty row marks the end of the stream.
+  rows.push_back(Row());
+  fake->ready.set_value();
+  EXPECT_EQ(2, consumed.size());
+  EXPECT_TRUE(done);
+}
+
+TEST(CoroutineTest, AsyncRowGeneratorReadyAfterCheck) {
+  std::deque<StatusOr<Row>> rows;
+  auto source = google::cloud::internal::make_unique<FakeSource>(&rows);
+  auto* fake = source.get();
+  AsyncRowGenerator generator{RowStream(std::move(source))};
+
+  auto awaiter = generator.Next();
+  EXPECT_FALSE(awaiter.await_ready());
+  rows.push_back(MakeTestRow({{"c", Value(1)}}));
+  fake->ready.set_value();
+  EXPECT_FALSE(awaiter.await_suspend(std::noop_coroutine()));
+  auto row = awaiter.await_resume();
+  ASSERT_TRUE(row.has_value());
+  EXPECT_EQ(MakeTestRow({{"c", Value(1)}}), **row);
+}
+
+TEST(CoroutineTest, AsyncRowGeneratorError) {
+  std::deque<StatusOr<Row>> rows;
+  auto source = google::cloud::internal::make_unique<FakeSource>(&rows);
+  auto* fake = source.get();
+  AsyncRowGenerator generator{RowStream(std::move(source))};
+
+  std::vector<StatusOr<Row>> consumed;
+  bool done = false;
+  ConsumeRows(generator, consumed, done);
+  rows.push_back(Status(StatusCode::kUnavailable, "try-again"));
+  fake->ready.set_value();
+
+  // The stream ends after the error, without waiting for more rows.
+  ASSERT_EQ(1, consumed.size());
+  EXPECT_EQ(StatusCode::kUnavailable, consumed[0].status().code());
+  EXPECT_TRUE(done);
+}
+
+#endif  // GOOGLE_CLOUD_CPP_SPANNER_HAVE_COROUTINES
+
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
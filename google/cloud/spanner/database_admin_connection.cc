@@ -13,9 +13,10 @@
 // limitations under the License.
 
 #include "google/cloud/spanner/database_admin_connection.h"
-#include "google/cloud/spanner/internal/polling_loop.h"
+#include "google/cloud/spanner/internal/async_polling_loop.h"
 #include "google/cloud/spanner/internal/retry_loop.h"
 #include "google/cloud/spanner/internal/time_utils.h"
+#include "google/cloud/background_threads.h"
 #include <chrono>
 
 namespace google {
@@ -124,19 +125,27 @@ class DatabaseAdminConnectionImpl : public DatabaseAdminConnection {
       std::shared_ptr<internal::DatabaseAdminStub> stub,
       std::unique_ptr<RetryPolicy> retry_policy,
       std::unique_ptr<BackoffPolicy> backoff_policy,
-      std::unique_ptr<PollingPolicy> polling_policy)
+      std::unique_ptr<PollingPolicy> polling_policy,
+      ConnectionOptions const& options)
       : stub_(std::move(stub)),
         retry_policy_prototype_(std::move(retry_policy)),
         backoff_policy_prototype_(std::move(backoff_policy)),
-        polling_policy_prototype_(std::move(polling_policy)) {}
+        polling_policy_prototype_(std::move(polling_policy)),
+        background_threads_(options.background_threads_factory()()) {}
 
   explicit DatabaseAdminConnectionImpl(
-      std::shared_ptr<internal::DatabaseAdminStub> stub)
+      std::shared_ptr<internal::DatabaseAdminStub> stub,
+      ConnectionOptions const& options)
       : DatabaseAdminConnectionImpl(std::move(stub), DefaultAdminRetryPolicy(),
                                     DefaultAdminBackoffPolicy(),
-                                    DefaultAdminPollingPolicy()) {}
+                                    DefaultAdminPollingPolicy(), options) {}
 
-  ~DatabaseAdminConnectionImpl() override = default;
+  ~DatabaseAdminConnectionImpl() override {
+    // Do not wait for the polling timers of any pending operations, their
+    // futures are satisfied with an error instead. The `CompletionQueue` may
+    // be shared, only the operations of this connection are cancelled.
+    polling_loops_.CancelAll();
+  }
 
   future<StatusOr<google::spanner::admin::database::v1::Database>>
   CreateDatabase(CreateDatabaseParams p) override {
@@ -505,72 +514,15 @@ class DatabaseAdminConnectionImpl : public DatabaseAdminConnection {
  private:
   future<StatusOr<gcsa::Database>> AwaitDatabase(
       google::longrunning::Operation operation) {
-    promise<StatusOr<gcsa::Database>> pr;
-    auto f = pr.get_future();
-
-    // TODO(#127) - use the (implicit) completion queue to run this loop.
-    std::thread t(
-        [](std::shared_ptr<internal::DatabaseAdminStub> stub,
-           google::longrunning::Operation operation,
-           std::unique_ptr<PollingPolicy> polling_policy,
-           google::cloud::promise<StatusOr<gcsa::Database>> promise,
-           char const* location) mutable {
-          auto result = internal::PollingLoop<
-              internal::PollingLoopResponseExtractor<gcsa::Database>>(
-              std::move(polling_policy),
-              [stub](grpc::ClientContext& context,
-                     google::longrunning::GetOperationRequest const& request) {
-                return stub->GetOperation(context, request);
-              },
-              std::move(operation), location);
-
-          // Drop our reference to stub; ideally we'd have std::moved into the
-          // lambda. Doing this also prevents a false leak from being reported
-          // when using googlemock.
-          stub.reset();
-          promise.set_value(std::move(result));
-        },
-        stub_, std::move(operation), polling_policy_prototype_->clone(),
-        std::move(pr), __func__);
-    t.detach();
-
-    return f;
+    return AwaitOperation<
+        internal::PollingLoopResponseExtractor<gcsa::Database>>(
+        std::move(operation), __func__);
   }
 
   future<StatusOr<gcsa::UpdateDatabaseDdlMetadata>> AwaitUpdateDatabase(
       google::longrunning::Operation operation) {
-    promise<StatusOr<gcsa::UpdateDatabaseDdlMetadata>> pr;
-    auto f = pr.get_future();
-
-    // TODO(#127) - use the (implicit) completion queue to run this loop.
-    std::thread t(
-        [](std::shared_ptr<internal::DatabaseAdminStub> stub,
-           google::longrunning::Operation operation,
-           std::unique_ptr<PollingPolicy> polling_policy,
-           promise<StatusOr<gcsa::UpdateDatabaseDdlMetadata>> promise,
-           char const* location) mutable {
-          auto result =
-              internal::PollingLoop<internal::PollingLoopMetadataExtractor<
-                  gcsa::UpdateDatabaseDdlMetadata>>(
-                  std::move(polling_policy),
-                  [stub](
-                      grpc::ClientContext& context,
-                      google::longrunning::GetOperationRequest const& request) {
-                    return stub->GetOperation(context, request);
-                  },
-                  std::move(operation), location);
-
-          // Drop our reference to stub; ideally we'd have std::moved into the
-          // lambda. Doing this also prevents a false leak from being reported
-          // when using googlemock.
-          stub.reset();
-          promise.set_value(std::move(result));
-        },
-        stub_, std::move(operation), polling_policy_prototype_->clone(),
-        std::move(pr), __func__);
-    t.detach();
-
-    return f;
+    return AwaitOperation<internal::PollingLoopMetadataExtractor<
+        gcsa::UpdateDatabaseDdlMetadata>>(std::move(operation), __func__);
   }
 
   future<StatusOr<gcsa::Backup>> AwaitCreateBackup(
@@ -579,47 +531,52 @@ class DatabaseAdminConnectionImpl : public DatabaseAdminConnection {
     // the callback will be called.
     std::shared_ptr<internal::DatabaseAdminStub> cancel_stub(stub_);
     // Create a promise with a cancellation callback.
-    promise<StatusOr<gcsa::Backup>> pr([cancel_stub, operation]() {
-      grpc::ClientContext context;
-      google::longrunning::CancelOperationRequest request;
-      request.set_name(operation.name());
-      cancel_stub->CancelOperation(context, request);
-    });
-    auto f = pr.get_future();
-
-    // TODO(#127) - use the (implicit) completion queue to run this loop.
-    std::thread t(
-        [](std::shared_ptr<internal::DatabaseAdminStub> stub,
-           google::longrunning::Operation operation,
-           std::unique_ptr<PollingPolicy> polling_policy,
-           google::cloud::promise<StatusOr<gcsa::Backup>> promise,
-           char const* location) mutable {
-          auto result = internal::PollingLoop<
-              internal::PollingLoopResponseExtractor<gcsa::Backup>>(
-              std::move(polling_policy),
-              [stub](grpc::ClientContext& context,
-                     google::longrunning::GetOperationRequest const& request) {
-                return stub->GetOperation(context, request);
-              },
-              std::move(operation), location);
+    auto pr = std::make_shared<promise<StatusOr<gcsa::Backup>>>(
+        [cancel_stub, operation]() {
+          grpc::ClientContext context;
+          google::longrunning::CancelOperationRequest request;
+          request.set_name(operation.name());
+          cancel_stub->CancelOperation(context, request);
+        });
+    auto f = pr->get_future();
 
-          // Drop our reference to stub; ideally we'd have std::moved into the
-          // lambda. Doing this also prevents a false leak from being reported
-          // when using googlemock.
-          stub.reset();
-          promise.set_value(std::move(result));
-        },
-        stub_, std::move(operation), polling_policy_prototype_->clone(),
-        std::move(pr), __func__);
-    t.detach();
+    AwaitOperation<internal::PollingLoopResponseExtractor<gcsa::Backup>>(
+        std::move(operation), __func__)
+        .then([pr](future<StatusOr<gcsa::Backup>> result) {
+          pr->set_value(result.get());
+        });
 
     return f;
   }
 
+  /// Polls @p operation until it completes, without blocking any thread.
+  template <typename ValueExtractor>
+  future<typename ValueExtractor::ReturnType> AwaitOperation(
+      google::longrunning::Operation operation, char const* location) {
+    // Capture the stub, not `this`, the loop may outlive the connection.
+    auto stub = stub_;
+    return internal::AsyncPollingLoop<ValueExtractor>(
+        background_threads_->cq(), polling_policy_prototype_->clone(),
+        [stub](CompletionQueue& cq,
+               std::unique_ptr<grpc::ClientContext> context,
+               google::longrunning::GetOperationRequest const& request) {
+          return cq.MakeUnaryRpc(
+              [stub](grpc::ClientContext* context,
+                     google::longrunning::GetOperationRequest const& request,
+                     grpc::CompletionQueue* cq) {
+                return stub->AsyncGetOperation(*context, request, cq);
+              },
+              request, std::move(context));
+        },
+        std::move(operation), location, &polling_loops_);
+  }
+
   std::shared_ptr<internal::DatabaseAdminStub> stub_;
   std::unique_ptr<RetryPolicy const> retry_policy_prototype_;
   std::unique_ptr<BackoffPolicy const> backoff_policy_prototype_;
   std::unique_ptr<PollingPolicy const> polling_policy_prototype_;
+  std::unique_ptr<BackgroundThreads> background_threads_;
+  internal::AsyncPollingLoops polling_loops_;
 };
 }  // namespace
 
@@ -628,7 +585,7 @@ DatabaseAdminConnection::~DatabaseAdminConnection() = default;
 std::shared_ptr<DatabaseAdminConnection> MakeDatabaseAdminConnection(
     ConnectionOptions const& options) {
   return std::make_shared<DatabaseAdminConnectionImpl>(
-      internal::CreateDefaultDatabaseAdminStub(options));
+      internal::CreateDefaultDatabaseAdminStub(options), options);
 }
 
 std::shared_ptr<DatabaseAdminConnection> MakeDatabaseAdminConnection(
@@ -638,7 +595,7 @@ std::shared_ptr<DatabaseAdminConnection> MakeDatabaseAdminConnection(
   return std::make_shared<DatabaseAdminConnectionImpl>(
       internal::CreateDefaultDatabaseAdminStub(options),
       std::move(retry_policy), std::move(backoff_policy),
-      std::move(polling_policy));
+      std::move(polling_policy), options);
 }
 
 namespace internal {
@@ -647,10 +604,11 @@ std::shared_ptr<DatabaseAdminConnection> MakeDatabaseAdminConnection(
     std::shared_ptr<internal::DatabaseAdminStub> stub,
     std::unique_ptr<RetryPolicy> retry_policy,
     std::unique_ptr<BackoffPolicy> backoff_policy,
-    std::unique_ptr<PollingPolicy> polling_policy) {
+    std::unique_ptr<PollingPolicy> polling_policy,
+    ConnectionOptions const& options) {
   return std::make_shared<DatabaseAdminConnectionImpl>(
       std::move(stub), std::move(retry_policy), std::move(backoff_policy),
-      std::move(polling_policy));
+      std::move(polling_policy), options);
 }
 
 }  // namespace internal
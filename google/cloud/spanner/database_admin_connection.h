@@ -343,12 +343,18 @@ std::shared_ptr<DatabaseAdminConnection> MakeDatabaseAdminConnection(
     std::unique_ptr<PollingPolicy> polling_policy);
 
 namespace internal {
-/// Create a connection with only the retry decorator.
+/**
+ * Create a connection with only the retry decorator.
+ *
+ * The long-running operations are polled on the `CompletionQueue` created by
+ * the `background_threads_factory()` in @p options.
+ */
 std::shared_ptr<DatabaseAdminConnection> MakeDatabaseAdminConnection(
     std::shared_ptr<internal::DatabaseAdminStub> stub,
     std::unique_ptr<RetryPolicy> retry_policy,
     std::unique_ptr<BackoffPolicy> backoff_policy,
-    std::unique_ptr<PollingPolicy> polling_policy);
+    std::unique_ptr<PollingPolicy> polling_policy,
+    ConnectionOptions const& options = ConnectionOptions());
 }  // namespace internal
 
 }  // namespace SPANNER_CLIENT_NS
@@ -15,9 +15,16 @@
 #include "google/cloud/spanner/database_admin_connection.h"
 #include "google/cloud/spanner/testing/matchers.h"
 #include "google/cloud/spanner/testing/mock_database_admin_stub.h"
+#include "google/cloud/internal/background_threads_impl.h"
+#include "google/cloud/internal/make_unique.h"
 #include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/mock_async_response_reader.h"
+#include "google/cloud/testing_util/mock_completion_queue.h"
 #include <google/protobuf/text_format.h>
 #include <gmock/gmock.h>
+#include <chrono>
+#include <memory>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -27,16 +34,18 @@ namespace {
 
 using ::google::cloud::spanner_testing::IsProtoEqual;
 using ::google::cloud::spanner_testing::MockDatabaseAdminStub;
+using ::google::cloud::testing_util::MockAsyncResponseReader;
+using ::google::cloud::testing_util::MockCompletionQueue;
 using ::google::protobuf::TextFormat;
 using ::testing::_;
 using ::testing::AtLeast;
 using ::testing::ElementsAre;
-using ::testing::Mock;
 using ::testing::Return;
 namespace gcsa = ::google::spanner::admin::database::v1;
 
 std::shared_ptr<DatabaseAdminConnection> CreateTestingConnection(
-    std::shared_ptr<internal::DatabaseAdminStub> mock) {
+    std::shared_ptr<internal::DatabaseAdminStub> mock,
+    ConnectionOptions const& options = ConnectionOptions()) {
   LimitedErrorCountRetryPolicy retry(/*maximum_failures=*/2);
   ExponentialBackoffPolicy backoff(
       /*initial_delay=*/std::chrono::microseconds(1),
@@ -44,7 +53,66 @@ std::shared_ptr<DatabaseAdminConnection> CreateTestingConnection(
       /*scaling=*/2.0);
   GenericPollingPolicy<LimitedErrorCountRetryPolicy> polling(retry, backoff);
   return internal::MakeDatabaseAdminConnection(
-      std::move(mock), retry.clone(), backoff.clone(), polling.clone());
+      std::move(mock), retry.clone(), backoff.clone(), polling.clone(),
+      options);
+}
+
+// Create a connection that polls long-running operations on @p impl, the test
+// completes each poll with `CompletePoll()`.
+std::shared_ptr<DatabaseAdminConnection> CreatePollingConnection(
+    std::shared_ptr<internal::DatabaseAdminStub> mock,
+    std::shared_ptr<MockCompletionQueue> impl) {
+  return CreateTestingConnection(
+      std::move(mock),
+      ConnectionOptions().DisableBackgroundThreads(CompletionQueue(impl)));
+}
+
+using OperationReader = MockAsyncResponseReader<google::longrunning::Operation>;
+
+// Sets up @p mock to poll "test-operation-name" once for each of @p responses,
+// in order. The returned readers must outlive the polls.
+std::vector<std::unique_ptr<OperationReader>> ExpectPolls(
+    MockDatabaseAdminStub& mock,
+    std::vector<google::longrunning::Operation> const& responses) {
+  ::testing::InSequence sequence;
+  std::vector<std::unique_ptr<OperationReader>> readers;
+  for (auto const& response : responses) {
+    auto reader = google::cloud::internal::make_unique<OperationReader>();
+    auto* r = reader.get();
+    EXPECT_CALL(mock, AsyncGetOperation(_, _, _))
+        .WillOnce([r](grpc::ClientContext&,
+                      google::longrunning::GetOperationRequest const& request,
+                      grpc::CompletionQueue*) {
+          EXPECT_EQ("test-operation-name", request.name());
+          // This is safe. See comments in MockAsyncResponseReader.
+          return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+              google::longrunning::Operation>>(r);
+        });
+    EXPECT_CALL(*r, Finish(_, _, _))
+        .WillOnce([response](google::longrunning::Operation* operation,
+                             grpc::Status* status, void*) {
+          *operation = response;
+          *status = grpc::Status::OK;
+        });
+    readers.push_back(std::move(reader));
+  }
+  return readers;
+}
+
+// Fires the polling timer, then completes the poll it starts.
+void CompletePoll(MockCompletionQueue& impl) {
+  impl.SimulateCompletion(true);  // The timer.
+  impl.SimulateCompletion(true);  // The `AsyncGetOperation()` call.
+}
+
+// Returns a completed operation, named "test-operation-name", with @p response.
+template <typename Response>
+google::longrunning::Operation DoneOperation(Response const& response) {
+  google::longrunning::Operation op;
+  op.set_name("test-operation-name");
+  op.set_done(true);
+  op.mutable_response()->PackFrom(response);
+  return op;
 }
 
 /// @test Verify that successful case works.
@@ -58,23 +126,16 @@ TEST(DatabaseAdminClientTest, CreateDatabaseSuccess) {
         op.set_done(false);
         return make_status_or(op);
       });
-  EXPECT_CALL(*mock, GetOperation(_, _))
-      .WillOnce([](grpc::ClientContext&,
-                   google::longrunning::GetOperationRequest const& r) {
-        EXPECT_EQ("test-operation-name", r.name());
-        google::longrunning::Operation op;
-        op.set_name(r.name());
-        op.set_done(true);
-        gcsa::Database database;
-        database.set_name("test-db");
-        op.mutable_response()->PackFrom(database);
-        return make_status_or(op);
-      });
+  gcsa::Database database;
+  database.set_name("test-db");
+  auto readers = ExpectPolls(*mock, {DoneOperation(database)});
 
-  auto conn = CreateTestingConnection(std::move(mock));
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = CreatePollingConnection(std::move(mock), impl);
   Database dbase("test-project", "test-instance", "test-db");
   auto fut = conn->CreateDatabase({dbase, {}});
-  EXPECT_EQ(std::future_status::ready, fut.wait_for(std::chrono::seconds(10)));
+  CompletePoll(*impl);
+  EXPECT_EQ(std::future_status::ready, fut.wait_for(std::chrono::seconds(0)));
   auto db = fut.get();
   EXPECT_STATUS_OK(db);
 
@@ -217,24 +278,21 @@ TEST(DatabaseAdminClientTest, UpdateDatabaseSuccess) {
             op.set_done(false);
             return make_status_or(op);
           });
-  EXPECT_CALL(*mock, GetOperation(_, _))
-      .WillOnce([](grpc::ClientContext&,
-                   google::longrunning::GetOperationRequest const& r) {
-        EXPECT_EQ("test-operation-name", r.name());
-        google::longrunning::Operation op;
-        op.set_name(r.name());
-        op.set_done(true);
-        gcsa::UpdateDatabaseDdlMetadata metadata;
-        metadata.set_database("test-db");
-        op.mutable_metadata()->PackFrom(metadata);
-        return make_status_or(op);
-      });
-
-  auto conn = CreateTestingConnection(std::move(mock));
+  google::longrunning::Operation done;
+  done.set_name("test-operation-name");
+  done.set_done(true);
+  gcsa::UpdateDatabaseDdlMetadata done_metadata;
+  done_metadata.set_database("test-db");
+  done.mutable_metadata()->PackFrom(done_metadata);
+  auto readers = ExpectPolls(*mock, {done});
+
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = CreatePollingConnection(std::move(mock), impl);
   Database dbase("test-project", "test-instance", "test-db");
   auto fut = conn->UpdateDatabase(
       {dbase, {"ALTER TABLE Albums ADD COLUMN MarketingBudget INT64"}});
-  EXPECT_EQ(std::future_status::ready, fut.wait_for(std::chrono::seconds(10)));
+  CompletePoll(*impl);
+  EXPECT_EQ(std::future_status::ready, fut.wait_for(std::chrono::seconds(0)));
   auto metadata = fut.get();
   EXPECT_STATUS_OK(metadata);
 
@@ -273,21 +331,19 @@ TEST(DatabaseAdminClientTest, CreateDatabaseErrorInPoll) {
         op.set_done(false);
         return make_status_or(std::move(op));
       });
-  EXPECT_CALL(*mock, GetOperation(_, _))
-      .WillOnce([](grpc::ClientContext&,
-                   google::longrunning::GetOperationRequest const& r) {
-        EXPECT_EQ("test-operation-name", r.name());
-        google::longrunning::Operation op;
-        op.set_done(true);
-        op.mutable_error()->set_code(
-            static_cast<int>(grpc::StatusCode::PERMISSION_DENIED));
-        op.mutable_error()->set_message("uh-oh");
-        return op;
-      });
-
-  auto conn = CreateTestingConnection(std::move(mock));
+  google::longrunning::Operation failed;
+  failed.set_done(true);
+  failed.mutable_error()->set_code(
+      static_cast<int>(grpc::StatusCode::PERMISSION_DENIED));
+  failed.mutable_error()->set_message("uh-oh");
+  auto readers = ExpectPolls(*mock, {failed});
+
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = CreatePollingConnection(std::move(mock), impl);
   Database dbase("test-project", "test-instance", "test-db");
-  auto db = conn->CreateDatabase({dbase, {}}).get();
+  auto fut = conn->CreateDatabase({dbase, {}});
+  CompletePoll(*impl);
+  auto db = fut.get();
   EXPECT_EQ(StatusCode::kPermissionDenied, db.status().code());
 }
 
@@ -303,24 +359,20 @@ TEST(DatabaseAdminClientTest, UpdateDatabaseGetOperationError) {
             op.set_done(false);
             return make_status_or(std::move(op));
           });
-  EXPECT_CALL(*mock, GetOperation(_, _))
-      .WillOnce([](grpc::ClientContext&,
-                   google::longrunning::GetOperationRequest const& r) {
-        EXPECT_EQ("test-operation-name", r.name());
-        google::longrunning::Operation op;
-        op.set_done(true);
-        op.mutable_error()->set_code(
-            static_cast<int>(grpc::StatusCode::PERMISSION_DENIED));
-        op.mutable_error()->set_message("uh-oh");
-        return op;
-      });
-
-  auto conn = CreateTestingConnection(std::move(mock));
+  google::longrunning::Operation failed;
+  failed.set_done(true);
+  failed.mutable_error()->set_code(
+      static_cast<int>(grpc::StatusCode::PERMISSION_DENIED));
+  failed.mutable_error()->set_message("uh-oh");
+  auto readers = ExpectPolls(*mock, {failed});
+
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = CreatePollingConnection(std::move(mock), impl);
   Database dbase("test-project", "test-instance", "test-db");
-  auto db =
-      conn->UpdateDatabase(
-              {dbase, {"ALTER TABLE Albums ADD COLUMN MarketingBudget INT64"}})
-          .get();
+  auto fut = conn->UpdateDatabase(
+      {dbase, {"ALTER TABLE Albums ADD COLUMN MarketingBudget INT64"}});
+  CompletePoll(*impl);
+  auto db = fut.get();
   EXPECT_EQ(StatusCode::kPermissionDenied, db.status().code());
 }
 
@@ -417,24 +469,17 @@ TEST(DatabaseAdminClientTest, RestoreDatabaseSuccess) {
         op.set_done(false);
         return make_status_or(op);
       });
-  EXPECT_CALL(*mock, GetOperation(_, _))
-      .WillOnce([](grpc::ClientContext&,
-                   google::longrunning::GetOperationRequest const& r) {
-        EXPECT_EQ("test-operation-name", r.name());
-        google::longrunning::Operation op;
-        op.set_name(r.name());
-        op.set_done(true);
-        gcsa::Database database;
-        database.set_name("test-db");
-        op.mutable_response()->PackFrom(database);
-        return make_status_or(op);
-      });
+  gcsa::Database database;
+  database.set_name("test-db");
+  auto readers = ExpectPolls(*mock, {DoneOperation(database)});
 
-  auto conn = CreateTestingConnection(std::move(mock));
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = CreatePollingConnection(std::move(mock), impl);
   Database dbase("test-project", "test-instance", "test-db");
   Backup backup(Instance("test-project", "test-instance"), "test-backup");
   auto fut = conn->RestoreDatabase({dbase, backup.FullName()});
-  EXPECT_EQ(std::future_status::ready, fut.wait_for(std::chrono::seconds(10)));
+  CompletePoll(*impl);
+  EXPECT_EQ(std::future_status::ready, fut.wait_for(std::chrono::seconds(0)));
   auto db = fut.get();
   EXPECT_STATUS_OK(db);
 
@@ -673,23 +718,16 @@ TEST(DatabaseAdminClientTest, CreateBackupSuccess) {
         op.set_done(false);
         return make_status_or(op);
       });
-  EXPECT_CALL(*mock, GetOperation(_, _))
-      .WillOnce([](grpc::ClientContext&,
-                   google::longrunning::GetOperationRequest const& r) {
-        EXPECT_EQ("test-operation-name", r.name());
-        google::longrunning::Operation op;
-        op.set_name(r.name());
-        op.set_done(true);
-        gcsa::Backup backup;
-        backup.set_name("test-backup");
-        op.mutable_response()->PackFrom(backup);
-        return make_status_or(op);
-      });
+  gcsa::Backup response;
+  response.set_name("test-backup");
+  auto readers = ExpectPolls(*mock, {DoneOperation(response)});
 
-  auto conn = CreateTestingConnection(std::move(mock));
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = CreatePollingConnection(std::move(mock), impl);
   Database dbase("test-project", "test-instance", "test-db");
   auto fut = conn->CreateBackup({dbase, "test-backup", {}});
-  EXPECT_EQ(std::future_status::ready, fut.wait_for(std::chrono::seconds(10)));
+  CompletePoll(*impl);
+  EXPECT_EQ(std::future_status::ready, fut.wait_for(std::chrono::seconds(0)));
   auto backup = fut.get();
   EXPECT_STATUS_OK(backup);
 
@@ -699,11 +737,6 @@ TEST(DatabaseAdminClientTest, CreateBackupSuccess) {
 /// @test Verify cancellation.
 TEST(DatabaseAdminClientTest, CreateBackupCancel) {
   auto mock = std::make_shared<MockDatabaseAdminStub>();
-  // Suppress a false leak.
-  // TODO(#127): After we fix the issue #127, we won't need to use
-  // `AllowLeak()` any more.
-  Mock::AllowLeak(mock.get());
-  promise<void> p;
 
   EXPECT_CALL(*mock, CreateBackup(_, _))
       .WillOnce([](grpc::ClientContext&, gcsa::CreateBackupRequest const&) {
@@ -718,39 +751,72 @@ TEST(DatabaseAdminClientTest, CreateBackupCancel) {
         EXPECT_EQ("test-operation-name", r.name());
         return google::cloud::Status();
       });
-  EXPECT_CALL(*mock, GetOperation(_, _))
-      .WillOnce([&p](grpc::ClientContext&,
-                     google::longrunning::GetOperationRequest const& r) {
-        EXPECT_EQ("test-operation-name", r.name());
-        google::longrunning::Operation op;
-        op.set_name(r.name());
-        op.set_done(false);
-        // wait for `cancel` call in the main thread.
-        p.get_future().get();
-        return make_status_or(op);
-      })
-      .WillOnce([](grpc::ClientContext&,
-                   google::longrunning::GetOperationRequest const& r) {
-        EXPECT_EQ("test-operation-name", r.name());
-        google::longrunning::Operation op;
-        op.set_name(r.name());
-        op.set_done(true);
-        gcsa::Backup backup;
-        backup.set_name("test-backup");
-        op.mutable_response()->PackFrom(backup);
-        return make_status_or(op);
-      });
-
-  auto conn = CreateTestingConnection(std::move(mock));
+  google::longrunning::Operation pending;
+  pending.set_name("test-operation-name");
+  pending.set_done(false);
+  gcsa::Backup response;
+  response.set_name("test-backup");
+  auto readers = ExpectPolls(*mock, {pending, DoneOperation(response)});
+
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = CreatePollingConnection(std::move(mock), impl);
   Database dbase("test-project", "test-instance", "test-db");
   auto fut = conn->CreateBackup({dbase, "test-backup", {}});
+  CompletePoll(*impl);
+  // The server may complete the operation after it is cancelled.
   fut.cancel();
-  p.set_value();
+  CompletePoll(*impl);
   auto backup = fut.get();
   EXPECT_STATUS_OK(backup);
   EXPECT_EQ("test-backup", backup->name());
-  // Explicitly verify the expectations in the mock.
-  EXPECT_TRUE(Mock::VerifyAndClearExpectations(mock.get()));
+}
+
+/// @test Verify that destroying a connection cancels its pending polls, and
+/// only those, when the `CompletionQueue` is shared.
+TEST(DatabaseAdminClientTest, DestructorCancelsPolling) {
+  auto make_mock = [] {
+    auto mock = std::make_shared<MockDatabaseAdminStub>();
+    EXPECT_CALL(*mock, CreateDatabase(_, _))
+        .WillOnce(
+            [](grpc::ClientContext&, gcsa::CreateDatabaseRequest const&) {
+              google::longrunning::Operation op;
+              op.set_name("test-operation-name");
+              op.set_done(false);
+              return make_status_or(op);
+            });
+    EXPECT_CALL(*mock, AsyncGetOperation(_, _, _)).Times(0);
+    return mock;
+  };
+  // Wait much longer than the test between polls, the loops only complete if
+  // they are cancelled.
+  LimitedErrorCountRetryPolicy retry(/*maximum_failures=*/2);
+  ExponentialBackoffPolicy backoff(/*initial_delay=*/std::chrono::hours(1),
+                                   /*maximum_delay=*/std::chrono::hours(1),
+                                   /*scaling=*/2.0);
+  GenericPollingPolicy<LimitedErrorCountRetryPolicy> polling(retry, backoff);
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto options = ConnectionOptions().DisableBackgroundThreads(threads.cq());
+  auto conn1 = internal::MakeDatabaseAdminConnection(
+      make_mock(), retry.clone(), backoff.clone(), polling.clone(), options);
+  auto conn2 = internal::MakeDatabaseAdminConnection(
+      make_mock(), retry.clone(), backoff.clone(), polling.clone(), options);
+
+  Database dbase("test-project", "test-instance", "test-db");
+  auto f1 = conn1->CreateDatabase({dbase, {}});
+  auto f2 = conn2->CreateDatabase({dbase, {}});
+  EXPECT_EQ(std::future_status::timeout,
+            f1.wait_for(std::chrono::milliseconds(10)));
+
+  conn1.reset();
+  ASSERT_EQ(std::future_status::ready, f1.wait_for(std::chrono::seconds(10)));
+  EXPECT_EQ(StatusCode::kCancelled, f1.get().status().code());
+  // The other connection, sharing the `CompletionQueue`, is still polling.
+  EXPECT_EQ(std::future_status::timeout,
+            f2.wait_for(std::chrono::milliseconds(10)));
+
+  conn2.reset();
+  ASSERT_EQ(std::future_status::ready, f2.wait_for(std::chrono::seconds(10)));
+  EXPECT_EQ(StatusCode::kCancelled, f2.get().status().code());
 }
 
 /// @test Verify that a permanent error in CreateBackup is immediately
@@ -14,8 +14,9 @@
 
 #include "google/cloud/spanner/instance_admin_connection.h"
 #include "google/cloud/spanner/instance.h"
-#include "google/cloud/spanner/internal/polling_loop.h"
+#include "google/cloud/spanner/internal/async_polling_loop.h"
 #include "google/cloud/spanner/internal/retry_loop.h"
+#include "google/cloud/background_threads.h"
 #include <chrono>
 
 namespace google {
@@ -54,20 +55,28 @@ class InstanceAdminConnectionImpl : public InstanceAdminConnection {
   InstanceAdminConnectionImpl(std::shared_ptr<internal::InstanceAdminStub> stub,
                               std::unique_ptr<RetryPolicy> retry_policy,
                               std::unique_ptr<BackoffPolicy> backoff_policy,
-                              std::unique_ptr<PollingPolicy> polling_policy)
+                              std::unique_ptr<PollingPolicy> polling_policy,
+                              ConnectionOptions const& options)
       : stub_(std::move(stub)),
         retry_policy_prototype_(std::move(retry_policy)),
         backoff_policy_prototype_(std::move(backoff_policy)),
-        polling_policy_prototype_(std::move(polling_policy)) {}
+        polling_policy_prototype_(std::move(polling_policy)),
+        background_threads_(options.background_threads_factory()()) {}
 
   explicit InstanceAdminConnectionImpl(
-      std::shared_ptr<internal::InstanceAdminStub> stub)
-      : InstanceAdminConnectionImpl(std::move(stub),
-                                    DefaultInstanceAdminRetryPolicy(),
-                                    DefaultInstanceAdminBackoffPolicy(),
-                                    DefaultInstanceAdminPollingPolicy()) {}
-
-  ~InstanceAdminConnectionImpl() override = default;
+      std::shared_ptr<internal::InstanceAdminStub> stub,
+      ConnectionOptions const& options)
+      : InstanceAdminConnectionImpl(
+            std::move(stub), DefaultInstanceAdminRetryPolicy(),
+            DefaultInstanceAdminBackoffPolicy(),
+            DefaultInstanceAdminPollingPolicy(), options) {}
+
+  ~InstanceAdminConnectionImpl() override {
+    // Do not wait for the polling timers of any pending operations, their
+    // futures are satisfied with an error instead. The `CompletionQueue` may
+    // be shared, only the operations of this connection are cancelled.
+    polling_loops_.CancelAll();
+  }
 
   StatusOr<gcsa::Instance> GetInstance(GetInstanceParams gip) override {
     gcsa::GetInstanceRequest request;
@@ -259,41 +268,30 @@ class InstanceAdminConnectionImpl : public InstanceAdminConnection {
  private:
   future<StatusOr<gcsa::Instance>> AwaitCreateOrUpdateInstance(
       google::longrunning::Operation operation) {
-    promise<StatusOr<gcsa::Instance>> pr;
-    auto f = pr.get_future();
-
-    // TODO(#127) - use the (implicit) completion queue to run this loop.
-    std::thread t(
-        [](std::shared_ptr<internal::InstanceAdminStub> stub,
-           google::longrunning::Operation operation,
-           std::unique_ptr<PollingPolicy> polling_policy,
-           google::cloud::promise<StatusOr<gcsa::Instance>> promise,
-           char const* location) mutable {
-          auto result = internal::PollingLoop<
-              internal::PollingLoopResponseExtractor<gcsa::Instance>>(
-              std::move(polling_policy),
-              [stub](grpc::ClientContext& context,
-                     google::longrunning::GetOperationRequest const& request) {
-                return stub->GetOperation(context, request);
+    // Capture the stub, not `this`, the loop may outlive the connection.
+    auto stub = stub_;
+    return internal::AsyncPollingLoop<
+        internal::PollingLoopResponseExtractor<gcsa::Instance>>(
+        background_threads_->cq(), polling_policy_prototype_->clone(),
+        [stub](CompletionQueue& cq,
+               std::unique_ptr<grpc::ClientContext> context,
+               google::longrunning::GetOperationRequest const& request) {
+          return cq.MakeUnaryRpc(
+              [stub](grpc::ClientContext* context,
+                     google::longrunning::GetOperationRequest const& request,
+                     grpc::CompletionQueue* cq) {
+                return stub->AsyncGetOperation(*context, request, cq);
               },
-              std::move(operation), location);
-
-          // Drop our reference to stub; ideally we'd have std::moved into the
-          // lambda. Doing this also prevents a false leak from being reported
-          // when using googlemock.
-          stub.reset();
-          promise.set_value(std::move(result));
+              request, std::move(context));
         },
-        stub_, std::move(operation), polling_policy_prototype_->clone(),
-        std::move(pr), __func__);
-    t.detach();
-
-    return f;
+        std::move(operation), __func__, &polling_loops_);
   }
   std::shared_ptr<internal::InstanceAdminStub> stub_;
   std::unique_ptr<RetryPolicy const> retry_policy_prototype_;
   std::unique_ptr<BackoffPolicy const> backoff_policy_prototype_;
   std::unique_ptr<PollingPolicy const> polling_policy_prototype_;
+  std::unique_ptr<BackgroundThreads> background_threads_;
+  internal::AsyncPollingLoops polling_loops_;
 };
 }  // namespace
 
@@ -312,25 +310,27 @@ std::shared_ptr<InstanceAdminConnection> MakeInstanceAdminConnection(
   return internal::MakeInstanceAdminConnection(
       internal::CreateDefaultInstanceAdminStub(options),
       std::move(retry_policy), std::move(backoff_policy),
-      std::move(polling_policy));
+      std::move(polling_policy), options);
 }
 
 namespace internal {
 
 std::shared_ptr<InstanceAdminConnection> MakeInstanceAdminConnection(
     std::shared_ptr<internal::InstanceAdminStub> base_stub,
-    ConnectionOptions const&) {
-  return std::make_shared<InstanceAdminConnectionImpl>(std::move(base_stub));
+    ConnectionOptions const& options) {
+  return std::make_shared<InstanceAdminConnectionImpl>(std::move(base_stub),
+                                                       options);
 }
 
 std::shared_ptr<InstanceAdminConnection> MakeInstanceAdminConnection(
     std::shared_ptr<internal::InstanceAdminStub> base_stub,
     std::unique_ptr<RetryPolicy> retry_policy,
     std::unique_ptr<BackoffPolicy> backoff_policy,
-    std::unique_ptr<PollingPolicy> polling_policy) {
+    std::unique_ptr<PollingPolicy> polling_policy,
+    ConnectionOptions const& options) {
   return std::make_shared<InstanceAdminConnectionImpl>(
       std::move(base_stub), std::move(retry_policy), std::move(backoff_policy),
-      std::move(polling_policy));
+      std::move(polling_policy), options);
 }
 
 }  // namespace internal
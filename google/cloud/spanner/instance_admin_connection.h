@@ -247,7 +247,8 @@ std::shared_ptr<InstanceAdminConnection> MakeInstanceAdminConnection(
     std::shared_ptr<internal::InstanceAdminStub> base_stub,
     std::unique_ptr<RetryPolicy> retry_policy,
     std::unique_ptr<BackoffPolicy> backoff_policy,
-    std::unique_ptr<PollingPolicy> polling_policy);
+    std::unique_ptr<PollingPolicy> polling_policy,
+    ConnectionOptions const& options = ConnectionOptions());
 
 }  // namespace internal
 
@@ -16,9 +16,15 @@
 #include "google/cloud/spanner/create_instance_request_builder.h"
 #include "google/cloud/spanner/testing/matchers.h"
 #include "google/cloud/spanner/testing/mock_instance_admin_stub.h"
+#include "google/cloud/internal/background_threads_impl.h"
+#include "google/cloud/internal/make_unique.h"
 #include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/mock_async_response_reader.h"
+#include "google/cloud/testing_util/mock_completion_queue.h"
 #include <google/protobuf/text_format.h>
 #include <gmock/gmock.h>
+#include <chrono>
+#include <memory>
 
 namespace google {
 namespace cloud {
@@ -27,6 +33,8 @@ inline namespace SPANNER_CLIENT_NS {
 namespace {
 
 using ::google::cloud::spanner_testing::IsProtoEqual;
+using ::google::cloud::testing_util::MockAsyncResponseReader;
+using ::google::cloud::testing_util::MockCompletionQueue;
 using ::google::protobuf::TextFormat;
 using ::testing::_;
 using ::testing::AtLeast;
@@ -41,7 +49,8 @@ namespace giam = ::google::iam::v1;
 // Other tests can use this method or just call `MakeInstanceAdminConnection()`
 // directly.
 std::shared_ptr<InstanceAdminConnection> MakeLimitedRetryConnection(
-    std::shared_ptr<spanner_testing::MockInstanceAdminStub> mock) {
+    std::shared_ptr<spanner_testing::MockInstanceAdminStub> mock,
+    ConnectionOptions const& options = ConnectionOptions()) {
   LimitedErrorCountRetryPolicy retry(/*maximum_failures=*/2);
   ExponentialBackoffPolicy backoff(
       /*initial_delay=*/std::chrono::microseconds(1),
@@ -49,7 +58,52 @@ std::shared_ptr<InstanceAdminConnection> MakeLimitedRetryConnection(
       /*scaling=*/2.0);
   GenericPollingPolicy<LimitedErrorCountRetryPolicy> polling(retry, backoff);
   return internal::MakeInstanceAdminConnection(
-      std::move(mock), retry.clone(), backoff.clone(), polling.clone());
+      std::move(mock), retry.clone(), backoff.clone(), polling.clone(),
+      options);
+}
+
+using OperationReader = MockAsyncResponseReader<google::longrunning::Operation>;
+
+// Sets up @p mock to poll "test-operation-name" once, returning @p response.
+// The returned reader must outlive the poll.
+std::unique_ptr<OperationReader> ExpectPoll(
+    spanner_testing::MockInstanceAdminStub& mock,
+    google::longrunning::Operation const& response) {
+  auto reader = google::cloud::internal::make_unique<OperationReader>();
+  auto* r = reader.get();
+  EXPECT_CALL(mock, AsyncGetOperation(_, _, _))
+      .WillOnce([r](grpc::ClientContext&,
+                    google::longrunning::GetOperationRequest const& request,
+                    grpc::CompletionQueue*) {
+        EXPECT_EQ("test-operation-name", request.name());
+        // This is safe. See comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            google::longrunning::Operation>>(r);
+      });
+  EXPECT_CALL(*r, Finish(_, _, _))
+      .WillOnce([response](google::longrunning::Operation* operation,
+                           grpc::Status* status, void*) {
+        *operation = response;
+        *status = grpc::Status::OK;
+      });
+  return reader;
+}
+
+// Fires the polling timer, then completes the poll it starts.
+void CompletePoll(MockCompletionQueue& impl) {
+  impl.SimulateCompletion(true);  // The timer.
+  impl.SimulateCompletion(true);  // The `AsyncGetOperation()` call.
+}
+
+// Returns a completed operation, named "test-operation-name", for @p name.
+google::longrunning::Operation DoneOperation(std::string const& name) {
+  google::longrunning::Operation op;
+  op.set_name("test-operation-name");
+  op.set_done(true);
+  gcsa::Instance instance;
+  instance.set_name(name);
+  op.mutable_response()->PackFrom(instance);
+  return op;
 }
 
 TEST(InstanceAdminConnectionTest, GetInstanceSuccess) {
@@ -127,21 +181,12 @@ TEST(InstanceAdminClientTest, CreateInstanceSuccess) {
         op.set_done(false);
         return make_status_or(op);
       });
-  EXPECT_CALL(*mock, GetOperation(_, _))
-      .WillOnce(
-          [&expected_name](grpc::ClientContext&,
-                           google::longrunning::GetOperationRequest const& r) {
-            EXPECT_EQ("test-operation-name", r.name());
-            google::longrunning::Operation op;
-            op.set_name(r.name());
-            op.set_done(true);
-            gcsa::Instance instance;
-            instance.set_name(expected_name);
-            op.mutable_response()->PackFrom(instance);
-            return make_status_or(op);
-          });
+  auto reader = ExpectPoll(*mock, DoneOperation(expected_name));
 
-  auto conn = MakeLimitedRetryConnection(std::move(mock));
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = MakeLimitedRetryConnection(
+      std::move(mock),
+      ConnectionOptions().DisableBackgroundThreads(CompletionQueue(impl)));
   Instance in("test-project", "test-instance");
   auto fut = conn->CreateInstance(
       {CreateInstanceRequestBuilder(in, "test-instance-config")
@@ -149,7 +194,8 @@ TEST(InstanceAdminClientTest, CreateInstanceSuccess) {
            .SetNodeCount(1)
            .SetLabels({{"key", "value"}})
            .Build()});
-  EXPECT_EQ(std::future_status::ready, fut.wait_for(std::chrono::seconds(10)));
+  CompletePoll(*impl);
+  EXPECT_EQ(std::future_status::ready, fut.wait_for(std::chrono::seconds(0)));
   auto instance = fut.get();
   EXPECT_STATUS_OK(instance);
 
@@ -192,31 +238,72 @@ TEST(InstanceAdminClientTest, UpdateInstanceSuccess) {
         op.set_done(false);
         return make_status_or(op);
       });
-  EXPECT_CALL(*mock, GetOperation(_, _))
-      .WillOnce(
-          [&expected_name](grpc::ClientContext&,
-                           google::longrunning::GetOperationRequest const& r) {
-            EXPECT_EQ("test-operation-name", r.name());
-            google::longrunning::Operation op;
-            op.set_name(r.name());
-            op.set_done(true);
-            gcsa::Instance instance;
-            instance.set_name(expected_name);
-            op.mutable_response()->PackFrom(instance);
-            return make_status_or(op);
-          });
+  auto reader = ExpectPoll(*mock, DoneOperation(expected_name));
 
-  auto conn = MakeLimitedRetryConnection(std::move(mock));
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = MakeLimitedRetryConnection(
+      std::move(mock),
+      ConnectionOptions().DisableBackgroundThreads(CompletionQueue(impl)));
   gcsa::UpdateInstanceRequest req;
   req.mutable_instance()->set_name(expected_name);
   auto fut = conn->UpdateInstance({req});
-  EXPECT_EQ(std::future_status::ready, fut.wait_for(std::chrono::seconds(10)));
+  CompletePoll(*impl);
+  EXPECT_EQ(std::future_status::ready, fut.wait_for(std::chrono::seconds(0)));
   auto instance = fut.get();
   EXPECT_STATUS_OK(instance);
 
   EXPECT_EQ(expected_name, instance->name());
 }
 
+/// @test Verify that destroying a connection cancels its pending polls, and
+/// only those, when the `CompletionQueue` is shared.
+TEST(InstanceAdminClientTest, DestructorCancelsPolling) {
+  auto make_mock = [] {
+    auto mock = std::make_shared<spanner_testing::MockInstanceAdminStub>();
+    EXPECT_CALL(*mock, UpdateInstance(_, _))
+        .WillOnce([](grpc::ClientContext&, gcsa::UpdateInstanceRequest const&) {
+          google::longrunning::Operation op;
+          op.set_name("test-operation-name");
+          op.set_done(false);
+          return make_status_or(op);
+        });
+    EXPECT_CALL(*mock, AsyncGetOperation(_, _, _)).Times(0);
+    return mock;
+  };
+  // Wait much longer than the test between polls, the loops only complete if
+  // they are cancelled.
+  LimitedErrorCountRetryPolicy retry(/*maximum_failures=*/2);
+  ExponentialBackoffPolicy backoff(/*initial_delay=*/std::chrono::hours(1),
+                                   /*maximum_delay=*/std::chrono::hours(1),
+                                   /*scaling=*/2.0);
+  GenericPollingPolicy<LimitedErrorCountRetryPolicy> polling(retry, backoff);
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto options = ConnectionOptions().DisableBackgroundThreads(threads.cq());
+  auto conn1 = internal::MakeInstanceAdminConnection(
+      make_mock(), retry.clone(), backoff.clone(), polling.clone(), options);
+  auto conn2 = internal::MakeInstanceAdminConnection(
+      make_mock(), retry.clone(), backoff.clone(), polling.clone(), options);
+
+  gcsa::UpdateInstanceRequest req;
+  req.mutable_instance()->set_name(
+      "projects/test-project/instances/test-instance");
+  auto f1 = conn1->UpdateInstance({req});
+  auto f2 = conn2->UpdateInstance({req});
+  EXPECT_EQ(std::future_status::timeout,
+            f1.wait_for(std::chrono::milliseconds(10)));
+
+  conn1.reset();
+  ASSERT_EQ(std::future_status::ready, f1.wait_for(std::chrono::seconds(10)));
+  EXPECT_EQ(StatusCode::kCancelled, f1.get().status().code());
+  // The other connection, sharing the `CompletionQueue`, is still polling.
+  EXPECT_EQ(std::future_status::timeout,
+            f2.wait_for(std::chrono::milliseconds(10)));
+
+  conn2.reset();
+  ASSERT_EQ(std::future_status::ready, f2.wait_for(std::chrono::seconds(10)));
+  EXPECT_EQ(StatusCode::kCancelled, f2.get().status().code());
+}
+
 TEST(InstanceAdminClientTest, UpdateInstancePermanentFailure) {
   auto mock = std::make_shared<spanner_testing::MockInstanceAdminStub>();
 
@@ -0,0 +1,147 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/async_partial_result_set_reader.h"
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+AsyncPartialResultSetReader::AsyncPartialResultSetReader(
+    StartFunction const& start, std::size_t buffer_limit)
+    : state_(std::make_shared<State>(buffer_limit)),
+      ready_(state_->on_ready.get_future()) {
+  auto state = state_;
+  cancel_ = start(
+      [state](google::spanner::v1::PartialResultSet r) {
+        return OnReadImpl(*state, std::move(r));
+      },
+      [state](Status s) { OnFinishImpl(*state, std::move(s)); });
+}
+
+AsyncPartialResultSetReader::~AsyncPartialResultSetReader() {
+  std::unique_lock<std::mutex> lk(state_->mu);
+  auto const finished = state_->status.has_value();
+  lk.unlock();
+  // Do not wait for the RPC, its callbacks only touch `state_`.
+  if (!finished) TryCancel();
+}
+
+future<bool> AsyncPartialResultSetReader::Ready() { return std::move(ready_); }
+
+void AsyncPartialResultSetReader::TryCancel() {
+  std::unique_lock<std::mutex> lk(state_->mu);
+  state_->cancelled = true;
+  state_->responses.clear();
+  state_->buffered_bytes = 0;
+  // The RPC may be waiting for the buffered responses to be consumed.
+  auto next = std::move(state_->next);
+  state_->next.reset();
+  lk.unlock();
+  if (next) next->set_value(false);
+  cancel_();
+}
+
+optional<google::spanner::v1::PartialResultSet>
+AsyncPartialResultSetReader::Read() {
+  google::spanner::v1::PartialResultSet result;
+  if (!ReadInto(&result)) return {};
+  return result;
+}
+
+bool AsyncPartialResultSetReader::ReadInto(
+    google::spanner::v1::PartialResultSet* result) {
+  std::unique_lock<std::mutex> lk(state_->mu);
+  state_->cv.wait(lk, [this] {
+    return !state_->responses.empty() || state_->status.has_value();
+  });
+  if (state_->responses.empty()) return false;
+  auto& front = state_->responses.front();
+  if (state_->buffer_limit > 0) {
+    // The size was cached by the `ByteSizeLong()` call in `OnReadImpl()`.
+    state_->buffered_bytes -= static_cast<std::size_t>(front.GetCachedSize());
+  }
+  result->Swap(&front);
+  state_->responses.pop_front();
+  if (!state_->next || !HasRoom(*state_)) return true;
+  auto next = *std::move(state_->next);
+  state_->next.reset();
+  lk.unlock();
+  next.set_value(true);
+  return true;
+}
+
+future<void> AsyncPartialResultSetReader::WhenReadable() {
+  std::unique_lock<std::mutex> lk(state_->mu);
+  if (!state_->responses.empty() || state_->status.has_value()) {
+    return make_ready_future();
+  }
+  state_->readable = promise<void>();
+  return state_->readable->get_future();
+}
+
+Status AsyncPartialResultSetReader::Finish() {
+  std::unique_lock<std::mutex> lk(state_->mu);
+  state_->cv.wait(lk, [this] { return state_->status.has_value(); });
+  return *state_->status;
+}
+
+future<bool> AsyncPartialResultSetReader::OnReadImpl(
+    State& state, google::spanner::v1::PartialResultSet r) {
+  std::unique_lock<std::mutex> lk(state.mu);
+  if (state.cancelled) return make_ready_future(false);
+  state.responses.push_back(std::move(r));
+  // A zero limit buffers a single response, there is no need to measure it.
+  if (state.buffer_limit > 0) {
+    state.buffered_bytes += state.responses.back().ByteSizeLong();
+  }
+  future<bool> consumed;
+  if (HasRoom(state)) {
+    // Keep prefetching, the reader catches up in its own time.
+    consumed = make_ready_future(true);
+  } else {
+    state.next = promise<bool>();
+    consumed = state.next->get_future();
+  }
+  auto const was_ready = state.ready;
+  state.ready = true;
+  auto readable = std::move(state.readable);
+  state.readable.reset();
+  lk.unlock();
+  state.cv.notify_all();
+  if (!was_ready) state.on_ready.set_value(true);
+  if (readable) readable->set_value();
+  return consumed;
+}
+
+void AsyncPartialResultSetReader::OnFinishImpl(State& state, Status s) {
+  std::unique_lock<std::mutex> lk(state.mu);
+  state.status = std::move(s);
+  auto const was_ready = state.ready;
+  state.ready = true;
+  auto readable = std::move(state.readable);
+  state.readable.reset();
+  lk.unlock();
+  state.cv.notify_all();
+  if (!was_ready) state.on_ready.set_value(false);
+  if (readable) readable->set_value();
+}
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,122 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_ASYNC_PARTIAL_RESULT_SET_READER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_ASYNC_PARTIAL_RESULT_SET_READER_H
+
+#include "google/cloud/spanner/internal/partial_result_set_reader.h"
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/future.h"
+#include "google/cloud/optional.h"
+#include "google/cloud/status.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+/**
+ * A `PartialResultSetReader` for a streaming RPC driven by a `CompletionQueue`.
+ *
+ * The RPC delivers each response to the `OnRead` callback, and its final
+ * status to the `OnFinish` callback, on a thread running the
+ * `CompletionQueue`. `ReadInto()` and `Finish()` block until those arrive, so
+ * they must not be called from a `CompletionQueue` thread; use `Ready()` to
+ * find out, without blocking, when the stream has produced something.
+ *
+ * The RPC keeps reading responses, on the `CompletionQueue`, while the reader
+ * buffers fewer than `buffer_limit` bytes of them. Once it reaches the limit,
+ * the RPC waits for the reader to consume some responses, and gRPC flow
+ * control pushes back on the server. A limit of 0 buffers a single response,
+ * and a single response is buffered even if it exceeds the limit.
+ */
+class AsyncPartialResultSetReader : public PartialResultSetReader {
+ public:
+  using OnRead =
+      std::function<future<bool>(google::spanner::v1::PartialResultSet)>;
+  using OnFinish = std::function<void(Status)>;
+
+  /**
+   * Starts the RPC, e.g., with `CompletionQueue::MakeStreamingReadRpc()`, and
+   * returns a function that cancels it.
+   */
+  using StartFunction =
+      std::function<std::function<void()>(OnRead, OnFinish)>;
+
+  explicit AsyncPartialResultSetReader(StartFunction const& start,
+                                       std::size_t buffer_limit = 0);
+  ~AsyncPartialResultSetReader() override;
+
+  /**
+   * Returns a future satisfied with `true` when the first response arrives, or
+   * with `false` if the stream finishes without one. In either case the next
+   * `ReadInto()` and `Finish()` calls do not block. May be called at most once.
+   */
+  future<bool> Ready();
+
+  void TryCancel() override;
+  optional<google::spanner::v1::PartialResultSet> Read() override;
+  Status Finish() override;
+  bool ReadInto(google::spanner::v1::PartialResultSet* result) override;
+  /// There can be only one pending `WhenReadable()` future at a time.
+  future<void> WhenReadable() override;
+
+ private:
+  // The state shared with the RPC callbacks, which may outlive the reader.
+  struct State {
+    explicit State(std::size_t limit) : buffer_limit(limit) {}
+
+    std::mutex mu;
+    std::condition_variable cv;
+    std::size_t const buffer_limit;
+    std::deque<google::spanner::v1::PartialResultSet> responses;
+    std::size_t buffered_bytes = 0;
+    // Set while the RPC waits for the buffer to drain, `false` cancels it.
+    optional<promise<bool>> next;
+    optional<Status> status;
+    bool cancelled = false;
+    bool ready = false;
+    promise<bool> on_ready;
+    // Set while `WhenReadable()` waits for a response or the status.
+    optional<promise<void>> readable;
+  };
+
+  // The RPC may read another response, the lock on `mu` must be held.
+  static bool HasRoom(State const& state) {
+    return state.responses.empty() ||
+           state.buffered_bytes < state.buffer_limit;
+  }
+  static future<bool> OnReadImpl(State& state,
+                                 google::spanner::v1::PartialResultSet r);
+  static void OnFinishImpl(State& state, Status s);
+
+  std::shared_ptr<State> state_;
+  future<bool> ready_;
+  std::function<void()> cancel_;
+};
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_ASYNC_PARTIAL_RESULT_SET_READER_H
@@ -0,0 +1,237 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/async_partial_result_set_reader.h"
+#include "google/cloud/spanner/testing/matchers.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include <gmock/gmock.h>
+#include <chrono>
+#include <thread>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+namespace spanner_proto = ::google::spanner::v1;
+
+using ::google::cloud::spanner_testing::IsProtoEqual;
+
+/// Captures the callbacks of the RPC, so the test can play its part.
+struct FakeRpc {
+  AsyncPartialResultSetReader::OnRead on_read;
+  AsyncPartialResultSetReader::OnFinish on_finish;
+  int cancel_count = 0;
+
+  AsyncPartialResultSetReader::StartFunction Start() {
+    return [this](AsyncPartialResultSetReader::OnRead r,
+                  AsyncPartialResultSetReader::OnFinish f) {
+      on_read = std::move(r);
+      on_finish = std::move(f);
+      return [this] { ++cancel_count; };
+    };
+  }
+};
+
+spanner_proto::PartialResultSet MakeResponse(std::string const& token) {
+  spanner_proto::PartialResultSet response;
+  response.set_resume_token(token);
+  return response;
+}
+
+template <typename T>
+bool IsReady(future<T>& f) {
+  return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+TEST(AsyncPartialResultSetReader, Success) {
+  FakeRpc rpc;
+  AsyncPartialResultSetReader reader(rpc.Start());
+  auto ready = reader.Ready();
+  EXPECT_FALSE(IsReady(ready));
+
+  auto consumed = rpc.on_read(MakeResponse("test-token-0"));
+  ASSERT_TRUE(IsReady(ready));
+  EXPECT_TRUE(ready.get());
+  EXPECT_FALSE(IsReady(consumed));
+
+  spanner_proto::PartialResultSet response;
+  ASSERT_TRUE(reader.ReadInto(&response));
+  EXPECT_THAT(response, IsProtoEqual(MakeResponse("test-token-0")));
+  ASSERT_TRUE(IsReady(consumed));
+  EXPECT_TRUE(consumed.get());
+
+  rpc.on_finish(Status());
+  EXPECT_FALSE(reader.Read().has_value());
+  EXPECT_STATUS_OK(reader.Finish());
+  EXPECT_EQ(0, rpc.cancel_count);
+}
+
+TEST(AsyncPartialResultSetReader, ReadBlocks) {
+  FakeRpc rpc;
+  AsyncPartialResultSetReader reader(rpc.Start());
+
+  // Play the RPC from a separate thread, as a `CompletionQueue` would.
+  std::thread producer([&rpc] {
+    for (auto const* token : {"test-token-0", "test-token-1"}) {
+      EXPECT_TRUE(rpc.on_read(MakeResponse(token)).get());
+    }
+    rpc.on_finish(Status(StatusCode::kUnavailable, "try-again"));
+  });
+
+  auto r0 = reader.Read();
+  ASSERT_TRUE(r0.has_value());
+  EXPECT_THAT(*r0, IsProtoEqual(MakeResponse("test-token-0")));
+  auto r1 = reader.Read();
+  ASSERT_TRUE(r1.has_value());
+  EXPECT_THAT(*r1, IsProtoEqual(MakeResponse("test-token-1")));
+  EXPECT_FALSE(reader.Read().has_value());
+  EXPECT_EQ(StatusCode::kUnavailable, reader.Finish().code());
+  producer.join();
+}
+
+TEST(AsyncPartialResultSetReader, PrefetchUpToLimit) {
+  auto const size = MakeResponse("test-token-0").ByteSizeLong();
+  FakeRpc rpc;
+  AsyncPartialResultSetReader reader(rpc.Start(), 2 * size);
+
+  // The RPC keeps reading until the buffer reaches the limit.
+  auto c0 = rpc.on_read(MakeResponse("test-token-0"));
+  ASSERT_TRUE(IsReady(c0));
+  EXPECT_TRUE(c0.get());
+  auto c1 = rpc.on_read(MakeResponse("test-token-1"));
+  EXPECT_FALSE(IsReady(c1));
+
+  // Consuming a response makes room for the next one.
+  auto r0 = reader.Read();
+  ASSERT_TRUE(r0.has_value());
+  EXPECT_THAT(*r0, IsProtoEqual(MakeResponse("test-token-0")));
+  ASSERT_TRUE(IsReady(c1));
+  EXPECT_TRUE(c1.get());
+
+  rpc.on_finish(Status());
+  auto r1 = reader.Read();
+  ASSERT_TRUE(r1.has_value());
+  EXPECT_THAT(*r1, IsProtoEqual(MakeResponse("test-token-1")));
+  EXPECT_FALSE(reader.Read().has_value());
+  EXPECT_STATUS_OK(reader.Finish());
+}
+
+TEST(AsyncPartialResultSetReader, PrefetchOversizedResponse) {
+  FakeRpc rpc;
+  AsyncPartialResultSetReader reader(rpc.Start(), 1);
+
+  // A response larger than the limit is still buffered.
+  auto c0 = rpc.on_read(MakeResponse("test-token-0"));
+  EXPECT_FALSE(IsReady(c0));
+  auto r0 = reader.Read();
+  ASSERT_TRUE(r0.has_value());
+  EXPECT_THAT(*r0, IsProtoEqual(MakeResponse("test-token-0")));
+  ASSERT_TRUE(IsReady(c0));
+  EXPECT_TRUE(c0.get());
+}
+
+TEST(AsyncPartialResultSetReader, CancelPrefetched) {
+  auto const size = MakeResponse("test-token-0").ByteSizeLong();
+  FakeRpc rpc;
+  AsyncPartialResultSetReader reader(rpc.Start(), 2 * size);
+  EXPECT_TRUE(rpc.on_read(MakeResponse("test-token-0")).get());
+  auto c1 = rpc.on_read(MakeResponse("test-token-1"));
+  EXPECT_FALSE(IsReady(c1));
+
+  reader.TryCancel();
+  EXPECT_EQ(1, rpc.cancel_count);
+  ASSERT_TRUE(IsReady(c1));
+  EXPECT_FALSE(c1.get());
+
+  // The prefetched responses are discarded.
+  rpc.on_finish(Status(StatusCode::kCancelled, "cancelled"));
+  EXPECT_FALSE(reader.Read().has_value());
+  EXPECT_EQ(StatusCode::kCancelled, reader.Finish().code());
+}
+
+TEST(AsyncPartialResultSetReader, WhenReadable) {
+  FakeRpc rpc;
+  AsyncPartialResultSetReader reader(rpc.Start());
+  auto readable = reader.WhenReadable();
+  EXPECT_FALSE(IsReady(readable));
+  auto consumed = rpc.on_read(MakeResponse("test-token-0"));
+  EXPECT_TRUE(IsReady(readable));
+
+  // Already readable, until the response is consumed.
+  readable = reader.WhenReadable();
+  EXPECT_TRUE(IsReady(readable));
+  EXPECT_TRUE(reader.Read().has_value());
+  readable = reader.WhenReadable();
+  EXPECT_FALSE(IsReady(readable));
+
+  // The end of the stream is readable too.
+  rpc.on_finish(Status());
+  EXPECT_TRUE(IsReady(readable));
+  EXPECT_FALSE(reader.Read().has_value());
+  EXPECT_STATUS_OK(reader.Finish());
+}
+
+TEST(AsyncPartialResultSetReader, FinishBeforeResponse) {
+  FakeRpc rpc;
+  AsyncPartialResultSetReader reader(rpc.Start());
+  auto ready = reader.Ready();
+  rpc.on_finish(Status(StatusCode::kPermissionDenied, "uh-oh"));
+  ASSERT_TRUE(IsReady(ready));
+  EXPECT_FALSE(ready.get());
+  EXPECT_FALSE(reader.Read().has_value());
+  EXPECT_EQ(StatusCode::kPermissionDenied, reader.Finish().code());
+}
+
+TEST(AsyncPartialResultSetReader, CancelPending) {
+  FakeRpc rpc;
+  AsyncPartialResultSetReader reader(rpc.Start());
+  auto consumed = rpc.on_read(MakeResponse("test-token-0"));
+  reader.TryCancel();
+  EXPECT_EQ(1, rpc.cancel_count);
+  ASSERT_TRUE(IsReady(consumed));
+  EXPECT_FALSE(consumed.get());
+
+  // Responses in flight are discarded.
+  auto discarded = rpc.on_read(MakeResponse("test-token-1"));
+  ASSERT_TRUE(IsReady(discarded));
+  EXPECT_FALSE(discarded.get());
+
+  rpc.on_finish(Status(StatusCode::kCancelled, "cancelled"));
+  EXPECT_FALSE(reader.Read().has_value());
+  EXPECT_EQ(StatusCode::kCancelled, reader.Finish().code());
+}
+
+TEST(AsyncPartialResultSetReader, DestructorCancels) {
+  FakeRpc rpc;
+  future<bool> consumed;
+  {
+    AsyncPartialResultSetReader reader(rpc.Start());
+    consumed = rpc.on_read(MakeResponse("test-token-0"));
+  }
+  EXPECT_EQ(1, rpc.cancel_count);
+  ASSERT_TRUE(IsReady(consumed));
+  EXPECT_FALSE(consumed.get());
+  // The callbacks remain usable after the reader is gone.
+  rpc.on_finish(Status(StatusCode::kCancelled, "cancelled"));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,50 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/async_polling_loop.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+void AsyncPollingLoops::Add(std::weak_ptr<Loop> loop) {
+  std::lock_guard<std::mutex> lk(mu_);
+  // Forget the loops that completed, so a long-lived owner does not grow.
+  loops_.erase(std::remove_if(loops_.begin(), loops_.end(),
+                              [](std::weak_ptr<Loop> const& l) {
+                                return l.expired();
+                              }),
+               loops_.end());
+  loops_.push_back(std::move(loop));
+}
+
+void AsyncPollingLoops::CancelAll() {
+  std::vector<std::weak_ptr<Loop>> loops;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    loops.swap(loops_);
+  }
+  for (auto& l : loops) {
+    if (auto loop = l.lock()) loop->Cancel();
+  }
+}
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
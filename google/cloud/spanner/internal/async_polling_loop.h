@@ -0,0 +1,267 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_ASYNC_POLLING_LOOP_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_ASYNC_POLLING_LOOP_H
+
+#include "google/cloud/spanner/internal/polling_loop.h"
+#include "google/cloud/spanner/polling_policy.h"
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/completion_queue.h"
+#include "google/cloud/future.h"
+#include "google/cloud/grpc_error_delegate.h"
+#include "google/cloud/internal/invoke_result.h"
+#include "google/cloud/internal/make_unique.h"
+#include "google/cloud/status_or.h"
+#include <google/longrunning/operations.pb.h>
+#include <grpcpp/grpcpp.h>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+/**
+ * The `AsyncPollingLoop()` calls started on behalf of one owner.
+ *
+ * `CompletionQueue::CancelAll()` cancels every operation on a, possibly shared,
+ * `CompletionQueue`. Instead, an owner (e.g. an admin connection) passes this
+ * object to each `AsyncPollingLoop()` it starts, and cancels only those loops
+ * when it is destroyed. The futures of the cancelled loops are satisfied with
+ * an error.
+ */
+class AsyncPollingLoops {
+ public:
+  /// The interface used to cancel a single loop.
+  class Loop {
+   public:
+    virtual ~Loop() = default;
+    virtual void Cancel() = 0;
+  };
+
+  /// Tracks @p loop until it completes, or until `CancelAll()` is called.
+  void Add(std::weak_ptr<Loop> loop);
+
+  /// Cancels the pending timer, or poll, of each loop that has not completed.
+  void CancelAll();
+
+ private:
+  std::mutex mu_;
+  std::vector<std::weak_ptr<Loop>> loops_;
+};
+
+/**
+ * The state of a single `AsyncPollingLoop()` call.
+ *
+ * Each poll, and each timer, holds a reference to this object, so it lives
+ * until the loop completes.
+ */
+template <typename ValueExtractor, typename Functor>
+class AsyncPollingLoopImpl
+    : public AsyncPollingLoops::Loop,
+      public std::enable_shared_from_this<
+          AsyncPollingLoopImpl<ValueExtractor, Functor>> {
+ public:
+  using ReturnType = typename ValueExtractor::ReturnType;
+
+  AsyncPollingLoopImpl(CompletionQueue cq,
+                       std::unique_ptr<PollingPolicy> polling_policy,
+                       Functor functor,
+                       google::longrunning::Operation operation,
+                       char const* location)
+      : cq_(std::move(cq)),
+        polling_policy_(std::move(polling_policy)),
+        functor_(std::move(functor)),
+        operation_(std::move(operation)),
+        location_(location) {}
+
+  future<ReturnType> Start() {
+    auto f = result_.get_future();
+    Wait();
+    return f;
+  }
+
+  void Cancel() override {
+    std::unique_lock<std::mutex> lk(mu_);
+    cancelled_ = true;
+    auto pending = std::move(pending_);
+    lk.unlock();
+    // The cancelled timer, or poll, fails, and that ends the loop.
+    if (pending.valid()) pending.cancel();
+  }
+
+ private:
+  void Wait() {
+    if (operation_.done()) return SetResult();
+    if (IsCancelled()) return SetCancelled();
+    auto self = this->shared_from_this();
+    auto const sequence = ++sequence_;
+    Track(sequence,
+          cq_.MakeRelativeTimer(polling_policy_->WaitPeriod())
+              .then([self](future<StatusOr<
+                               std::chrono::system_clock::time_point>> f) {
+                self->OnTimer(f.get().status());
+              }));
+  }
+
+  void OnTimer(Status const& timer_status) {
+    // `Cancel()` also cancels the timer, report that as a cancelled loop.
+    if (IsCancelled()) return SetCancelled();
+    // Otherwise the timer fails only if it is cancelled, e.g., during shutdown.
+    if (!timer_status.ok()) return result_.set_value(timer_status);
+    google::longrunning::GetOperationRequest poll_request;
+    poll_request.set_name(operation_.name());
+    auto self = this->shared_from_this();
+    auto const sequence = ++sequence_;
+    Track(sequence,
+          functor_(cq_,
+                   google::cloud::internal::make_unique<grpc::ClientContext>(),
+                   poll_request)
+              .then([self](future<StatusOr<google::longrunning::Operation>> f) {
+                self->OnPoll(f.get());
+              }));
+  }
+
+  // Saves the future of the pending timer, or poll, so `Cancel()` can cancel
+  // it. The next step may start (and be tracked) before this is called, the
+  // sequence number keeps the latest step.
+  void Track(std::uint64_t sequence, future<void> pending) {
+    std::unique_lock<std::mutex> lk(mu_);
+    if (cancelled_) {
+      lk.unlock();
+      pending.cancel();
+      return;
+    }
+    if (sequence < tracked_sequence_) return;
+    tracked_sequence_ = sequence;
+    pending_ = std::move(pending);
+  }
+
+  bool IsCancelled() {
+    std::lock_guard<std::mutex> lk(mu_);
+    return cancelled_;
+  }
+
+  void SetCancelled() {
+    result_.set_value(Status(StatusCode::kCancelled,
+                             std::string(location_) +
+                                 "() polling loop cancelled, name=" +
+                                 operation_.name()));
+  }
+
+  void OnPoll(StatusOr<google::longrunning::Operation> update) {
+    if (update && update->done()) {
+      // Before updating the polling policy make sure we do not discard a
+      // successful result that completes the request.
+      using std::swap;
+      swap(*update, operation_);
+      return SetResult();
+    }
+    // A cancelled poll fails, report that as a cancelled loop too.
+    if (IsCancelled()) return SetCancelled();
+    // Update the polling policy even on successful requests, so we can stop
+    // after too many polling attempts.
+    if (!polling_policy_->OnFailure(update.status())) {
+      if (update) {
+        return result_.set_value(
+            Status(StatusCode::kDeadlineExceeded,
+                   "exhausted polling policy with no previous error"));
+      }
+      return result_.set_value(std::move(update).status());
+    }
+    if (update) {
+      using std::swap;
+      swap(*update, operation_);
+    }
+    Wait();
+  }
+
+  void SetResult() {
+    if (operation_.has_error()) {
+      // The long running operation failed, return the error to the caller.
+      return result_.set_value(
+          google::cloud::MakeStatusFromRpcError(operation_.error()));
+    }
+    result_.set_value(ValueExtractor::Extract(operation_, location_));
+  }
+
+  CompletionQueue cq_;
+  std::unique_ptr<PollingPolicy> polling_policy_;
+  Functor functor_;
+  google::longrunning::Operation operation_;
+  char const* location_;
+  promise<ReturnType> result_;
+  // Only the step that runs next reads and increments `sequence_`.
+  std::uint64_t sequence_ = 0;
+  std::mutex mu_;
+  bool cancelled_ = false;
+  std::uint64_t tracked_sequence_ = 0;
+  future<void> pending_;
+};
+
+/**
+ * A generic polling loop for long-running operations, without blocking.
+ *
+ * This is the asynchronous version of `PollingLoop()`, with the same policies
+ * and results. Instead of sleeping between polls it waits on a
+ * `CompletionQueue` timer, so no thread is blocked while the operation runs.
+ *
+ * @param cq the `CompletionQueue` used for the timers, it is also passed to
+ *     @p functor.
+ * @param polling_policy controls how often, and for how long, the loop polls.
+ * @param functor the `GetOperation()` call, it receives the `CompletionQueue`,
+ *     a new `grpc::ClientContext` for each poll, and the request. It returns a
+ *     `future<StatusOr<google::longrunning::Operation>>`.
+ * @param operation the long-running operation to poll.
+ * @param location a string to annotate any error returned by this function.
+ * @param loops if not null, the loop is added to it, so the caller can cancel
+ *     the loop, e.g., when the caller is destroyed.
+ * @tparam ValueExtractor extracts the result from the completed operation,
+ *     see `PollingLoopResponseExtractor` and `PollingLoopMetadataExtractor`.
+ * @return a future satisfied with the result of the operation, or a
+ *     `google::cloud::Status` that indicates why polling failed.
+ */
+template <typename ValueExtractor, typename Functor,
+          typename std::enable_if<
+              google::cloud::internal::is_invocable<
+                  Functor, CompletionQueue&,
+                  std::unique_ptr<grpc::ClientContext>,
+                  google::longrunning::GetOperationRequest const&>::value,
+              int>::type = 0>
+future<typename ValueExtractor::ReturnType> AsyncPollingLoop(
+    CompletionQueue cq, std::unique_ptr<PollingPolicy> polling_policy,
+    Functor&& functor, google::longrunning::Operation operation,
+    char const* location, AsyncPollingLoops* loops = nullptr) {
+  auto loop = std::make_shared<
+      AsyncPollingLoopImpl<ValueExtractor, typename std::decay<Functor>::type>>(
+      std::move(cq), std::move(polling_policy), std::forward<Functor>(functor),
+      std::move(operation), location);
+  if (loops != nullptr) loops->Add(loop);
+  return loop->Start();
+}
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_ASYNC_POLLING_LOOP_H
@@ -0,0 +1,291 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/async_polling_loop.h"
+#include "google/cloud/internal/background_threads_impl.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include <google/protobuf/struct.pb.h>
+#include <gmock/gmock.h>
+#include <chrono>
+#include <future>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::testing::HasSubstr;
+using Extractor = PollingLoopResponseExtractor<google::protobuf::Value>;
+
+std::unique_ptr<PollingPolicy> TestPollingPolicy() {
+  using Policy = GenericPollingPolicy<LimitedErrorCountRetryPolicy,
+                                      ExponentialBackoffPolicy>;
+  return Policy(LimitedErrorCountRetryPolicy(5),
+                ExponentialBackoffPolicy(std::chrono::microseconds(1),
+                                         std::chrono::microseconds(5), 2.0))
+      .clone();
+}
+
+// A policy that waits much longer than any test, so the loop only completes
+// if it is cancelled.
+std::unique_ptr<PollingPolicy> SlowPollingPolicy() {
+  using Policy = GenericPollingPolicy<LimitedErrorCountRetryPolicy,
+                                      ExponentialBackoffPolicy>;
+  return Policy(LimitedErrorCountRetryPolicy(5),
+                ExponentialBackoffPolicy(std::chrono::hours(1),
+                                         std::chrono::hours(1), 2.0))
+      .clone();
+}
+
+// This function is used to test early failures, where the polling loop callable
+// should not get called.
+future<StatusOr<google::longrunning::Operation>> ShouldNotBeCalled(
+    CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+    google::longrunning::GetOperationRequest const&) {
+  EXPECT_TRUE(false) << "should not have been called";
+  return make_ready_future(StatusOr<google::longrunning::Operation>(
+      Status(StatusCode::kUnimplemented, "should not have been called")));
+}
+
+TEST(AsyncPollingLoopTest, ImmediateSuccess) {
+  google::protobuf::Value expected;
+  expected.set_string_value("42");
+
+  google::longrunning::Operation operation;
+  operation.set_name("test-operation");
+  operation.set_done(true);
+  operation.mutable_response()->PackFrom(expected);
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  StatusOr<google::protobuf::Value> actual =
+      AsyncPollingLoop<Extractor>(threads.cq(), TestPollingPolicy(),
+                                  ShouldNotBeCalled, operation, "location")
+          .get();
+  EXPECT_STATUS_OK(actual);
+  EXPECT_EQ(expected.string_value(), actual->string_value());
+}
+
+TEST(AsyncPollingLoopTest, SuccessWithTransientFailures) {
+  google::protobuf::Value expected;
+  expected.set_string_value("42");
+
+  google::longrunning::Operation operation;
+  operation.set_name("test-operation");
+  operation.set_done(false);
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  int counter = 4;
+  StatusOr<google::protobuf::Value> actual =
+      AsyncPollingLoop<Extractor>(
+          threads.cq(), TestPollingPolicy(),
+          [expected, &counter](
+              CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+              google::longrunning::GetOperationRequest const& r) {
+            google::longrunning::Operation op;
+            op.set_name(r.name());
+            counter--;
+            if (counter >= 2) {
+              return make_ready_future(StatusOr<google::longrunning::Operation>(
+                  Status(StatusCode::kUnavailable, "try again")));
+            }
+            if (counter > 0) {
+              op.set_done(false);
+            } else {
+              op.set_done(true);
+              op.mutable_response()->PackFrom(expected);
+            }
+            return make_ready_future(make_status_or(op));
+          },
+          operation, "location")
+          .get();
+  EXPECT_STATUS_OK(actual);
+  EXPECT_EQ(expected.string_value(), actual->string_value());
+  EXPECT_EQ(0, counter);
+}
+
+TEST(AsyncPollingLoopTest, FailureWithSuccessfulPolling) {
+  google::rpc::Status error;
+  error.set_code(static_cast<int>(StatusCode::kResourceExhausted));
+  error.set_message("cannot complete operation");
+
+  google::longrunning::Operation operation;
+  operation.set_name("test-operation");
+  operation.set_done(false);
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  int counter = 3;
+  StatusOr<google::protobuf::Value> actual =
+      AsyncPollingLoop<Extractor>(
+          threads.cq(), TestPollingPolicy(),
+          [error, &counter](CompletionQueue&,
+                            std::unique_ptr<grpc::ClientContext>,
+                            google::longrunning::GetOperationRequest const& r) {
+            google::longrunning::Operation op;
+            op.set_name(r.name());
+            if (--counter != 0) {
+              op.set_done(false);
+            } else {
+              op.set_done(true);
+              *op.mutable_error() = error;
+            }
+            return make_ready_future(make_status_or(op));
+          },
+          operation, "location")
+          .get();
+  EXPECT_EQ(StatusCode::kResourceExhausted, actual.status().code());
+  EXPECT_EQ(error.message(), actual.status().message());
+}
+
+TEST(AsyncPollingLoopTest, FailurePermanentError) {
+  google::longrunning::Operation operation;
+  operation.set_name("test-operation");
+  operation.set_done(false);
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  StatusOr<google::protobuf::Value> actual =
+      AsyncPollingLoop<Extractor>(
+          threads.cq(), TestPollingPolicy(),
+          [](CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+             google::longrunning::GetOperationRequest const&) {
+            return make_ready_future(StatusOr<google::longrunning::Operation>(
+                Status(StatusCode::kPermissionDenied, "uh oh")));
+          },
+          operation, "location")
+          .get();
+  EXPECT_EQ(StatusCode::kPermissionDenied, actual.status().code());
+}
+
+TEST(AsyncPollingLoopTest, FailureTooManySuccesses) {
+  google::longrunning::Operation operation;
+  operation.set_name("test-operation");
+  operation.set_done(false);
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  StatusOr<google::protobuf::Value> actual =
+      AsyncPollingLoop<Extractor>(
+          threads.cq(), TestPollingPolicy(),
+          [operation](CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+                      google::longrunning::GetOperationRequest const&) {
+            return make_ready_future(make_status_or(operation));
+          },
+          operation, "location")
+          .get();
+  EXPECT_EQ(StatusCode::kDeadlineExceeded, actual.status().code());
+  EXPECT_THAT(actual.status().message(), HasSubstr("exhausted polling policy"));
+}
+
+TEST(AsyncPollingLoopTest, CancelDuringTimer) {
+  google::longrunning::Operation operation;
+  operation.set_name("test-operation");
+  operation.set_done(false);
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  AsyncPollingLoops loops;
+  auto f = AsyncPollingLoop<Extractor>(threads.cq(), SlowPollingPolicy(),
+                                       ShouldNotBeCalled, operation,
+                                       "location", &loops);
+  EXPECT_EQ(std::future_status::timeout,
+            f.wait_for(std::chrono::milliseconds(10)));
+  loops.CancelAll();
+  ASSERT_EQ(std::future_status::ready, f.wait_for(std::chrono::seconds(10)));
+  auto actual = f.get();
+  EXPECT_EQ(StatusCode::kCancelled, actual.status().code());
+  EXPECT_THAT(actual.status().message(),
+              HasSubstr("location() polling loop cancelled, "
+                        "name=test-operation"));
+}
+
+TEST(AsyncPollingLoopTest, CancelDuringPoll) {
+  google::longrunning::Operation operation;
+  operation.set_name("test-operation");
+  operation.set_done(false);
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  AsyncPollingLoops loops;
+  std::promise<void> polling;
+  std::promise<void> poll_cancelled;
+  promise<StatusOr<google::longrunning::Operation>> poll;
+  auto f = AsyncPollingLoop<Extractor>(
+      threads.cq(), TestPollingPolicy(),
+      [&](CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+          google::longrunning::GetOperationRequest const&) {
+        poll = promise<StatusOr<google::longrunning::Operation>>(
+            [&] { poll_cancelled.set_value(); });
+        auto result = poll.get_future();
+        polling.set_value();
+        return result;
+      },
+      operation, "location", &loops);
+  polling.get_future().get();
+  loops.CancelAll();
+  poll_cancelled.get_future().get();
+  // Like a cancelled RPC, the poll completes with an error.
+  poll.set_value(Status(StatusCode::kCancelled, "poll cancelled"));
+  auto actual = f.get();
+  EXPECT_EQ(StatusCode::kCancelled, actual.status().code());
+  EXPECT_THAT(actual.status().message(),
+              HasSubstr("location() polling loop cancelled, "
+                        "name=test-operation"));
+}
+
+TEST(AsyncPollingLoopTest, CancelOnlyTrackedLoops) {
+  google::protobuf::Value expected;
+  expected.set_string_value("42");
+
+  google::longrunning::Operation operation;
+  operation.set_name("test-operation");
+  operation.set_done(false);
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  AsyncPollingLoops loops;
+  auto cancelled = AsyncPollingLoop<Extractor>(
+      threads.cq(), SlowPollingPolicy(), ShouldNotBeCalled, operation,
+      "location", &loops);
+
+  std::promise<void> polling;
+  promise<StatusOr<google::longrunning::Operation>> poll;
+  auto untracked = AsyncPollingLoop<Extractor>(
+      threads.cq(), TestPollingPolicy(),
+      [&](CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+          google::longrunning::GetOperationRequest const&) {
+        auto result = poll.get_future();
+        polling.set_value();
+        return result;
+      },
+      operation, "location");
+  polling.get_future().get();
+
+  loops.CancelAll();
+  EXPECT_EQ(StatusCode::kCancelled, cancelled.get().status().code());
+  EXPECT_EQ(std::future_status::timeout,
+            untracked.wait_for(std::chrono::milliseconds(10)));
+
+  google::longrunning::Operation done;
+  done.set_name("test-operation");
+  done.set_done(true);
+  done.mutable_response()->PackFrom(expected);
+  poll.set_value(done);
+  auto actual = untracked.get();
+  ASSERT_STATUS_OK(actual);
+  EXPECT_EQ(expected.string_value(), actual->string_value());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,174 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_ASYNC_RETRY_LOOP_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_ASYNC_RETRY_LOOP_H
+
+#include "google/cloud/spanner/backoff_policy.h"
+#include "google/cloud/spanner/internal/retry_loop.h"
+#include "google/cloud/spanner/retry_policy.h"
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/completion_queue.h"
+#include "google/cloud/future.h"
+#include "google/cloud/internal/invoke_result.h"
+#include "google/cloud/internal/make_unique.h"
+#include "google/cloud/status_or.h"
+#include <grpcpp/grpcpp.h>
+#include <chrono>
+#include <memory>
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+/**
+ * The state of a single `AsyncRetryLoop()` call.
+ *
+ * Each attempt, and each backoff timer, holds a reference to this object, so
+ * it lives until the loop completes.
+ */
+template <typename Functor, typename Request>
+class AsyncRetryLoopImpl
+    : public std::enable_shared_from_this<
+          AsyncRetryLoopImpl<Functor, Request>> {
+ public:
+  using ReturnType = google::cloud::internal::invoke_result_t<
+      Functor, CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+      Request const&>;
+  using T = decltype(std::declval<ReturnType>().get());
+
+  AsyncRetryLoopImpl(std::unique_ptr<RetryPolicy> retry_policy,
+                     std::unique_ptr<BackoffPolicy> backoff_policy,
+                     bool is_idempotent, CompletionQueue cq, Functor functor,
+                     Request request, char const* location)
+      : retry_policy_(std::move(retry_policy)),
+        backoff_policy_(std::move(backoff_policy)),
+        is_idempotent_(is_idempotent),
+        cq_(std::move(cq)),
+        functor_(std::move(functor)),
+        request_(std::move(request)),
+        location_(location) {}
+
+  future<T> Start() {
+    auto f = result_.get_future();
+    StartAttempt();
+    return f;
+  }
+
+ private:
+  void StartAttempt() {
+    if (retry_policy_->IsExhausted()) {
+      return SetError("Retry policy exhausted in");
+    }
+    auto self = this->shared_from_this();
+    // Need to create a new context for each retry.
+    functor_(cq_, google::cloud::internal::make_unique<grpc::ClientContext>(),
+             request_)
+        .then([self](ReturnType f) { self->OnAttempt(f.get()); });
+  }
+
+  void OnAttempt(T result) {
+    if (result.ok()) return result_.set_value(std::move(result));
+    last_status_ = GetResultStatus(std::move(result));
+    if (!is_idempotent_) {
+      return SetError("Error in non-idempotent operation");
+    }
+    if (!retry_policy_->OnFailure(last_status_)) {
+      // Same as in `RetryLoop()`, errors that stop the loop before the retry
+      // policy is exhausted are "permanent errors".
+      return SetError(retry_policy_->IsExhausted() ? "Retry policy exhausted in"
+                                                   : "Permanent error in");
+    }
+    auto self = this->shared_from_this();
+    cq_.MakeRelativeTimer(backoff_policy_->OnCompletion())
+        .then([self](future<StatusOr<std::chrono::system_clock::time_point>>
+                         f) { self->OnBackoff(f.get().status()); });
+  }
+
+  void OnBackoff(Status const& timer_status) {
+    // The timer fails only if it is cancelled, e.g., during shutdown.
+    if (!timer_status.ok()) return SetError("Backoff timer cancelled in");
+    StartAttempt();
+  }
+
+  void SetError(char const* loop_message) {
+    result_.set_value(RetryLoopError(loop_message, location_, last_status_));
+  }
+
+  std::unique_ptr<RetryPolicy> retry_policy_;
+  std::unique_ptr<BackoffPolicy> backoff_policy_;
+  bool const is_idempotent_;
+  CompletionQueue cq_;
+  Functor functor_;
+  Request request_;
+  char const* location_;
+  Status last_status_;
+  promise<T> result_;
+};
+
+/**
+ * A generic retry loop for asynchronous gRPC operations.
+ *
+ * This is the asynchronous version of `RetryLoop()`, with the same policies
+ * and error messages. Instead of sleeping between attempts it waits on a
+ * `CompletionQueue` timer, so no thread is blocked while the loop backs off.
+ *
+ * @param retry_policy controls the duration of the retry loop.
+ * @param backoff_policy controls how the loop backsoff from a recoverable
+ *     failure.
+ * @param is_idempotent if false, the operation is not retried even on transient
+ *     errors.
+ * @param cq the `CompletionQueue` used for the backoff timers, it is also
+ *     passed to @p functor.
+ * @param functor the operation to retry, it receives the `CompletionQueue`, a
+ *     new `grpc::ClientContext` for each attempt, and the request. It returns a
+ *     `future<StatusOr<T>>` or a `future<Status>`, for example, the result of
+ *     `CompletionQueue::MakeUnaryRpc()`.
+ * @param request the parameters for the request.
+ * @param location a string to annotate any error returned by this function.
+ * @return a future satisfied with the result of the first successful call to
+ *     @p functor, or a `google::cloud::Status` that indicates the final error
+ *     for this request.
+ */
+template <typename Functor, typename Request,
+          typename std::enable_if<
+              google::cloud::internal::is_invocable<
+                  Functor, CompletionQueue&,
+                  std::unique_ptr<grpc::ClientContext>,
+                  Request const&>::value,
+              int>::type = 0>
+auto AsyncRetryLoop(std::unique_ptr<RetryPolicy> retry_policy,
+                    std::unique_ptr<BackoffPolicy> backoff_policy,
+                    bool is_idempotent, CompletionQueue cq, Functor&& functor,
+                    Request request, char const* location)
+    -> typename AsyncRetryLoopImpl<typename std::decay<Functor>::type,
+                                   Request>::ReturnType {
+  auto loop = std::make_shared<
+      AsyncRetryLoopImpl<typename std::decay<Functor>::type, Request>>(
+      std::move(retry_policy), std::move(backoff_policy), is_idempotent,
+      std::move(cq), std::forward<Functor>(functor), std::move(request),
+      location);
+  return loop->Start();
+}
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_ASYNC_RETRY_LOOP_H
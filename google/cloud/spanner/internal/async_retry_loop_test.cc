@@ -0,0 +1,189 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/async_retry_loop.h"
+#include "google/cloud/internal/background_threads_impl.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include <gmock/gmock.h>
+#include <chrono>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::testing::HasSubstr;
+using ::testing::Return;
+
+std::unique_ptr<RetryPolicy> TestRetryPolicy() {
+  return LimitedErrorCountRetryPolicy(5).clone();
+}
+
+std::unique_ptr<BackoffPolicy> TestBackoffPolicy() {
+  return ExponentialBackoffPolicy(std::chrono::microseconds(1),
+                                  std::chrono::microseconds(5), 2.0)
+      .clone();
+}
+
+TEST(AsyncRetryLoopTest, Success) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  StatusOr<int> actual =
+      AsyncRetryLoop(
+          TestRetryPolicy(), TestBackoffPolicy(), true, threads.cq(),
+          [](CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+             int request) {
+            return make_ready_future(StatusOr<int>(2 * request));
+          },
+          42, "error message")
+          .get();
+  EXPECT_STATUS_OK(actual);
+  EXPECT_EQ(84, *actual);
+}
+
+TEST(AsyncRetryLoopTest, TransientThenSuccess) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  int counter = 0;
+  StatusOr<int> actual =
+      AsyncRetryLoop(
+          TestRetryPolicy(), TestBackoffPolicy(), true, threads.cq(),
+          [&counter](CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+                     int request) {
+            if (++counter < 3) {
+              return make_ready_future(
+                  StatusOr<int>(Status(StatusCode::kUnavailable, "try again")));
+            }
+            return make_ready_future(StatusOr<int>(2 * request));
+          },
+          42, "error message")
+          .get();
+  EXPECT_STATUS_OK(actual);
+  EXPECT_EQ(84, *actual);
+  EXPECT_EQ(3, counter);
+}
+
+TEST(AsyncRetryLoopTest, ReturnJustStatus) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  int counter = 0;
+  Status actual =
+      AsyncRetryLoop(
+          TestRetryPolicy(), TestBackoffPolicy(), true, threads.cq(),
+          [&counter](CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+                     int) {
+            if (++counter <= 3) {
+              return make_ready_future(
+                  Status(StatusCode::kResourceExhausted, "slow-down"));
+            }
+            return make_ready_future(Status());
+          },
+          42, "error message")
+          .get();
+  EXPECT_STATUS_OK(actual);
+}
+
+class MockBackoffPolicy : public BackoffPolicy {
+ public:
+  MOCK_CONST_METHOD0(clone, std::unique_ptr<BackoffPolicy>());
+  MOCK_METHOD0(OnCompletion, std::chrono::milliseconds());
+};
+
+/// @test Verify the loop waits on the backoff timers between attempts.
+TEST(AsyncRetryLoopTest, UsesBackoffPolicy) {
+  using ms = std::chrono::milliseconds;
+
+  std::unique_ptr<MockBackoffPolicy> mock(new MockBackoffPolicy);
+  EXPECT_CALL(*mock, OnCompletion())
+      .WillOnce(Return(ms(10)))
+      .WillOnce(Return(ms(20)));
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  int counter = 0;
+  auto const start = std::chrono::steady_clock::now();
+  auto pending = AsyncRetryLoop(
+      TestRetryPolicy(), std::move(mock), true, threads.cq(),
+      [&counter](CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+                 int request) {
+        if (++counter <= 2) {
+          return make_ready_future(
+              StatusOr<int>(Status(StatusCode::kUnavailable, "try again")));
+        }
+        return make_ready_future(StatusOr<int>(2 * request));
+      },
+      42, "error message");
+  StatusOr<int> actual = pending.get();
+  auto const elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_STATUS_OK(actual);
+  EXPECT_EQ(84, *actual);
+  EXPECT_EQ(3, counter);
+  EXPECT_LE(ms(30), elapsed);
+}
+
+TEST(AsyncRetryLoopTest, TransientFailureNonIdempotent) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  StatusOr<int> actual =
+      AsyncRetryLoop(
+          TestRetryPolicy(), TestBackoffPolicy(), false, threads.cq(),
+          [](CompletionQueue&, std::unique_ptr<grpc::ClientContext>, int) {
+            return make_ready_future(
+                StatusOr<int>(Status(StatusCode::kUnavailable, "try again")));
+          },
+          42, "the answer to everything")
+          .get();
+  EXPECT_EQ(StatusCode::kUnavailable, actual.status().code());
+  EXPECT_THAT(actual.status().message(), HasSubstr("try again"));
+  EXPECT_THAT(actual.status().message(), HasSubstr("the answer to everything"));
+  EXPECT_THAT(actual.status().message(), HasSubstr("Error in non-idempotent"));
+}
+
+TEST(AsyncRetryLoopTest, PermanentFailureIdempotent) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  StatusOr<int> actual =
+      AsyncRetryLoop(
+          TestRetryPolicy(), TestBackoffPolicy(), true, threads.cq(),
+          [](CompletionQueue&, std::unique_ptr<grpc::ClientContext>, int) {
+            return make_ready_future(
+                StatusOr<int>(Status(StatusCode::kPermissionDenied, "uh oh")));
+          },
+          42, "the answer to everything")
+          .get();
+  EXPECT_EQ(StatusCode::kPermissionDenied, actual.status().code());
+  EXPECT_THAT(actual.status().message(), HasSubstr("uh oh"));
+  EXPECT_THAT(actual.status().message(), HasSubstr("the answer to everything"));
+  EXPECT_THAT(actual.status().message(), HasSubstr("Permanent error"));
+}
+
+TEST(AsyncRetryLoopTest, TooManyTransientFailuresIdempotent) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  StatusOr<int> actual =
+      AsyncRetryLoop(
+          TestRetryPolicy(), TestBackoffPolicy(), true, threads.cq(),
+          [](CompletionQueue&, std::unique_ptr<grpc::ClientContext>, int) {
+            return make_ready_future(
+                StatusOr<int>(Status(StatusCode::kUnavailable, "try again")));
+          },
+          42, "the answer to everything")
+          .get();
+  EXPECT_EQ(StatusCode::kUnavailable, actual.status().code());
+  EXPECT_THAT(actual.status().message(), HasSubstr("try again"));
+  EXPECT_THAT(actual.status().message(), HasSubstr("the answer to everything"));
+  EXPECT_THAT(actual.status().message(), HasSubstr("Retry policy exhausted"));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -17,6 +17,7 @@
 
 #include "google/cloud/spanner/internal/spanner_stub.h"
 #include "google/cloud/spanner/version.h"
+#include <atomic>
 #include <memory>
 
 namespace google {
@@ -39,6 +40,10 @@ struct Channel {
 
   std::shared_ptr<SpannerStub> const stub;
   int session_count = 0;
+
+  // The number of sessions on this channel currently allocated to callers,
+  // which approximates the number of RPCs in flight on the channel.
+  std::atomic<int> sessions_in_use{0};
 };
 
 }  // namespace internal
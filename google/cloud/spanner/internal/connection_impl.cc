@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include "google/cloud/spanner/internal/connection_impl.h"
+#include "google/cloud/spanner/internal/async_partial_result_set_reader.h"
+#include "google/cloud/spanner/internal/async_retry_loop.h"
 #include "google/cloud/spanner/internal/logging_result_set_reader.h"
 #include "google/cloud/spanner/internal/partial_result_set_resume.h"
 #include "google/cloud/spanner/internal/partial_result_set_source.h"
@@ -20,6 +22,7 @@
 #include "google/cloud/spanner/internal/status_utils.h"
 #include "google/cloud/spanner/query_partition.h"
 #include "google/cloud/spanner/read_partition.h"
+#include "google/cloud/completion_queue.h"
 #include "google/cloud/grpc_error_delegate.h"
 #include "google/cloud/internal/make_unique.h"
 #include <limits>
@@ -50,6 +53,10 @@ class DefaultPartialResultSetReader : public PartialResultSetReader {
     return result;
   }
 
+  bool ReadInto(google::spanner::v1::PartialResultSet* result) override {
+    return reader_->Read(result);
+  }
+
   Status Finish() override {
     return google::cloud::MakeStatusFromRpcError(reader_->Finish());
   }
@@ -63,6 +70,15 @@ class DefaultPartialResultSetReader : public PartialResultSetReader {
 
 namespace spanner_proto = ::google::spanner::v1;
 
+struct AsyncConnectionContext {
+  std::shared_ptr<SessionPool> session_pool;
+  std::shared_ptr<RetryPolicy const> retry_policy_prototype;
+  std::shared_ptr<BackoffPolicy const> backoff_policy_prototype;
+  CompletionQueue cq;
+  bool rpc_stream_tracing_enabled;
+  TracingOptions tracing_options;
+};
+
 std::unique_ptr<RetryPolicy> DefaultConnectionRetryPolicy() {
   return google::cloud::spanner::LimitedTimeRetryPolicy(
              std::chrono::minutes(10))
@@ -102,7 +118,13 @@ ConnectionImpl::ConnectionImpl(Database db,
           background_threads_->cq(), retry_policy_prototype_->clone(),
           backoff_policy_prototype_->clone())),
       rpc_stream_tracing_enabled_(options.tracing_enabled("rpc-streams")),
-      tracing_options_(options.tracing_options()) {}
+      tracing_options_(options.tracing_options()),
+      async_context_(std::make_shared<AsyncConnectionContext>(
+          AsyncConnectionContext{session_pool_, retry_policy_prototype_,
+                                 backoff_policy_prototype_,
+                                 background_threads_->cq(),
+                                 rpc_stream_tracing_enabled_,
+                                 tracing_options_})) {}
 
 RowStream ConnectionImpl::Read(ReadParams params) {
   return internal::Visit(
@@ -224,8 +246,12 @@ Status ConnectionImpl::Rollback(RollbackParams params) {
 
 class StatusOnlyResultSetSource : public internal::ResultSourceInterface {
  public:
-  explicit StatusOnlyResultSetSource(google::cloud::Status status)
-      : status_(std::move(status)) {}
+  // The unused `abandoned` source, if any, is destroyed with this one, i.e.,
+  // by the owner of the result and not on the thread that created it.
+  explicit StatusOnlyResultSetSource(
+      google::cloud::Status status,
+      std::unique_ptr<ResultSourceInterface> abandoned = nullptr)
+      : status_(std::move(status)), abandoned_(std::move(abandoned)) {}
   ~StatusOnlyResultSetSource() override = default;
 
   StatusOr<Row> NextRow() override { return status_; }
@@ -238,6 +264,7 @@ class StatusOnlyResultSetSource : public internal::ResultSourceInterface {
 
  private:
   google::cloud::Status status_;
+  std::unique_ptr<ResultSourceInterface> abandoned_;
 };
 
 // Helper function to build and wrap a `StatusOnlyResultSetSource`.
@@ -296,14 +323,32 @@ Status ConnectionImpl::PrepareSession(SessionHolder& session,
   return Status();
 }
 
-RowStream ConnectionImpl::ReadImpl(SessionHolder& session,
-                                   spanner_proto::TransactionSelector& s,
-                                   ReadParams params) {
-  auto prepare_status = PrepareSession(session);
-  if (!prepare_status.ok()) {
-    return MakeStatusOnlyResult<RowStream>(std::move(prepare_status));
+/**
+ * Like `PrepareSession()` above, but if the selector begins a read-write
+ * transaction on a new session, prefer a session where the pool already began
+ * one, and use that transaction (saving the work to begin it inline).
+ */
+Status ConnectionImpl::PrepareSession(SessionHolder& session,
+                                      spanner_proto::TransactionSelector& s) {
+  if (session || !s.has_begin() || !s.begin().has_read_write()) {
+    return PrepareSession(session);
+  }
+  auto session_or = session_pool_->Allocate(/*dissociate_from_pool=*/false,
+                                            /*read_write=*/true);
+  if (!session_or) {
+    return std::move(session_or).status();
   }
+  session = std::move(*session_or);
+  auto id = session->TakePreparedTransaction();
+  if (!id.empty()) s.set_id(std::move(id));
+  return Status();
+}
 
+namespace {
+
+spanner_proto::ReadRequest MakeReadRequest(
+    SessionHolder const& session, spanner_proto::TransactionSelector const& s,
+    Connection::ReadParams params) {
   spanner_proto::ReadRequest request;
   request.set_session(session->session_name());
   *request.mutable_transaction() = s;
@@ -317,29 +362,131 @@ RowStream ConnectionImpl::ReadImpl(SessionHolder& session,
   if (params.partition_token) {
     request.set_partition_token(*std::move(params.partition_token));
   }
+  return request;
+}
+
+spanner_proto::ExecuteSqlRequest MakeExecuteSqlRequest(
+    SessionHolder const& session, spanner_proto::TransactionSelector const& s,
+    std::int64_t seqno, Connection::SqlParams params,
+    spanner_proto::ExecuteSqlRequest::QueryMode query_mode) {
+  spanner_proto::ExecuteSqlRequest request;
+  request.set_session(session->session_name());
+  *request.mutable_transaction() = s;
+  auto sql_statement = internal::ToProto(std::move(params.statement));
+  request.set_sql(std::move(*sql_statement.mutable_sql()));
+  *request.mutable_params() = std::move(*sql_statement.mutable_params());
+  *request.mutable_param_types() =
+      std::move(*sql_statement.mutable_param_types());
+  request.set_seqno(seqno);
+  request.set_query_mode(query_mode);
+  if (params.partition_token) {
+    request.set_partition_token(*std::move(params.partition_token));
+  }
+  if (params.query_options.optimizer_version()) {
+    request.mutable_query_options()->set_optimizer_version(
+        *params.query_options.optimizer_version());
+  }
+  return request;
+}
+
+/**
+ * Starts a streaming RPC on @p cq, prefetching up to @p buffer_limit bytes of
+ * its responses.
+ *
+ * @p prepare is the `PrepareAsync*()` call to make on the `CompletionQueue`.
+ */
+template <typename Request, typename PrepareAsyncCall>
+std::unique_ptr<AsyncPartialResultSetReader> StartAsyncReader(
+    CompletionQueue cq, Request const& request, PrepareAsyncCall prepare,
+    std::size_t buffer_limit) {
+  return google::cloud::internal::make_unique<AsyncPartialResultSetReader>(
+      [&](AsyncPartialResultSetReader::OnRead on_read,
+          AsyncPartialResultSetReader::OnFinish on_finish) {
+        auto op = cq.MakeStreamingReadRpc(
+            prepare, request,
+            google::cloud::internal::make_unique<grpc::ClientContext>(),
+            std::move(on_read), std::move(on_finish));
+        return std::function<void()>([op] { op->Cancel(); });
+      },
+      buffer_limit);
+}
+
+/**
+ * Returns a reader that resumes the streams created by @p factory.
+ *
+ * The prefetching readers, used when @p prefetch_bytes is not zero, can wait
+ * for the stream without blocking. The reader resumes them with timers on
+ * @p cq, so `WhenRowReady()` does not block either.
+ */
+std::unique_ptr<PartialResultSetResume> MakeResume(
+    PartialResultSetReaderFactory factory,
+    std::unique_ptr<RetryPolicy> retry_policy,
+    std::unique_ptr<BackoffPolicy> backoff_policy, CompletionQueue cq,
+    std::size_t prefetch_bytes) {
+  if (prefetch_bytes == 0) {
+    return google::cloud::internal::make_unique<PartialResultSetResume>(
+        std::move(factory), Idempotency::kIdempotent, std::move(retry_policy),
+        std::move(backoff_policy));
+  }
+  return google::cloud::internal::make_unique<PartialResultSetResume>(
+      std::move(factory), Idempotency::kIdempotent, std::move(retry_policy),
+      std::move(backoff_policy), std::move(cq));
+}
+
+}  // namespace
+
+RowStream ConnectionImpl::ReadImpl(SessionHolder& session,
+                                   spanner_proto::TransactionSelector& s,
+                                   ReadParams params) {
+  auto prepare_status = PrepareSession(session, s);
+  if (!prepare_status.ok()) {
+    return MakeStatusOnlyResult<RowStream>(std::move(prepare_status));
+  }
+
+  auto const prefetch_bytes = params.read_options.prefetch_buffer_bytes;
+  auto request = MakeReadRequest(session, s, std::move(params));
 
   // Capture a copy of `stub` to ensure the `shared_ptr<>` remains valid through
   // the lifetime of the lambda.
   auto stub = session_pool_->GetStub(*session);
+  auto cq = background_threads_->cq();
   auto const tracing_enabled = rpc_stream_tracing_enabled_;
   auto const tracing_options = tracing_options_;
-  auto factory = [stub, request, tracing_enabled,
+  auto factory = [stub, request, cq, prefetch_bytes, tracing_enabled,
                   tracing_options](std::string const& resume_token) mutable {
     request.set_resume_token(resume_token);
-    auto context = google::cloud::internal::make_unique<grpc::ClientContext>();
-    std::unique_ptr<PartialResultSetReader> reader =
-        google::cloud::internal::make_unique<DefaultPartialResultSetReader>(
-            std::move(context), stub->StreamingRead(*context, request));
+    std::unique_ptr<PartialResultSetReader> reader;
+    if (prefetch_bytes > 0) {
+      reader = StartAsyncReader(
+          cq, request,
+          [stub](grpc::ClientContext* context,
+                 spanner_proto::ReadRequest const& request,
+                 grpc::CompletionQueue* cq) {
+            return stub->PrepareAsyncStreamingRead(*context, request, cq);
+          },
+          prefetch_bytes);
+    } else {
+      auto context =
+          google::cloud::internal::make_unique<grpc::ClientContext>();
+      reader =
+          google::cloud::internal::make_unique<DefaultPartialResultSetReader>(
+              std::move(context), stub->StreamingRead(*context, request));
+    }
     if (tracing_enabled) {
       reader = google::cloud::internal::make_unique<LoggingResultSetReader>(
           std::move(reader), tracing_options);
     }
     return reader;
   };
-  auto rpc = google::cloud::internal::make_unique<PartialResultSetResume>(
-      std::move(factory), Idempotency::kIdempotent,
-      retry_policy_prototype_->clone(), backoff_policy_prototype_->clone());
-  auto reader = PartialResultSetSource::Create(std::move(rpc));
+  auto rpc = MakeResume(std::move(factory), retry_policy_prototype_->clone(),
+                        backoff_policy_prototype_->clone(), cq,
+                        prefetch_bytes);
+  // The prefetched responses are allocated by the RPC callbacks, copying them
+  // into an arena would only add work. Without prefetching, the arena only
+  // helps `NextBatch()` and `StreamOf<>`, the source stops using it once the
+  // application reads a `Row`.
+  auto reader = PartialResultSetSource::Create(
+      std::move(rpc), /*use_arena=*/prefetch_bytes == 0);
   if (!reader.ok()) {
     auto status = std::move(reader).status();
     if (internal::IsSessionNotFound(status)) session->set_bad();
@@ -417,23 +564,8 @@ StatusOr<ResultType> ConnectionImpl::ExecuteSqlImpl(
     std::function<StatusOr<std::unique_ptr<ResultSourceInterface>>(
         google::spanner::v1 ::ExecuteSqlRequest& request)> const&
         retry_resume_fn) {
-  spanner_proto::ExecuteSqlRequest request;
-  request.set_session(session->session_name());
-  *request.mutable_transaction() = s;
-  auto sql_statement = internal::ToProto(std::move(params.statement));
-  request.set_sql(std::move(*sql_statement.mutable_sql()));
-  *request.mutable_params() = std::move(*sql_statement.mutable_params());
-  *request.mutable_param_types() =
-      std::move(*sql_statement.mutable_param_types());
-  request.set_seqno(seqno);
-  request.set_query_mode(query_mode);
-  if (params.partition_token) {
-    request.set_partition_token(*std::move(params.partition_token));
-  }
-  if (params.query_options.optimizer_version()) {
-    request.mutable_query_options()->set_optimizer_version(
-        *params.query_options.optimizer_version());
-  }
+  auto request = MakeExecuteSqlRequest(session, s, seqno, std::move(params),
+                                       query_mode);
   auto reader = retry_resume_fn(request);
   if (!reader.ok()) {
     return std::move(reader).status();
@@ -454,7 +586,7 @@ ResultType ConnectionImpl::CommonQueryImpl(
     SessionHolder& session, spanner_proto::TransactionSelector& s,
     std::int64_t seqno, SqlParams params,
     google::spanner::v1::ExecuteSqlRequest::QueryMode query_mode) {
-  auto prepare_status = PrepareSession(session);
+  auto prepare_status = PrepareSession(session, s);
   if (!prepare_status.ok()) {
     return MakeStatusOnlyResult<ResultType>(std::move(prepare_status));
   }
@@ -464,31 +596,47 @@ ResultType ConnectionImpl::CommonQueryImpl(
   auto stub = session_pool_->GetStub(*session);
   auto const& retry_policy = retry_policy_prototype_;
   auto const& backoff_policy = backoff_policy_prototype_;
+  auto cq = background_threads_->cq();
+  auto const prefetch_bytes =
+      params.query_options.prefetch_buffer_bytes().value_or(0);
   auto const tracing_enabled = rpc_stream_tracing_enabled_;
   auto const tracing_options = tracing_options_;
   auto retry_resume_fn =
-      [stub, retry_policy, backoff_policy, tracing_enabled,
+      [stub, retry_policy, backoff_policy, cq, prefetch_bytes, tracing_enabled,
        tracing_options](spanner_proto::ExecuteSqlRequest& request) mutable
       -> StatusOr<std::unique_ptr<ResultSourceInterface>> {
-    auto factory = [stub, request, tracing_enabled,
+    auto factory = [stub, request, cq, prefetch_bytes, tracing_enabled,
                     tracing_options](std::string const& resume_token) mutable {
       request.set_resume_token(resume_token);
-      auto context =
-          google::cloud::internal::make_unique<grpc::ClientContext>();
-      std::unique_ptr<PartialResultSetReader> reader =
-          google::cloud::internal::make_unique<DefaultPartialResultSetReader>(
-              std::move(context), stub->ExecuteStreamingSql(*context, request));
+      std::unique_ptr<PartialResultSetReader> reader;
+      if (prefetch_bytes > 0) {
+        reader = StartAsyncReader(
+            cq, request,
+            [stub](grpc::ClientContext* context,
+                   spanner_proto::ExecuteSqlRequest const& request,
+                   grpc::CompletionQueue* cq) {
+              return stub->PrepareAsyncExecuteStreamingSql(*context, request,
+                                                           cq);
+            },
+            prefetch_bytes);
+      } else {
+        auto context =
+            google::cloud::internal::make_unique<grpc::ClientContext>();
+        reader = google::cloud::internal::make_unique<
+            DefaultPartialResultSetReader>(
+            std::move(context), stub->ExecuteStreamingSql(*context, request));
+      }
       if (tracing_enabled) {
         reader = google::cloud::internal::make_unique<LoggingResultSetReader>(
             std::move(reader), tracing_options);
       }
       return reader;
     };
-    auto rpc = google::cloud::internal::make_unique<PartialResultSetResume>(
-        std::move(factory), Idempotency::kIdempotent, retry_policy->clone(),
-        backoff_policy->clone());
+    auto rpc = MakeResume(std::move(factory), retry_policy->clone(),
+                          backoff_policy->clone(), cq, prefetch_bytes);
 
-    return PartialResultSetSource::Create(std::move(rpc));
+    return PartialResultSetSource::Create(std::move(rpc),
+                                          /*use_arena=*/prefetch_bytes == 0);
   };
 
   StatusOr<ResultType> response =
@@ -523,7 +671,7 @@ StatusOr<ResultType> ConnectionImpl::CommonDmlImpl(
     std::int64_t seqno, SqlParams params,
     google::spanner::v1::ExecuteSqlRequest::QueryMode query_mode) {
   auto function_name = __func__;
-  auto prepare_status = PrepareSession(session);
+  auto prepare_status = PrepareSession(session, s);
   if (!prepare_status.ok()) {
     return prepare_status;
   }
@@ -636,7 +784,7 @@ StatusOr<std::vector<QueryPartition>> ConnectionImpl::PartitionQueryImpl(
 StatusOr<BatchDmlResult> ConnectionImpl::ExecuteBatchDmlImpl(
     SessionHolder& session, spanner_proto::TransactionSelector& s,
     std::int64_t seqno, ExecuteBatchDmlParams params) {
-  auto prepare_status = PrepareSession(session);
+  auto prepare_status = PrepareSession(session, s);
   if (!prepare_status.ok()) {
     return prepare_status;
   }
@@ -738,7 +886,7 @@ StatusOr<PartitionedDmlResult> ConnectionImpl::ExecutePartitionedDmlImpl(
 StatusOr<CommitResult> ConnectionImpl::CommitImpl(
     SessionHolder& session, spanner_proto::TransactionSelector& s,
     CommitParams params) {
-  auto prepare_status = PrepareSession(session);
+  auto prepare_status = PrepareSession(session, s);
   if (!prepare_status.ok()) {
     return prepare_status;
   }
@@ -823,6 +971,500 @@ Status ConnectionImpl::RollbackImpl(SessionHolder& session,
   return status;
 }
 
+namespace {
+
+// Like `ConnectionImpl::PrepareSession()`, but without blocking.
+future<Status> AsyncPrepareSession(AsyncConnectionContext& context,
+                                   SessionHolder& session) {
+  if (session) return make_ready_future(Status());
+  return context.session_pool->AsyncAllocate().then(
+      [&session](future<StatusOr<SessionHolder>> f) {
+        auto session_or = f.get();
+        if (!session_or) return std::move(session_or).status();
+        session = *std::move(session_or);
+        return Status();
+      });
+}
+
+/**
+ * Like `AsyncPrepareSession()` above, but uses a transaction the pool already
+ * began, as `ConnectionImpl::PrepareSession()` does.
+ */
+future<Status> AsyncPrepareSession(AsyncConnectionContext& context,
+                                   SessionHolder& session,
+                                   spanner_proto::TransactionSelector& s) {
+  if (session || !s.has_begin() || !s.begin().has_read_write()) {
+    return AsyncPrepareSession(context, session);
+  }
+  return context.session_pool
+      ->AsyncAllocate((std::chrono::system_clock::time_point::max)(),
+                      /*dissociate_from_pool=*/false, /*read_write=*/true)
+      .then([&session, &s](future<StatusOr<SessionHolder>> f) {
+        auto session_or = f.get();
+        if (!session_or) return std::move(session_or).status();
+        session = *std::move(session_or);
+        auto id = session->TakePreparedTransaction();
+        if (!id.empty()) s.set_id(std::move(id));
+        return Status();
+      });
+}
+
+using AsyncReaderFactory =
+    std::function<std::unique_ptr<AsyncPartialResultSetReader>(
+        std::string const& resume_token)>;
+
+/**
+ * Returns a factory for the readers of a streaming RPC.
+ *
+ * Each reader calls `StartAsyncReader()` with the given resume token set in
+ * @p request.
+ */
+template <typename Request, typename PrepareAsyncCall>
+AsyncReaderFactory MakeAsyncReaderFactory(CompletionQueue cq, Request request,
+                                          PrepareAsyncCall prepare,
+                                          std::size_t buffer_limit) {
+  return [cq, request, prepare,
+          buffer_limit](std::string const& resume_token) mutable {
+    request.set_resume_token(resume_token);
+    return StartAsyncReader(cq, request, prepare, buffer_limit);
+  };
+}
+
+using AsyncReaderResult =
+    StatusOr<std::unique_ptr<AsyncPartialResultSetReader>>;
+
+/**
+ * Starts a streaming RPC, retrying transient failures that occur before the
+ * first response.
+ *
+ * The backoff between attempts uses `CompletionQueue` timers, so this never
+ * blocks the thread that satisfies the returned future.
+ */
+future<AsyncReaderResult> AsyncStartStream(
+    AsyncConnectionContext const& context, AsyncReaderFactory factory,
+    char const* location) {
+  return internal::AsyncRetryLoop(
+      context.retry_policy_prototype->clone(),
+      context.backoff_policy_prototype->clone(),
+      /*is_idempotent=*/true, context.cq,
+      // Each reader creates the `grpc::ClientContext` for its own RPC.
+      [factory](CompletionQueue&, std::unique_ptr<grpc::ClientContext>,
+                std::string const& resume_token) {
+        auto reader =
+            std::make_shared<std::unique_ptr<AsyncPartialResultSetReader>>(
+                factory(resume_token));
+        return (*reader)->Ready().then(
+            [reader](future<bool> f) -> AsyncReaderResult {
+              // `Finish()` does not block once the reader is ready without a
+              // response.
+              if (!f.get()) {
+                auto status = (*reader)->Finish();
+                if (!status.ok()) return status;
+              }
+              return std::move(*reader);
+            });
+      },
+      std::string{}, location);
+}
+
+using AsyncSource = StatusOr<std::unique_ptr<ResultSourceInterface>>;
+
+/**
+ * Starts a streaming RPC and, once its first response arrives, returns a
+ * source that resumes the stream after transient failures.
+ *
+ * The first response is read on the thread that satisfies the returned future,
+ * but it is already buffered, so that does not block. Any later reads happen
+ * on the thread iterating over the results. The resumes wait for the backoff
+ * on the `CompletionQueue`, so `WhenRowReady()` never blocks.
+ */
+future<AsyncSource> AsyncStreamingSource(
+    std::shared_ptr<AsyncConnectionContext> const& context,
+    AsyncReaderFactory factory, char const* location) {
+  return AsyncStartStream(*context, factory, location)
+      .then([context, factory](future<AsyncReaderResult> f) -> AsyncSource {
+        auto started = f.get();
+        if (!started) return std::move(started).status();
+        // The resume policy returns the started reader the first time.
+        auto first = std::make_shared<std::unique_ptr<PartialResultSetReader>>(
+            *std::move(started));
+        auto const tracing_enabled = context->rpc_stream_tracing_enabled;
+        auto const tracing_options = context->tracing_options;
+        auto resume_factory = [first, factory, tracing_enabled,
+                               tracing_options](std::string const& token) {
+          std::unique_ptr<PartialResultSetReader> reader = std::move(*first);
+          if (!reader) reader = factory(token);
+          if (tracing_enabled) {
+            reader =
+                google::cloud::internal::make_unique<LoggingResultSetReader>(
+                    std::move(reader), tracing_options);
+          }
+          return reader;
+        };
+        auto rpc = google::cloud::internal::make_unique<PartialResultSetResume>(
+            std::move(resume_factory), Idempotency::kIdempotent,
+            context->retry_policy_prototype->clone(),
+            context->backoff_policy_prototype->clone(), context->cq);
+        // The responses are allocated by the RPC callbacks, using an arena
+        // here would only add a copy.
+        return PartialResultSetSource::Create(std::move(rpc),
+                                              /*use_arena=*/false);
+      });
+}
+
+// Wraps the result of `AsyncStreamingSource()` in a `RowStream`, and records
+// the transaction it began, if any.
+RowStream MakeAsyncRowStream(SessionHolder& session,
+                             spanner_proto::TransactionSelector& s,
+                             AsyncSource source) {
+  if (!source) {
+    auto status = std::move(source).status();
+    if (internal::IsSessionNotFound(status)) session->set_bad();
+    return MakeStatusOnlyResult<RowStream>(std::move(status));
+  }
+  if (s.has_begin()) {
+    auto metadata = (*source)->Metadata();
+    if (!metadata || metadata->transaction().id().empty()) {
+      // Destroying the source blocks until its RPC finishes, which would
+      // deadlock on this `CompletionQueue` thread.
+      return RowStream(
+          google::cloud::internal::make_unique<StatusOnlyResultSetSource>(
+              Status(StatusCode::kInternal,
+                     "Begin transaction requested but no transaction "
+                     "returned."),
+              *std::move(source)));
+    }
+    s.set_id(metadata->transaction().id());
+  }
+  return RowStream(*std::move(source));
+}
+
+// The functions below run inside `internal::AsyncVisit()`, so `session` and
+// `s` remain valid until the future they return is satisfied.
+
+future<RowStream> AsyncReadImpl(
+    std::shared_ptr<AsyncConnectionContext> const& context,
+    SessionHolder& session, spanner_proto::TransactionSelector& s,
+    Connection::ReadParams params) {
+  return AsyncPrepareSession(*context, session, s)
+      .then([context, &session, &s,
+             params](future<Status> f) mutable -> future<RowStream> {
+        auto status = f.get();
+        if (!status.ok()) {
+          return make_ready_future(
+              MakeStatusOnlyResult<RowStream>(std::move(status)));
+        }
+        auto stub = context->session_pool->GetStub(*session);
+        auto const prefetch_bytes = params.read_options.prefetch_buffer_bytes;
+        auto factory = MakeAsyncReaderFactory(
+            context->cq, MakeReadRequest(session, s, std::move(params)),
+            [stub](grpc::ClientContext* context,
+                   spanner_proto::ReadRequest const& request,
+                   grpc::CompletionQueue* cq) {
+              return stub->PrepareAsyncStreamingRead(*context, request, cq);
+            },
+            prefetch_bytes);
+        return AsyncStreamingSource(context, std::move(factory), "AsyncRead")
+            .then([&session, &s](future<AsyncSource> f) {
+              return MakeAsyncRowStream(session, s, f.get());
+            });
+      });
+}
+
+future<RowStream> AsyncExecuteQueryImpl(
+    std::shared_ptr<AsyncConnectionContext> const& context,
+    SessionHolder& session, spanner_proto::TransactionSelector& s,
+    std::int64_t seqno, Connection::SqlParams params) {
+  return AsyncPrepareSession(*context, session, s)
+      .then([context, &session, &s, seqno,
+             params](future<Status> f) mutable -> future<RowStream> {
+        auto status = f.get();
+        if (!status.ok()) {
+          return make_ready_future(
+              MakeStatusOnlyResult<RowStream>(std::move(status)));
+        }
+        auto stub = context->session_pool->GetStub(*session);
+        auto const prefetch_bytes =
+            params.query_options.prefetch_buffer_bytes().value_or(0);
+        auto factory = MakeAsyncReaderFactory(
+            context->cq,
+            MakeExecuteSqlRequest(session, s, seqno, std::move(params),
+                                  spanner_proto::ExecuteSqlRequest::NORMAL),
+            [stub](grpc::ClientContext* context,
+                   spanner_proto::ExecuteSqlRequest const& request,
+                   grpc::CompletionQueue* cq) {
+              return stub->PrepareAsyncExecuteStreamingSql(*context, request,
+                                                           cq);
+            },
+            prefetch_bytes);
+        return AsyncStreamingSource(context, std::move(factory),
+                                    "AsyncExecuteQuery")
+            .then([&session, &s](future<AsyncSource> f) {
+              return MakeAsyncRowStream(session, s, f.get());
+            });
+      });
+}
+
+future<StatusOr<DmlResult>> AsyncExecuteDmlImpl(
+    std::shared_ptr<AsyncConnectionContext> const& context,
+    SessionHolder& session, spanner_proto::TransactionSelector& s,
+    std::int64_t seqno, Connection::SqlParams params) {
+  return AsyncPrepareSession(*context, session, s)
+      .then([context, &session, &s, seqno,
+             params](future<Status> f) mutable -> future<StatusOr<DmlResult>> {
+        auto status = f.get();
+        if (!status.ok()) {
+          return make_ready_future(StatusOr<DmlResult>(std::move(status)));
+        }
+        auto stub = context->session_pool->GetStub(*session);
+        return internal::AsyncRetryLoop(
+                   context->retry_policy_prototype->clone(),
+                   context->backoff_policy_prototype->clone(),
+                   /*is_idempotent=*/true, context->cq,
+                   [stub](CompletionQueue& cq,
+                          std::unique_ptr<grpc::ClientContext> context,
+                          spanner_proto::ExecuteSqlRequest const& request) {
+                     return cq.MakeUnaryRpc(
+                         [stub](grpc::ClientContext* context,
+                                spanner_proto::ExecuteSqlRequest const& request,
+                                grpc::CompletionQueue* cq) {
+                           return stub->AsyncExecuteSql(*context, request, cq);
+                         },
+                         request, std::move(context));
+                   },
+                   MakeExecuteSqlRequest(
+                       session, s, seqno, std::move(params),
+                       spanner_proto::ExecuteSqlRequest::NORMAL),
+                   "AsyncExecuteDml")
+            .then([&session, &s](future<StatusOr<spanner_proto::ResultSet>> f)
+                      -> StatusOr<DmlResult> {
+              auto response = f.get();
+              if (!response) {
+                auto status = std::move(response).status();
+                if (internal::IsSessionNotFound(status)) session->set_bad();
+                return status;
+              }
+              if (s.has_begin()) {
+                auto const& id = response->metadata().transaction().id();
+                if (id.empty()) {
+                  return Status(
+                      StatusCode::kInternal,
+                      "Begin transaction requested but no transaction "
+                      "returned.");
+                }
+                s.set_id(id);
+              }
+              return DmlResult(
+                  google::cloud::internal::make_unique<DmlResultSetSource>(
+                      *std::move(response)));
+            });
+      });
+}
+
+future<StatusOr<CommitResult>> AsyncCommitRpc(
+    std::shared_ptr<AsyncConnectionContext> const& context,
+    SessionHolder& session, spanner_proto::CommitRequest request) {
+  auto stub = context->session_pool->GetStub(*session);
+  return internal::AsyncRetryLoop(
+             context->retry_policy_prototype->clone(),
+             context->backoff_policy_prototype->clone(),
+             /*is_idempotent=*/true, context->cq,
+             [stub](CompletionQueue& cq,
+                    std::unique_ptr<grpc::ClientContext> context,
+                    spanner_proto::CommitRequest const& request) {
+               return cq.MakeUnaryRpc(
+                   [stub](grpc::ClientContext* context,
+                          spanner_proto::CommitRequest const& request,
+                          grpc::CompletionQueue* cq) {
+                     return stub->AsyncCommit(*context, request, cq);
+                   },
+                   request, std::move(context));
+             },
+             std::move(request), "AsyncCommit")
+      .then([&session](future<StatusOr<spanner_proto::CommitResponse>> f)
+                -> StatusOr<CommitResult> {
+        auto response = f.get();
+        if (!response) {
+          auto status = std::move(response).status();
+          if (internal::IsSessionNotFound(status)) session->set_bad();
+          return status;
+        }
+        CommitResult r;
+        r.commit_timestamp =
+            internal::TimestampFromProto(response->commit_timestamp());
+        return r;
+      });
+}
+
+future<StatusOr<CommitResult>> AsyncCommitImpl(
+    std::shared_ptr<AsyncConnectionContext> const& context,
+    SessionHolder& session, spanner_proto::TransactionSelector& s,
+    Connection::CommitParams params) {
+  return AsyncPrepareSession(*context, session, s)
+      .then([context, &session, &s, params](future<Status> f) mutable
+            -> future<StatusOr<CommitResult>> {
+        auto status = f.get();
+        if (!status.ok()) {
+          return make_ready_future(StatusOr<CommitResult>(std::move(status)));
+        }
+        auto request = std::make_shared<spanner_proto::CommitRequest>();
+        request->set_session(session->session_name());
+        for (auto&& m : params.mutations) {
+          *request->add_mutations() = std::move(m).as_proto();
+        }
+        if (s.selector_case() == spanner_proto::TransactionSelector::kId) {
+          request->set_transaction_id(s.id());
+          return AsyncCommitRpc(context, session, std::move(*request));
+        }
+
+        spanner_proto::BeginTransactionRequest begin;
+        begin.set_session(session->session_name());
+        *begin.mutable_options() = s.has_begin() ? s.begin() : s.single_use();
+        auto stub = context->session_pool->GetStub(*session);
+        return internal::AsyncRetryLoop(
+                   context->retry_policy_prototype->clone(),
+                   context->backoff_policy_prototype->clone(),
+                   /*is_idempotent=*/true, context->cq,
+                   [stub](CompletionQueue& cq,
+                          std::unique_ptr<grpc::ClientContext> context,
+                          spanner_proto::BeginTransactionRequest const& r) {
+                     return cq.MakeUnaryRpc(
+                         [stub](grpc::ClientContext* context,
+                                spanner_proto::BeginTransactionRequest const& r,
+                                grpc::CompletionQueue* cq) {
+                           return stub->AsyncBeginTransaction(*context, r, cq);
+                         },
+                         r, std::move(context));
+                   },
+                   std::move(begin), "AsyncCommit")
+            .then([context, &session, &s,
+                   request](future<StatusOr<spanner_proto::Transaction>> f)
+                      -> future<StatusOr<CommitResult>> {
+              auto response = f.get();
+              if (!response) {
+                auto status = std::move(response).status();
+                if (internal::IsSessionNotFound(status)) session->set_bad();
+                return make_ready_future(
+                    StatusOr<CommitResult>(std::move(status)));
+              }
+              s.set_id(response->id());
+              request->set_transaction_id(s.id());
+              return AsyncCommitRpc(context, session, std::move(*request));
+            });
+      });
+}
+
+future<Status> AsyncRollbackImpl(
+    std::shared_ptr<AsyncConnectionContext> const& context,
+    SessionHolder& session, spanner_proto::TransactionSelector& s) {
+  return AsyncPrepareSession(*context, session)
+      .then([context, &session, &s](future<Status> f) -> future<Status> {
+        auto status = f.get();
+        if (!status.ok()) return make_ready_future(std::move(status));
+        if (s.has_single_use()) {
+          return make_ready_future(
+              Status(StatusCode::kInvalidArgument,
+                     "Cannot rollback a single-use transaction"));
+        }
+        // There is nothing to rollback if a transaction id has not yet been
+        // assigned, so we just succeed without making an RPC.
+        if (s.has_begin()) return make_ready_future(Status());
+
+        spanner_proto::RollbackRequest request;
+        request.set_session(session->session_name());
+        request.set_transaction_id(s.id());
+        auto stub = context->session_pool->GetStub(*session);
+        return internal::AsyncRetryLoop(
+                   context->retry_policy_prototype->clone(),
+                   context->backoff_policy_prototype->clone(),
+                   /*is_idempotent=*/true, context->cq,
+                   [stub](CompletionQueue& cq,
+                          std::unique_ptr<grpc::ClientContext> context,
+                          spanner_proto::RollbackRequest const& request) {
+                     return cq.MakeUnaryRpc(
+                         [stub](grpc::ClientContext* context,
+                                spanner_proto::RollbackRequest const& request,
+                                grpc::CompletionQueue* cq) {
+                           return stub->AsyncRollback(*context, request, cq);
+                         },
+                         request, std::move(context));
+                   },
+                   std::move(request), "AsyncRollback")
+            .then([&session](future<StatusOr<google::protobuf::Empty>> f) {
+              auto status = f.get().status();
+              if (internal::IsSessionNotFound(status)) session->set_bad();
+              return status;
+            });
+      });
+}
+
+}  // namespace
+
+future<RowStream> ConnectionImpl::AsyncRead(ReadParams params) {
+  auto context = async_context_;
+  auto txn = std::move(params.transaction);
+  return internal::AsyncVisit(
+      std::move(txn),
+      [context, params](SessionHolder& session,
+                        spanner_proto::TransactionSelector& s,
+                        std::int64_t) mutable {
+        return AsyncReadImpl(context, session, s, std::move(params));
+      });
+}
+
+future<RowStream> ConnectionImpl::AsyncExecuteQuery(SqlParams params) {
+  auto context = async_context_;
+  auto txn = std::move(params.transaction);
+  return internal::AsyncVisit(
+      std::move(txn),
+      [context, params](SessionHolder& session,
+                        spanner_proto::TransactionSelector& s,
+                        std::int64_t seqno) mutable {
+        return AsyncExecuteQueryImpl(context, session, s, seqno,
+                                     std::move(params));
+      });
+}
+
+future<StatusOr<DmlResult>> ConnectionImpl::AsyncExecuteDml(SqlParams params) {
+  auto context = async_context_;
+  auto txn = std::move(params.transaction);
+  return internal::AsyncVisit(
+      std::move(txn),
+      [context, params](SessionHolder& session,
+                        spanner_proto::TransactionSelector& s,
+                        std::int64_t seqno) mutable {
+        return AsyncExecuteDmlImpl(context, session, s, seqno,
+                                   std::move(params));
+      });
+}
+
+future<StatusOr<CommitResult>> ConnectionImpl::AsyncCommit(
+    CommitParams params) {
+  auto context = async_context_;
+  auto txn = std::move(params.transaction);
+  return internal::AsyncVisit(
+      std::move(txn),
+      [context, params](SessionHolder& session,
+                        spanner_proto::TransactionSelector& s,
+                        std::int64_t) mutable {
+        return AsyncCommitImpl(context, session, s, std::move(params));
+      });
+}
+
+future<Status> ConnectionImpl::AsyncRollback(RollbackParams params) {
+  auto context = async_context_;
+  return internal::AsyncVisit(
+      std::move(params.transaction),
+      [context](SessionHolder& session, spanner_proto::TransactionSelector& s,
+                std::int64_t) {
+        return AsyncRollbackImpl(context, session, s);
+      });
+}
+
+StatusOr<SessionPoolMetrics> ConnectionImpl::GetSessionPoolMetrics() {
+  return session_pool_->Metrics();
+}
+
 }  // namespace internal
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner
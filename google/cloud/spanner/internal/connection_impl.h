@@ -25,6 +25,7 @@
 #include "google/cloud/spanner/tracing_options.h"
 #include "google/cloud/spanner/version.h"
 #include "google/cloud/background_threads.h"
+#include "google/cloud/future.h"
 #include "google/cloud/status.h"
 #include "google/cloud/status_or.h"
 #include <google/spanner/v1/spanner.pb.h>
@@ -60,6 +61,9 @@ std::shared_ptr<ConnectionImpl> MakeConnection(
     std::unique_ptr<BackoffPolicy> backoff_policy =
         DefaultConnectionBackoffPolicy());
 
+/// The state shared by the asynchronous operations of a `ConnectionImpl`.
+struct AsyncConnectionContext;
+
 /**
  * A concrete `Connection` subclass that uses gRPC to actually talk to a real
  * Spanner instance. See `MakeConnection()` for a factory function that creates
@@ -83,6 +87,23 @@ class ConnectionImpl : public Connection {
   StatusOr<CommitResult> Commit(CommitParams) override;
   Status Rollback(RollbackParams) override;
 
+  /**
+   * @name Asynchronous operations.
+   *
+   * These run on the `CompletionQueue` of the connection's background threads.
+   * The `RowStream`s block while they wait for more results, so they must not
+   * be iterated on one of those threads.
+   */
+  //@{
+  future<RowStream> AsyncRead(ReadParams) override;
+  future<RowStream> AsyncExecuteQuery(SqlParams) override;
+  future<StatusOr<DmlResult>> AsyncExecuteDml(SqlParams) override;
+  future<StatusOr<CommitResult>> AsyncCommit(CommitParams) override;
+  future<Status> AsyncRollback(RollbackParams) override;
+  //@}
+
+  StatusOr<SessionPoolMetrics> GetSessionPoolMetrics() override;
+
  private:
   // Only the factory method can construct instances of this class.
   friend std::shared_ptr<ConnectionImpl> MakeConnection(
@@ -97,6 +118,8 @@ class ConnectionImpl : public Connection {
 
   Status PrepareSession(SessionHolder& session,
                         bool dissociate_from_pool = false);
+  Status PrepareSession(SessionHolder& session,
+                        google::spanner::v1::TransactionSelector& s);
 
   RowStream ReadImpl(SessionHolder& session,
                      google::spanner::v1::TransactionSelector& s,
@@ -172,6 +195,10 @@ class ConnectionImpl : public Connection {
   std::shared_ptr<SessionPool> session_pool_;
   bool rpc_stream_tracing_enabled_ = false;
   TracingOptions tracing_options_;
+  // The callbacks of the asynchronous operations hold on to this, rather than
+  // to `this`, as the last reference to a `ConnectionImpl` must not be
+  // released on one of its own background threads.
+  std::shared_ptr<AsyncConnectionContext> async_context_;
 };
 
 }  // namespace internal
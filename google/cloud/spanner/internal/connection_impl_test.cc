@@ -19,12 +19,17 @@
 #include "google/cloud/spanner/testing/mock_spanner_stub.h"
 #include "google/cloud/internal/make_unique.h"
 #include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/mock_async_response_reader.h"
+#include "google/cloud/testing_util/mock_completion_queue.h"
 #include <google/protobuf/text_format.h>
 #include <gmock/gmock.h>
 #include <array>
 #include <atomic>
 #include <chrono>
+#include <deque>
+#include <functional>
 #include <future>
+#include <memory>
 #include <string>
 #include <thread>
 #include <vector>
@@ -54,11 +59,14 @@ namespace {
 
 using ::google::cloud::internal::make_unique;
 using ::google::cloud::spanner_testing::HasSessionAndTransactionId;
+using ::google::cloud::testing_util::MockAsyncResponseReader;
+using ::google::cloud::testing_util::MockCompletionQueue;
 using ::google::protobuf::TextFormat;
 using ::testing::_;
 using ::testing::AtLeast;
 using ::testing::ByMove;
 using ::testing::DoAll;
+using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::HasSubstr;
 using ::testing::InSequence;
@@ -1547,6 +1555,36 @@ TEST(ConnectionImplTest, CommitSuccessWithTransactionId) {
   EXPECT_STATUS_OK(commit);
 }
 
+TEST(ConnectionImplTest, GetSessionPoolMetrics) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+
+  auto db = Database("dummy_project", "dummy_instance", "dummy_database_id");
+  auto conn = MakeConnection(db, {mock});
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+  EXPECT_CALL(*mock, Commit(_, _))
+      .WillOnce(Return(Status(StatusCode::kPermissionDenied, "uh-oh")));
+
+  {
+    // The transaction holds on to its session until it is destroyed.
+    auto txn = MakeReadWriteTransaction();
+    SetTransactionId(txn, "test-txn-id");
+    auto commit = conn->Commit({txn});
+    EXPECT_EQ(StatusCode::kPermissionDenied, commit.status().code());
+  }
+
+  auto metrics = conn->GetSessionPoolMetrics();
+  ASSERT_STATUS_OK(metrics);
+  EXPECT_EQ(1, metrics->total_sessions);
+  EXPECT_EQ(1, metrics->idle_sessions);
+  EXPECT_EQ(0, metrics->threads_waiting);
+  ASSERT_EQ(1, metrics->channels.size());
+  EXPECT_EQ(1, metrics->channels[0].session_count);
+  EXPECT_EQ(0, metrics->channels[0].sessions_in_use);
+  EXPECT_EQ(1, metrics->allocation_wait.count);
+  EXPECT_EQ(1, metrics->creation_latency.count);
+}
+
 TEST(ConnectionImplTest, RollbackGetSessionFailure) {
   auto db = Database("project", "instance", "database");
 
@@ -2385,6 +2423,872 @@ TEST(ConnectionImplTest, RollbackSessionNotFound) {
   EXPECT_THAT(txn, HasBadSession());
 }
 
+// Create a `Connection` for the asynchronous operations. Its session pool
+// creates a session (with the synchronous `BatchCreateSessions()`) up front,
+// so `AsyncAllocate()` is satisfied immediately, and all the RPCs and timers
+// run on @p impl.
+std::shared_ptr<Connection> MakeAsyncConnection(
+    Database const& db, std::shared_ptr<spanner_testing::MockSpannerStub> mock,
+    std::shared_ptr<MockCompletionQueue> impl) {
+  return MakeConnection(
+      db, {std::move(mock)},
+      ConnectionOptions{}.DisableBackgroundThreads(CompletionQueue(impl)),
+      SessionPoolOptions{}.set_min_sessions(1),
+      LimitedErrorCountRetryPolicy(/*maximum_failures=*/2).clone(),
+      ExponentialBackoffPolicy(/*initial_delay=*/std::chrono::microseconds(1),
+                               /*maximum_delay=*/std::chrono::microseconds(1),
+                               /*scaling=*/2.0)
+          .clone());
+}
+
+class MockAsyncGrpcReader
+    : public grpc::ClientAsyncReaderInterface<spanner_proto::PartialResultSet> {
+ public:
+  MOCK_METHOD1(StartCall, void(void*));
+  MOCK_METHOD1(ReadInitialMetadata, void(void*));
+  MOCK_METHOD2(Read, void(spanner_proto::PartialResultSet*, void*));
+  MOCK_METHOD2(Finish, void(grpc::Status*, void*));
+};
+
+// Returns a reader for a stream with a single @p response, which then finishes
+// with @p status.
+std::unique_ptr<MockAsyncGrpcReader> MakeAsyncGrpcReader(
+    spanner_proto::PartialResultSet const& response,
+    grpc::Status const& status = grpc::Status()) {
+  auto reader = make_unique<MockAsyncGrpcReader>();
+  EXPECT_CALL(*reader, StartCall(_)).Times(1);
+  EXPECT_CALL(*reader, Read(_, _))
+      .WillOnce([response](spanner_proto::PartialResultSet* r, void*) {
+        *r = response;
+      })
+      .WillOnce([](spanner_proto::PartialResultSet*, void*) {});
+  EXPECT_CALL(*reader, Finish(_, _))
+      .WillOnce([status](grpc::Status* s, void*) { *s = status; });
+  return reader;
+}
+
+// The pool replaces a session marked bad using `AsyncBatchCreateSessions()`.
+// The caller completes that RPC (and owns the returned reader) so the
+// replacement does not outlive the test.
+std::unique_ptr<
+    MockAsyncResponseReader<spanner_proto::BatchCreateSessionsResponse>>
+ExpectReplacementSession(spanner_testing::MockSpannerStub& mock) {
+  auto reader = make_unique<
+      MockAsyncResponseReader<spanner_proto::BatchCreateSessionsResponse>>();
+  auto* r = reader.get();
+  EXPECT_CALL(mock, AsyncBatchCreateSessions(_, _, _))
+      .WillOnce([r](grpc::ClientContext&,
+                    spanner_proto::BatchCreateSessionsRequest const&,
+                    grpc::CompletionQueue*) {
+        // This is safe. See comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            spanner_proto::BatchCreateSessionsResponse>>(r);
+      });
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce([](spanner_proto::BatchCreateSessionsResponse* response,
+                   grpc::Status* status, void*) {
+        response->add_session()->set_name("replacement-session");
+        *status = grpc::Status::OK;
+      });
+  return reader;
+}
+
+// Simulates the completion of a stream created by `MakeAsyncGrpcReader()`,
+// after its first response has been delivered.
+void FinishAsyncStream(MockCompletionQueue& impl) {
+  impl.SimulateCompletion(false);  // The second `Read()`.
+  impl.SimulateCompletion(true);   // `Finish()`.
+}
+
+TEST(ConnectionImplTest, AsyncReadSuccess) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+  auto constexpr kText = R"pb(
+    metadata: {
+      row_type: {
+        fields: {
+          name: "UserId",
+          type: { code: INT64 }
+        }
+        fields: {
+          name: "UserName",
+          type: { code: STRING }
+        }
+      }
+    }
+    values: { string_value: "12" }
+    values: { string_value: "Steve" }
+    values: { string_value: "42" }
+    values: { string_value: "Ann" }
+  )pb";
+  spanner_proto::PartialResultSet response;
+  ASSERT_TRUE(TextFormat::ParseFromString(kText, &response));
+  EXPECT_CALL(*mock, PrepareAsyncStreamingRead(_, _, _))
+      .WillOnce([&response](grpc::ClientContext&,
+                            spanner_proto::ReadRequest const& request,
+                            grpc::CompletionQueue*) {
+        EXPECT_EQ("test-session-name", request.session());
+        EXPECT_TRUE(request.transaction().has_single_use());
+        return std::unique_ptr<grpc::ClientAsyncReaderInterface<
+            spanner_proto::PartialResultSet>>(MakeAsyncGrpcReader(response));
+      });
+
+  auto db = Database("project", "instance", "database");
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = MakeAsyncConnection(db, mock, impl);
+  auto f =
+      conn->AsyncRead({MakeSingleUseTransaction(Transaction::ReadOnlyOptions()),
+                       "table",
+                       KeySet::All(),
+                       {"UserId", "UserName"}});
+  impl->SimulateCompletion(true);  // `StartCall()`
+  EXPECT_EQ(std::future_status::timeout,
+            f.wait_for(std::chrono::milliseconds(0)));
+  impl->SimulateCompletion(true);  // The first `Read()`.
+  ASSERT_EQ(std::future_status::ready,
+            f.wait_for(std::chrono::milliseconds(0)));
+  auto rows = f.get();
+  FinishAsyncStream(*impl);
+
+  using RowType = std::tuple<std::int64_t, std::string>;
+  auto expected = std::vector<RowType>{
+      RowType(12, "Steve"),
+      RowType(42, "Ann"),
+  };
+  int row_number = 0;
+  for (auto& row : StreamOf<RowType>(rows)) {
+    ASSERT_STATUS_OK(row);
+    EXPECT_EQ(*row, expected[row_number]);
+    ++row_number;
+  }
+  EXPECT_EQ(row_number, expected.size());
+}
+
+TEST(ConnectionImplTest, AsyncReadImplicitBeginTransaction) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+  auto constexpr kText = R"pb(metadata: { transaction: { id: "ABCDEF00" } })pb";
+  spanner_proto::PartialResultSet response;
+  ASSERT_TRUE(TextFormat::ParseFromString(kText, &response));
+  EXPECT_CALL(*mock, PrepareAsyncStreamingRead(
+                         _, ReadRequestHasSessionAndBeginTransaction(
+                                "test-session-name"),
+                         _))
+      .WillOnce([&response](grpc::ClientContext&,
+                            spanner_proto::ReadRequest const&,
+                            grpc::CompletionQueue*) {
+        return std::unique_ptr<grpc::ClientAsyncReaderInterface<
+            spanner_proto::PartialResultSet>>(MakeAsyncGrpcReader(response));
+      });
+
+  auto db = Database("project", "instance", "database");
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = MakeAsyncConnection(db, mock, impl);
+  Transaction txn = MakeReadOnlyTransaction(Transaction::ReadOnlyOptions());
+  auto f = conn->AsyncRead({txn, "table", KeySet::All(), {"UserId"}});
+  impl->SimulateCompletion(true);  // `StartCall()`
+  impl->SimulateCompletion(true);  // The first `Read()`.
+  auto rows = f.get();
+  FinishAsyncStream(*impl);
+  for (auto& row : rows) {
+    EXPECT_STATUS_OK(row);
+  }
+  EXPECT_THAT(txn, HasSessionAndTransactionId("test-session-name", "ABCDEF00"));
+}
+
+TEST(ConnectionImplTest, AsyncExecuteQueryImplicitBeginTransaction) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+  auto constexpr kText = R"pb(
+    metadata: {
+      row_type: {
+        fields: {
+          name: "UserId",
+          type: { code: INT64 }
+        }
+      }
+      transaction: { id: "ABCDEF00" }
+    }
+    values: { string_value: "12" }
+  )pb";
+  spanner_proto::PartialResultSet response;
+  ASSERT_TRUE(TextFormat::ParseFromString(kText, &response));
+  EXPECT_CALL(*mock, PrepareAsyncExecuteStreamingSql(_, _, _))
+      .WillOnce([&response](grpc::ClientContext&,
+                            spanner_proto::ExecuteSqlRequest const& request,
+                            grpc::CompletionQueue*) {
+        EXPECT_EQ("test-session-name", request.session());
+        EXPECT_TRUE(request.transaction().has_begin());
+        EXPECT_EQ("select * from table", request.sql());
+        return std::unique_ptr<grpc::ClientAsyncReaderInterface<
+            spanner_proto::PartialResultSet>>(MakeAsyncGrpcReader(response));
+      });
+
+  auto db = Database("project", "instance", "database");
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = MakeAsyncConnection(db, mock, impl);
+  Transaction txn = MakeReadOnlyTransaction(Transaction::ReadOnlyOptions());
+  auto f = conn->AsyncExecuteQuery({txn, SqlStatement("select * from table")});
+  impl->SimulateCompletion(true);  // `StartCall()`
+  impl->SimulateCompletion(true);  // The first `Read()`.
+  auto rows = f.get();
+  FinishAsyncStream(*impl);
+  EXPECT_THAT(txn, HasSessionAndTransactionId("test-session-name", "ABCDEF00"));
+
+  int row_number = 0;
+  for (auto& row : StreamOf<std::tuple<std::int64_t>>(rows)) {
+    ASSERT_STATUS_OK(row);
+    EXPECT_EQ(12, std::get<0>(*row));
+    ++row_number;
+  }
+  EXPECT_EQ(1, row_number);
+}
+
+TEST(ConnectionImplTest, AsyncExecuteQueryBeginTransactionWithoutId) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+  auto constexpr kText = R"pb(
+    metadata: {
+      row_type: {
+        fields: {
+          name: "UserId",
+          type: { code: INT64 }
+        }
+      }
+    }
+  )pb";
+  spanner_proto::PartialResultSet response;
+  ASSERT_TRUE(TextFormat::ParseFromString(kText, &response));
+  EXPECT_CALL(*mock, PrepareAsyncExecuteStreamingSql(_, _, _))
+      .WillOnce([&response](grpc::ClientContext&,
+                            spanner_proto::ExecuteSqlRequest const&,
+                            grpc::CompletionQueue*) {
+        return std::unique_ptr<grpc::ClientAsyncReaderInterface<
+            spanner_proto::PartialResultSet>>(MakeAsyncGrpcReader(response));
+      });
+
+  auto db = Database("project", "instance", "database");
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = MakeAsyncConnection(db, mock, impl);
+  Transaction txn = MakeReadOnlyTransaction(Transaction::ReadOnlyOptions());
+  auto f = conn->AsyncExecuteQuery({txn, SqlStatement("select * from table")});
+  impl->SimulateCompletion(true);  // `StartCall()`
+  impl->SimulateCompletion(true);  // The first `Read()`.
+  auto rows = f.get();
+  FinishAsyncStream(*impl);
+  auto begin = rows.begin();
+  ASSERT_NE(begin, rows.end());
+  EXPECT_EQ(StatusCode::kInternal, begin->status().code());
+  EXPECT_THAT(begin->status().message(),
+              HasSubstr("Begin transaction requested"));
+}
+
+TEST(ConnectionImplTest, AsyncExecuteQuerySessionNotFound) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+  EXPECT_CALL(*mock, PrepareAsyncExecuteStreamingSql(_, _, _))
+      .WillOnce([](grpc::ClientContext&,
+                   spanner_proto::ExecuteSqlRequest const&,
+                   grpc::CompletionQueue*) {
+        auto reader = make_unique<MockAsyncGrpcReader>();
+        EXPECT_CALL(*reader, StartCall(_)).Times(1);
+        EXPECT_CALL(*reader, Read(_, _)).Times(1);
+        EXPECT_CALL(*reader, Finish(_, _))
+            .WillOnce([](grpc::Status* status, void*) {
+              *status = grpc::Status(grpc::StatusCode::NOT_FOUND,
+                                     "Session not found");
+            });
+        return std::unique_ptr<grpc::ClientAsyncReaderInterface<
+            spanner_proto::PartialResultSet>>(std::move(reader));
+      });
+  auto replacement = ExpectReplacementSession(*mock);
+
+  auto db = Database("project", "instance", "database");
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = MakeAsyncConnection(db, mock, impl);
+  auto txn = MakeReadWriteTransaction();
+  SetTransactionId(txn, "test-txn-id");
+  auto f = conn->AsyncExecuteQuery({txn, SqlStatement("select * from table")});
+  impl->SimulateCompletion(true);   // `StartCall()`
+  impl->SimulateCompletion(false);  // `Read()`, there are no responses.
+  impl->SimulateCompletion(true);   // `Finish()`
+  auto rows = f.get();
+  auto begin = rows.begin();
+  ASSERT_NE(begin, rows.end());
+  EXPECT_TRUE(IsSessionNotFound(begin->status())) << begin->status();
+  EXPECT_THAT(txn, HasBadSession());
+  txn = MakeReadWriteTransaction();  // Release the bad session.
+  impl->SimulateCompletion(true);    // The replacement session.
+}
+
+TEST(ConnectionImplTest, AsyncExecuteQueryResumeOnCompletionQueue) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+  spanner_proto::PartialResultSet first;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"pb(
+        metadata: {
+          row_type: {
+            fields: {
+              name: "UserId",
+              type: { code: INT64 }
+            }
+          }
+        }
+        values: { string_value: "12" }
+        resume_token: "resume-after-12"
+      )pb",
+      &first));
+  spanner_proto::PartialResultSet second;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"pb(values: { string_value: "42" })pb", &second));
+  EXPECT_CALL(*mock, PrepareAsyncExecuteStreamingSql(_, _, _))
+      .WillOnce([&first](grpc::ClientContext&,
+                         spanner_proto::ExecuteSqlRequest const& request,
+                         grpc::CompletionQueue*) {
+        EXPECT_TRUE(request.resume_token().empty());
+        return std::unique_ptr<grpc::ClientAsyncReaderInterface<
+            spanner_proto::PartialResultSet>>(MakeAsyncGrpcReader(
+            first, grpc::Status(grpc::StatusCode::UNAVAILABLE, "try-again")));
+      })
+      .WillOnce([&second](grpc::ClientContext&,
+                          spanner_proto::ExecuteSqlRequest const& request,
+                          grpc::CompletionQueue*) {
+        EXPECT_EQ("resume-after-12", request.resume_token());
+        return std::unique_ptr<grpc::ClientAsyncReaderInterface<
+            spanner_proto::PartialResultSet>>(MakeAsyncGrpcReader(second));
+      });
+
+  // The test thread is the only thread running the `CompletionQueue`, and it
+  // consumes the rows from the `WhenRowReady()` callbacks, like a coroutine
+  // would. Any blocking call in those callbacks would deadlock the test.
+  auto db = Database("project", "instance", "database");
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = MakeAsyncConnection(db, mock, impl);
+  auto f = conn->AsyncExecuteQuery(
+      {MakeSingleUseTransaction(Transaction::ReadOnlyOptions()),
+       SqlStatement("select * from table")});
+  impl->SimulateCompletion(true);  // `StartCall()`
+  impl->SimulateCompletion(true);  // The first `Read()`.
+  ASSERT_EQ(std::future_status::ready,
+            f.wait_for(std::chrono::milliseconds(0)));
+  auto rows = f.get();
+
+  std::vector<std::int64_t> values;
+  optional<Status> done;
+  RowStreamIterator it;
+  bool started = false;
+  std::function<void()> consume = [&] {
+    for (;;) {
+      auto ready = rows.WhenRowReady();
+      if (ready.wait_for(std::chrono::milliseconds(0)) !=
+          std::future_status::ready) {
+        ready.then([&consume](future<void>) { consume(); });
+        return;
+      }
+      if (!started) {
+        started = true;
+        it = rows.begin();
+      } else {
+        ++it;
+      }
+      if (it == rows.end()) {
+        done = Status();
+        return;
+      }
+      if (!*it) {
+        done = it->status();
+        return;
+      }
+      auto value = (*it)->get<std::int64_t>(0);
+      ASSERT_STATUS_OK(value);
+      values.push_back(*value);
+    }
+  };
+  consume();
+  EXPECT_THAT(values, ElementsAre(12));
+
+  FinishAsyncStream(*impl);  // The first stream fails with UNAVAILABLE.
+  EXPECT_FALSE(done.has_value());
+  impl->SimulateCompletion(true);  // The backoff timer.
+  impl->SimulateCompletion(true);  // `StartCall()`
+  impl->SimulateCompletion(true);  // The first `Read()`.
+  EXPECT_THAT(values, ElementsAre(12, 42));
+  FinishAsyncStream(*impl);
+  ASSERT_TRUE(done.has_value());
+  EXPECT_STATUS_OK(*done);
+}
+
+TEST(ConnectionImplTest, AsyncExecuteDmlImplicitBeginTransaction) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+  auto reader =
+      make_unique<MockAsyncResponseReader<spanner_proto::ResultSet>>();
+  EXPECT_CALL(*mock, AsyncExecuteSql(_, _, _))
+      .WillOnce([&reader](grpc::ClientContext&,
+                          spanner_proto::ExecuteSqlRequest const& request,
+                          grpc::CompletionQueue*) {
+        EXPECT_EQ("test-session-name", request.session());
+        EXPECT_TRUE(request.transaction().begin().has_read_write());
+        EXPECT_EQ("delete * from table", request.sql());
+        // This is safe. See comments in MockAsyncResponseReader.
+        return std::unique_ptr<
+            grpc::ClientAsyncResponseReaderInterface<spanner_proto::ResultSet>>(
+            reader.get());
+      });
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce([](spanner_proto::ResultSet* response, grpc::Status* status,
+                   void*) {
+        auto constexpr kText = R"pb(
+          metadata: { transaction: { id: "1234567890" } }
+          stats: { row_count_exact: 42 }
+        )pb";
+        ASSERT_TRUE(TextFormat::ParseFromString(kText, response));
+        *status = grpc::Status::OK;
+      });
+
+  auto db = Database("project", "instance", "database");
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = MakeAsyncConnection(db, mock, impl);
+  auto txn = MakeReadWriteTransaction();
+  auto f = conn->AsyncExecuteDml({txn, SqlStatement("delete * from table")});
+  impl->SimulateCompletion(true);
+  auto result = f.get();
+  ASSERT_STATUS_OK(result);
+  EXPECT_EQ(42, result->RowsModified());
+  EXPECT_THAT(txn,
+              HasSessionAndTransactionId("test-session-name", "1234567890"));
+}
+
+TEST(ConnectionImplTest, AsyncCommitWithTransactionId) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+  auto reader =
+      make_unique<MockAsyncResponseReader<spanner_proto::CommitResponse>>();
+  EXPECT_CALL(*mock, AsyncCommit(_, _, _))
+      .WillOnce([&reader](grpc::ClientContext&,
+                          spanner_proto::CommitRequest const& request,
+                          grpc::CompletionQueue*) {
+        EXPECT_EQ("test-session-name", request.session());
+        EXPECT_EQ("test-txn-id", request.transaction_id());
+        // This is safe. See comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            spanner_proto::CommitResponse>>(reader.get());
+      });
+  auto const timestamp =
+      MakeTimestamp(std::chrono::system_clock::from_time_t(123)).value();
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce([timestamp](spanner_proto::CommitResponse* response,
+                            grpc::Status* status, void*) {
+        *response->mutable_commit_timestamp() =
+            internal::TimestampToProto(timestamp);
+        *status = grpc::Status::OK;
+      });
+
+  auto db = Database("project", "instance", "database");
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = MakeAsyncConnection(db, mock, impl);
+  auto txn = MakeReadWriteTransaction();
+  SetTransactionId(txn, "test-txn-id");
+  auto f = conn->AsyncCommit({txn});
+  EXPECT_EQ(std::future_status::timeout,
+            f.wait_for(std::chrono::milliseconds(0)));
+  impl->SimulateCompletion(true);
+  auto commit = f.get();
+  ASSERT_STATUS_OK(commit);
+  EXPECT_EQ(timestamp, commit->commit_timestamp);
+}
+
+TEST(ConnectionImplTest, AsyncCommitBeginTransaction) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+  auto begin_reader =
+      make_unique<MockAsyncResponseReader<spanner_proto::Transaction>>();
+  EXPECT_CALL(*mock, AsyncBeginTransaction(_, _, _))
+      .WillOnce([&begin_reader](
+                    grpc::ClientContext&,
+                    spanner_proto::BeginTransactionRequest const& request,
+                    grpc::CompletionQueue*) {
+        EXPECT_EQ("test-session-name", request.session());
+        EXPECT_TRUE(request.options().has_read_write());
+        // This is safe. See comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            spanner_proto::Transaction>>(begin_reader.get());
+      });
+  EXPECT_CALL(*begin_reader, Finish(_, _, _))
+      .WillOnce([](spanner_proto::Transaction* response, grpc::Status* status,
+                   void*) {
+        response->set_id("test-txn-id");
+        *status = grpc::Status::OK;
+      });
+  auto commit_reader =
+      make_unique<MockAsyncResponseReader<spanner_proto::CommitResponse>>();
+  EXPECT_CALL(*mock, AsyncCommit(_, _, _))
+      .WillOnce([&commit_reader](grpc::ClientContext&,
+                                 spanner_proto::CommitRequest const& request,
+                                 grpc::CompletionQueue*) {
+        EXPECT_EQ("test-session-name", request.session());
+        EXPECT_EQ("test-txn-id", request.transaction_id());
+        // This is safe. See comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            spanner_proto::CommitResponse>>(commit_reader.get());
+      });
+  EXPECT_CALL(*commit_reader, Finish(_, _, _))
+      .WillOnce([](spanner_proto::CommitResponse*, grpc::Status* status,
+                   void*) { *status = grpc::Status::OK; });
+
+  auto db = Database("project", "instance", "database");
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = MakeAsyncConnection(db, mock, impl);
+  auto txn = MakeReadWriteTransaction();
+  auto f = conn->AsyncCommit({txn});
+  impl->SimulateCompletion(true);  // `BeginTransaction()`
+  EXPECT_EQ(std::future_status::timeout,
+            f.wait_for(std::chrono::milliseconds(0)));
+  impl->SimulateCompletion(true);  // `Commit()`
+  EXPECT_STATUS_OK(f.get());
+  EXPECT_THAT(txn,
+              HasSessionAndTransactionId("test-session-name", "test-txn-id"));
+}
+
+TEST(ConnectionImplTest, AsyncCommitRetryTransientFailure) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+  auto reader1 =
+      make_unique<MockAsyncResponseReader<spanner_proto::CommitResponse>>();
+  EXPECT_CALL(*reader1, Finish(_, _, _))
+      .WillOnce([](spanner_proto::CommitResponse*, grpc::Status* status,
+                   void*) {
+        *status = grpc::Status(grpc::StatusCode::UNAVAILABLE, "try-again");
+      });
+  auto reader2 =
+      make_unique<MockAsyncResponseReader<spanner_proto::CommitResponse>>();
+  EXPECT_CALL(*reader2, Finish(_, _, _))
+      .WillOnce([](spanner_proto::CommitResponse*, grpc::Status* status,
+                   void*) { *status = grpc::Status::OK; });
+  EXPECT_CALL(*mock, AsyncCommit(_, _, _))
+      .WillOnce([&reader1](grpc::ClientContext&,
+                           spanner_proto::CommitRequest const&,
+                           grpc::CompletionQueue*) {
+        // This is safe. See comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            spanner_proto::CommitResponse>>(reader1.get());
+      })
+      .WillOnce([&reader2](grpc::ClientContext&,
+                           spanner_proto::CommitRequest const& request,
+                           grpc::CompletionQueue*) {
+        EXPECT_EQ("test-txn-id", request.transaction_id());
+        // This is safe. See comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            spanner_proto::CommitResponse>>(reader2.get());
+      });
+
+  auto db = Database("project", "instance", "database");
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = MakeAsyncConnection(db, mock, impl);
+  auto txn = MakeReadWriteTransaction();
+  SetTransactionId(txn, "test-txn-id");
+  auto f = conn->AsyncCommit({txn});
+  impl->SimulateCompletion(true);  // The first `Commit()` fails.
+  impl->SimulateCompletion(true);  // The backoff timer.
+  EXPECT_EQ(std::future_status::timeout,
+            f.wait_for(std::chrono::milliseconds(0)));
+  impl->SimulateCompletion(true);  // The second `Commit()`.
+  EXPECT_STATUS_OK(f.get());
+}
+
+TEST(ConnectionImplTest, AsyncCommitSessionNotFound) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+  auto reader =
+      make_unique<MockAsyncResponseReader<spanner_proto::CommitResponse>>();
+  EXPECT_CALL(*mock, AsyncCommit(_, _, _))
+      .WillOnce([&reader](grpc::ClientContext&,
+                          spanner_proto::CommitRequest const&,
+                          grpc::CompletionQueue*) {
+        // This is safe. See comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            spanner_proto::CommitResponse>>(reader.get());
+      });
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce([](spanner_proto::CommitResponse*, grpc::Status* status,
+                   void*) {
+        *status =
+            grpc::Status(grpc::StatusCode::NOT_FOUND, "Session not found");
+      });
+  auto replacement = ExpectReplacementSession(*mock);
+
+  auto db = Database("project", "instance", "database");
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = MakeAsyncConnection(db, mock, impl);
+  auto txn = MakeReadWriteTransaction();
+  SetTransactionId(txn, "test-txn-id");
+  auto f = conn->AsyncCommit({txn});
+  impl->SimulateCompletion(true);
+  auto commit = f.get();
+  EXPECT_TRUE(IsSessionNotFound(commit.status())) << commit.status();
+  EXPECT_THAT(txn, HasBadSession());
+  txn = MakeReadWriteTransaction();  // Release the bad session.
+  impl->SimulateCompletion(true);    // The replacement session.
+}
+
+TEST(ConnectionImplTest, AsyncRollbackSingleUseTransaction) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+  EXPECT_CALL(*mock, AsyncRollback(_, _, _)).Times(0);
+
+  auto db = Database("project", "instance", "database");
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = MakeAsyncConnection(db, mock, impl);
+  auto txn = internal::MakeSingleUseTransaction(
+      Transaction::SingleUseOptions{Transaction::ReadOnlyOptions{}});
+  auto status = conn->AsyncRollback({txn}).get();
+  EXPECT_EQ(StatusCode::kInvalidArgument, status.code());
+  EXPECT_THAT(status.message(), HasSubstr("Cannot rollback"));
+}
+
+TEST(ConnectionImplTest, AsyncRollbackBeginTransaction) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+  EXPECT_CALL(*mock, AsyncRollback(_, _, _)).Times(0);
+
+  auto db = Database("project", "instance", "database");
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = MakeAsyncConnection(db, mock, impl);
+  auto txn = MakeReadWriteTransaction();
+  EXPECT_STATUS_OK(conn->AsyncRollback({txn}).get());
+}
+
+TEST(ConnectionImplTest, AsyncRollbackWithTransactionId) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+  auto reader = make_unique<MockAsyncResponseReader<google::protobuf::Empty>>();
+  EXPECT_CALL(*mock, AsyncRollback(_, _, _))
+      .WillOnce([&reader](grpc::ClientContext&,
+                          spanner_proto::RollbackRequest const& request,
+                          grpc::CompletionQueue*) {
+        EXPECT_EQ("test-session-name", request.session());
+        EXPECT_EQ("test-txn-id", request.transaction_id());
+        // This is safe. See comments in MockAsyncResponseReader.
+        return std::unique_ptr<
+            grpc::ClientAsyncResponseReaderInterface<google::protobuf::Empty>>(
+            reader.get());
+      });
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce([](google::protobuf::Empty*, grpc::Status* status, void*) {
+        *status = grpc::Status::OK;
+      });
+
+  auto db = Database("project", "instance", "database");
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = MakeAsyncConnection(db, mock, impl);
+  auto txn = MakeReadWriteTransaction();
+  SetTransactionId(txn, "test-txn-id");
+  auto f = conn->AsyncRollback({txn});
+  impl->SimulateCompletion(true);
+  EXPECT_STATUS_OK(f.get());
+}
+
+// Returns a reader for a stream with @p responses, which then finishes with
+// @p status. Each operation the stream starts increments @p started.
+std::unique_ptr<MockAsyncGrpcReader> MakePrefetchGrpcReader(
+    std::vector<spanner_proto::PartialResultSet> const& responses,
+    grpc::Status const& status, std::atomic<int>& started) {
+  auto pending = std::make_shared<std::deque<spanner_proto::PartialResultSet>>(
+      responses.begin(), responses.end());
+  auto reader = make_unique<MockAsyncGrpcReader>();
+  EXPECT_CALL(*reader, StartCall(_)).WillOnce([&started](void*) {
+    ++started;
+  });
+  EXPECT_CALL(*reader, Read(_, _))
+      .Times(static_cast<int>(responses.size()) + 1)
+      .WillRepeatedly(
+          [pending, &started](spanner_proto::PartialResultSet* r, void*) {
+            if (!pending->empty()) {
+              *r = std::move(pending->front());
+              pending->pop_front();
+            }
+            ++started;
+          });
+  EXPECT_CALL(*reader, Finish(_, _))
+      .WillOnce([status, &started](grpc::Status* s, void*) {
+        *s = status;
+        ++started;
+      });
+  return reader;
+}
+
+// Waits for the blocking call, running on another thread, to start its next
+// operation on @p impl, and completes that operation with @p ok.
+void CompleteNextOperation(MockCompletionQueue& impl,
+                           std::atomic<int> const& started, int& completed,
+                           bool ok) {
+  while (started.load() == completed) std::this_thread::yield();
+  ++completed;
+  impl.SimulateCompletion(ok);
+}
+
+// Waits for the stream, running on another thread, to schedule its backoff
+// timer on @p impl, and fires that timer.
+void CompleteBackoffTimer(MockCompletionQueue& impl) {
+  while (impl.size() == 0) std::this_thread::yield();
+  impl.SimulateCompletion(true);
+}
+
+TEST(ConnectionImplTest, ReadPrefetchSuccess) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+  std::vector<spanner_proto::PartialResultSet> responses(2);
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"pb(
+        metadata: {
+          row_type: {
+            fields: {
+              name: "UserId",
+              type: { code: INT64 }
+            }
+          }
+        }
+        values: { string_value: "12" }
+      )pb",
+      &responses[0]));
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"pb(values: { string_value: "42" })pb", &responses[1]));
+  std::atomic<int> started(0);
+  EXPECT_CALL(*mock, StreamingRead(_, _)).Times(0);
+  EXPECT_CALL(*mock, PrepareAsyncStreamingRead(_, _, _))
+      .WillOnce([&](grpc::ClientContext&,
+                    spanner_proto::ReadRequest const& request,
+                    grpc::CompletionQueue*) {
+        EXPECT_EQ("test-session-name", request.session());
+        return std::unique_ptr<grpc::ClientAsyncReaderInterface<
+            spanner_proto::PartialResultSet>>(
+            MakePrefetchGrpcReader(responses, grpc::Status(), started));
+      });
+
+  auto db = Database("project", "instance", "database");
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = MakeAsyncConnection(db, mock, impl);
+  ReadOptions read_options;
+  read_options.prefetch_buffer_bytes = 1024;
+  auto result = std::async(std::launch::async, [&] {
+    auto rows =
+        conn->Read({MakeSingleUseTransaction(Transaction::ReadOnlyOptions()),
+                    "table",
+                    KeySet::All(),
+                    {"UserId"},
+                    read_options});
+    std::vector<std::int64_t> values;
+    for (auto& row : StreamOf<std::tuple<std::int64_t>>(rows)) {
+      if (!row) return StatusOr<std::vector<std::int64_t>>(row.status());
+      values.push_back(std::get<0>(*row));
+    }
+    return StatusOr<std::vector<std::int64_t>>(std::move(values));
+  });
+
+  int completed = 0;
+  CompleteNextOperation(*impl, started, completed, true);   // `StartCall()`
+  CompleteNextOperation(*impl, started, completed, true);   // `Read()`
+  CompleteNextOperation(*impl, started, completed, true);   // `Read()`
+  CompleteNextOperation(*impl, started, completed, false);  // The end.
+  CompleteNextOperation(*impl, started, completed, true);   // `Finish()`
+  auto values = result.get();
+  ASSERT_STATUS_OK(values);
+  EXPECT_THAT(*values, ElementsAre(12, 42));
+}
+
+TEST(ConnectionImplTest, ExecuteQueryPrefetchResume) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+  std::vector<spanner_proto::PartialResultSet> first(1);
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"pb(
+        metadata: {
+          row_type: {
+            fields: {
+              name: "UserId",
+              type: { code: INT64 }
+            }
+          }
+        }
+        values: { string_value: "12" }
+        resume_token: "resume-after-12"
+      )pb",
+      &first[0]));
+  std::vector<spanner_proto::PartialResultSet> second(1);
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"pb(values: { string_value: "42" })pb", &second[0]));
+  std::atomic<int> started(0);
+  EXPECT_CALL(*mock, ExecuteStreamingSql(_, _)).Times(0);
+  EXPECT_CALL(*mock, PrepareAsyncExecuteStreamingSql(_, _, _))
+      .WillOnce([&](grpc::ClientContext&,
+                    spanner_proto::ExecuteSqlRequest const& request,
+                    grpc::CompletionQueue*) {
+        EXPECT_TRUE(request.resume_token().empty());
+        return std::unique_ptr<grpc::ClientAsyncReaderInterface<
+            spanner_proto::PartialResultSet>>(MakePrefetchGrpcReader(
+            first, grpc::Status(grpc::StatusCode::UNAVAILABLE, "try-again"),
+            started));
+      })
+      .WillOnce([&](grpc::ClientContext&,
+                    spanner_proto::ExecuteSqlRequest const& request,
+                    grpc::CompletionQueue*) {
+        EXPECT_EQ("resume-after-12", request.resume_token());
+        return std::unique_ptr<grpc::ClientAsyncReaderInterface<
+            spanner_proto::PartialResultSet>>(
+            MakePrefetchGrpcReader(second, grpc::Status(), started));
+      });
+
+  auto db = Database("project", "instance", "database");
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto conn = MakeAsyncConnection(db, mock, impl);
+  auto result = std::async(std::launch::async, [&] {
+    auto rows = conn->ExecuteQuery(
+        {MakeSingleUseTransaction(Transaction::ReadOnlyOptions()),
+         SqlStatement("select * from table"),
+         QueryOptions().set_prefetch_buffer_bytes(1024)});
+    std::vector<std::int64_t> values;
+    for (auto& row : StreamOf<std::tuple<std::int64_t>>(rows)) {
+      if (!row) return StatusOr<std::vector<std::int64_t>>(row.status());
+      values.push_back(std::get<0>(*row));
+    }
+    return StatusOr<std::vector<std::int64_t>>(std::move(values));
+  });
+
+  int completed = 0;
+  // The first stream fails after one response.
+  CompleteNextOperation(*impl, started, completed, true);   // `StartCall()`
+  CompleteNextOperation(*impl, started, completed, true);   // `Read()`
+  CompleteNextOperation(*impl, started, completed, false);  // The end.
+  CompleteNextOperation(*impl, started, completed, true);   // `Finish()`
+  // The backoff before resuming runs on the completion queue.
+  CompleteBackoffTimer(*impl);
+  // The second stream resumes after the first response.
+  CompleteNextOperation(*impl, started, completed, true);   // `StartCall()`
+  CompleteNextOperation(*impl, started, completed, true);   // `Read()`
+  CompleteNextOperation(*impl, started, completed, false);  // The end.
+  CompleteNextOperation(*impl, started, completed, true);   // `Finish()`
+  auto values = result.get();
+  ASSERT_STATUS_OK(values);
+  EXPECT_THAT(*values, ElementsAre(12, 42));
+}
+
 #if defined(__GNUC__) || defined(__clang__)
 #pragma GCC diagnostic pop
 #endif
@@ -132,6 +132,12 @@ class DatabaseAdminLogging : public DatabaseAdminStub {
       grpc::ClientContext& context,
       google::longrunning::GetOperationRequest const& request) override;
 
+  std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+      google::longrunning::Operation>>
+  AsyncGetOperation(grpc::ClientContext& context,
+                    google::longrunning::GetOperationRequest const& request,
+                    grpc::CompletionQueue* cq) override;
+
   Status CancelOperation(
       grpc::ClientContext& context,
       google::longrunning::CancelOperationRequest const& request) override;
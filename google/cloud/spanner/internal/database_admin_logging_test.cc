@@ -308,6 +308,25 @@ TEST_F(DatabaseAdminLoggingTest, GetOperation) {
   HasLogLineWith(TransientError().message());
 }
 
+TEST_F(DatabaseAdminLoggingTest, AsyncGetOperation) {
+  EXPECT_CALL(*mock_, AsyncGetOperation(_, _, _))
+      .WillOnce([](grpc::ClientContext&,
+                   google::longrunning::GetOperationRequest const&,
+                   grpc::CompletionQueue*) {
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            google::longrunning::Operation>>{};
+      });
+
+  DatabaseAdminLogging stub(mock_, TracingOptions{});
+  grpc::ClientContext context;
+  grpc::CompletionQueue cq;
+  auto reader = stub.AsyncGetOperation(
+      context, google::longrunning::GetOperationRequest{}, &cq);
+  EXPECT_FALSE(reader);
+  HasLogLineWith("AsyncGetOperation");
+  HasLogLineWith(" null async response reader");
+}
+
 TEST_F(DatabaseAdminLoggingTest, CancelOperation) {
   EXPECT_CALL(*mock_, CancelOperation(_, _)).WillOnce(Return(TransientError()));
 
@@ -124,6 +124,12 @@ class DatabaseAdminMetadata : public DatabaseAdminStub {
       grpc::ClientContext& context,
       google::longrunning::GetOperationRequest const& request) override;
 
+  std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+      google::longrunning::Operation>>
+  AsyncGetOperation(grpc::ClientContext& context,
+                    google::longrunning::GetOperationRequest const& request,
+                    grpc::CompletionQueue* cq) override;
+
   Status CancelOperation(
       grpc::ClientContext& context,
       google::longrunning::CancelOperationRequest const& request) override;
@@ -409,6 +409,27 @@ TEST_F(DatabaseAdminMetadataTest, GetOperation) {
   EXPECT_EQ(TransientError(), status.status());
 }
 
+TEST_F(DatabaseAdminMetadataTest, AsyncGetOperation) {
+  EXPECT_CALL(*mock_, AsyncGetOperation(_, _, _))
+      .WillOnce([this](grpc::ClientContext& context,
+                       google::longrunning::GetOperationRequest const&,
+                       grpc::CompletionQueue*) {
+        EXPECT_STATUS_OK(spanner_testing::IsContextMDValid(
+            context, "google.longrunning.Operations.GetOperation",
+            expected_api_client_header_));
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            google::longrunning::Operation>>{};
+      });
+
+  DatabaseAdminMetadata stub(mock_);
+  grpc::ClientContext context;
+  grpc::CompletionQueue cq;
+  google::longrunning::GetOperationRequest request;
+  request.set_name("operations/fake-operation-name");
+  auto reader = stub.AsyncGetOperation(context, request, &cq);
+  EXPECT_FALSE(reader);
+}
+
 TEST_F(DatabaseAdminMetadataTest, CancelOperation) {
   EXPECT_CALL(*mock_, CancelOperation(_, _))
       .WillOnce([this](grpc::ClientContext& context,
@@ -257,6 +257,14 @@ class DefaultDatabaseAdminStub : public DatabaseAdminStub {
     return response;
   }
 
+  std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+      google::longrunning::Operation>>
+  AsyncGetOperation(grpc::ClientContext& client_context,
+                    google::longrunning::GetOperationRequest const& request,
+                    grpc::CompletionQueue* cq) override {
+    return operations_->AsyncGetOperation(&client_context, request, cq);
+  }
+
   Status CancelOperation(
       grpc::ClientContext& client_context,
       google::longrunning::CancelOperationRequest const& request) override {
@@ -135,6 +135,13 @@ class DatabaseAdminStub {
       grpc::ClientContext& client_context,
       google::longrunning::GetOperationRequest const& request) = 0;
 
+  /// Poll a long-running operation, without blocking.
+  virtual std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+      google::longrunning::Operation>>
+  AsyncGetOperation(grpc::ClientContext& client_context,
+                    google::longrunning::GetOperationRequest const& request,
+                    grpc::CompletionQueue* cq) = 0;
+
   /// Cancel a long-running operation.
   virtual Status CancelOperation(
       grpc::ClientContext& client_context,
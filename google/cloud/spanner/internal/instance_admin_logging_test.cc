@@ -203,6 +203,25 @@ TEST_F(InstanceAdminLoggingTest, TestIamPermissions) {
   HasLogLineWith(TransientError().message());
 }
 
+TEST_F(InstanceAdminLoggingTest, AsyncGetOperation) {
+  EXPECT_CALL(*mock_, AsyncGetOperation(_, _, _))
+      .WillOnce([](grpc::ClientContext&,
+                   google::longrunning::GetOperationRequest const&,
+                   grpc::CompletionQueue*) {
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            google::longrunning::Operation>>{};
+      });
+
+  InstanceAdminLogging stub(mock_, TracingOptions{});
+  grpc::ClientContext context;
+  grpc::CompletionQueue cq;
+  auto reader = stub.AsyncGetOperation(
+      context, google::longrunning::GetOperationRequest{}, &cq);
+  EXPECT_FALSE(reader);
+  HasLogLineWith("AsyncGetOperation");
+  HasLogLineWith(" null async response reader");
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace SPANNER_CLIENT_NS
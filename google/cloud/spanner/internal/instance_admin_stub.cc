@@ -167,6 +167,14 @@ class DefaultInstanceAdminStub : public InstanceAdminStub {
     return response;
   }
 
+  std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+      google::longrunning::Operation>>
+  AsyncGetOperation(grpc::ClientContext& client_context,
+                    google::longrunning::GetOperationRequest const& request,
+                    grpc::CompletionQueue* cq) override {
+    return operations_->AsyncGetOperation(&client_context, request, cq);
+  }
+
  private:
   std::unique_ptr<gcsa::InstanceAdmin::Stub> instance_admin_;
   std::unique_ptr<google::longrunning::Operations::Stub> operations_;
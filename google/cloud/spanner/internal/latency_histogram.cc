@@ -0,0 +1,53 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/latency_histogram.h"
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+std::size_t constexpr LatencyHistogram::kBucketCount;
+
+LatencyHistogram::LatencyHistogram() {
+  for (auto& b : buckets_) b.store(0);
+}
+
+void LatencyHistogram::Record(std::chrono::microseconds latency) {
+  // Bucket `i` holds the samples in `[2^(i-1), 2^i)`, i.e., `i` is the number
+  // of significant bits in the sample.
+  auto const us = latency.count();
+  std::size_t bucket = 0;
+  for (auto v = us; v > 0 && bucket + 1 < kBucketCount; v >>= 1) ++bucket;
+  ++buckets_[bucket];
+  ++count_;
+  if (us > 0) sum_us_ += us;
+}
+
+LatencyHistogramSnapshot LatencyHistogram::Snapshot() const {
+  LatencyHistogramSnapshot snapshot;
+  snapshot.count = count_.load();
+  snapshot.sum = std::chrono::microseconds(sum_us_.load());
+  snapshot.buckets.reserve(buckets_.size());
+  for (auto const& b : buckets_) snapshot.buckets.push_back(b.load());
+  return snapshot;
+}
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,70 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_LATENCY_HISTOGRAM_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_LATENCY_HISTOGRAM_H
+
+#include "google/cloud/spanner/session_pool_metrics.h"
+#include "google/cloud/spanner/version.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+/**
+ * A histogram of latencies with exponentially sized buckets.
+ *
+ * Recording a sample only uses atomic increments, so it is safe (and cheap)
+ * to call `Record()` from many threads at once.
+ */
+class LatencyHistogram {
+ public:
+  /// Buckets up to 2^30 microseconds (about 18 minutes), plus an overflow.
+  static std::size_t constexpr kBucketCount = 32;
+
+  LatencyHistogram();
+
+  // Not copyable or moveable.
+  LatencyHistogram(LatencyHistogram const&) = delete;
+  LatencyHistogram& operator=(LatencyHistogram const&) = delete;
+
+  void Record(std::chrono::microseconds latency);
+
+  /**
+   * Return a copy of the current counts. Samples recorded concurrently may or
+   * may not be included, so `count` might not be exactly the sum of the
+   * buckets.
+   */
+  LatencyHistogramSnapshot Snapshot() const;
+
+ private:
+  std::array<std::atomic<std::int64_t>, kBucketCount> buckets_;
+  std::atomic<std::int64_t> count_{0};
+  std::atomic<std::int64_t> sum_us_{0};
+};
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_LATENCY_HISTOGRAM_H
@@ -0,0 +1,96 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/latency_histogram.h"
+#include <gmock/gmock.h>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::std::chrono::microseconds;
+
+TEST(LatencyHistogram, Empty) {
+  LatencyHistogram h;
+  auto s = h.Snapshot();
+  EXPECT_EQ(0, s.count);
+  EXPECT_EQ(microseconds(0), s.sum);
+  EXPECT_EQ(LatencyHistogram::kBucketCount, s.buckets.size());
+  EXPECT_EQ(microseconds(0), s.Percentile(0.5));
+}
+
+TEST(LatencyHistogram, Buckets) {
+  LatencyHistogram h;
+  h.Record(microseconds(0));
+  h.Record(microseconds(1));
+  h.Record(microseconds(3));
+  h.Record(microseconds(4));
+  h.Record(microseconds(1000));
+  auto s = h.Snapshot();
+  EXPECT_EQ(5, s.count);
+  EXPECT_EQ(microseconds(1008), s.sum);
+  EXPECT_EQ(1, s.buckets[0]);   // [0, 1)
+  EXPECT_EQ(1, s.buckets[1]);   // [1, 2)
+  EXPECT_EQ(1, s.buckets[2]);   // [2, 4)
+  EXPECT_EQ(1, s.buckets[3]);   // [4, 8)
+  EXPECT_EQ(1, s.buckets[10]);  // [512, 1024)
+}
+
+TEST(LatencyHistogram, Overflow) {
+  LatencyHistogram h;
+  h.Record(std::chrono::hours(24));
+  auto s = h.Snapshot();
+  EXPECT_EQ(1, s.buckets.back());
+}
+
+TEST(LatencyHistogram, Percentile) {
+  LatencyHistogram h;
+  for (int i = 0; i != 90; ++i) h.Record(microseconds(10));
+  for (int i = 0; i != 10; ++i) h.Record(microseconds(5000));
+  auto s = h.Snapshot();
+  EXPECT_EQ(microseconds(16), s.Percentile(0.5));
+  EXPECT_EQ(microseconds(16), s.Percentile(0.9));
+  EXPECT_EQ(microseconds(8192), s.Percentile(0.99));
+  EXPECT_EQ(microseconds(8192), s.Percentile(1.0));
+}
+
+TEST(LatencyHistogram, Concurrent) {
+  LatencyHistogram h;
+  int const thread_count = 8;
+  int const iterations = 1000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t != thread_count; ++t) {
+    threads.emplace_back([&h] {
+      for (int i = 0; i != iterations; ++i) h.Record(microseconds(i));
+    });
+  }
+  for (auto& t : threads) t.join();
+  auto s = h.Snapshot();
+  EXPECT_EQ(thread_count * iterations, s.count);
+  std::int64_t total = 0;
+  for (auto b : s.buckets) total += b;
+  EXPECT_EQ(s.count, total);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -39,6 +39,19 @@ optional<google::spanner::v1::PartialResultSet> LoggingResultSetReader::Read() {
   return result;
 }
 
+bool LoggingResultSetReader::ReadInto(
+    google::spanner::v1::PartialResultSet* result) {
+  GCP_LOG(DEBUG) << __func__ << "() << (void)";
+  auto success = impl_->ReadInto(result);
+  if (!success) {
+    GCP_LOG(DEBUG) << __func__ << "() >> (false)";
+  } else {
+    GCP_LOG(DEBUG) << __func__ << "() >> "
+                   << DebugString(*result, tracing_options_);
+  }
+  return success;
+}
+
 Status LoggingResultSetReader::Finish() {
   GCP_LOG(DEBUG) << __func__ << "() << (void)";
   auto status = impl_->Finish();
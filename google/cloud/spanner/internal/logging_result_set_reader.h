@@ -35,6 +35,8 @@ class LoggingResultSetReader : public PartialResultSetReader {
   void TryCancel() override;
   optional<google::spanner::v1::PartialResultSet> Read() override;
   Status Finish() override;
+  bool ReadInto(google::spanner::v1::PartialResultSet* result) override;
+  future<void> WhenReadable() override { return impl_->WhenReadable(); }
 
  private:
   std::unique_ptr<PartialResultSetReader> impl_;
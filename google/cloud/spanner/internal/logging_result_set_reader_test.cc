@@ -97,6 +97,31 @@ TEST_F(LoggingResultSetReaderTest, Read) {
   HasLogLineWith("(optional-with-no-value)");
 }
 
+TEST_F(LoggingResultSetReaderTest, ReadInto) {
+  auto mock = google::cloud::internal::make_unique<
+      spanner_testing::MockPartialResultSetReader>();
+  EXPECT_CALL(*mock, Read())
+      .WillOnce([] {
+        spanner_proto::PartialResultSet result;
+        result.set_resume_token("test-token");
+        return result;
+      })
+      .WillOnce([] {
+        return google::cloud::optional<spanner_proto::PartialResultSet>{};
+      });
+  LoggingResultSetReader reader(std::move(mock), TracingOptions{});
+  spanner_proto::PartialResultSet result;
+  ASSERT_TRUE(reader.ReadInto(&result));
+  EXPECT_EQ("test-token", result.resume_token());
+
+  HasLogLineWith("ReadInto");
+  HasLogLineWith("test-token");
+
+  ClearLogCapture();
+  ASSERT_FALSE(reader.ReadInto(&result));
+  HasLogLineWith("(false)");
+}
+
 TEST_F(LoggingResultSetReaderTest, Finish) {
   Status const expected_status = Status(StatusCode::kOutOfRange, "weird");
   auto mock = google::cloud::internal::make_unique<
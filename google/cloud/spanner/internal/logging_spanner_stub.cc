@@ -135,6 +135,21 @@ StatusOr<spanner_proto::ResultSet> LoggingSpannerStub::ExecuteSql(
       client_context, request, __func__, tracing_options_);
 }
 
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<spanner_proto::ResultSet>>
+LoggingSpannerStub::AsyncExecuteSql(
+    grpc::ClientContext& client_context,
+    spanner_proto::ExecuteSqlRequest const& request,
+    grpc::CompletionQueue* cq) {
+  return LogWrapper(
+      [this](grpc::ClientContext& context,
+             spanner_proto::ExecuteSqlRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return child_->AsyncExecuteSql(context, request, cq);
+      },
+      client_context, request, cq, __func__, tracing_options_);
+}
+
 std::unique_ptr<grpc::ClientReaderInterface<spanner_proto::PartialResultSet>>
 LoggingSpannerStub::ExecuteStreamingSql(
     grpc::ClientContext& client_context,
@@ -147,6 +162,21 @@ LoggingSpannerStub::ExecuteStreamingSql(
       client_context, request, __func__, tracing_options_);
 }
 
+std::unique_ptr<
+    grpc::ClientAsyncReaderInterface<spanner_proto::PartialResultSet>>
+LoggingSpannerStub::PrepareAsyncExecuteStreamingSql(
+    grpc::ClientContext& client_context,
+    spanner_proto::ExecuteSqlRequest const& request,
+    grpc::CompletionQueue* cq) {
+  return LogWrapper(
+      [this](grpc::ClientContext& context,
+             spanner_proto::ExecuteSqlRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return child_->PrepareAsyncExecuteStreamingSql(context, request, cq);
+      },
+      client_context, request, cq, __func__, tracing_options_);
+}
+
 StatusOr<spanner_proto::ExecuteBatchDmlResponse>
 LoggingSpannerStub::ExecuteBatchDml(
     grpc::ClientContext& client_context,
@@ -170,6 +200,20 @@ LoggingSpannerStub::StreamingRead(grpc::ClientContext& client_context,
       client_context, request, __func__, tracing_options_);
 }
 
+std::unique_ptr<
+    grpc::ClientAsyncReaderInterface<spanner_proto::PartialResultSet>>
+LoggingSpannerStub::PrepareAsyncStreamingRead(
+    grpc::ClientContext& client_context,
+    spanner_proto::ReadRequest const& request, grpc::CompletionQueue* cq) {
+  return LogWrapper(
+      [this](grpc::ClientContext& context,
+             spanner_proto::ReadRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return child_->PrepareAsyncStreamingRead(context, request, cq);
+      },
+      client_context, request, cq, __func__, tracing_options_);
+}
+
 StatusOr<spanner_proto::Transaction> LoggingSpannerStub::BeginTransaction(
     grpc::ClientContext& client_context,
     spanner_proto::BeginTransactionRequest const& request) {
@@ -181,6 +225,21 @@ StatusOr<spanner_proto::Transaction> LoggingSpannerStub::BeginTransaction(
       client_context, request, __func__, tracing_options_);
 }
 
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<spanner_proto::Transaction>>
+LoggingSpannerStub::AsyncBeginTransaction(
+    grpc::ClientContext& client_context,
+    spanner_proto::BeginTransactionRequest const& request,
+    grpc::CompletionQueue* cq) {
+  return LogWrapper(
+      [this](grpc::ClientContext& context,
+             spanner_proto::BeginTransactionRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return child_->AsyncBeginTransaction(context, request, cq);
+      },
+      client_context, request, cq, __func__, tracing_options_);
+}
+
 StatusOr<spanner_proto::CommitResponse> LoggingSpannerStub::Commit(
     grpc::ClientContext& client_context,
     spanner_proto::CommitRequest const& request) {
@@ -192,6 +251,20 @@ StatusOr<spanner_proto::CommitResponse> LoggingSpannerStub::Commit(
       client_context, request, __func__, tracing_options_);
 }
 
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<spanner_proto::CommitResponse>>
+LoggingSpannerStub::AsyncCommit(grpc::ClientContext& client_context,
+                                spanner_proto::CommitRequest const& request,
+                                grpc::CompletionQueue* cq) {
+  return LogWrapper(
+      [this](grpc::ClientContext& context,
+             spanner_proto::CommitRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return child_->AsyncCommit(context, request, cq);
+      },
+      client_context, request, cq, __func__, tracing_options_);
+}
+
 Status LoggingSpannerStub::Rollback(
     grpc::ClientContext& client_context,
     spanner_proto::RollbackRequest const& request) {
@@ -203,6 +276,20 @@ Status LoggingSpannerStub::Rollback(
       client_context, request, __func__, tracing_options_);
 }
 
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<google::protobuf::Empty>>
+LoggingSpannerStub::AsyncRollback(
+    grpc::ClientContext& client_context,
+    spanner_proto::RollbackRequest const& request, grpc::CompletionQueue* cq) {
+  return LogWrapper(
+      [this](grpc::ClientContext& context,
+             spanner_proto::RollbackRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return child_->AsyncRollback(context, request, cq);
+      },
+      client_context, request, cq, __func__, tracing_options_);
+}
+
 StatusOr<spanner_proto::PartitionResponse> LoggingSpannerStub::PartitionQuery(
     grpc::ClientContext& client_context,
     spanner_proto::PartitionQueryRequest const& request) {
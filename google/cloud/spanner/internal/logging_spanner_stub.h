@@ -71,11 +71,22 @@ class LoggingSpannerStub : public SpannerStub {
   StatusOr<google::spanner::v1::ResultSet> ExecuteSql(
       grpc::ClientContext& client_context,
       google::spanner::v1::ExecuteSqlRequest const& request) override;
+  std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<google::spanner::v1::ResultSet>>
+  AsyncExecuteSql(grpc::ClientContext& client_context,
+                  google::spanner::v1::ExecuteSqlRequest const& request,
+                  grpc::CompletionQueue* cq) override;
   std::unique_ptr<
       grpc::ClientReaderInterface<google::spanner::v1::PartialResultSet>>
   ExecuteStreamingSql(
       grpc::ClientContext& client_context,
       google::spanner::v1::ExecuteSqlRequest const& request) override;
+  std::unique_ptr<
+      grpc::ClientAsyncReaderInterface<google::spanner::v1::PartialResultSet>>
+  PrepareAsyncExecuteStreamingSql(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::ExecuteSqlRequest const& request,
+      grpc::CompletionQueue* cq) override;
   StatusOr<google::spanner::v1::ExecuteBatchDmlResponse> ExecuteBatchDml(
       grpc::ClientContext& client_context,
       google::spanner::v1::ExecuteBatchDmlRequest const& request) override;
@@ -83,14 +94,35 @@ class LoggingSpannerStub : public SpannerStub {
       grpc::ClientReaderInterface<google::spanner::v1::PartialResultSet>>
   StreamingRead(grpc::ClientContext& client_context,
                 google::spanner::v1::ReadRequest const& request) override;
+  std::unique_ptr<
+      grpc::ClientAsyncReaderInterface<google::spanner::v1::PartialResultSet>>
+  PrepareAsyncStreamingRead(grpc::ClientContext& client_context,
+                            google::spanner::v1::ReadRequest const& request,
+                            grpc::CompletionQueue* cq) override;
   StatusOr<google::spanner::v1::Transaction> BeginTransaction(
       grpc::ClientContext& client_context,
       google::spanner::v1::BeginTransactionRequest const& request) override;
+  std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+      google::spanner::v1::Transaction>>
+  AsyncBeginTransaction(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::BeginTransactionRequest const& request,
+      grpc::CompletionQueue* cq) override;
   StatusOr<google::spanner::v1::CommitResponse> Commit(
       grpc::ClientContext& client_context,
       google::spanner::v1::CommitRequest const& request) override;
+  std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+      google::spanner::v1::CommitResponse>>
+  AsyncCommit(grpc::ClientContext& client_context,
+              google::spanner::v1::CommitRequest const& request,
+              grpc::CompletionQueue* cq) override;
   Status Rollback(grpc::ClientContext& client_context,
                   google::spanner::v1::RollbackRequest const& request) override;
+  std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<google::protobuf::Empty>>
+  AsyncRollback(grpc::ClientContext& client_context,
+                google::spanner::v1::RollbackRequest const& request,
+                grpc::CompletionQueue* cq) override;
   StatusOr<google::spanner::v1::PartitionResponse> PartitionQuery(
       grpc::ClientContext& client_context,
       google::spanner::v1::PartitionQueryRequest const& request) override;
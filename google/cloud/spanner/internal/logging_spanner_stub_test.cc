@@ -176,6 +176,25 @@ TEST_F(LoggingSpannerStubTest, ExecuteStreamingSql) {
   HasLogLineWith(" null stream");
 }
 
+TEST_F(LoggingSpannerStubTest, PrepareAsyncExecuteStreamingSql) {
+  EXPECT_CALL(*mock_, PrepareAsyncExecuteStreamingSql(_, _, _))
+      .WillOnce([](grpc::ClientContext&,
+                   spanner_proto::ExecuteSqlRequest const&,
+                   grpc::CompletionQueue*) {
+        return std::unique_ptr<grpc::ClientAsyncReaderInterface<
+            spanner_proto::PartialResultSet>>{};
+      });
+
+  LoggingSpannerStub stub(mock_, TracingOptions{});
+  grpc::ClientContext context;
+  grpc::CompletionQueue cq;
+  auto reader = stub.PrepareAsyncExecuteStreamingSql(
+      context, spanner_proto::ExecuteSqlRequest(), &cq);
+  EXPECT_FALSE(reader);
+  HasLogLineWith("PrepareAsyncExecuteStreamingSql");
+  HasLogLineWith(" null async response reader");
+}
+
 TEST_F(LoggingSpannerStubTest, ExecuteBatchDml) {
   EXPECT_CALL(*mock_, ExecuteBatchDml(_, _)).WillOnce(Return(TransientError()));
 
@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include "google/cloud/spanner/internal/merge_chunk.h"
+#include "google/cloud/internal/make_unique.h"
+#include <iterator>
+#include <utility>
 
 namespace google {
 namespace cloud {
@@ -74,6 +77,108 @@ Status MergeChunk(google::protobuf::Value& value,
   return Status(StatusCode::kUnknown, "unknown Value type");
 }
 
+namespace {
+// Returns true if the next chunk may continue @p value, as opposed to starting
+// a new element of the enclosing list.
+bool IsMergeable(google::protobuf::Value const& value) {
+  return value.kind_case() == google::protobuf::Value::kStringValue ||
+         value.kind_case() == google::protobuf::Value::kListValue;
+}
+}  // namespace
+
+ChunkedValue::ChunkedValue(google::protobuf::Value&& value)
+    : kind_(value.kind_case()) {
+  switch (kind_) {
+    case google::protobuf::Value::kStringValue:
+      size_ = value.string_value().size();
+      pieces_.push_back(std::move(*value.mutable_string_value()));
+      break;
+    case google::protobuf::Value::kListValue:
+      value_.mutable_list_value();
+      AppendElements(*value.mutable_list_value()->mutable_values(), 0);
+      break;
+    default:
+      // Cannot be merged, `Append()` reports the error.
+      value_ = std::move(value);
+      break;
+  }
+}
+
+Status ChunkedValue::Append(google::protobuf::Value&& chunk) {
+  if (kind_ != chunk.kind_case()) {
+    return Status(StatusCode::kInvalidArgument, "mismatched types");
+  }
+  switch (kind_) {
+    case google::protobuf::Value::kBoolValue:
+    case google::protobuf::Value::kNumberValue:
+    case google::protobuf::Value::kNullValue:
+    case google::protobuf::Value::kStructValue:
+      return Status(StatusCode::kInvalidArgument, "invalid type");
+
+    case google::protobuf::Value::kStringValue: {
+      // Moving the string does not copy its data, even from an arena.
+      size_ += chunk.string_value().size();
+      pieces_.push_back(std::move(*chunk.mutable_string_value()));
+      return Status();
+    }
+
+    case google::protobuf::Value::kListValue: {
+      auto& elements = *chunk.mutable_list_value()->mutable_values();
+      if (elements.empty()) return Status();
+      int begin = 0;
+      if (tail_) {
+        // The first element continues the last element of the value.
+        auto status = tail_->Append(std::move(elements[0]));
+        if (!status.ok()) return status;
+        if (elements.size() == 1) return Status();
+        CloseTail();
+        begin = 1;
+      }
+      AppendElements(elements, begin);
+      return Status();
+    }
+
+    default:
+      break;
+  }
+  return Status(StatusCode::kUnknown, "unknown Value type");
+}
+
+google::protobuf::Value ChunkedValue::Finish() && {
+  if (kind_ == google::protobuf::Value::kStringValue) {
+    std::string s = std::move(pieces_.front());
+    s.reserve(size_);
+    for (auto i = std::next(pieces_.begin()); i != pieces_.end(); ++i) {
+      s += *i;
+    }
+    value_.set_string_value(std::move(s));
+  } else if (tail_) {
+    CloseTail();
+  }
+  return std::move(value_);
+}
+
+void ChunkedValue::AppendElements(
+    google::protobuf::RepeatedPtrField<google::protobuf::Value>& elements,
+    int begin) {
+  auto& values = *value_.mutable_list_value()->mutable_values();
+  auto const end = elements.size();
+  values.Reserve(values.size() + end - begin);
+  for (auto i = begin; i != end; ++i) {
+    if (i == end - 1 && IsMergeable(elements[i])) {
+      tail_ = google::cloud::internal::make_unique<ChunkedValue>(
+          std::move(elements[i]));
+      break;
+    }
+    *values.Add() = std::move(elements[i]);
+  }
+}
+
+void ChunkedValue::CloseTail() {
+  *value_.mutable_list_value()->add_values() = std::move(*tail_).Finish();
+  tail_.reset();
+}
+
 }  // namespace internal
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner
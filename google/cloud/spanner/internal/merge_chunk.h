@@ -18,6 +18,10 @@
 #include "google/cloud/spanner/version.h"
 #include "google/cloud/status.h"
 #include <google/protobuf/struct.pb.h>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -47,6 +51,40 @@ namespace internal {
 Status MergeChunk(google::protobuf::Value& value,
                   google::protobuf::Value&& chunk);
 
+/**
+ * Merges a value split into any number of chunks, or returns an error.
+ *
+ * The result is the same as calling `MergeChunk()` with each chunk, but the
+ * pieces of each string are only concatenated by `Finish()`, and the elements
+ * of each list are moved only once. Merging a large value split across many
+ * `PartialResultSet`s is therefore linear in its size.
+ */
+class ChunkedValue {
+ public:
+  /// Starts a value with its first chunk.
+  explicit ChunkedValue(google::protobuf::Value&& value);
+
+  /// Merges the next @p chunk into the value.
+  Status Append(google::protobuf::Value&& chunk);
+
+  /// Returns the merged value.
+  google::protobuf::Value Finish() &&;
+
+ private:
+  void AppendElements(
+      google::protobuf::RepeatedPtrField<google::protobuf::Value>& elements,
+      int begin);
+  void CloseTail();
+
+  google::protobuf::Value::KindCase kind_;
+  // The value, except for the pieces of a string, and the open tail of a list.
+  google::protobuf::Value value_;
+  std::vector<std::string> pieces_;
+  std::size_t size_ = 0;
+  // The last element of a list, if it may be continued by the next chunk.
+  std::unique_ptr<ChunkedValue> tail_;
+};
+
 }  // namespace internal
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner
@@ -15,6 +15,9 @@
 #include "google/cloud/spanner/internal/merge_chunk.h"
 #include "google/cloud/spanner/value.h"
 #include <benchmark/benchmark.h>
+#include <cstddef>
+#include <string>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -116,6 +119,84 @@ void BM_MergeChunkListsOfListOfString(benchmark::State& state) {
 }
 BENCHMARK(BM_MergeChunkListsOfListOfString);
 
+// A 4MiB STRING split into `state.range(0)` chunks, the merged value is only
+// used once all the chunks are received.
+std::vector<google::protobuf::Value> MakeStringChunks(
+    benchmark::State const& state) {
+  auto const chunks = static_cast<std::size_t>(state.range(0));
+  auto const chunk_size = (4 * 1024 * 1024) / chunks;
+  std::vector<google::protobuf::Value> result;
+  for (std::size_t i = 0; i != chunks; ++i) {
+    result.push_back(MakeProtoValue(std::string(chunk_size, 'a')));
+  }
+  return result;
+}
+
+// An ARRAY<STRING> with 64Ki elements of 64 bytes, split into
+// `state.range(0)` chunks, each splitting one of the strings.
+std::vector<google::protobuf::Value> MakeArrayChunks(
+    benchmark::State const& state) {
+  auto const chunks = static_cast<std::size_t>(state.range(0));
+  auto const elements = (64 * 1024) / chunks;
+  std::vector<google::protobuf::Value> result;
+  for (std::size_t i = 0; i != chunks; ++i) {
+    std::vector<std::string> v(elements, std::string(64, 'a'));
+    if (i != 0) v.front().resize(32);
+    if (i != chunks - 1) v.back().resize(32);
+    result.push_back(MakeProtoValue(std::move(v)));
+  }
+  return result;
+}
+
+// The chunks are consumed by each iteration, copying them is not measured.
+void MergeEachChunk(benchmark::State& state,
+                    std::vector<google::protobuf::Value> const& chunks) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto copy = chunks;
+    state.ResumeTiming();
+    auto& value = copy.front();
+    for (std::size_t i = 1; i != copy.size(); ++i) {
+      benchmark::DoNotOptimize(MergeChunk(value, std::move(copy[i])));
+    }
+    benchmark::DoNotOptimize(value);
+  }
+}
+
+void MergeChunkedValue(benchmark::State& state,
+                       std::vector<google::protobuf::Value> const& chunks) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto copy = chunks;
+    state.ResumeTiming();
+    ChunkedValue value(std::move(copy.front()));
+    for (std::size_t i = 1; i != copy.size(); ++i) {
+      benchmark::DoNotOptimize(value.Append(std::move(copy[i])));
+    }
+    benchmark::DoNotOptimize(std::move(value).Finish());
+  }
+}
+
+void BM_MergeChunkLargeString(benchmark::State& state) {
+  MergeEachChunk(state, MakeStringChunks(state));
+}
+BENCHMARK(BM_MergeChunkLargeString)->Range(2, 4096);
+
+void BM_ChunkedValueLargeString(benchmark::State& state) {
+  MergeChunkedValue(state, MakeStringChunks(state));
+}
+BENCHMARK(BM_ChunkedValueLargeString)->Range(2, 4096);
+
+void BM_MergeChunkLargeArray(benchmark::State& state) {
+  MergeEachChunk(state, MakeArrayChunks(state));
+}
+BENCHMARK(BM_MergeChunkLargeArray)->Range(2, 4096);
+
+void BM_ChunkedValueLargeArray(benchmark::State& state) {
+  MergeChunkedValue(state, MakeArrayChunks(state));
+}
+BENCHMARK(BM_ChunkedValueLargeArray)->Range(2, 4096);
+
 }  // namespace
 }  // namespace internal
 }  // namespace SPANNER_CLIENT_NS
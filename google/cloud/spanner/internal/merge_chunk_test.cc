@@ -217,6 +217,71 @@ TEST(MergeChunk, CannotMergeStruct) {
   EXPECT_THAT(status.message(), testing::HasSubstr("invalid type"));
 }
 
+// Merges `chunks` with both `MergeChunk()` and `ChunkedValue`, and verifies
+// the results match.
+void CheckChunkedValue(std::vector<google::protobuf::Value> const& chunks) {
+  auto expected = chunks[0];
+  auto chunk = chunks[0];
+  ChunkedValue actual(std::move(chunk));
+  for (std::size_t i = 1; i != chunks.size(); ++i) {
+    ASSERT_STATUS_OK(MergeChunk(expected, google::protobuf::Value(chunks[i])));
+    ASSERT_STATUS_OK(actual.Append(google::protobuf::Value(chunks[i])));
+  }
+  EXPECT_THAT(std::move(actual).Finish(), IsProtoEqual(expected));
+}
+
+TEST(ChunkedValue, Strings) {
+  CheckChunkedValue({MakeProtoValue("foo")});
+  CheckChunkedValue({MakeProtoValue("foo"), MakeProtoValue("bar")});
+  CheckChunkedValue({MakeProtoValue(""), MakeProtoValue("a"),
+                     MakeProtoValue(""), MakeProtoValue("bc")});
+}
+
+TEST(ChunkedValue, Lists) {
+  google::protobuf::Value empty_list;
+  empty_list.mutable_list_value();
+
+  CheckChunkedValue({MakeProtoValue(std::vector<double>{2, 3}),
+                     MakeProtoValue(std::vector<double>{4}), empty_list,
+                     MakeProtoValue(std::vector<double>{5, 6})});
+  CheckChunkedValue(
+      {empty_list, MakeProtoValue(std::vector<std::string>{"a", "b"})});
+  // A string continued across several chunks, each with a single element.
+  CheckChunkedValue({MakeProtoValue(std::vector<std::string>{"a", "b"}),
+                     MakeProtoValue(std::vector<std::string>{"c"}),
+                     MakeProtoValue(std::vector<std::string>{"d"}),
+                     MakeProtoValue(std::vector<std::string>{"e", "f"}),
+                     empty_list});
+}
+
+TEST(ChunkedValue, ListsOfListOfString) {
+  // ["a", ["b", "c"]], [["d"]], [["e", "f"], "g"], ["h"]
+  //     => ["a", ["b", "cde", "f"], "gh"]
+  CheckChunkedValue(
+      {MakeProtoValue(std::vector<Value>{
+           Value("a"), Value(std::vector<std::string>{"b", "c"})}),
+       MakeProtoValue(std::vector<Value>{Value(std::vector<std::string>{"d"})}),
+       MakeProtoValue(std::vector<Value>{
+           Value(std::vector<std::string>{"e", "f"}), Value("g")}),
+       MakeProtoValue(std::vector<Value>{Value("h")})});
+}
+
+TEST(ChunkedValue, Errors) {
+  ChunkedValue list(MakeProtoValue(std::vector<std::string>{"hello"}));
+  auto status = list.Append(MakeProtoValue("world"));
+  EXPECT_THAT(status.message(), testing::HasSubstr("mismatched types"));
+
+  // The last element of the list is a string, so it cannot be continued by
+  // a list.
+  status = list.Append(MakeProtoValue(std::vector<Value>{
+      Value(std::vector<std::string>{"world"})}));
+  EXPECT_THAT(status.message(), testing::HasSubstr("mismatched types"));
+
+  ChunkedValue number(MakeProtoValue(1.0));
+  status = number.Append(MakeProtoValue(2.0));
+  EXPECT_THAT(status.message(), testing::HasSubstr("invalid type"));
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace SPANNER_CLIENT_NS
@@ -101,6 +101,16 @@ StatusOr<spanner_proto::ResultSet> MetadataSpannerStub::ExecuteSql(
   return child_->ExecuteSql(client_context, request);
 }
 
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<spanner_proto::ResultSet>>
+MetadataSpannerStub::AsyncExecuteSql(
+    grpc::ClientContext& client_context,
+    spanner_proto::ExecuteSqlRequest const& request,
+    grpc::CompletionQueue* cq) {
+  SetMetadata(client_context, "session=" + request.session());
+  return child_->AsyncExecuteSql(client_context, request, cq);
+}
+
 std::unique_ptr<grpc::ClientReaderInterface<spanner_proto::PartialResultSet>>
 MetadataSpannerStub::ExecuteStreamingSql(
     grpc::ClientContext& client_context,
@@ -109,6 +119,16 @@ MetadataSpannerStub::ExecuteStreamingSql(
   return child_->ExecuteStreamingSql(client_context, request);
 }
 
+std::unique_ptr<
+    grpc::ClientAsyncReaderInterface<spanner_proto::PartialResultSet>>
+MetadataSpannerStub::PrepareAsyncExecuteStreamingSql(
+    grpc::ClientContext& client_context,
+    spanner_proto::ExecuteSqlRequest const& request,
+    grpc::CompletionQueue* cq) {
+  SetMetadata(client_context, "session=" + request.session());
+  return child_->PrepareAsyncExecuteStreamingSql(client_context, request, cq);
+}
+
 StatusOr<spanner_proto::ExecuteBatchDmlResponse>
 MetadataSpannerStub::ExecuteBatchDml(
     grpc::ClientContext& client_context,
@@ -124,6 +144,15 @@ MetadataSpannerStub::StreamingRead(grpc::ClientContext& client_context,
   return child_->StreamingRead(client_context, request);
 }
 
+std::unique_ptr<
+    grpc::ClientAsyncReaderInterface<spanner_proto::PartialResultSet>>
+MetadataSpannerStub::PrepareAsyncStreamingRead(
+    grpc::ClientContext& client_context,
+    spanner_proto::ReadRequest const& request, grpc::CompletionQueue* cq) {
+  SetMetadata(client_context, "session=" + request.session());
+  return child_->PrepareAsyncStreamingRead(client_context, request, cq);
+}
+
 StatusOr<spanner_proto::Transaction> MetadataSpannerStub::BeginTransaction(
     grpc::ClientContext& client_context,
     spanner_proto::BeginTransactionRequest const& request) {
@@ -131,6 +160,16 @@ StatusOr<spanner_proto::Transaction> MetadataSpannerStub::BeginTransaction(
   return child_->BeginTransaction(client_context, request);
 }
 
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<spanner_proto::Transaction>>
+MetadataSpannerStub::AsyncBeginTransaction(
+    grpc::ClientContext& client_context,
+    spanner_proto::BeginTransactionRequest const& request,
+    grpc::CompletionQueue* cq) {
+  SetMetadata(client_context, "session=" + request.session());
+  return child_->AsyncBeginTransaction(client_context, request, cq);
+}
+
 StatusOr<spanner_proto::CommitResponse> MetadataSpannerStub::Commit(
     grpc::ClientContext& client_context,
     spanner_proto::CommitRequest const& request) {
@@ -138,6 +177,15 @@ StatusOr<spanner_proto::CommitResponse> MetadataSpannerStub::Commit(
   return child_->Commit(client_context, request);
 }
 
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<spanner_proto::CommitResponse>>
+MetadataSpannerStub::AsyncCommit(grpc::ClientContext& client_context,
+                                 spanner_proto::CommitRequest const& request,
+                                 grpc::CompletionQueue* cq) {
+  SetMetadata(client_context, "session=" + request.session());
+  return child_->AsyncCommit(client_context, request, cq);
+}
+
 Status MetadataSpannerStub::Rollback(
     grpc::ClientContext& client_context,
     spanner_proto::RollbackRequest const& request) {
@@ -145,6 +193,15 @@ Status MetadataSpannerStub::Rollback(
   return child_->Rollback(client_context, request);
 }
 
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<google::protobuf::Empty>>
+MetadataSpannerStub::AsyncRollback(
+    grpc::ClientContext& client_context,
+    spanner_proto::RollbackRequest const& request, grpc::CompletionQueue* cq) {
+  SetMetadata(client_context, "session=" + request.session());
+  return child_->AsyncRollback(client_context, request, cq);
+}
+
 StatusOr<spanner_proto::PartitionResponse> MetadataSpannerStub::PartitionQuery(
     grpc::ClientContext& client_context,
     spanner_proto::PartitionQueryRequest const& request) {
@@ -220,6 +220,31 @@ TEST_F(MetadataSpannerStubTest, ExecuteStreamingSql) {
   EXPECT_FALSE(result);
 }
 
+TEST_F(MetadataSpannerStubTest, PrepareAsyncExecuteStreamingSql) {
+  EXPECT_CALL(*mock_, PrepareAsyncExecuteStreamingSql(_, _, _))
+      .WillOnce([this](grpc::ClientContext& context,
+                       spanner_proto::ExecuteSqlRequest const&,
+                       grpc::CompletionQueue*) {
+        EXPECT_STATUS_OK(spanner_testing::IsContextMDValid(
+            context, "google.spanner.v1.Spanner.ExecuteStreamingSql",
+            expected_api_client_header_));
+        return std::unique_ptr<grpc::ClientAsyncReaderInterface<
+            spanner_proto::PartialResultSet>>{};
+      });
+
+  MetadataSpannerStub stub(mock_);
+  grpc::ClientContext context;
+  grpc::CompletionQueue cq;
+  spanner_proto::ExecuteSqlRequest request;
+  request.set_session(
+      "projects/test-project-id/"
+      "instances/test-instance-id/"
+      "databases/test-database-id/"
+      "sessions/test-session-id");
+  auto result = stub.PrepareAsyncExecuteStreamingSql(context, request, &cq);
+  EXPECT_FALSE(result);
+}
+
 TEST_F(MetadataSpannerStubTest, ExecuteBatchDml) {
   SESSION_TEST(ExecuteBatchDml, spanner_proto::ExecuteBatchDmlRequest);
 }
@@ -247,6 +272,31 @@ TEST_F(MetadataSpannerStubTest, StreamingRead) {
   EXPECT_FALSE(result);
 }
 
+TEST_F(MetadataSpannerStubTest, PrepareAsyncStreamingRead) {
+  EXPECT_CALL(*mock_, PrepareAsyncStreamingRead(_, _, _))
+      .WillOnce([this](grpc::ClientContext& context,
+                       spanner_proto::ReadRequest const&,
+                       grpc::CompletionQueue*) {
+        EXPECT_STATUS_OK(spanner_testing::IsContextMDValid(
+            context, "google.spanner.v1.Spanner.StreamingRead",
+            expected_api_client_header_));
+        return std::unique_ptr<grpc::ClientAsyncReaderInterface<
+            spanner_proto::PartialResultSet>>{};
+      });
+
+  MetadataSpannerStub stub(mock_);
+  grpc::ClientContext context;
+  grpc::CompletionQueue cq;
+  spanner_proto::ReadRequest request;
+  request.set_session(
+      "projects/test-project-id/"
+      "instances/test-instance-id/"
+      "databases/test-database-id/"
+      "sessions/test-session-id");
+  auto result = stub.PrepareAsyncStreamingRead(context, request, &cq);
+  EXPECT_FALSE(result);
+}
+
 TEST_F(MetadataSpannerStubTest, BeginTransaction) {
   SESSION_TEST(BeginTransaction, spanner_proto::BeginTransactionRequest);
 }
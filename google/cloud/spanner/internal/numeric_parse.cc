@@ -0,0 +1,135 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/numeric_parse.h"
+#include <cmath>
+#include <limits>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+namespace {
+
+// The maximum number of significant digits in a (64-bit) INT64. Any value
+// with that many digits fits in a `std::uint64_t`.
+auto constexpr kMaxInt64Digits = 19;
+
+// Loads 8 characters so that the first one is in the least-significant byte.
+// Compilers turn this into a single (unaligned) load on little-endian CPUs.
+std::uint64_t LoadEightChars(char const* p) {
+  std::uint64_t chunk = 0;
+  for (int i = 0; i != 8; ++i) {
+    chunk |= std::uint64_t{static_cast<unsigned char>(p[i])} << (8 * i);
+  }
+  return chunk;
+}
+
+// Returns true if all the bytes in `chunk` are ASCII digits. Adding 6 to a
+// digit ('0'..'9' == 0x30..0x39) keeps its high nibble at 3, for any other
+// byte either the high nibble of the byte, or of the byte plus 6, is not 3.
+bool IsEightDigits(std::uint64_t chunk) {
+  auto constexpr kHighNibbles = 0xF0F0F0F0F0F0F0F0ULL;
+  return ((chunk & kHighNibbles) |
+          (((chunk + 0x0606060606060606ULL) & kHighNibbles) >> 4)) ==
+         0x3333333333333333ULL;
+}
+
+// Converts 8 ASCII digits (as loaded by `LoadEightChars()`) to their value,
+// combining pairs of digits, then pairs of pairs, with 3 multiplications
+// instead of 8.
+std::uint64_t ParseEightDigits(std::uint64_t chunk) {
+  auto constexpr kMask = 0x000000FF000000FFULL;
+  auto constexpr kMul1 = 100 + (1000000ULL << 32);
+  auto constexpr kMul2 = 1 + (10000ULL << 32);
+  chunk -= 0x3030303030303030ULL;
+  chunk = (chunk * 10) + (chunk >> 8);
+  return (((chunk & kMask) * kMul1) + (((chunk >> 16) & kMask) * kMul2)) >> 32;
+}
+
+Status Int64Error(std::string const& message, std::string const& s) {
+  return Status(StatusCode::kUnknown, message + ": \"" + s + "\"");
+}
+
+}  // namespace
+
+StatusOr<std::int64_t> ParseInt64(std::string const& s) {
+  char const* p = s.data();
+  char const* const end = p + s.size();
+  bool const negative = p != end && *p == '-';
+  if (p != end && (*p == '-' || *p == '+')) ++p;
+  if (p == end || static_cast<unsigned>(*p - '0') > 9) {
+    return Int64Error("No numeric conversion", s);
+  }
+  // Leading zeros are valid, but do not count towards the digit limit.
+  while (end - p > 1 && *p == '0') ++p;
+
+  char const* const digits = p;
+  std::uint64_t value = 0;
+  while (end - p >= 8 && p - digits + 8 <= kMaxInt64Digits) {
+    auto const chunk = LoadEightChars(p);
+    if (!IsEightDigits(chunk)) break;
+    value = value * 100000000 + ParseEightDigits(chunk);
+    p += 8;
+  }
+  for (; p != end && p - digits < kMaxInt64Digits; ++p) {
+    auto const digit = static_cast<unsigned>(*p - '0');
+    if (digit > 9) return Int64Error("Trailing data", s);
+    value = value * 10 + digit;
+  }
+  if (p != end) {
+    // There are more than `kMaxInt64Digits` characters left after the sign and
+    // any leading zeros, so the value is out of range unless it is malformed.
+    while (p != end && static_cast<unsigned>(*p - '0') <= 9) ++p;
+    if (p != end) return Int64Error("Trailing data", s);
+    return Int64Error("INT64 value out of range", s);
+  }
+
+  auto constexpr kMax =
+      static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+  if (value > kMax + (negative ? 1 : 0)) {
+    return Int64Error("INT64 value out of range", s);
+  }
+  if (!negative) return static_cast<std::int64_t>(value);
+  // Avoid converting 2^63 to a `std::int64_t`, which would overflow.
+  if (value == 0) return std::int64_t{0};
+  return -static_cast<std::int64_t>(value - 1) - 1;
+}
+
+StatusOr<double> ParseFloat64(std::string const& s) {
+  auto const inf = std::numeric_limits<double>::infinity();
+  // The valid strings have different lengths, so one comparison suffices.
+  switch (s.size()) {
+    case 3:
+      if (s == "NaN") return std::nan("");
+      break;
+    case 8:
+      if (s == "Infinity") return inf;
+      break;
+    case 9:
+      if (s == "-Infinity") return -inf;
+      break;
+    default:
+      break;
+  }
+  return Status(StatusCode::kUnknown, "bad FLOAT64 data: \"" + s + "\"");
+}
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
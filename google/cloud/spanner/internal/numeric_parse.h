@@ -0,0 +1,57 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_NUMERIC_PARSE_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_NUMERIC_PARSE_H
+
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/status_or.h"
+#include <cstdint>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+/**
+ * Convert the decimal representation of an `INT64`, as sent by Spanner, to
+ * a `std::int64_t`.
+ *
+ * The input is an optional sign followed by one or more decimal digits. Unlike
+ * `std::strtoll()`, leading whitespace is not accepted.
+ *
+ * Returns a non-OK Status if the input cannot be parsed or is out of range.
+ */
+StatusOr<std::int64_t> ParseInt64(std::string const& s);
+
+/**
+ * Convert the string representation of a `FLOAT64` to a `double`.
+ *
+ * Spanner sends finite values as JSON numbers, so only "NaN", "Infinity", and
+ * "-Infinity" are valid. These must match exactly, so leading or trailing
+ * whitespace is not accepted.
+ *
+ * Returns a non-OK Status if the input is any other string.
+ */
+StatusOr<double> ParseFloat64(std::string const& s);
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_NUMERIC_PARSE_H
@@ -0,0 +1,102 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/numeric_parse.h"
+#include "google/cloud/spanner/value.h"
+#include <benchmark/benchmark.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+// Returns `count` decimal INT64 strings, with a mix of lengths.
+std::vector<std::string> MakeInt64Strings(std::size_t count) {
+  std::mt19937_64 generator(42);
+  std::uniform_int_distribution<std::int64_t> values;
+  std::uniform_int_distribution<int> shifts(0, 63);
+  std::vector<std::string> result;
+  for (std::size_t i = 0; i != count; ++i) {
+    result.push_back(std::to_string(values(generator) >> shifts(generator)));
+  }
+  return result;
+}
+
+// The previous implementation, as a baseline.
+void BM_ParseInt64Strtoll(benchmark::State& state) {
+  auto const data = MakeInt64Strings(1024);
+  for (auto _ : state) {
+    for (auto const& s : data) {
+      char* end = nullptr;
+      errno = 0;
+      benchmark::DoNotOptimize(std::strtoll(s.c_str(), &end, 10));
+      benchmark::DoNotOptimize(errno != 0 || *end != '\0');
+    }
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(data.size()));
+}
+BENCHMARK(BM_ParseInt64Strtoll);
+
+void BM_ParseInt64(benchmark::State& state) {
+  auto const data = MakeInt64Strings(1024);
+  for (auto _ : state) {
+    for (auto const& s : data) {
+      benchmark::DoNotOptimize(ParseInt64(s));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(data.size()));
+}
+BENCHMARK(BM_ParseInt64);
+
+// Decodes an `ARRAY<INT64>` of `state.range(0)` elements.
+void BM_ValueGetInt64Array(benchmark::State& state) {
+  auto const data = MakeInt64Strings(static_cast<std::size_t>(state.range(0)));
+  std::vector<std::int64_t> values;
+  for (auto const& s : data) values.push_back(ParseInt64(s).value());
+  Value const v(values);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(v.get<std::vector<std::int64_t>>());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ValueGetInt64Array)->Range(8, 8 << 10);
+
+void BM_ParseFloat64(benchmark::State& state) {
+  std::vector<std::string> const data{"NaN", "Infinity", "-Infinity"};
+  for (auto _ : state) {
+    for (auto const& s : data) {
+      benchmark::DoNotOptimize(ParseFloat64(s));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(data.size()));
+}
+BENCHMARK(BM_ParseFloat64);
+
+}  // namespace
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
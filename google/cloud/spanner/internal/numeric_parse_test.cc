@@ -0,0 +1,104 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/numeric_parse.h"
+#include <gmock/gmock.h>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::testing::HasSubstr;
+
+TEST(NumericParse, ParseInt64) {
+  auto const min64 = std::numeric_limits<std::int64_t>::min();
+  auto const max64 = std::numeric_limits<std::int64_t>::max();
+  EXPECT_EQ(0, ParseInt64("0").value());
+  EXPECT_EQ(0, ParseInt64("-0").value());
+  EXPECT_EQ(42, ParseInt64("42").value());
+  EXPECT_EQ(42, ParseInt64("+42").value());
+  EXPECT_EQ(-42, ParseInt64("-42").value());
+  EXPECT_EQ(12345678, ParseInt64("12345678").value());
+  EXPECT_EQ(123456789, ParseInt64("123456789").value());
+  EXPECT_EQ(1234567890123456, ParseInt64("1234567890123456").value());
+  EXPECT_EQ(max64, ParseInt64("9223372036854775807").value());
+  EXPECT_EQ(min64, ParseInt64("-9223372036854775808").value());
+  EXPECT_EQ(42, ParseInt64("0000000000000000000000042").value());
+  EXPECT_EQ(min64, ParseInt64("-0009223372036854775808").value());
+}
+
+TEST(NumericParse, ParseInt64RoundTrip) {
+  std::mt19937_64 generator(std::random_device{}());
+  std::uniform_int_distribution<std::int64_t> values;
+  std::uniform_int_distribution<int> shifts(0, 63);
+  for (int i = 0; i != 10000; ++i) {
+    // Shift the values to get a mix of lengths.
+    auto const expected = values(generator) >> shifts(generator);
+    auto const s = std::to_string(expected);
+    EXPECT_EQ(expected, ParseInt64(s).value()) << s;
+  }
+}
+
+TEST(NumericParse, ParseInt64Failure) {
+  for (auto const* s : {"", "-", "+", "blah", " 1", "--1", "0x10"}) {
+    auto x = ParseInt64(s);
+    EXPECT_FALSE(x.ok()) << s;
+  }
+  EXPECT_THAT(ParseInt64("blah").status().message(),
+              HasSubstr("No numeric conversion"));
+
+  for (auto const* s : {"123blah", "1 ", "12345678x", "1234567x9",
+                        "1234567890123456789012x"}) {
+    auto x = ParseInt64(s);
+    ASSERT_FALSE(x.ok()) << s;
+    EXPECT_THAT(x.status().message(), HasSubstr("Trailing data")) << s;
+  }
+
+  for (auto const* s : {"9223372036854775808", "-9223372036854775809",
+                        "18446744073709551616", "99999999999999999999",
+                        "-123456789012345678901234567890"}) {
+    auto x = ParseInt64(s);
+    ASSERT_FALSE(x.ok()) << s;
+    EXPECT_THAT(x.status().message(), HasSubstr("INT64 value out of range"))
+        << s;
+  }
+}
+
+TEST(NumericParse, ParseFloat64) {
+  auto const inf = std::numeric_limits<double>::infinity();
+  EXPECT_EQ(inf, ParseFloat64("Infinity").value());
+  EXPECT_EQ(-inf, ParseFloat64("-Infinity").value());
+  EXPECT_TRUE(std::isnan(ParseFloat64("NaN").value()));
+
+  for (auto const* s : {"", "nan", "NaNs", "infinity", "+Infinity", "1.5",
+                        " NaN", "Infinity "}) {
+    auto x = ParseFloat64(s);
+    EXPECT_FALSE(x.ok()) << s;
+  }
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -16,6 +16,7 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_PARTIAL_RESULT_SET_READER_H
 
 #include "google/cloud/spanner/version.h"
+#include "google/cloud/future.h"
 #include "google/cloud/optional.h"
 #include "google/cloud/status.h"
 #include <google/spanner/v1/spanner.grpc.pb.h>
@@ -44,6 +45,30 @@ class PartialResultSetReader {
   virtual void TryCancel() = 0;
   virtual optional<google::spanner::v1::PartialResultSet> Read() = 0;
   virtual Status Finish() = 0;
+
+  /**
+   * Reads the next response into @p result, returns false at the end of the
+   * stream.
+   *
+   * Unlike `Read()`, this allows the caller to choose where the response is
+   * allocated, e.g., in a `google::protobuf::Arena`. Readers that can parse
+   * directly into @p result should override the default implementation,
+   * which copies the value returned by `Read()` if @p result is in an arena.
+   */
+  virtual bool ReadInto(google::spanner::v1::PartialResultSet* result) {
+    auto r = Read();
+    if (!r) return false;
+    *result = *std::move(r);
+    return true;
+  }
+
+  /**
+   * Returns a future satisfied when the next `ReadInto()` call would not block.
+   *
+   * Readers that cannot wait for the stream asynchronously should not
+   * override the default implementation, which returns a satisfied future.
+   */
+  virtual future<void> WhenReadable() { return make_ready_future(); }
 };
 
 }  // namespace internal
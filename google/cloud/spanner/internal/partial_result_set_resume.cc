@@ -13,7 +13,10 @@
 // limitations under the License.
 
 #include "google/cloud/spanner/internal/partial_result_set_resume.h"
+#include <chrono>
+#include <future>
 #include <thread>
+#include <utility>
 
 namespace google {
 namespace cloud {
@@ -21,35 +24,157 @@ namespace spanner {
 inline namespace SPANNER_CLIENT_NS {
 namespace internal {
 
-void PartialResultSetResume::TryCancel() { child_->TryCancel(); }
+void PartialResultSetResume::TryCancel() {
+  std::unique_lock<std::mutex> lk(state_->mu);
+  state_->cancelled = true;
+  state_->child->TryCancel();
+  auto pending = std::move(state_->pending);
+  lk.unlock();
+  // The cancelled timer fails, and that ends the resume.
+  if (pending.valid()) pending.cancel();
+}
 
 optional<google::spanner::v1::PartialResultSet> PartialResultSetResume::Read() {
+  google::spanner::v1::PartialResultSet result;
+  if (!ReadInto(&result)) return {};
+  return result;
+}
+
+bool PartialResultSetResume::ReadInto(
+    google::spanner::v1::PartialResultSet* result) {
+  if (!state_->cq) return ReadIntoBlocking(result);
+  // This blocks only if the caller did not wait for `WhenReadable()`.
+  ReadAhead(state_).get();
+  if (!state_->next) return false;
+  *result = *std::move(state_->next);
+  state_->next.reset();
+  return true;
+}
+
+future<void> PartialResultSetResume::WhenReadable() {
+  if (!state_->cq) return state_->child->WhenReadable();
+  return ReadAhead(state_);
+}
+
+Status PartialResultSetResume::Finish() {
+  std::unique_lock<std::mutex> lk(state_->mu);
+  // Finish() can be called only once, so cache the last result.
+  if (state_->last_status.has_value()) {
+    return *state_->last_status;
+  }
+  if (state_->cq && state_->cancelled) {
+    // Do not wait for the stream, or for a pending resume, this may run on a
+    // `CompletionQueue` thread.
+    return Status(StatusCode::kCancelled, "the stream was cancelled");
+  }
+  lk.unlock();
+  auto status = state_->child->Finish();
+  lk.lock();
+  state_->last_status = status;
+  return status;
+}
+
+bool PartialResultSetResume::ReadIntoBlocking(
+    google::spanner::v1::PartialResultSet* result) {
+  auto& state = *state_;
   do {
-    optional<google::spanner::v1::PartialResultSet> result = child_->Read();
-    if (result) {
-      last_resume_token_ = result->resume_token();
-      return result;
+    if (state.child->ReadInto(result)) {
+      state.last_resume_token = result->resume_token();
+      return true;
     }
     auto status = Finish();
-    if (status.ok()) return {};
-    if (is_idempotent_ == Idempotency::kNotIdempotent ||
-        !retry_policy_prototype_->OnFailure(status)) {
-      return {};
+    if (status.ok()) return false;
+    if (state.is_idempotent == Idempotency::kNotIdempotent ||
+        !state.retry_policy_prototype->OnFailure(status)) {
+      return false;
     }
-    std::this_thread::sleep_for(backoff_policy_prototype_->OnCompletion());
-    last_status_.reset();
-    child_ = factory_(last_resume_token_);
-  } while (!retry_policy_prototype_->IsExhausted());
-  return {};
+    std::this_thread::sleep_for(state.backoff_policy_prototype->OnCompletion());
+    state.last_status.reset();
+    state.child = state.factory(state.last_resume_token);
+  } while (!state.retry_policy_prototype->IsExhausted());
+  return false;
 }
 
-Status PartialResultSetResume::Finish() {
-  // Finish() can be called only once, so cache the last result.
-  if (last_status_.has_value()) {
-    return *last_status_;
+future<void> PartialResultSetResume::ReadAhead(
+    std::shared_ptr<State> const& state) {
+  {
+    std::lock_guard<std::mutex> lk(state->mu);
+    if (state->next || state->last_status) return make_ready_future();
+  }
+  auto readable = state->child->WhenReadable();
+  if (readable.wait_for(std::chrono::seconds(0)) !=
+      std::future_status::ready) {
+    return readable.then([state](future<void>) { return ReadAhead(state); });
+  }
+
+  // Neither `ReadInto()` nor `Finish()` block once the child is readable.
+  google::spanner::v1::PartialResultSet response;
+  if (state->child->ReadInto(&response)) {
+    state->last_resume_token = response.resume_token();
+    state->next = std::move(response);
+    return make_ready_future();
+  }
+  auto status = state->child->Finish();
+  std::unique_lock<std::mutex> lk(state->mu);
+  if (status.ok() || state->cancelled ||
+      state->is_idempotent == Idempotency::kNotIdempotent ||
+      !state->retry_policy_prototype->OnFailure(status)) {
+    state->last_status = std::move(status);
+    return make_ready_future();
+  }
+  auto const sequence = ++state->sequence;
+  lk.unlock();
+
+  // Wait for the backoff on a timer, then read from a new stream.
+  auto done = std::make_shared<promise<void>>();
+  auto f = done->get_future();
+  Track(*state, sequence,
+        state->cq
+            ->MakeRelativeTimer(
+                state->backoff_policy_prototype->OnCompletion())
+            .then([state, done](future<StatusOr<
+                                    std::chrono::system_clock::time_point>>
+                                    f) {
+              OnBackoff(*state, f.get().status());
+              ReadAhead(state).then(
+                  [done](future<void>) { done->set_value(); });
+            }));
+  return f;
+}
+
+void PartialResultSetResume::Track(State& state, std::uint64_t sequence,
+                                   future<void> pending) {
+  std::unique_lock<std::mutex> lk(state.mu);
+  if (state.cancelled) {
+    lk.unlock();
+    pending.cancel();
+    return;
+  }
+  if (sequence < state.tracked_sequence) return;
+  state.tracked_sequence = sequence;
+  state.pending = std::move(pending);
+}
+
+void PartialResultSetResume::OnBackoff(State& state,
+                                       Status const& timer_status) {
+  std::unique_lock<std::mutex> lk(state.mu);
+  if (state.cancelled) {
+    state.last_status = Status(StatusCode::kCancelled,
+                               "the stream was cancelled");
+    return;
+  }
+  // The timer fails only if it is cancelled, e.g., during shutdown.
+  if (!timer_status.ok()) {
+    state.last_status = timer_status;
+    return;
   }
-  last_status_ = child_->Finish();
-  return *last_status_;
+  lk.unlock();
+  auto child = state.factory(state.last_resume_token);
+  lk.lock();
+  if (state.cancelled) child->TryCancel();
+  state.child.swap(child);
+  lk.unlock();
+  // The previous child is released without the lock.
 }
 
 }  // namespace internal
@@ -18,8 +18,15 @@
 #include "google/cloud/spanner/backoff_policy.h"
 #include "google/cloud/spanner/internal/partial_result_set_reader.h"
 #include "google/cloud/spanner/retry_policy.h"
+#include "google/cloud/completion_queue.h"
+#include "google/cloud/future.h"
+#include "google/cloud/optional.h"
+#include "google/cloud/status.h"
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <string>
 
 namespace google {
 namespace cloud {
@@ -38,6 +45,12 @@ enum class Idempotency {
 
 /**
  * A PartialResultSetReader that resumes the streaming RPC on retryable errors.
+ *
+ * If created with a `CompletionQueue`, `WhenReadable()` also resumes the
+ * stream: it waits for the backoff with a timer on that queue, and then for
+ * the new stream, so it never blocks. This requires readers, created by the
+ * factory, that support `WhenReadable()`. Otherwise `ReadInto()` sleeps
+ * during the backoff.
  */
 class PartialResultSetResume : public PartialResultSetReader {
  public:
@@ -45,26 +58,69 @@ class PartialResultSetResume : public PartialResultSetReader {
                          Idempotency is_idempotent,
                          std::unique_ptr<RetryPolicy> retry_policy,
                          std::unique_ptr<BackoffPolicy> backoff_policy)
-      : factory_(std::move(factory)),
-        is_idempotent_(is_idempotent),
-        retry_policy_prototype_(std::move(retry_policy)),
-        backoff_policy_prototype_(std::move(backoff_policy)),
-        child_(factory_(last_resume_token_)) {}
+      : state_(std::make_shared<State>(
+            std::move(factory), is_idempotent, std::move(retry_policy),
+            std::move(backoff_policy), optional<CompletionQueue>{})) {}
+
+  PartialResultSetResume(PartialResultSetReaderFactory factory,
+                         Idempotency is_idempotent,
+                         std::unique_ptr<RetryPolicy> retry_policy,
+                         std::unique_ptr<BackoffPolicy> backoff_policy,
+                         CompletionQueue cq)
+      : state_(std::make_shared<State>(
+            std::move(factory), is_idempotent, std::move(retry_policy),
+            std::move(backoff_policy), std::move(cq))) {}
 
   ~PartialResultSetResume() override = default;
 
   void TryCancel() override;
   optional<google::spanner::v1::PartialResultSet> Read() override;
   Status Finish() override;
+  bool ReadInto(google::spanner::v1::PartialResultSet* result) override;
+  /// There can be only one pending `WhenReadable()` future at a time.
+  future<void> WhenReadable() override;
 
  private:
-  PartialResultSetReaderFactory factory_;
-  Idempotency is_idempotent_;
-  std::unique_ptr<RetryPolicy> retry_policy_prototype_;
-  std::unique_ptr<BackoffPolicy> backoff_policy_prototype_;
-  std::string last_resume_token_;
-  std::unique_ptr<PartialResultSetReader> child_;
-  optional<Status> last_status_;
+  // The state shared with the pending timers and `WhenReadable()` callbacks,
+  // which may outlive the reader.
+  struct State {
+    State(PartialResultSetReaderFactory f, Idempotency i,
+          std::unique_ptr<RetryPolicy> r, std::unique_ptr<BackoffPolicy> b,
+          optional<CompletionQueue> q)
+        : factory(std::move(f)),
+          is_idempotent(i),
+          retry_policy_prototype(std::move(r)),
+          backoff_policy_prototype(std::move(b)),
+          cq(std::move(q)),
+          child(factory(last_resume_token)) {}
+
+    PartialResultSetReaderFactory factory;
+    Idempotency is_idempotent;
+    std::unique_ptr<RetryPolicy> retry_policy_prototype;
+    std::unique_ptr<BackoffPolicy> backoff_policy_prototype;
+    optional<CompletionQueue> cq;
+    std::string last_resume_token;
+    // `TryCancel()` and `Finish()` may be called while a timer callback
+    // resumes the stream, which replaces `child` with the lock held.
+    std::mutex mu;
+    std::unique_ptr<PartialResultSetReader> child;
+    optional<Status> last_status;  // GUARDED_BY(mu)
+    bool cancelled = false;        // GUARDED_BY(mu)
+    // The pending backoff timer, the sequence number keeps the latest one.
+    future<void> pending;                  // GUARDED_BY(mu)
+    std::uint64_t sequence = 0;            // GUARDED_BY(mu)
+    std::uint64_t tracked_sequence = 0;    // GUARDED_BY(mu)
+    // The response read ahead by `WhenReadable()`.
+    optional<google::spanner::v1::PartialResultSet> next;
+  };
+
+  bool ReadIntoBlocking(google::spanner::v1::PartialResultSet* result);
+  static future<void> ReadAhead(std::shared_ptr<State> const& state);
+  static void Track(State& state, std::uint64_t sequence,
+                    future<void> pending);
+  static void OnBackoff(State& state, Status const& timer_status);
+
+  std::shared_ptr<State> state_;
 };
 
 }  // namespace internal
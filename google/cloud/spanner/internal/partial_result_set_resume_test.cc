@@ -18,10 +18,13 @@
 #include "google/cloud/spanner/value.h"
 #include "google/cloud/internal/make_unique.h"
 #include "google/cloud/testing_util/assert_ok.h"
+#include "google/cloud/testing_util/mock_completion_queue.h"
 #include <google/protobuf/text_format.h>
 #include <gmock/gmock.h>
 #include <array>
+#include <chrono>
 #include <cstdint>
+#include <future>
 #include <string>
 
 namespace google {
@@ -36,6 +39,7 @@ namespace spanner_proto = ::google::spanner::v1;
 using ::google::cloud::internal::make_unique;
 using ::google::cloud::spanner_testing::IsProtoEqual;
 using ::google::cloud::spanner_testing::MockPartialResultSetReader;
+using ::google::cloud::testing_util::MockCompletionQueue;
 using ::google::protobuf::TextFormat;
 using ::testing::_;
 using ::testing::AtLeast;
@@ -60,6 +64,18 @@ std::unique_ptr<PartialResultSetReader> MakeTestResume(
           .clone());
 }
 
+std::unique_ptr<PartialResultSetReader> MakeTestResume(
+    PartialResultSetReaderFactory factory, CompletionQueue cq) {
+  return google::cloud::internal::make_unique<PartialResultSetResume>(
+      std::move(factory), Idempotency::kIdempotent,
+      LimitedErrorCountRetryPolicy(/*maximum_failures=*/2).clone(),
+      ExponentialBackoffPolicy(/*initial_delay=*/std::chrono::microseconds(1),
+                               /*maximum_delay=*/std::chrono::microseconds(1),
+                               /*scaling=*/2.0)
+          .clone(),
+      std::move(cq));
+}
+
 TEST(PartialResultSetResume, Success) {
   spanner_proto::PartialResultSet response;
   auto constexpr kText =
@@ -295,6 +311,121 @@ TEST(PartialResultSetResume, TooManyTransients) {
   EXPECT_THAT(status.message(), HasSubstr("try-again-N"));
 }
 
+TEST(PartialResultSetResume, RestartOnCompletionQueue) {
+  auto constexpr kText0 = R"pb(
+    metadata: {
+      row_type: {
+        fields: {
+          name: "TestColumn",
+          type: { code: STRING }
+        }
+      }
+    }
+    resume_token: "test-token-0"
+    values: { string_value: "value-1" }
+  )pb";
+  spanner_proto::PartialResultSet r0;
+  ASSERT_TRUE(TextFormat::ParseFromString(kText0, &r0));
+  spanner_proto::PartialResultSet r1;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"pb(values: { string_value: "value-2" })pb", &r1));
+
+  MockFactory mock_factory;
+  EXPECT_CALL(mock_factory, MakeReader(_))
+      .WillOnce([&r0](std::string const& token) {
+        EXPECT_TRUE(token.empty());
+        auto mock = make_unique<MockPartialResultSetReader>();
+        EXPECT_CALL(*mock, WhenReadable()).WillRepeatedly([] {
+          return make_ready_future();
+        });
+        EXPECT_CALL(*mock, Read())
+            .WillOnce([&r0] { return ReadReturn(r0); })
+            .WillOnce(Return(ReadReturn{}));
+        EXPECT_CALL(*mock, Finish())
+            .WillOnce(Return(Status(StatusCode::kUnavailable, "try-again-0")));
+        return mock;
+      })
+      .WillOnce([&r1](std::string const& token) {
+        EXPECT_EQ("test-token-0", token);
+        auto mock = make_unique<MockPartialResultSetReader>();
+        EXPECT_CALL(*mock, WhenReadable()).WillRepeatedly([] {
+          return make_ready_future();
+        });
+        EXPECT_CALL(*mock, Read())
+            .WillOnce([&r1] { return ReadReturn(r1); })
+            .WillOnce(Return(ReadReturn{}));
+        EXPECT_CALL(*mock, Finish()).WillOnce(Return(Status()));
+        return mock;
+      });
+
+  auto factory = [&mock_factory](std::string const& token) {
+    return mock_factory.MakeReader(token);
+  };
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto reader = MakeTestResume(factory, CompletionQueue(impl));
+  auto readable = reader->WhenReadable();
+  EXPECT_EQ(std::future_status::ready,
+            readable.wait_for(std::chrono::seconds(0)));
+  auto v = reader->Read();
+  ASSERT_TRUE(v.has_value());
+  EXPECT_THAT(*v, IsProtoEqual(r0));
+
+  // The first stream fails, `WhenReadable()` waits for the backoff timer
+  // instead of blocking the caller.
+  readable = reader->WhenReadable();
+  EXPECT_NE(std::future_status::ready,
+            readable.wait_for(std::chrono::seconds(0)));
+  EXPECT_EQ(1, impl->size());
+  impl->SimulateCompletion(true);
+  EXPECT_EQ(std::future_status::ready,
+            readable.wait_for(std::chrono::seconds(0)));
+
+  v = reader->Read();
+  ASSERT_TRUE(v.has_value());
+  EXPECT_THAT(*v, IsProtoEqual(r1));
+  readable = reader->WhenReadable();
+  EXPECT_EQ(std::future_status::ready,
+            readable.wait_for(std::chrono::seconds(0)));
+  v = reader->Read();
+  ASSERT_FALSE(v.has_value());
+  auto status = reader->Finish();
+  EXPECT_STATUS_OK(status);
+}
+
+TEST(PartialResultSetResume, CancelDuringBackoff) {
+  MockFactory mock_factory;
+  EXPECT_CALL(mock_factory, MakeReader(_)).WillOnce([](std::string const&) {
+    auto mock = make_unique<MockPartialResultSetReader>();
+    EXPECT_CALL(*mock, WhenReadable()).WillRepeatedly([] {
+      return make_ready_future();
+    });
+    EXPECT_CALL(*mock, Read()).WillOnce(Return(ReadReturn{}));
+    EXPECT_CALL(*mock, Finish())
+        .WillOnce(Return(Status(StatusCode::kUnavailable, "try-again-0")));
+    EXPECT_CALL(*mock, TryCancel()).Times(1);
+    return mock;
+  });
+
+  auto factory = [&mock_factory](std::string const& token) {
+    return mock_factory.MakeReader(token);
+  };
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto reader = MakeTestResume(factory, CompletionQueue(impl));
+  auto readable = reader->WhenReadable();
+  EXPECT_NE(std::future_status::ready,
+            readable.wait_for(std::chrono::seconds(0)));
+
+  // Cancelling the reader cancels the timer, and the stream is not resumed.
+  reader->TryCancel();
+  impl->SimulateCompletion(false);
+  EXPECT_EQ(std::future_status::ready,
+            readable.wait_for(std::chrono::seconds(0)));
+  auto v = reader->Read();
+  ASSERT_FALSE(v.has_value());
+  auto status = reader->Finish();
+  EXPECT_EQ(StatusCode::kCancelled, status.code());
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace SPANNER_CLIENT_NS
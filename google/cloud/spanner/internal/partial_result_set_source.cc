@@ -13,8 +13,10 @@
 // limitations under the License.
 
 #include "google/cloud/spanner/internal/partial_result_set_source.h"
-#include "google/cloud/spanner/internal/merge_chunk.h"
+#include "google/cloud/internal/make_unique.h"
 #include "google/cloud/log.h"
+#include <algorithm>
+#include <chrono>
 
 namespace google {
 namespace cloud {
@@ -22,10 +24,17 @@ namespace spanner {
 inline namespace SPANNER_CLIENT_NS {
 namespace internal {
 
+namespace {
+// The arena starts with a block of this size, and grows it to fit the largest
+// response seen so far, up to `kMaxArenaBlockSize`.
+std::size_t constexpr kMinArenaBlockSize = 64 * 1024;
+std::size_t constexpr kMaxArenaBlockSize = 8 * 1024 * 1024;
+}  // namespace
+
 StatusOr<std::unique_ptr<ResultSourceInterface>> PartialResultSetSource::Create(
-    std::unique_ptr<PartialResultSetReader> reader) {
+    std::unique_ptr<PartialResultSetReader> reader, bool use_arena) {
   std::unique_ptr<PartialResultSetSource> source(
-      new PartialResultSetSource(std::move(reader)));
+      new PartialResultSetSource(std::move(reader), use_arena));
 
   // Do the first read so the metadata is immediately available.
   auto status = source->ReadFromStream();
@@ -42,42 +51,155 @@ StatusOr<std::unique_ptr<ResultSourceInterface>> PartialResultSetSource::Create(
 }
 
 StatusOr<Row> PartialResultSetSource::NextRow() {
-  if (finished_) {
-    return Row();
+  auto buffered = BufferRow();
+  if (!buffered) return std::move(buffered).status();
+  if (!*buffered) return Row();
+  return TakeRow();
+}
+
+StatusOr<std::vector<Row>> PartialResultSetSource::NextRows(
+    std::size_t max_rows) {
+  std::vector<Row> rows;
+  while (rows.size() < max_rows) {
+    auto buffered = BufferRow();
+    if (!buffered) return std::move(buffered).status();
+    if (!*buffered) break;
+    // Hands out all the complete rows in the last response in one pass.
+    auto const n = (std::min)(BufferedRows(), max_rows - rows.size());
+    rows.reserve(rows.size() + n);
+    for (std::size_t i = 0; i != n; ++i) rows.push_back(TakeRow());
+  }
+  return rows;
+}
+
+StatusOr<ColumnBatch> PartialResultSetSource::NextBatch(
+    std::size_t max_rows) {
+  std::vector<google::spanner::v1::TypeCode> type_codes;
+  type_codes.reserve(column_types_->size());
+  for (auto const& type : *column_types_) type_codes.push_back(type->code());
+  auto builder = ColumnBatchBuilder::Create(columns_, type_codes);
+  if (!builder) return std::move(builder).status();
+
+  // The values are decoded straight from the buffered protos, no `Row` or
+  // `Value` objects are created.
+  auto const columns = column_types_->size();
+  while (builder->size() < max_rows) {
+    auto buffered = BufferRow();
+    if (!buffered) return std::move(buffered).status();
+    if (!*buffered) break;
+    auto const n = (std::min)(BufferedRows(), max_rows - builder->size());
+    for (std::size_t r = 0; r != n; ++r) {
+      for (std::size_t i = 0; i != columns; ++i) {
+        auto status = builder->Append(i, *buffer_[buffer_pos_ + i]);
+        if (status.ok()) continue;
+        // The builder discarded the partial row. Return the rows before it,
+        // the next call finds the bad value first, skips its row, and reports
+        // the error.
+        if (builder->size() != 0) return std::move(*builder).Build();
+        buffer_pos_ += columns;
+        return status;
+      }
+      buffer_pos_ += columns;
+    }
+  }
+  return std::move(*builder).Build();
+}
+
+StatusOr<bool> PartialResultSetSource::NextRowProtos(
+    std::vector<google::protobuf::Value*>& values) {
+  auto buffered = BufferRow();
+  if (!buffered || !*buffered) return buffered;
+  // The protos remain valid until the next read from the stream, which cannot
+  // happen before the next call.
+  auto* begin = buffer_.data() + buffer_pos_;
+  buffer_pos_ += column_types_->size();
+  values.assign(begin, buffer_.data() + buffer_pos_);
+  return true;
+}
+
+future<void> PartialResultSetSource::WhenRowReady() {
+  // Consume the responses already received until there is a complete row.
+  for (;;) {
+    auto const columns = column_types_->size();
+    auto const has_row =
+        columns != 0 && buffer_.size() - buffer_pos_ >= columns;
+    if (finished_ || has_row) return make_ready_future();
+    auto readable = reader_->WhenReadable();
+    if (readable.wait_for(std::chrono::seconds(0)) !=
+        std::future_status::ready) {
+      return readable;
+    }
+    auto status = ReadFromStream();
+    if (status.ok() && finished_) status = EndOfStreamStatus();
+    if (!status.ok()) {
+      // Reported by the next call to `BufferRow()`.
+      deferred_status_ = std::move(status);
+      return make_ready_future();
+    }
+  }
+}
+
+StatusOr<bool> PartialResultSetSource::BufferRow() {
+  auto const columns = column_types_->size();
+  // Most calls find a complete row already buffered.
+  if (columns != 0 && buffer_.size() - buffer_pos_ >= columns) return true;
+  if (!deferred_status_.ok()) {
+    auto status = std::move(deferred_status_);
+    deferred_status_ = Status();
+    return status;
   }
+  if (finished_) return false;
 
-  while (buffer_.empty() || buffer_.size() < columns_->size()) {
+  while (buffer_.size() == buffer_pos_ ||
+         buffer_.size() - buffer_pos_ < columns) {
     auto status = ReadFromStream();
     if (!status.ok()) {
       return status;
     }
     if (finished_) {
-      if (chunk_) {
-        return Status(StatusCode::kInternal,
-                      "incomplete chunked_value at end of stream");
-      }
-      if (!buffer_.empty()) {
-        return Status(StatusCode::kInternal, "incomplete row at end of stream");
-      }
-      return Row();
+      status = EndOfStreamStatus();
+      if (!status.ok()) return status;
+      return false;
     }
   }
-
-  auto const& fields = metadata_->row_type().fields();
-  if (fields.empty()) {
+  if (columns == 0) {
     return Status(StatusCode::kInternal,
                   "response metadata is missing row type information");
   }
+  return true;
+}
 
-  std::vector<Value> values;
-  values.reserve(fields.size());
-  auto iter = buffer_.begin();
-  for (auto const& field : fields) {
-    values.push_back(FromProto(field.type(), std::move(*iter)));
-    ++iter;
+Status PartialResultSetSource::EndOfStreamStatus() const {
+  if (chunk_) {
+    return Status(StatusCode::kInternal,
+                  "incomplete chunked_value at end of stream");
+  }
+  if (buffer_.size() != buffer_pos_) {
+    return Status(StatusCode::kInternal, "incomplete row at end of stream");
+  }
+  return Status();
+}
+
+Row PartialResultSetSource::TakeRow() {
+  release_arena_ = arena_ != nullptr;
+  // The cells are decoded only when the caller asks for them, the row shares
+  // the (immutable) column types, names, and positions with every other row.
+  std::vector<google::protobuf::Value> protos(column_types_->size());
+  for (auto& p : protos) {
+    // Copies the value if it is in the arena, otherwise this is cheap.
+    p = std::move(*buffer_[buffer_pos_++]);
+  }
+  return internal::MakeRow(std::move(protos), column_types_, columns_,
+                           column_positions_);
+}
+
+PartialResultSetSource::PartialResultSetSource(
+    std::unique_ptr<PartialResultSetReader> reader, bool use_arena)
+    : reader_(std::move(reader)) {
+  if (use_arena) {
+    arena_block_.resize(kMinArenaBlockSize);
+    arena_ = MakeArena();
   }
-  buffer_.erase(buffer_.begin(), iter);
-  return internal::MakeRow(std::move(values), columns_);
 }
 
 PartialResultSetSource::~PartialResultSetSource() {
@@ -95,11 +217,56 @@ PartialResultSetSource::~PartialResultSetSource() {
   }
 }
 
+std::unique_ptr<google::protobuf::Arena> PartialResultSetSource::MakeArena() {
+  google::protobuf::ArenaOptions options;
+  options.initial_block = arena_block_.data();
+  options.initial_block_size = arena_block_.size();
+  options.start_block_size = arena_block_.size();
+  options.max_block_size = kMaxArenaBlockSize;
+  return google::cloud::internal::make_unique<google::protobuf::Arena>(options);
+}
+
+void PartialResultSetSource::Recycle() {
+  std::vector<google::protobuf::Value> carry;
+  carry.reserve(buffer_.size() - buffer_pos_);
+  for (auto i = buffer_pos_; i != buffer_.size(); ++i) {
+    carry.push_back(std::move(*buffer_[i]));
+  }
+  carry_.swap(carry);
+  buffer_.clear();  // keeps the capacity
+  buffer_pos_ = 0;
+  for (auto& v : carry_) buffer_.push_back(&v);
+  if (!arena_) return;
+  if (release_arena_) {
+    // The values are copied into `Row`s anyway, parse them on the heap.
+    arena_.reset();
+    arena_block_ = {};
+    return;
+  }
+
+  // Resetting the arena keeps its initial block, if the last response did not
+  // fit, start over with a larger one.
+  auto const allocated = static_cast<std::size_t>(arena_->Reset());
+  if (allocated <= arena_block_.size() ||
+      arena_block_.size() >= kMaxArenaBlockSize) {
+    return;
+  }
+  arena_.reset();
+  auto size = arena_block_.size();
+  while (size < allocated && size < kMaxArenaBlockSize) size *= 2;
+  arena_block_.resize(size);
+  arena_ = MakeArena();
+}
+
 Status PartialResultSetSource::ReadFromStream() {
-  auto result_set = reader_->Read();
-  if (!result_set) {
-    // Read() returns false for end of stream, whether we read all the data or
-    // encountered an error. Finish() tells us the status.
+  Recycle();
+  auto* result_set =
+      arena_ ? google::protobuf::Arena::CreateMessage<
+                   google::spanner::v1::PartialResultSet>(arena_.get())
+             : &heap_response_;
+  if (!reader_->ReadInto(result_set)) {
+    // ReadInto() returns false for end of stream, whether we read all the data
+    // or encountered an error. Finish() tells us the status.
     finished_ = true;
     return reader_->Finish();
   }
@@ -111,11 +278,16 @@ Status PartialResultSetSource::ReadFromStream() {
     } else {
       metadata_ = std::move(*result_set->mutable_metadata());
       // Copies the column names into a shared_ptr that will be shared with
-      // every Row object returned from NextRow().
+      // every Row object returned from NextRow(). Likewise, the column types
+      // are shared with every Row and every Value created from those rows.
       columns_ = std::make_shared<std::vector<std::string>>();
       for (auto const& field : metadata_->row_type().fields()) {
         columns_->push_back(field.name());
+        column_types_->push_back(
+            std::make_shared<google::spanner::v1::Type const>(field.type()));
       }
+      // The rows find their columns by name in this (shared) index.
+      column_positions_ = MakeColumnPositions(*columns_);
     }
   }
 
@@ -146,20 +318,24 @@ Status PartialResultSetSource::ReadFromStream() {
   //
   // n.b. One value can span more than two responses (the `E1E2E3` case above);
   // the code "just works" without needing to treat that as a special-case.
+  int begin = 0;
+  int end = new_values.size();
   if (chunk_) {
     if (new_values.empty()) {
       return Status(StatusCode::kInternal,
                     "PartialResultSet contained no values "
                     "to merge with prior chunked_value");
     }
-    auto& front = new_values[0];
-    auto merge_status = MergeChunk(*chunk_, std::move(front));
+    auto merge_status = chunk_->Append(std::move(new_values[0]));
     if (!merge_status.ok()) {
       return merge_status;
     }
-    using std::swap;
-    swap(*chunk_, front);
+    // The value may continue in the next response (the `E2` case above).
+    if (end == 1 && result_set->chunked_value()) return {};
+    merged_ = std::move(*chunk_).Finish();
     chunk_ = {};
+    buffer_.push_back(&merged_);
+    begin = 1;
   }
 
   if (result_set->chunked_value()) {
@@ -168,13 +344,13 @@ Status PartialResultSetSource::ReadFromStream() {
                     "PartialResultSet had chunked_value "
                     "set true but contained no values");
     }
-    chunk_ = std::move(new_values[new_values.size() - 1]);
-    new_values.RemoveLast();
+    chunk_ = ChunkedValue(std::move(new_values[--end]));
   }
 
-  // Moves all the remaining in new_values to buffer_
-  for (auto& value_proto : new_values) {
-    buffer_.push_back(std::move(value_proto));
+  // Adds all the remaining in new_values to buffer_
+  buffer_.reserve(buffer_.size() + static_cast<std::size_t>(end - begin));
+  for (auto i = begin; i != end; ++i) {
+    buffer_.push_back(&new_values[i]);
   }
 
   return {};  // OK
@@ -15,17 +15,20 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_PARTIAL_RESULT_SET_SOURCE_H
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_PARTIAL_RESULT_SET_SOURCE_H
 
+#include "google/cloud/spanner/internal/merge_chunk.h"
 #include "google/cloud/spanner/internal/partial_result_set_reader.h"
 #include "google/cloud/spanner/results.h"
 #include "google/cloud/spanner/value.h"
+#include "google/cloud/future.h"
 #include "google/cloud/optional.h"
 #include "google/cloud/status.h"
 #include "google/cloud/status_or.h"
+#include <google/protobuf/arena.h>
 #include <google/spanner/v1/spanner.grpc.pb.h>
 #include <google/spanner/v1/spanner.pb.h>
 #include <grpcpp/grpcpp.h>
-#include <deque>
 #include <memory>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -37,17 +40,47 @@ namespace internal {
  * This class serves as a bridge between the gRPC `PartialResultSet` streaming
  * reader and the spanner `ResultSet`, which is used to iterate over the rows
  * returned from a read operation.
+ *
+ * Optionally, the responses are parsed into a `google::protobuf::Arena`, which
+ * is reset (and its memory reused) before each read. Only `NextBatch()` and
+ * the `ProtoRowSource` interface, which decode the values directly from the
+ * arena, benefit from it. A `Row` must own copies of its values, copying them
+ * out of the arena costs more than the arena saves, so the source stops using
+ * it once the application reads a `Row`. Applications that consume `Row`s
+ * gain nothing from the arena.
  */
-class PartialResultSetSource : public internal::ResultSourceInterface {
+class PartialResultSetSource : public internal::ResultSourceInterface,
+                               public internal::ProtoRowSource {
  public:
-  /// Factory method to create a PartialResultSetSource.
+  /**
+   * Factory method to create a PartialResultSetSource.
+   *
+   * With @p use_arena the responses are parsed into a reused arena until the
+   * first `Row` is read. This only saves allocations for `NextBatch()` and
+   * `ProtoRowSource` consumers, `Row` consumers gain nothing.
+   */
   static StatusOr<std::unique_ptr<ResultSourceInterface>> Create(
-      std::unique_ptr<PartialResultSetReader> reader);
+      std::unique_ptr<PartialResultSetReader> reader, bool use_arena = false);
 
   ~PartialResultSetSource() override;
 
   StatusOr<Row> NextRow() override;
 
+  future<void> WhenRowReady() override;
+
+  StatusOr<ColumnBatch> NextBatch(std::size_t max_rows) override;
+
+  StatusOr<std::vector<Row>> NextRows(std::size_t max_rows) override;
+
+  ProtoRowSource* AsProtoRowSource() override { return this; }
+
+  google::spanner::v1::StructType const* RowType() override {
+    return metadata_ ? &metadata_->row_type() : nullptr;
+  }
+
+  StatusOr<bool> NextRowProtos(
+      std::vector<google::protobuf::Value*>& values) override;
+
   optional<google::spanner::v1::ResultSetMetadata> Metadata() override {
     return metadata_;
   }
@@ -57,19 +90,58 @@ class PartialResultSetSource : public internal::ResultSourceInterface {
   }
 
  private:
-  explicit PartialResultSetSource(
-      std::unique_ptr<PartialResultSetReader> reader)
-      : reader_(std::move(reader)) {}
+  PartialResultSetSource(std::unique_ptr<PartialResultSetReader> reader,
+                         bool use_arena);
 
   Status ReadFromStream();
 
+  // Releases the storage of the consumed values, before the next read reuses
+  // it. The values not yet returned (at most a partial row) are moved to
+  // `carry_`.
+  void Recycle();
+
+  std::unique_ptr<google::protobuf::Arena> MakeArena();
+
+  // Reads from the stream until `buffer_` holds a complete row. Returns false
+  // at the end of the stream.
+  StatusOr<bool> BufferRow();
+
+  // The error, if any, for a stream that ended with a partial row or value.
+  Status EndOfStreamStatus() const;
+
+  // The number of complete rows in `buffer_`, requires a non-empty row type.
+  std::size_t BufferedRows() const {
+    return (buffer_.size() - buffer_pos_) / column_types_->size();
+  }
+
+  // Removes the next row from `buffer_`, which must hold a complete row.
+  Row TakeRow();
+
   std::unique_ptr<PartialResultSetReader> reader_;
   optional<google::spanner::v1::ResultSetMetadata> metadata_;
   optional<google::spanner::v1::ResultSetStats> stats_;
-  std::deque<google::protobuf::Value> buffer_;
-  optional<google::protobuf::Value> chunk_;
+  // The values received from the stream, those before `buffer_pos_` have been
+  // returned already. They point into the last response, which is allocated in
+  // `arena_` or is `heap_response_`, into `carry_`, or to `merged_`. The
+  // consumed prefix is discarded (keeping the capacity) by the next read, so
+  // handing out a row only advances `buffer_pos_`.
+  std::vector<google::protobuf::Value*> buffer_;
+  std::size_t buffer_pos_ = 0;
+  std::vector<google::protobuf::Value> carry_;
+  google::spanner::v1::PartialResultSet heap_response_;
+  std::vector<char> arena_block_;
+  std::unique_ptr<google::protobuf::Arena> arena_;  // nullptr if not in use
+  // Set when a `Row` is returned, the next read releases `arena_`.
+  bool release_arena_ = false;
+  // The value continued by the next response, and the last value completed.
+  optional<ChunkedValue> chunk_;
+  google::protobuf::Value merged_;
   std::shared_ptr<std::vector<std::string>> columns_;
+  std::shared_ptr<ColumnPositions const> column_positions_;
+  std::shared_ptr<ColumnTypes> column_types_ = std::make_shared<ColumnTypes>();
   bool finished_ = false;
+  // An error found by `WhenRowReady()`, returned by the next `BufferRow()`.
+  Status deferred_status_;
 };
 
 }  // namespace internal
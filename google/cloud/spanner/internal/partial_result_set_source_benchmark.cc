@@ -0,0 +1,312 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/partial_result_set_source.h"
+#include "google/cloud/internal/make_unique.h"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+// Counts the calls to the global `operator new`, so the benchmarks can report
+// how many allocations are needed per row.
+std::atomic<std::int64_t> allocation_count{0};
+}  // namespace
+
+void* operator new(std::size_t size) {
+  ++allocation_count;
+  if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+namespace spanner_proto = ::google::spanner::v1;
+
+// The `Value`s of a result set share the `Type` of their column, instead of
+// each one holding a copy. That change was measured with the `NextRow()`
+// benchmarks below (without the arena, which came later), on one 2.1 GHz
+// core, built with -O2 -DNDEBUG. The time is the median of 7 repetitions, the
+// allocations per row are in parentheses. `multiple_rows_cpu_benchmark` needs
+// a Spanner instance and was not used.
+//
+// Benchmark                                  Copied Type       Shared Type
+// BM_PartialResultSetSourceNextRow/10        3.02ms (26.8)     3.42ms (26.8)
+// BM_PartialResultSetSourceNextRow/100       34.0ms (258)      31.5ms (258)
+// BM_PartialResultSetSourceNextRowArrays/1   1.94ms (24.2)     1.70ms (23.2)
+// BM_PartialResultSetSourceNextRowArrays/10  22.0ms (232)      19.4ms (222)
+// BM_PartialResultSetSourceNextRowArrays/100  236ms (2308)      168ms (2208)
+//
+// Copying a scalar `Type` does not allocate, so the INT64 and STRING columns
+// only differ by noise (a second run of the 10 column case took 4.58ms with
+// copied types). Each ARRAY<INT64> cell saves one allocation.
+
+auto constexpr kRowsPerResponse = 64;
+auto constexpr kResponses = 16;
+
+// Returns the serialized responses for a scan of `columns` wide rows, where
+// the columns alternate between INT64 and STRING.
+std::shared_ptr<std::vector<std::string>> MakeResponses(int columns) {
+  auto responses = std::make_shared<std::vector<std::string>>();
+  for (int r = 0; r != kResponses; ++r) {
+    spanner_proto::PartialResultSet response;
+    if (r == 0) {
+      auto& row_type = *response.mutable_metadata()->mutable_row_type();
+      for (int c = 0; c != columns; ++c) {
+        auto& field = *row_type.add_fields();
+        field.set_name("Column" + std::to_string(c));
+        field.mutable_type()->set_code(c % 2 == 0 ? spanner_proto::INT64
+                                                  : spanner_proto::STRING);
+      }
+    }
+    for (int row = 0; row != kRowsPerResponse; ++row) {
+      for (int c = 0; c != columns; ++c) {
+        auto const id = (r * kRowsPerResponse + row) * columns + c;
+        response.add_values()->set_string_value(
+            c % 2 == 0 ? std::to_string(id)
+                       : "a string value for cell " + std::to_string(id));
+      }
+    }
+    responses->push_back(response.SerializeAsString());
+  }
+  return responses;
+}
+
+// Returns the serialized responses for a scan of `columns` wide rows, where
+// every column is an ARRAY<INT64> with 8 elements.
+std::shared_ptr<std::vector<std::string>> MakeArrayResponses(int columns) {
+  auto responses = std::make_shared<std::vector<std::string>>();
+  for (int r = 0; r != kResponses; ++r) {
+    spanner_proto::PartialResultSet response;
+    if (r == 0) {
+      auto& row_type = *response.mutable_metadata()->mutable_row_type();
+      for (int c = 0; c != columns; ++c) {
+        auto& field = *row_type.add_fields();
+        field.set_name("Column" + std::to_string(c));
+        field.mutable_type()->set_code(spanner_proto::ARRAY);
+        field.mutable_type()->mutable_array_element_type()->set_code(
+            spanner_proto::INT64);
+      }
+    }
+    for (int row = 0; row != kRowsPerResponse; ++row) {
+      for (int c = 0; c != columns; ++c) {
+        auto const id = (r * kRowsPerResponse + row) * columns + c;
+        auto& list = *response.add_values()->mutable_list_value();
+        for (int i = 0; i != 8; ++i) {
+          list.add_values()->set_string_value(std::to_string(id * 8 + i));
+        }
+      }
+    }
+    responses->push_back(response.SerializeAsString());
+  }
+  return responses;
+}
+
+// A reader that parses the responses from their serialized form, like the
+// gRPC streaming reader does.
+class SerializedReader : public PartialResultSetReader {
+ public:
+  explicit SerializedReader(std::shared_ptr<std::vector<std::string>> data)
+      : data_(std::move(data)) {}
+
+  void TryCancel() override {}
+
+  optional<spanner_proto::PartialResultSet> Read() override {
+    spanner_proto::PartialResultSet result;
+    if (!ReadInto(&result)) return {};
+    return result;
+  }
+
+  bool ReadInto(spanner_proto::PartialResultSet* result) override {
+    if (index_ == data_->size()) return false;
+    return result->ParseFromString((*data_)[index_++]);
+  }
+
+  Status Finish() override { return Status(); }
+
+ private:
+  std::shared_ptr<std::vector<std::string>> data_;
+  std::size_t index_ = 0;
+};
+
+std::unique_ptr<ResultSourceInterface> MakeSource(
+    std::shared_ptr<std::vector<std::string>> data, bool use_arena) {
+  auto source = PartialResultSetSource::Create(
+      google::cloud::internal::make_unique<SerializedReader>(std::move(data)),
+      use_arena);
+  if (!source) std::abort();
+  return *std::move(source);
+}
+
+void ReportAllocations(benchmark::State& state, std::int64_t allocations) {
+  auto const rows = static_cast<double>(state.iterations()) *
+                    kResponses * kRowsPerResponse;
+  state.counters["allocs/row"] = static_cast<double>(allocations) / rows;
+  state.SetItemsProcessed(state.iterations() * kResponses * kRowsPerResponse);
+}
+
+// The benchmarks run with {columns, use_arena} arguments.
+void SourceArguments(benchmark::internal::Benchmark* b) {
+  for (int columns : {1, 10, 100}) {
+    for (int use_arena : {0, 1}) b->Args({columns, use_arena});
+  }
+}
+
+// Reads the whole scan with `NextRow()`, the values are copied out of the
+// arena (when in use) into each `Row`.
+//
+// The arena is dropped after the first `Row`, so `Row` consumers gain nothing
+// from it, the first response even costs a few allocations more. A run on one
+// 2.1 GHz core, medians of 5 repetitions, allocations per row in parentheses:
+//
+// Benchmark                                  Heap              Arena
+// BM_PartialResultSetSourceNextRow/1         213us (2.09)      221us (2.09)
+// BM_PartialResultSetSourceNextRow/10        1.54ms (16.7)     1.57ms (17.0)
+// BM_PartialResultSetSourceNextRow/100       21.5ms (158)      22.4ms (161)
+void BM_PartialResultSetSourceNextRow(benchmark::State& state) {
+  auto data = MakeResponses(static_cast<int>(state.range(0)));
+  auto const use_arena = state.range(1) != 0;
+  auto const start = allocation_count.load();
+  for (auto _ : state) {
+    auto source = MakeSource(data, use_arena);
+    for (;;) {
+      auto row = source->NextRow();
+      if (!row || row->size() == 0) break;
+      benchmark::DoNotOptimize(row);
+    }
+  }
+  ReportAllocations(state, allocation_count.load() - start);
+}
+BENCHMARK(BM_PartialResultSetSourceNextRow)
+    ->Apply(SourceArguments);
+
+// Reads a scan of ARRAY<INT64> columns with `NextRow()`, the type of these
+// columns is not a scalar, so copying it would need an allocation.
+void BM_PartialResultSetSourceNextRowArrays(benchmark::State& state) {
+  auto data = MakeArrayResponses(static_cast<int>(state.range(0)));
+  auto const use_arena = state.range(1) != 0;
+  auto const start = allocation_count.load();
+  for (auto _ : state) {
+    auto source = MakeSource(data, use_arena);
+    for (;;) {
+      auto row = source->NextRow();
+      if (!row || row->size() == 0) break;
+      benchmark::DoNotOptimize(row);
+    }
+  }
+  ReportAllocations(state, allocation_count.load() - start);
+}
+BENCHMARK(BM_PartialResultSetSourceNextRowArrays)->Apply(SourceArguments);
+
+// Reads the whole scan with `NextRows()`, which hands out all the complete
+// rows buffered from a response at once.
+void BM_PartialResultSetSourceNextRows(benchmark::State& state) {
+  auto data = MakeResponses(static_cast<int>(state.range(0)));
+  auto const use_arena = state.range(1) != 0;
+  auto const start = allocation_count.load();
+  for (auto _ : state) {
+    auto source = MakeSource(data, use_arena);
+    for (;;) {
+      auto rows = source->NextRows(kRowsPerResponse);
+      if (!rows || rows->empty()) break;
+      benchmark::DoNotOptimize(rows);
+    }
+  }
+  ReportAllocations(state, allocation_count.load() - start);
+}
+BENCHMARK(BM_PartialResultSetSourceNextRows)->Apply(SourceArguments);
+
+// Reads the whole scan with `NextBatch()`, the values are decoded directly
+// from the arena (when in use). In the same run as above:
+//
+// Benchmark                                  Heap              Arena
+// BM_PartialResultSetSourceNextBatch/1       137us (1.34)      149us (0.27)
+// BM_PartialResultSetSourceNextBatch/10      1.82ms (18.6)     1.56ms (7.92)
+// BM_PartialResultSetSourceNextBatch/100     16.7ms (185)      14.6ms (78.7)
+void BM_PartialResultSetSourceNextBatch(benchmark::State& state) {
+  auto data = MakeResponses(static_cast<int>(state.range(0)));
+  auto const use_arena = state.range(1) != 0;
+  auto const start = allocation_count.load();
+  for (auto _ : state) {
+    auto source = MakeSource(data, use_arena);
+    for (;;) {
+      auto batch = source->NextBatch(kRowsPerResponse);
+      if (!batch || batch->empty()) break;
+      benchmark::DoNotOptimize(batch);
+    }
+  }
+  ReportAllocations(state, allocation_count.load() - start);
+}
+BENCHMARK(BM_PartialResultSetSourceNextBatch)
+    ->Apply(SourceArguments);
+
+// Returns the serialized responses for a single 4MiB STRING, split into
+// `chunks` chunked values.
+std::shared_ptr<std::vector<std::string>> MakeChunkedResponses(int chunks) {
+  auto responses = std::make_shared<std::vector<std::string>>();
+  auto const chunk_size = (4 * 1024 * 1024) / chunks;
+  for (int r = 0; r != chunks; ++r) {
+    spanner_proto::PartialResultSet response;
+    if (r == 0) {
+      auto& field =
+          *response.mutable_metadata()->mutable_row_type()->add_fields();
+      field.set_name("Blob");
+      field.mutable_type()->set_code(spanner_proto::STRING);
+    }
+    response.add_values()->set_string_value(std::string(chunk_size, 'a'));
+    response.set_chunked_value(r != chunks - 1);
+    responses->push_back(response.SerializeAsString());
+  }
+  return responses;
+}
+
+// Reads a value split across `state.range(0)` responses.
+void BM_PartialResultSetSourceChunkedValue(benchmark::State& state) {
+  auto data = MakeChunkedResponses(static_cast<int>(state.range(0)));
+  auto const use_arena = state.range(1) != 0;
+  for (auto _ : state) {
+    auto source = MakeSource(data, use_arena);
+    auto row = source->NextRow();
+    if (!row || row->size() != 1) std::abort();
+    benchmark::DoNotOptimize(row);
+  }
+  state.SetBytesProcessed(state.iterations() * 4 * 1024 * 1024);
+}
+BENCHMARK(BM_PartialResultSetSourceChunkedValue)
+    ->Apply([](benchmark::internal::Benchmark* b) {
+      for (int chunks : {16, 256, 4096}) {
+        for (int use_arena : {0, 1}) b->Args({chunks, use_arena});
+      }
+    });
+
+}  // namespace
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -22,8 +22,11 @@
 #include <google/protobuf/text_format.h>
 #include <gmock/gmock.h>
 #include <array>
+#include <chrono>
 #include <cstdint>
 #include <string>
+#include <tuple>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -38,6 +41,7 @@ using ::google::cloud::internal::make_unique;
 using ::google::cloud::spanner_testing::IsProtoEqual;
 using ::google::cloud::spanner_testing::MockPartialResultSetReader;
 using ::google::protobuf::TextFormat;
+using ::testing::ElementsAre;
 using ::testing::HasSubstr;
 using ::testing::Return;
 
@@ -459,6 +463,148 @@ TEST(PartialResultSetSourceTest, ChunkedStringValueWellFormed) {
   EXPECT_THAT((*reader)->NextRow(), IsValidAndEquals(Row{}));
 }
 
+/**
+ * @test Verify the values are correct when the responses are parsed into an
+ * arena, with rows and chunked values that span several responses, and with
+ * responses larger than the initial arena block.
+ */
+TEST(PartialResultSetSourceTest, Arena) {
+  auto grpc_reader = make_unique<MockPartialResultSetReader>();
+  std::array<char const*, 4> text{{
+      R"pb(
+        metadata: {
+          row_type: {
+            fields: {
+              name: "UserId",
+              type: { code: INT64 }
+            }
+            fields: {
+              name: "UserName",
+              type: { code: STRING }
+            }
+          }
+        }
+        values: { string_value: "10" }
+        values: { string_value: "user" }
+        chunked_value: true
+      )pb",
+      R"pb(
+        values: { string_value: "10" }
+        values: { string_value: "22" }
+      )pb",
+      R"pb(
+        values: { string_value: "user22" }
+      )pb",
+      R"pb(
+        values: { string_value: "99" }
+      )pb",
+  }};
+  std::array<spanner_proto::PartialResultSet, text.size()> response;
+  for (std::size_t i = 0; i != text.size(); ++i) {
+    SCOPED_TRACE("Converting text to proto [" + std::to_string(i) + "]");
+    ASSERT_TRUE(TextFormat::ParseFromString(text[i], &response[i]));
+  }
+  std::string const large(256 * 1024, 'x');
+  response[3].add_values()->set_string_value(large);
+  EXPECT_CALL(*grpc_reader, Read())
+      .WillOnce(Return(response[0]))
+      .WillOnce(Return(response[1]))
+      .WillOnce(Return(response[2]))
+      .WillOnce(Return(response[3]))
+      .WillOnce(Return(optional<spanner_proto::PartialResultSet>{}));
+  EXPECT_CALL(*grpc_reader, Finish()).WillOnce(Return(Status()));
+
+  auto reader = PartialResultSetSource::Create(std::move(grpc_reader),
+                                               /*use_arena=*/true);
+  ASSERT_STATUS_OK(reader);
+
+  EXPECT_THAT((*reader)->NextRow(), IsValidAndEquals(MakeTestRow({
+                                        {"UserId", Value(10)},
+                                        {"UserName", Value("user10")},
+                                    })));
+  EXPECT_THAT((*reader)->NextRow(), IsValidAndEquals(MakeTestRow({
+                                        {"UserId", Value(22)},
+                                        {"UserName", Value("user22")},
+                                    })));
+  EXPECT_THAT((*reader)->NextRow(), IsValidAndEquals(MakeTestRow({
+                                        {"UserId", Value(99)},
+                                        {"UserName", Value(large)},
+                                    })));
+  EXPECT_THAT((*reader)->NextRow(), IsValidAndEquals(Row{}));
+}
+
+/**
+ * @test Verify an `ARRAY<STRING>` split into many chunks, including strings
+ * continued across several responses, is merged correctly.
+ */
+TEST(PartialResultSetSourceTest, ChunkedArrayValue) {
+  auto grpc_reader = make_unique<MockPartialResultSetReader>();
+  std::array<char const*, 4> text{{
+      R"pb(
+        metadata: {
+          row_type: {
+            fields: {
+              name: "Names",
+              type: {
+                code: ARRAY
+                array_element_type: { code: STRING }
+              }
+            }
+          }
+        }
+        values: {
+          list_value: {
+            values: { string_value: "a" }
+            values: { string_value: "b1" }
+          }
+        }
+        chunked_value: true
+      )pb",
+      R"pb(
+        values: { list_value: { values: { string_value: "b2" } } }
+        chunked_value: true
+      )pb",
+      R"pb(
+        values: {
+          list_value: {
+            values: { string_value: "b3" }
+            values: { null_value: NULL_VALUE }
+            values: { string_value: "c" }
+          }
+        }
+        chunked_value: true
+      )pb",
+      R"pb(
+        values: { list_value: { values: { string_value: "1" } } }
+        values: { list_value: {} }
+      )pb",
+  }};
+  std::array<spanner_proto::PartialResultSet, text.size()> response;
+  for (std::size_t i = 0; i != text.size(); ++i) {
+    SCOPED_TRACE("Converting text to proto [" + std::to_string(i) + "]");
+    ASSERT_TRUE(TextFormat::ParseFromString(text[i], &response[i]));
+  }
+  EXPECT_CALL(*grpc_reader, Read())
+      .WillOnce(Return(response[0]))
+      .WillOnce(Return(response[1]))
+      .WillOnce(Return(response[2]))
+      .WillOnce(Return(response[3]))
+      .WillOnce(Return(optional<spanner_proto::PartialResultSet>{}));
+  EXPECT_CALL(*grpc_reader, Finish()).WillOnce(Return(Status()));
+
+  auto reader = PartialResultSetSource::Create(std::move(grpc_reader),
+                                               /*use_arena=*/true);
+  ASSERT_STATUS_OK(reader);
+
+  using Names = std::vector<optional<std::string>>;
+  Names const expected{"a", "b1b2b3", {}, "c1"};
+  EXPECT_THAT((*reader)->NextRow(),
+              IsValidAndEquals(MakeTestRow({{"Names", Value(expected)}})));
+  EXPECT_THAT((*reader)->NextRow(),
+              IsValidAndEquals(MakeTestRow({{"Names", Value(Names{})}})));
+  EXPECT_THAT((*reader)->NextRow(), IsValidAndEquals(Row{}));
+}
+
 /**
  * @test Verify the behavior when `chunked_value` is set but there are no
  * values in the response.
@@ -722,6 +868,404 @@ TEST(PartialResultSetSourceTest, ErrorOnIncompleteRow) {
   EXPECT_THAT(row.status().message(), HasSubstr("incomplete row"));
 }
 
+/**
+ * @test Verify `NextBatch()` decodes the values into columns, across several
+ * responses, and that it can be mixed with `NextRow()`.
+ */
+TEST(PartialResultSetSourceTest, NextBatch) {
+  // With an arena, `NextRow()` switches the source to the heap mid-stream.
+  for (bool use_arena : {false, true}) {
+    SCOPED_TRACE("use_arena=" + std::to_string(use_arena));
+    auto grpc_reader = make_unique<MockPartialResultSetReader>();
+    std::array<char const*, 4> text{{
+        R"pb(
+          metadata: {
+            row_type: {
+              fields: {
+                name: "UserId",
+                type: { code: INT64 }
+              }
+              fields: {
+                name: "UserName",
+                type: { code: STRING }
+              }
+            }
+          }
+          values: { string_value: "10" }
+          values: { string_value: "user10" }
+        )pb",
+        R"pb(
+          values: { string_value: "22" }
+          values: { null_value: NULL_VALUE }
+          values: { string_value: "99" }
+        )pb",
+        R"pb(
+          values: { string_value: "user99" }
+          values: { string_value: "7" }
+          values: { string_value: "user7" }
+        )pb",
+        R"pb(
+          values: { string_value: "8" }
+          values: { string_value: "user8" }
+        )pb",
+    }};
+    std::array<spanner_proto::PartialResultSet, text.size()> response;
+    for (std::size_t i = 0; i != text.size(); ++i) {
+      SCOPED_TRACE("Converting text to proto [" + std::to_string(i) + "]");
+      ASSERT_TRUE(TextFormat::ParseFromString(text[i], &response[i]));
+    }
+    EXPECT_CALL(*grpc_reader, Read())
+        .WillOnce(Return(response[0]))
+        .WillOnce(Return(response[1]))
+        .WillOnce(Return(response[2]))
+        .WillOnce(Return(response[3]))
+        .WillOnce(Return(optional<spanner_proto::PartialResultSet>{}));
+    EXPECT_CALL(*grpc_reader, Finish()).WillOnce(Return(Status()));
+
+    auto reader = PartialResultSetSource::Create(std::move(grpc_reader),
+                                                 use_arena);
+    ASSERT_STATUS_OK(reader);
+
+    auto batch = (*reader)->NextBatch(3);
+    ASSERT_STATUS_OK(batch);
+    ASSERT_EQ(3, batch->size());
+    EXPECT_THAT(batch->column_names(), ElementsAre("UserId", "UserName"));
+    EXPECT_THAT(batch->column(0).int64_values(), ElementsAre(10, 22, 99));
+    auto const& names = batch->column(1);
+    EXPECT_THAT(names.nulls(), ElementsAre(0, 1, 0));
+    EXPECT_EQ("user10", names.string_value(0));
+    EXPECT_EQ("user99", names.string_value(2));
+
+    EXPECT_THAT((*reader)->NextRow(), IsValidAndEquals(MakeTestRow({
+                                          {"UserId", Value(7)},
+                                          {"UserName", Value("user7")},
+                                      })));
+
+    // The last batch is short, and then the batches are empty.
+    batch = (*reader)->NextBatch(3);
+    ASSERT_STATUS_OK(batch);
+    EXPECT_THAT(batch->column(0).int64_values(), ElementsAre(8));
+    batch = (*reader)->NextBatch(3);
+    ASSERT_STATUS_OK(batch);
+    EXPECT_TRUE(batch->empty());
+  }
+}
+
+/**
+ * @test Verify `NextRows()` returns the rows buffered from several responses,
+ * and that it can be mixed with `NextRow()`.
+ */
+TEST(PartialResultSetSourceTest, NextRows) {
+  auto grpc_reader = make_unique<MockPartialResultSetReader>();
+  std::array<char const*, 3> text{{
+      R"pb(
+        metadata: {
+          row_type: {
+            fields: {
+              name: "UserId",
+              type: { code: INT64 }
+            }
+            fields: {
+              name: "UserName",
+              type: { code: STRING }
+            }
+          }
+        }
+        values: { string_value: "10" }
+        values: { string_value: "user10" }
+        values: { string_value: "22" }
+        values: { string_value: "user22" }
+        values: { string_value: "99" }
+      )pb",
+      R"pb(
+        values: { string_value: "user99" }
+        values: { string_value: "7" }
+        values: { string_value: "user7" }
+        values: { string_value: "8" }
+      )pb",
+      R"pb(
+        values: { string_value: "user8" }
+      )pb",
+  }};
+  std::array<spanner_proto::PartialResultSet, text.size()> response;
+  for (std::size_t i = 0; i != text.size(); ++i) {
+    SCOPED_TRACE("Converting text to proto [" + std::to_string(i) + "]");
+    ASSERT_TRUE(TextFormat::ParseFromString(text[i], &response[i]));
+  }
+  EXPECT_CALL(*grpc_reader, Read())
+      .WillOnce(Return(response[0]))
+      .WillOnce(Return(response[1]))
+      .WillOnce(Return(response[2]))
+      .WillOnce(Return(optional<spanner_proto::PartialResultSet>{}));
+  EXPECT_CALL(*grpc_reader, Finish()).WillOnce(Return(Status()));
+
+  auto reader = PartialResultSetSource::Create(std::move(grpc_reader));
+  ASSERT_STATUS_OK(reader);
+
+  auto row = [](std::int64_t id, std::string name) {
+    return MakeTestRow({{"UserId", Value(id)}, {"UserName", Value(name)}});
+  };
+  auto rows = (*reader)->NextRows(3);
+  ASSERT_STATUS_OK(rows);
+  EXPECT_THAT(*rows, ElementsAre(row(10, "user10"), row(22, "user22"),
+                                 row(99, "user99")));
+  EXPECT_THAT((*reader)->NextRow(), IsValidAndEquals(row(7, "user7")));
+
+  // The last call is short, and then the results are empty.
+  rows = (*reader)->NextRows(3);
+  ASSERT_STATUS_OK(rows);
+  EXPECT_THAT(*rows, ElementsAre(row(8, "user8")));
+  rows = (*reader)->NextRows(3);
+  ASSERT_STATUS_OK(rows);
+  EXPECT_TRUE(rows->empty());
+}
+
+/// @test Verify `StreamOf<std::tuple<...>>` decodes the protos directly.
+TEST(PartialResultSetSourceTest, StreamOfTuple) {
+  auto grpc_reader = make_unique<MockPartialResultSetReader>();
+  std::array<char const*, 2> text{{
+      R"pb(
+        metadata: {
+          row_type: {
+            fields: {
+              name: "UserId",
+              type: { code: INT64 }
+            }
+            fields: {
+              name: "UserName",
+              type: { code: STRING }
+            }
+          }
+        }
+        values: { string_value: "10" }
+        values: { string_value: "user10" }
+        values: { string_value: "22" }
+      )pb",
+      R"pb(
+        values: { null_value: NULL_VALUE }
+        values: { string_value: "99" }
+        values: { string_value: "user99" }
+      )pb",
+  }};
+  std::array<spanner_proto::PartialResultSet, text.size()> response;
+  for (std::size_t i = 0; i != text.size(); ++i) {
+    SCOPED_TRACE("Converting text to proto [" + std::to_string(i) + "]");
+    ASSERT_TRUE(TextFormat::ParseFromString(text[i], &response[i]));
+  }
+  EXPECT_CALL(*grpc_reader, Read())
+      .WillOnce(Return(response[0]))
+      .WillOnce(Return(response[1]))
+      .WillOnce(Return(optional<spanner_proto::PartialResultSet>{}));
+  EXPECT_CALL(*grpc_reader, Finish()).WillOnce(Return(Status()));
+
+  auto source = PartialResultSetSource::Create(std::move(grpc_reader));
+  ASSERT_STATUS_OK(source);
+  RowStream rows(*std::move(source));
+
+  using RowType = std::tuple<std::int64_t, optional<std::string>>;
+  std::vector<RowType> actual;
+  for (auto& row : StreamOf<RowType>(rows)) {
+    ASSERT_STATUS_OK(row);
+    actual.push_back(*std::move(row));
+  }
+  std::vector<RowType> const expected{
+      RowType{10, "user10"}, RowType{22, {}}, RowType{99, "user99"}};
+  EXPECT_EQ(expected, actual);
+}
+
+/// @test Verify `NextBatch()` rejects the column types it does not support.
+TEST(PartialResultSetSourceTest, NextBatchUnsupportedType) {
+  auto grpc_reader = make_unique<MockPartialResultSetReader>();
+  spanner_proto::PartialResultSet response;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"pb(
+        metadata: {
+          row_type: {
+            fields: {
+              name: "Tags",
+              type: {
+                code: ARRAY
+                array_element_type: { code: STRING }
+              }
+            }
+          }
+        }
+      )pb",
+      &response));
+  EXPECT_CALL(*grpc_reader, Read()).WillOnce(Return(response));
+  EXPECT_CALL(*grpc_reader, TryCancel()).Times(1);
+  EXPECT_CALL(*grpc_reader, Finish()).WillOnce(Return(Status()));
+
+  auto reader = PartialResultSetSource::Create(std::move(grpc_reader));
+  ASSERT_STATUS_OK(reader);
+  auto batch = (*reader)->NextBatch(10);
+  EXPECT_EQ(StatusCode::kInvalidArgument, batch.status().code());
+}
+
+/**
+ * @test Verify `NextBatch()` skips a row with a bad value, after returning the
+ * rows before it, and continues with the next row.
+ */
+TEST(PartialResultSetSourceTest, NextBatchBadValue) {
+  for (bool use_arena : {false, true}) {
+    SCOPED_TRACE("use_arena=" + std::to_string(use_arena));
+    auto grpc_reader = make_unique<MockPartialResultSetReader>();
+    spanner_proto::PartialResultSet response;
+    ASSERT_TRUE(TextFormat::ParseFromString(
+        R"pb(
+          metadata: {
+            row_type: {
+              fields: {
+                name: "UserName",
+                type: { code: STRING }
+              }
+              fields: {
+                name: "UserId",
+                type: { code: INT64 }
+              }
+            }
+          }
+          values: { string_value: "user10" }
+          values: { string_value: "10" }
+          values: { string_value: "user22" }
+          values: { string_value: "not-a-number" }
+          values: { string_value: "user99" }
+          values: { string_value: "99" }
+        )pb",
+        &response));
+    EXPECT_CALL(*grpc_reader, Read())
+        .WillOnce(Return(response))
+        .WillOnce(Return(optional<spanner_proto::PartialResultSet>{}));
+    EXPECT_CALL(*grpc_reader, Finish()).WillOnce(Return(Status()));
+
+    auto reader = PartialResultSetSource::Create(std::move(grpc_reader),
+                                                 use_arena);
+    ASSERT_STATUS_OK(reader);
+
+    auto batch = (*reader)->NextBatch(10);
+    ASSERT_STATUS_OK(batch);
+    ASSERT_EQ(1, batch->size());
+    EXPECT_EQ("user10", batch->column(0).string_value(0));
+    EXPECT_THAT(batch->column(1).int64_values(), ElementsAre(10));
+
+    batch = (*reader)->NextBatch(10);
+    EXPECT_FALSE(batch.ok());
+
+    batch = (*reader)->NextBatch(10);
+    ASSERT_STATUS_OK(batch);
+    ASSERT_EQ(1, batch->size());
+    EXPECT_EQ("user99", batch->column(0).string_value(0));
+    EXPECT_THAT(batch->column(1).int64_values(), ElementsAre(99));
+
+    batch = (*reader)->NextBatch(10);
+    ASSERT_STATUS_OK(batch);
+    EXPECT_TRUE(batch->empty());
+  }
+}
+
+/**
+ * @test Verify `WhenRowReady()` waits for the stream without blocking, and
+ * consumes the responses already received.
+ */
+TEST(PartialResultSetSourceTest, WhenRowReady) {
+  auto grpc_reader = make_unique<MockPartialResultSetReader>();
+  std::array<char const*, 2> text{{
+      R"pb(
+        metadata: {
+          row_type: {
+            fields: {
+              name: "UserId",
+              type: { code: INT64 }
+            }
+            fields: {
+              name: "UserName",
+              type: { code: STRING }
+            }
+          }
+        }
+        values: { string_value: "10" }
+      )pb",
+      R"pb(
+        values: { string_value: "user10" }
+      )pb",
+  }};
+  std::array<spanner_proto::PartialResultSet, text.size()> response;
+  for (std::size_t i = 0; i != text.size(); ++i) {
+    SCOPED_TRACE("Converting text to proto [" + std::to_string(i) + "]");
+    ASSERT_TRUE(TextFormat::ParseFromString(text[i], &response[i]));
+  }
+  promise<void> readable;
+  EXPECT_CALL(*grpc_reader, WhenReadable())
+      .WillOnce([&readable] { return readable.get_future(); })
+      .WillRepeatedly([] { return make_ready_future(); });
+  EXPECT_CALL(*grpc_reader, Read())
+      .WillOnce(Return(response[0]))
+      .WillOnce(Return(response[1]))
+      .WillOnce(Return(optional<spanner_proto::PartialResultSet>{}));
+  EXPECT_CALL(*grpc_reader, Finish()).WillOnce(Return(Status()));
+
+  auto reader = PartialResultSetSource::Create(std::move(grpc_reader));
+  ASSERT_STATUS_OK(reader);
+
+  // The first response holds only part of the row.
+  auto ready = (*reader)->WhenRowReady();
+  EXPECT_NE(std::future_status::ready,
+            ready.wait_for(std::chrono::seconds(0)));
+  readable.set_value();
+  EXPECT_EQ(std::future_status::ready, ready.wait_for(std::chrono::seconds(0)));
+
+  ready = (*reader)->WhenRowReady();
+  EXPECT_EQ(std::future_status::ready, ready.wait_for(std::chrono::seconds(0)));
+  EXPECT_THAT((*reader)->NextRow(), IsValidAndEquals(MakeTestRow({
+                                        {"UserId", Value(10)},
+                                        {"UserName", Value("user10")},
+                                    })));
+
+  ready = (*reader)->WhenRowReady();
+  EXPECT_EQ(std::future_status::ready, ready.wait_for(std::chrono::seconds(0)));
+  auto row = (*reader)->NextRow();
+  ASSERT_STATUS_OK(row);
+  EXPECT_EQ(0, row->size());
+}
+
+/// @test Verify `WhenRowReady()` defers the errors to `NextRow()`.
+TEST(PartialResultSetSourceTest, WhenRowReadyIncompleteRow) {
+  auto grpc_reader = make_unique<MockPartialResultSetReader>();
+  spanner_proto::PartialResultSet response;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"pb(
+        metadata: {
+          row_type: {
+            fields: {
+              name: "UserId",
+              type: { code: INT64 }
+            }
+            fields: {
+              name: "UserName",
+              type: { code: STRING }
+            }
+          }
+        }
+        values: { string_value: "10" }
+      )pb",
+      &response));
+  EXPECT_CALL(*grpc_reader, WhenReadable()).WillRepeatedly([] {
+    return make_ready_future();
+  });
+  EXPECT_CALL(*grpc_reader, Read())
+      .WillOnce(Return(response))
+      .WillOnce(Return(optional<spanner_proto::PartialResultSet>{}));
+  EXPECT_CALL(*grpc_reader, Finish()).WillOnce(Return(Status()));
+
+  auto reader = PartialResultSetSource::Create(std::move(grpc_reader));
+  ASSERT_STATUS_OK(reader);
+  auto ready = (*reader)->WhenRowReady();
+  EXPECT_EQ(std::future_status::ready, ready.wait_for(std::chrono::seconds(0)));
+  auto row = (*reader)->NextRow();
+  EXPECT_EQ(StatusCode::kInternal, row.status().code());
+  EXPECT_THAT(row.status().message(), HasSubstr("incomplete row"));
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace SPANNER_CLIENT_NS
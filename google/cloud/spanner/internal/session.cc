@@ -20,6 +20,17 @@ namespace spanner {
 inline namespace SPANNER_CLIENT_NS {
 namespace internal {
 
+constexpr std::chrono::seconds Session::kPreparedTransactionMaxAge;
+
+std::string Session::TakePreparedTransaction() {
+  std::string id;
+  if (!prepared_transaction_is_stale()) {
+    id = std::move(prepared_transaction_id_);
+  }
+  prepared_transaction_id_.clear();
+  return id;
+}
+
 SessionHolder MakeDissociatedSessionHolder(std::string session_name) {
   return SessionHolder(
       new Session(std::move(session_name), /*channel=*/nullptr),
@@ -58,7 +58,20 @@ class Session {
   void set_bad() { is_bad_.store(true, std::memory_order_relaxed); }
   bool is_bad() const { return is_bad_.load(std::memory_order_relaxed); }
 
+  /**
+   * Return (and forget) the read-write transaction the pool began on this
+   * session, or an empty string if there is none, or it is too old to use.
+   *
+   * Only the holder of the session may call this, and the transaction should
+   * only be used by the first read-write transaction on the session.
+   */
+  std::string TakePreparedTransaction();
+
  private:
+  // The server may abort a read-write transaction that has been idle for
+  // about 10 seconds, so use prepared transactions well before that.
+  static constexpr std::chrono::seconds kPreparedTransactionMaxAge{7};
+
   // Give `SessionPool` access to the private methods below.
   friend class SessionPool;
   std::shared_ptr<Channel> const& channel() const { return channel_; }
@@ -68,11 +81,25 @@ class Session {
   Clock::time_point last_use_time() const { return last_use_time_; }
   void update_last_use_time() { last_use_time_ = clock_->Now(); }
 
+  bool has_prepared_transaction() const {
+    return !prepared_transaction_id_.empty();
+  }
+  bool prepared_transaction_is_stale() const {
+    return clock_->Now() - prepared_time_ > kPreparedTransactionMaxAge;
+  }
+  void set_prepared_transaction(std::string id) {
+    prepared_transaction_id_ = std::move(id);
+    prepared_time_ = clock_->Now();
+  }
+  void clear_prepared_transaction() { prepared_transaction_id_.clear(); }
+
   std::string const session_name_;
   std::shared_ptr<Channel> const channel_;
   std::atomic<bool> is_bad_;
   std::shared_ptr<Clock> clock_;
   Clock::time_point last_use_time_;
+  std::string prepared_transaction_id_;
+  Clock::time_point prepared_time_;
 };
 
 /**
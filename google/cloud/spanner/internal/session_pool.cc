@@ -16,14 +16,18 @@
 #include "google/cloud/spanner/internal/connection_impl.h"
 #include "google/cloud/spanner/internal/retry_loop.h"
 #include "google/cloud/spanner/internal/session.h"
+#include "google/cloud/spanner/internal/status_utils.h"
 #include "google/cloud/completion_queue.h"
 #include "google/cloud/internal/async_retry_unary_rpc.h"
 #include "google/cloud/internal/make_unique.h"
 #include "google/cloud/log.h"
 #include "google/cloud/status.h"
 #include <algorithm>
+#include <atomic>
 #include <chrono>
-#include <random>
+#include <functional>
+#include <iterator>
+#include <string>
 #include <thread>
 #include <utility>
 #include <vector>
@@ -36,6 +40,32 @@ namespace internal {
 
 namespace spanner_proto = ::google::spanner::v1;
 
+namespace {
+// The maximum number of sessions created by a single BatchCreateSessions call.
+int constexpr kMaxSessionsPerBatch = 100;
+
+// Returns a duration in `[0, max_jitter)`, which is stable for each session.
+Session::Clock::duration KeepAliveJitter(std::string const& session_name,
+                                         Session::Clock::duration max_jitter) {
+  if (max_jitter.count() <= 0) return Session::Clock::duration::zero();
+  auto const h = std::hash<std::string>{}(session_name);
+  return Session::Clock::duration(
+      static_cast<Session::Clock::duration::rep>(
+          h % static_cast<std::size_t>(max_jitter.count())));
+}
+
+// The session last released by each thread, for
+// `SessionAllocationStrategy::kThreadAffinity`. The pointers are only compared
+// with those of the idle sessions in `pool`, never dereferenced, so they may
+// outlive the objects they point to.
+struct ThreadAffinity {
+  SessionPool const* pool;
+  Session const* session;
+  std::size_t shard;
+};
+thread_local ThreadAffinity thread_affinity{nullptr, nullptr, 0};
+}  // namespace
+
 std::shared_ptr<SessionPool> MakeSessionPool(
     Database db, std::vector<std::shared_ptr<SpannerStub>> stubs,
     SessionPoolOptions options, google::cloud::CompletionQueue cq,
@@ -64,29 +94,89 @@ SessionPool::SessionPool(Database db,
       backoff_policy_prototype_(std::move(backoff_policy)),
       clock_(std::move(clock)),
       max_pool_size_(options_.max_sessions_per_channel() *
-                     static_cast<int>(stubs.size())),
-      random_generator_(std::random_device()()) {
+                     static_cast<int>(stubs.size())) {
   if (stubs.empty()) {
     google::cloud::internal::ThrowInvalidArgument(
         "SessionPool requires a non-empty set of stubs");
   }
 
   channels_.reserve(stubs.size());
+  shards_.reserve(stubs.size());
   for (auto& stub : stubs) {
     channels_.push_back(std::make_shared<Channel>(std::move(stub)));
+    shards_.push_back(
+        google::cloud::internal::make_unique<Shard>(channels_.back()));
   }
-  // `channels_` is never resized after this point.
+  // `channels_` and `shards_` are never resized after this point.
   next_dissociated_stub_channel_ = channels_.begin();
 }
 
 void SessionPool::Initialize() {
-  if (options_.min_sessions() > 0) {
-    std::unique_lock<std::mutex> lk(mu_);
-    (void)Grow(lk, options_.min_sessions(), WaitForSessionAllocation::kWait);
+  auto const create_counts = StartInitialization();
+  if (create_counts.size() == 1) {
+    // There is nothing to overlap a single call with, make it on this thread.
+    auto const& op = create_counts.front();
+    (void)CreateSessionsSync(op.channel, options_.labels(), op.session_count);
+  } else if (!create_counts.empty()) {
+    (void)CreateInitialSessions(create_counts).get();
   }
   ScheduleBackgroundWork(std::chrono::seconds(5));
 }
 
+future<Status> SessionPool::InitializeAsync() {
+  auto const create_counts = StartInitialization();
+  ScheduleBackgroundWork(std::chrono::seconds(5));
+  return CreateInitialSessions(create_counts);
+}
+
+// Makes all the `create_counts` calls concurrently, the returned future is
+// satisfied once they all complete.
+future<Status> SessionPool::CreateInitialSessions(
+    std::vector<CreateCount> const& create_counts) {
+  if (create_counts.empty()) return make_ready_future(Status());
+
+  struct State {
+    std::mutex mu;
+    std::size_t pending;  // GUARDED_BY(mu)
+    Status status;        // GUARDED_BY(mu)
+    promise<Status> done;
+  };
+  auto state = std::make_shared<State>();
+  state->pending = create_counts.size();
+  auto f = state->done.get_future();
+  for (auto const& op : create_counts) {
+    CreateSessionsAsync(op.channel, options_.labels(), op.session_count)
+        .then([state](future<Status> result) {
+          auto status = result.get();
+          std::unique_lock<std::mutex> lk(state->mu);
+          if (!status.ok()) state->status = std::move(status);
+          if (--state->pending != 0) return;
+          auto final_status = std::move(state->status);
+          lk.unlock();
+          state->done.set_value(std::move(final_status));
+        });
+  }
+  return f;
+}
+
+std::vector<SessionPool::CreateCount> SessionPool::StartInitialization() {
+  std::vector<CreateCount> create_counts;
+  if (options_.min_sessions() == 0) return create_counts;
+  std::unique_lock<std::mutex> lk(mu_);
+  auto per_channel = ComputeCreateCounts(options_.min_sessions());
+  if (!per_channel.ok()) return create_counts;
+  // The server creates at most `kMaxSessionsPerBatch` sessions per call, so
+  // split larger requests into several concurrent calls.
+  for (auto const& op : *per_channel) {
+    for (int n = op.session_count; n > 0; n -= kMaxSessionsPerBatch) {
+      create_counts.push_back(
+          {op.channel, (std::min)(n, kMaxSessionsPerBatch)});
+    }
+  }
+  create_calls_in_progress_ += static_cast<int>(create_counts.size());
+  return create_counts;
+}
+
 SessionPool::~SessionPool() {
   // All references to this object are via `shared_ptr`; since we're in the
   // destructor that implies there can be no concurrent accesses to any member
@@ -99,6 +189,13 @@ SessionPool::~SessionPool() {
   // must return `nullptr`, and the lambda will not do any work nor reschedule
   // the timer.
   current_timer_.cancel();
+
+  // Any queued `AsyncAllocate()` requests can no longer be satisfied.
+  for (auto& waiter : async_waiters_) {
+    if (waiter->timer.valid()) waiter->timer.cancel();
+    waiter->result.set_value(
+        Status(StatusCode::kCancelled, "session pool destroyed"));
+  }
 }
 
 void SessionPool::ScheduleBackgroundWork(std::chrono::seconds relative_time) {
@@ -118,57 +215,196 @@ void SessionPool::ScheduleBackgroundWork(std::chrono::seconds relative_time) {
 
 void SessionPool::DoBackgroundWork() {
   MaintainPoolSize();
+  PrepareWriteSessions();
   RefreshExpiringSessions();
   ScheduleBackgroundWork(std::chrono::seconds(5));
 }
 
 // Ensure the pool size conforms to what was specified in the `SessionOptions`,
-// creating or deleting sessions as necessary.
+// creating or deleting sessions as necessary. With adaptive sizing the target
+// size follows the observed demand, otherwise it is `min_sessions`.
 void SessionPool::MaintainPoolSize() {
   std::unique_lock<std::mutex> lk(mu_);
-  if (create_calls_in_progress_ == 0 &&
-      total_sessions_ < options_.min_sessions()) {
-    Grow(lk, total_sessions_ - options_.min_sessions(),
-         WaitForSessionAllocation::kNoWait);
+  UpdateDemandStats();
+  auto const target = demand_stats_.target_sessions;
+  if (total_sessions_ < target) {
+    if (create_calls_in_progress_ == 0) {
+      (void)Grow(lk, target - total_sessions_,
+                 WaitForSessionAllocation::kNoWait);
+    }
+    return;
   }
+
+  // Only shrink after the demand has been below the pool size for a full
+  // window, so a short lull does not discard sessions we will soon need.
+  if (!options_.adaptive_sizing() ||
+      demand_stats_.observed_period < options_.demand_window()) {
+    return;
+  }
+  auto const excess = (std::min)(idle_sessions_ - options_.max_idle_sessions(),
+                                 total_sessions_ - target);
+  if (excess > 0) ShrinkPool(lk, excess);
 }
 
-// Initiate an async GetSession() call on any session whose last-use time is
-// older than the keep-alive interval.
-void SessionPool::RefreshExpiringSessions() {
+void SessionPool::UpdateDemandStats() {
+  auto const now = clock_->Now();
+  // The peak for the next sample starts at the number of sessions in use now.
+  // Allocations racing with these exchanges may be attributed to either
+  // sample, which is fine for sizing purposes.
+  demand_samples_.push_back(
+      DemandSample{demand_sample_start_, now, allocations_.exchange(0),
+                   peak_sessions_in_use_.exchange(sessions_in_use_.load())});
+  demand_sample_start_ = now;
+  auto const window_start = now - options_.demand_window();
+  while (demand_samples_.size() > 1 &&
+         demand_samples_.front().end <= window_start) {
+    demand_samples_.pop_front();
+  }
+
+  SessionPoolDemandStats stats;
+  for (auto const& sample : demand_samples_) {
+    stats.allocations += sample.allocations;
+    stats.peak_sessions_in_use =
+        (std::max)(stats.peak_sessions_in_use, sample.peak_sessions_in_use);
+  }
+  auto const observed = now - demand_samples_.front().start;
+  stats.observed_period =
+      std::chrono::duration_cast<std::chrono::seconds>(observed);
+  auto const seconds = std::chrono::duration<double>(observed).count();
+  if (seconds > 0) {
+    stats.allocations_per_second =
+        static_cast<double>(stats.allocations) / seconds;
+  }
+  stats.target_sessions = options_.min_sessions();
+  if (options_.adaptive_sizing()) {
+    // Keep enough sessions for the peak demand, plus 25% headroom.
+    auto const peak = stats.peak_sessions_in_use;
+    auto const wanted = peak + (peak + 3) / 4;
+    stats.target_sessions =
+        (std::min)(max_pool_size_, (std::max)(stats.target_sessions, wanted));
+  }
+  demand_stats_ = stats;
+}
+
+SessionPoolDemandStats SessionPool::DemandStats() {
+  std::lock_guard<std::mutex> lk(mu_);
+  return demand_stats_;
+}
+
+void SessionPool::ShrinkPool(std::unique_lock<std::mutex>& lk, int count) {
+  // Remove the least recently used sessions (at the front of each shard),
+  // visiting the shards in turn so the channels remain balanced.
   std::vector<std::pair<std::shared_ptr<SpannerStub>, std::string>>
-      sessions_to_refresh;
+      sessions_to_delete;
+  bool removed = true;
+  while (count > 0 && removed) {
+    removed = false;
+    for (auto& shard : shards_) {
+      if (count == 0) break;
+      std::unique_ptr<Session> session;
+      {
+        std::lock_guard<std::mutex> shard_lk(shard->mu);
+        if (shard->sessions.empty()) continue;
+        session = PopIdleSession(*shard, shard->sessions.begin());
+      }
+      RemoveFromCounts(*session);
+      sessions_to_delete.emplace_back(session->channel()->stub,
+                                      session->session_name());
+      --count;
+      removed = true;
+    }
+  }
+
+  lk.unlock();
+  for (auto& session : sessions_to_delete) {
+    AsyncDeleteSession(cq_, session.first, std::move(session.second))
+        .then([](future<StatusOr<google::protobuf::Empty>> result) {
+          // The server garbage collects sessions eventually, so there is
+          // nothing useful to do if the call fails.
+          (void)result.get();
+        });
+  }
+  lk.lock();
+}
+
+// Initiate an async keep-alive call on any session whose last-use time is
+// older than the keep-alive interval (less a per-session jitter).
+//
+// Sessions created (or used) together would otherwise all expire together,
+// and be refreshed in a single burst. Each session is refreshed at a fixed
+// point in the last quarter of the interval, derived from its name, which
+// smears the refreshes over that period. The number of keep-alive calls in
+// flight on each channel is bounded, and any session over the limit is
+// refreshed in a later pass.
+void SessionPool::RefreshExpiringSessions() {
+  struct Refresh {
+    Shard* shard;
+    std::string session_name;
+  };
+  std::vector<Refresh> sessions_to_refresh;
   auto now = clock_->Now();
-  auto refresh_limit = now - options_.keep_alive_interval();
+  auto const keep_alive = std::chrono::duration_cast<Session::Clock::duration>(
+      options_.keep_alive_interval());
+  auto const max_jitter = keep_alive / 4;
+  auto refresh_limit = now - keep_alive;
   {
     std::unique_lock<std::mutex> lk(mu_);
-    if (last_use_time_lower_bound_ <= refresh_limit) {
+    if (last_use_time_lower_bound_ <= refresh_limit + max_jitter) {
       last_use_time_lower_bound_ = now;
-      for (auto const& session : sessions_) {
-        auto last_use_time = session->last_use_time();
-        if (last_use_time <= refresh_limit) {
-          sessions_to_refresh.emplace_back(session->channel()->stub,
-                                           session->session_name());
-          session->update_last_use_time();
-        } else if (last_use_time < last_use_time_lower_bound_) {
-          last_use_time_lower_bound_ = last_use_time;
+      for (auto const& shard : shards_) {
+        std::lock_guard<std::mutex> shard_lk(shard->mu);
+        for (auto const& session : shard->sessions) {
+          auto last_use_time = session->last_use_time();
+          auto const jitter =
+              KeepAliveJitter(session->session_name(), max_jitter);
+          if (last_use_time <= refresh_limit + jitter &&
+              shard->keep_alives_in_flight <
+                  options_.keep_alive_concurrency()) {
+            ++shard->keep_alives_in_flight;
+            sessions_to_refresh.push_back(
+                Refresh{shard.get(), session->session_name()});
+            session->update_last_use_time();
+          } else if (last_use_time < last_use_time_lower_bound_) {
+            last_use_time_lower_bound_ = last_use_time;
+          }
         }
       }
     }
   }
+  std::weak_ptr<SessionPool> pool = shared_from_this();
   for (auto& refresh : sessions_to_refresh) {
-    AsyncGetSession(cq_, refresh.first, std::move(refresh.second))
-        .then([](future<StatusOr<spanner_proto::Session>> result) {
-          // We simply discard the response as handling IsSessionNotFound()
-          // by removing the session from the pool is problematic (and would
-          // not eliminate the possibility of IsSessionNotFound() elsewhere).
-          // The last-use time has already been updated to throttle attempts.
-          // TODO(#1430): Re-evaluate these decisions.
-          (void)result.get();
+    auto* shard = refresh.shard;
+    auto name = refresh.session_name;
+    AsyncKeepAlive(shard->channel->stub, std::move(refresh.session_name))
+        .then([pool, shard, name](future<Status> result) {
+          // `shard` is owned by the pool, only use it while the pool lives.
+          auto shared_pool = pool.lock();
+          if (!shared_pool) return;
+          --shard->keep_alives_in_flight;
+          // Other errors are ignored, the last-use time has already been
+          // updated to throttle attempts. But a session the server no longer
+          // knows about is evicted (and replaced) before a caller uses it.
+          if (IsSessionNotFound(result.get())) {
+            shared_pool->EvictIdleSession(*shard, name);
+          }
         });
   }
 }
 
+future<Status> SessionPool::AsyncKeepAlive(
+    std::shared_ptr<SpannerStub> const& stub, std::string session_name) {
+  if (options_.keep_alive_with_select()) {
+    return AsyncSelectOne(cq_, stub, std::move(session_name))
+        .then([](future<StatusOr<spanner_proto::ResultSet>> f) {
+          return f.get().status();
+        });
+  }
+  return AsyncGetSession(cq_, stub, std::move(session_name))
+      .then([](future<StatusOr<spanner_proto::Session>> f) {
+        return f.get().status();
+      });
+}
+
 /**
  * Grow the session pool by creating up to `sessions_to_create` sessions and
  * adding them to the pool.  Note that `lk` may be released and reacquired in
@@ -258,38 +494,48 @@ Status SessionPool::CreateSessions(
         break;
       }
       case WaitForSessionAllocation::kNoWait:
-        CreateSessionsAsync(op.channel, options_.labels(), op.session_count);
+        (void)CreateSessionsAsync(op.channel, options_.labels(),
+                                  op.session_count);
         break;
     }
   }
   return return_status;
 }
 
-StatusOr<SessionHolder> SessionPool::Allocate(bool dissociate_from_pool) {
+StatusOr<SessionHolder> SessionPool::Allocate(bool dissociate_from_pool,
+                                              bool read_write) {
+  // The fast path: take an idle session without acquiring `mu_`.
+  if (auto session = TryPopIdleSession(read_write)) {
+    if (dissociate_from_pool) {
+      std::lock_guard<std::mutex> lk(mu_);
+      RemoveFromCounts(*session);
+    }
+    PrewarmIfExhausted();
+    allocation_wait_.Record(std::chrono::microseconds(0));
+    return {MakeSessionHolder(std::move(session), dissociate_from_pool)};
+  }
+
+  auto const start = clock_->Now();
   std::unique_lock<std::mutex> lk(mu_);
   for (;;) {
-    if (!sessions_.empty()) {
-      // return the most recently used session.
-      auto session = std::move(sessions_.back());
-      sessions_.pop_back();
-      if (dissociate_from_pool) {
-        --total_sessions_;
-        auto const& channel = session->channel();
-        if (channel) {
-          --channel->session_count;
-        }
-      }
+    if (auto session = TryPopIdleSessionLocked(read_write)) {
+      if (dissociate_from_pool) RemoveFromCounts(*session);
+      lk.unlock();
+      PrewarmIfExhausted();
+      allocation_wait_.Record(ElapsedSince(start));
       return {MakeSessionHolder(std::move(session), dissociate_from_pool)};
     }
 
     // If the pool is at its max size, fail or wait until someone returns a
     // session to the pool then try again.
     if (total_sessions_ >= max_pool_size_) {
+      ++exhaustion_events_;
       if (options_.action_on_exhaustion() == ActionOnExhaustion::kFail) {
+        allocation_wait_.Record(ElapsedSince(start));
         return Status(StatusCode::kResourceExhausted, "session pool exhausted");
       }
       Wait(lk, [this] {
-        return !sessions_.empty() || total_sessions_ < max_pool_size_;
+        return idle_sessions_ > 0 || total_sessions_ < max_pool_size_;
       });
       continue;
     }
@@ -301,8 +547,9 @@ StatusOr<SessionHolder> SessionPool::Allocate(bool dissociate_from_pool) {
     // simulaneous calls if additional sessions are needed. We can also use the
     // number of waiters in the `sessions_to_create` calculation below.
     if (create_calls_in_progress_ > 0) {
-      Wait(lk, [this] {
-        return !sessions_.empty() || create_calls_in_progress_ == 0;
+      Wait(lk, [this, read_write] {
+        return UsableIdleSessions(read_write) > 0 ||
+               create_calls_in_progress_ == 0;
       });
       continue;
     }
@@ -312,11 +559,88 @@ StatusOr<SessionHolder> SessionPool::Allocate(bool dissociate_from_pool) {
     auto status =
         Grow(lk, options_.min_sessions() + 1, WaitForSessionAllocation::kWait);
     if (!status.ok()) {
+      allocation_wait_.Record(ElapsedSince(start));
       return status;
     }
   }
 }
 
+future<StatusOr<SessionHolder>> SessionPool::AsyncAllocate(
+    std::chrono::system_clock::time_point deadline, bool dissociate_from_pool,
+    bool read_write) {
+  // The fast path, as in `Allocate()`. Skip it if there are queued requests,
+  // so they are satisfied in FIFO order.
+  if (num_async_waiters_ == 0) {
+    if (auto session = TryPopIdleSession(read_write)) {
+      if (dissociate_from_pool) {
+        std::lock_guard<std::mutex> lk(mu_);
+        RemoveFromCounts(*session);
+      }
+      PrewarmIfExhausted();
+      allocation_wait_.Record(std::chrono::microseconds(0));
+      return make_ready_future(StatusOr<SessionHolder>(
+          MakeSessionHolder(std::move(session), dissociate_from_pool)));
+    }
+  }
+
+  auto waiter = std::make_shared<AsyncWaiter>(dissociate_from_pool, read_write,
+                                              clock_->Now());
+  auto f = waiter->result.get_future();
+  std::unique_lock<std::mutex> lk(mu_);
+  async_waiters_.push_back(waiter);
+  ++num_async_waiters_;
+  auto completions = ServeAsyncWaiters();
+  if (waiter->queued) {
+    if (total_sessions_ >= max_pool_size_) {
+      ++exhaustion_events_;
+      if (options_.action_on_exhaustion() == ActionOnExhaustion::kFail) {
+        // `waiter` was not served, so it must still be the last one queued.
+        async_waiters_.pop_back();
+        --num_async_waiters_;
+        completions.push_back(MakeAsyncCompletion(
+            waiter,
+            Status(StatusCode::kResourceExhausted, "session pool exhausted")));
+      }
+    } else if (create_calls_in_progress_ == 0) {
+      // Add sessions for all the queued requests, plus `min_sessions`. The
+      // requests are served when the sessions are added to the pool.
+      (void)Grow(lk,
+                 options_.min_sessions() +
+                     static_cast<int>(async_waiters_.size()),
+                 WaitForSessionAllocation::kNoWait);
+    }
+  }
+  bool const queued = waiter->queued;
+  lk.unlock();
+  CompleteAsyncWaiters(std::move(completions));
+
+  if (queued && deadline != (std::chrono::system_clock::time_point::max)()) {
+    std::weak_ptr<SessionPool> pool = shared_from_this();
+    std::weak_ptr<AsyncWaiter> weak_waiter = waiter;
+    auto timer =
+        cq_.MakeDeadlineTimer(deadline).then(
+            [pool, weak_waiter](
+                future<StatusOr<std::chrono::system_clock::time_point>>
+                    result) {
+              // Ignore cancelled timers, the request was already satisfied.
+              if (!result.get().ok()) return;
+              auto shared_pool = pool.lock();
+              auto shared_waiter = weak_waiter.lock();
+              if (shared_pool && shared_waiter) {
+                shared_pool->ExpireAsyncWaiter(shared_waiter);
+              }
+            });
+    lk.lock();
+    if (waiter->queued) {
+      waiter->timer = std::move(timer);
+    } else {
+      lk.unlock();
+      timer.cancel();
+    }
+  }
+  return f;
+}
+
 std::shared_ptr<SpannerStub> SessionPool::GetStub(Session const& session) {
   auto const& channel = session.channel();
   if (channel) {
@@ -334,26 +658,469 @@ std::shared_ptr<SpannerStub> SessionPool::GetStub(Session const& session) {
   return stub;
 }
 
-void SessionPool::Release(std::unique_ptr<Session> session) {
+std::unique_ptr<Session> SessionPool::TryPopIdleSessionLocked(
+    bool read_write) {
+  return TryPopIdleSession(read_write,
+                           /*use_prepared=*/total_sessions_ >= max_pool_size_);
+}
+
+int SessionPool::UsableIdleSessions(bool read_write) const {
+  if (read_write) return idle_sessions_;
+  return idle_sessions_ - prepared_sessions_;
+}
+
+std::unique_ptr<Session> SessionPool::TryPopIdleSession(bool read_write,
+                                                        bool use_prepared) {
+  if (idle_sessions_ == 0) return nullptr;
+  if (options_.allocation_strategy() ==
+      SessionAllocationStrategy::kThreadAffinity) {
+    if (auto session = TryPopAffinitySession(read_write)) return session;
+  }
+  auto const shard_count = shards_.size();
+  auto const hint = ShardHint();
+
+  // Find the least loaded channel that has idle sessions. Starting the search
+  // at the thread's preferred shard breaks ties in different ways for
+  // different threads. The counters are read without any locks, so this is
+  // only a (very good) heuristic.
+  Shard* best = nullptr;
+  int best_in_use = 0;
+  for (std::size_t i = 0; i != shard_count; ++i) {
+    auto& shard = *shards_[(hint + i) % shard_count];
+    if (shard.idle_count == 0) continue;
+    auto const in_use = shard.channel->sessions_in_use.load();
+    if (best == nullptr || in_use < best_in_use) {
+      best = &shard;
+      best_in_use = in_use;
+    }
+  }
+  if (best != nullptr) {
+    if (auto session = TryPopIdleSession(*best, read_write, use_prepared)) {
+      return session;
+    }
+  }
+
+  // Another thread took the session we found, try every shard in turn.
+  for (std::size_t i = 0; i != shard_count; ++i) {
+    auto& shard = *shards_[(hint + i) % shard_count];
+    if (auto session = TryPopIdleSession(shard, read_write, use_prepared)) {
+      return session;
+    }
+  }
+  return nullptr;
+}
+
+std::unique_ptr<Session> SessionPool::TryPopIdleSession(Shard& shard,
+                                                        bool read_write,
+                                                        bool use_prepared) {
+  std::lock_guard<std::mutex> lk(shard.mu);
+  if (shard.sessions.empty()) return nullptr;
+  auto const matches = [read_write](std::unique_ptr<Session> const& s) {
+    return s->has_prepared_transaction() == read_write;
+  };
+  // Read-write callers may use any session, read-only callers only use a
+  // prepared session if allowed to, as that wastes its transaction.
+  auto const usable = read_write || use_prepared;
+  // Return the least (FIFO) or most (otherwise) recently used session, unless
+  // there is a better match for `read_write`. Without prepared sessions there
+  // is nothing to search.
+  if (options_.allocation_strategy() == SessionAllocationStrategy::kFifo) {
+    auto it = shard.sessions.begin();
+    if (shard.prepared_count > 0 && !matches(*it)) {
+      auto match = std::find_if(it, shard.sessions.end(), matches);
+      if (match != shard.sessions.end()) {
+        it = match;
+      } else if (!usable) {
+        return nullptr;
+      }
+    }
+    return PopIdleSession(shard, it);
+  }
+  auto it = std::prev(shard.sessions.end());
+  if (shard.prepared_count > 0 && !matches(*it)) {
+    auto match = std::find_if(shard.sessions.rbegin(), shard.sessions.rend(),
+                              matches);
+    if (match != shard.sessions.rend()) {
+      it = std::prev(match.base());
+    } else if (!usable) {
+      return nullptr;
+    }
+  }
+  return PopIdleSession(shard, it);
+}
+
+std::unique_ptr<Session> SessionPool::TryPopAffinitySession(bool read_write) {
+  auto const& affinity = thread_affinity;
+  if (affinity.pool != this || affinity.shard >= shards_.size()) {
+    return nullptr;
+  }
+  auto& shard = *shards_[affinity.shard];
+  std::lock_guard<std::mutex> lk(shard.mu);
+  // The session was released recently, so search from the back.
+  auto match = std::find_if(shard.sessions.rbegin(), shard.sessions.rend(),
+                            [&affinity](std::unique_ptr<Session> const& s) {
+                              return s.get() == affinity.session;
+                            });
+  if (match == shard.sessions.rend()) return nullptr;
+  if (shard.prepared_count > 0 &&
+      (*match)->has_prepared_transaction() != read_write) {
+    return nullptr;
+  }
+  return PopIdleSession(shard, std::prev(match.base()));
+}
+
+std::unique_ptr<Session> SessionPool::PopIdleSession(
+    Shard& shard, std::deque<std::unique_ptr<Session>>::iterator it) {
+  auto session = std::move(*it);
+  shard.sessions.erase(it);
+  --shard.idle_count;
+  --idle_sessions_;
+  if (session->has_prepared_transaction()) {
+    --shard.prepared_count;
+    --prepared_sessions_;
+  }
+  return session;
+}
+
+void SessionPool::RemoveFromCounts(Session const& session) {
+  --total_sessions_;
+  auto const& channel = session.channel();
+  if (channel) {
+    --channel->session_count;
+  }
+}
+
+SessionPool::Shard& SessionPool::ShardFor(
+    std::shared_ptr<Channel> const& channel) {
+  return *shards_[ShardIndex(channel)];
+}
+
+std::size_t SessionPool::ShardIndex(
+    std::shared_ptr<Channel> const& channel) const {
+  for (std::size_t i = 0; i != shards_.size(); ++i) {
+    if (shards_[i]->channel == channel) return i;
+  }
+  // Sessions in the pool are always created on one of `channels_`.
+  return 0;
+}
+
+std::size_t SessionPool::ShardHint() const {
+  // Assign each thread a fixed starting shard, round-robin, so concurrent
+  // callers tend to use different shard mutexes. (Hashing the thread id is
+  // not suitable, as some platforms use aligned addresses as thread ids.)
+  static std::atomic<std::size_t> next_hint{0};
+  static thread_local std::size_t const hint = next_hint++;
+  return hint % shards_.size();
+}
+
+std::vector<SessionPool::AsyncCompletion> SessionPool::ServeAsyncWaiters() {
+  std::vector<AsyncCompletion> completions;
+  while (!async_waiters_.empty()) {
+    auto session = TryPopIdleSessionLocked(async_waiters_.front()->read_write);
+    if (!session) break;
+    auto waiter = std::move(async_waiters_.front());
+    async_waiters_.pop_front();
+    --num_async_waiters_;
+    if (waiter->dissociate_from_pool) RemoveFromCounts(*session);
+    auto holder =
+        MakeSessionHolder(std::move(session), waiter->dissociate_from_pool);
+    completions.push_back(
+        MakeAsyncCompletion(std::move(waiter), std::move(holder)));
+  }
+  return completions;
+}
+
+std::vector<SessionPool::AsyncCompletion> SessionPool::FailAsyncWaiters(
+    Status const& status) {
+  std::vector<AsyncCompletion> completions;
+  for (auto& waiter : async_waiters_) {
+    completions.push_back(MakeAsyncCompletion(std::move(waiter), status));
+  }
+  async_waiters_.clear();
+  num_async_waiters_ = 0;
+  return completions;
+}
+
+SessionPool::AsyncCompletion SessionPool::MakeAsyncCompletion(
+    std::shared_ptr<AsyncWaiter> waiter, StatusOr<SessionHolder> result) {
+  waiter->queued = false;
+  auto timer = std::move(waiter->timer);
+  return AsyncCompletion{std::move(waiter), std::move(result),
+                         std::move(timer)};
+}
+
+void SessionPool::CompleteAsyncWaiters(
+    std::vector<AsyncCompletion> completions) {
+  // Satisfies the future from the `CompletionQueue`. If the queue discards the
+  // callback without running it, e.g. because it is shut down, the destructor
+  // satisfies the future in the discarding thread instead.
+  struct PendingCompletion {
+    PendingCompletion(std::shared_ptr<AsyncWaiter> w,
+                      StatusOr<SessionHolder> r)
+        : waiter(std::move(w)), result(std::move(r)) {}
+
+    std::shared_ptr<AsyncWaiter> waiter;
+    StatusOr<SessionHolder> result;
+    bool done = false;
+
+    void Complete() {
+      if (done) return;
+      done = true;
+      waiter->result.set_value(std::move(result));
+    }
+    ~PendingCompletion() { Complete(); }
+  };
+
+  for (auto& c : completions) {
+    if (c.timer.valid()) c.timer.cancel();
+    allocation_wait_.Record(ElapsedSince(c.waiter->start));
+    auto pending = std::make_shared<PendingCompletion>(std::move(c.waiter),
+                                                       std::move(c.result));
+    cq_.RunAsync([pending](CompletionQueue&) { pending->Complete(); });
+  }
+}
+
+void SessionPool::ExpireAsyncWaiter(
+    std::shared_ptr<AsyncWaiter> const& waiter) {
+  std::unique_lock<std::mutex> lk(mu_);
+  if (!waiter->queued) return;
+  async_waiters_.erase(
+      std::find(async_waiters_.begin(), async_waiters_.end(), waiter));
+  --num_async_waiters_;
+  std::vector<AsyncCompletion> completions;
+  completions.push_back(MakeAsyncCompletion(
+      waiter, Status(StatusCode::kDeadlineExceeded,
+                     "timed out waiting for a session")));
+  lk.unlock();
+  CompleteAsyncWaiters(std::move(completions));
+}
+
+SessionPoolMetrics SessionPool::Metrics() {
+  SessionPoolMetrics metrics;
   std::unique_lock<std::mutex> lk(mu_);
+  metrics.total_sessions = total_sessions_;
+  metrics.idle_sessions = idle_sessions_;
+  metrics.create_calls_in_progress = create_calls_in_progress_;
+  metrics.prepared_sessions = prepared_sessions_;
+  metrics.threads_waiting = num_waiting_for_session_;
+  metrics.async_waiters = static_cast<int>(async_waiters_.size());
+  metrics.channels.reserve(shards_.size());
+  for (auto const& shard : shards_) {
+    SessionPoolMetrics::ChannelMetrics channel;
+    channel.session_count = shard->channel->session_count;
+    channel.sessions_in_use = shard->channel->sessions_in_use;
+    channel.idle_sessions = shard->idle_count;
+    metrics.channels.push_back(channel);
+  }
+  lk.unlock();
+  metrics.exhaustion_events = exhaustion_events_;
+  metrics.allocation_wait = allocation_wait_.Snapshot();
+  metrics.creation_latency = creation_latency_.Snapshot();
+  return metrics;
+}
+
+std::chrono::microseconds SessionPool::ElapsedSince(
+    Session::Clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(clock_->Now() -
+                                                               start);
+}
+
+std::vector<int> SessionPool::SessionsInUsePerChannel() const {
+  std::vector<int> result;
+  result.reserve(shards_.size());
+  for (auto const& shard : shards_) {
+    result.push_back(shard->channel->sessions_in_use.load());
+  }
+  return result;
+}
+
+void SessionPool::GrowInBackground(std::unique_lock<std::mutex>& lk) {
+  // A call in progress calls this again when it completes.
+  if (create_calls_in_progress_ > 0 || total_sessions_ >= max_pool_size_) {
+    return;
+  }
+  auto const target =
+      (std::max)(options_.min_sessions(), demand_stats_.target_sessions);
+  auto const count = (std::max)(target - total_sessions_,
+                                static_cast<int>(async_waiters_.size()));
+  if (count <= 0) return;
+  (void)Grow(lk, count, WaitForSessionAllocation::kNoWait);
+}
+
+void SessionPool::EvictIdleSession(Shard& shard,
+                                   std::string const& session_name) {
+  std::unique_lock<std::mutex> lk(mu_);
+  std::unique_ptr<Session> session;
+  {
+    std::lock_guard<std::mutex> shard_lk(shard.mu);
+    auto it = std::find_if(shard.sessions.begin(), shard.sessions.end(),
+                           [&session_name](std::unique_ptr<Session> const& s) {
+                             return s->session_name() == session_name;
+                           });
+    // If the session is in use it is marked bad (and replaced) when the
+    // caller's request fails.
+    if (it == shard.sessions.end()) return;
+    session = PopIdleSession(shard, it);
+  }
+  RemoveFromCounts(*session);
+  GrowInBackground(lk);
+}
+
+void SessionPool::Release(std::unique_ptr<Session> session) {
+  --session->channel()->sessions_in_use;
+  --sessions_in_use_;
   if (session->is_bad()) {
-    // Once we have support for background processing, we may want to signal
-    // that to replenish this bad session.
-    --total_sessions_;
-    auto const& channel = session->channel();
-    if (channel) {
-      --channel->session_count;
-    }
+    DiscardSession(*session);
     return;
   }
   session->update_last_use_time();
-  sessions_.push_back(std::move(session));
+  if (options_.allocation_strategy() ==
+      SessionAllocationStrategy::kThreadAffinity) {
+    thread_affinity = ThreadAffinity{this, session.get(),
+                                     ShardIndex(session->channel())};
+  }
+  // A session that still has its prepared transaction (e.g. one given to a
+  // read-only holder when the pool was full) keeps it for a read-write caller.
+  if (!session->has_prepared_transaction() &&
+      options_.write_sessions_fraction() > 0 && StartPreparing()) {
+    PrepareReadWriteTransaction(std::move(session));
+    return;
+  }
+  AddIdleSession(std::move(session));
+}
+
+void SessionPool::AddIdleSession(std::unique_ptr<Session> session) {
+  auto& shard = ShardFor(session->channel());
+  auto const prepared = session->has_prepared_transaction();
+  {
+    std::lock_guard<std::mutex> lk(shard.mu);
+    if (prepared) {
+      ++shard.prepared_count;
+      ++prepared_sessions_;
+    }
+    shard.sessions.push_back(std::move(session));
+    ++shard.idle_count;
+    ++idle_sessions_;
+  }
+  if (num_async_waiters_ > 0) {
+    std::unique_lock<std::mutex> lk(mu_);
+    auto completions = ServeAsyncWaiters();
+    lk.unlock();
+    CompleteAsyncWaiters(std::move(completions));
+  }
+  if (num_waiting_for_session_ > 0) {
+    // Waiters check their predicate and block with `mu_` held; acquiring it
+    // here guarantees the notification cannot be missed.
+    { std::lock_guard<std::mutex> lk(mu_); }
+    // Read-only callers may not be able to use a prepared session, so wake
+    // them all to make sure a read-write caller sees it.
+    if (prepared) {
+      cond_.notify_all();
+    } else {
+      cond_.notify_one();
+    }
+  }
+}
+
+void SessionPool::DiscardSession(Session const& session) {
+  // Drop the session, and replace it in the background, so callers do not
+  // wait for the replacement to be created.
+  std::unique_lock<std::mutex> lk(mu_);
+  RemoveFromCounts(session);
+  GrowInBackground(lk);
+  // Wake any waiters, the pool may now have room to grow.
   if (num_waiting_for_session_ > 0) {
     lk.unlock();
     cond_.notify_one();
   }
 }
 
+bool SessionPool::StartPreparing() {
+  // Never delay callers waiting for a session.
+  if (num_waiting_for_session_ > 0 || num_async_waiters_ > 0) return false;
+  auto const target = static_cast<int>(options_.write_sessions_fraction() *
+                                       static_cast<double>(total_sessions_));
+  // The counters may change concurrently, so the target is approximate, but
+  // each call in flight is counted exactly once.
+  auto preparing = preparing_sessions_.load();
+  do {
+    if (prepared_sessions_ + preparing >= target) return false;
+  } while (
+      !preparing_sessions_.compare_exchange_weak(preparing, preparing + 1));
+  return true;
+}
+
+void SessionPool::PrepareWriteSessions() {
+  if (options_.write_sessions_fraction() <= 0) return;
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lk(shard->mu);
+    if (shard->prepared_count == 0) continue;
+    for (auto& session : shard->sessions) {
+      if (session->has_prepared_transaction() &&
+          session->prepared_transaction_is_stale()) {
+        session->clear_prepared_transaction();
+        --shard->prepared_count;
+        --prepared_sessions_;
+      }
+    }
+  }
+
+  std::vector<std::unique_ptr<Session>> sessions;
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lk(shard->mu);
+    // Use the least recently used sessions first, they are the least likely
+    // to be allocated while the transaction is being prepared.
+    while (StartPreparing()) {
+      auto it = std::find_if(shard->sessions.begin(), shard->sessions.end(),
+                             [](std::unique_ptr<Session> const& s) {
+                               return !s->has_prepared_transaction();
+                             });
+      if (it == shard->sessions.end()) {
+        --preparing_sessions_;
+        break;
+      }
+      sessions.push_back(PopIdleSession(*shard, it));
+    }
+  }
+  for (auto& session : sessions) {
+    PrepareReadWriteTransaction(std::move(session));
+  }
+}
+
+void SessionPool::PrepareReadWriteTransaction(
+    std::unique_ptr<Session> session) {
+  auto stub = session->channel()->stub;
+  auto name = session->session_name();
+  // The continuation must be copyable, so share the ownership of `session`
+  // until the call completes.
+  auto owner = std::make_shared<std::unique_ptr<Session>>(std::move(session));
+  std::weak_ptr<SessionPool> pool = shared_from_this();
+  AsyncBeginTransaction(cq_, stub, std::move(name))
+      .then([pool, owner](future<StatusOr<spanner_proto::Transaction>> f) {
+        if (auto shared_pool = pool.lock()) {
+          shared_pool->HandleBeginTransactionDone(std::move(*owner), f.get());
+        }
+      });
+}
+
+void SessionPool::HandleBeginTransactionDone(
+    std::unique_ptr<Session> session,
+    StatusOr<spanner_proto::Transaction> transaction) {
+  --preparing_sessions_;
+  if (!transaction.ok()) {
+    if (IsSessionNotFound(transaction.status())) {
+      DiscardSession(*session);
+      return;
+    }
+    // The session is still usable, just without a prepared transaction.
+    AddIdleSession(std::move(session));
+    return;
+  }
+  session->update_last_use_time();
+  session->set_prepared_transaction(std::move(*transaction->mutable_id()));
+  AddIdleSession(std::move(session));
+}
+
 // Creates `num_sessions` on `channel` and adds them to the pool.
 Status SessionPool::CreateSessionsSync(
     std::shared_ptr<Channel> const& channel,
@@ -364,6 +1131,7 @@ Status SessionPool::CreateSessionsSync(
                                                                labels.end());
   request.set_session_count(std::int32_t{num_sessions});
   auto const& stub = channel->stub;
+  auto const start = clock_->Now();
   auto response = RetryLoop(
       retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
       true,
@@ -372,30 +1140,37 @@ Status SessionPool::CreateSessionsSync(
         return stub->BatchCreateSessions(context, request);
       },
       request, __func__);
+  creation_latency_.Record(ElapsedSince(start));
   return HandleBatchCreateSessionsDone(channel, std::move(response));
 }
 
-void SessionPool::CreateSessionsAsync(
+future<Status> SessionPool::CreateSessionsAsync(
     std::shared_ptr<Channel> const& channel,
     std::map<std::string, std::string> const& labels, int num_sessions) {
   std::weak_ptr<SessionPool> pool = shared_from_this();
-  AsyncBatchCreateSessions(cq_, channel->stub, labels, num_sessions)
-      .then([pool, channel](
+  auto const start = clock_->Now();
+  return AsyncBatchCreateSessions(cq_, channel->stub, labels, num_sessions)
+      .then([pool, channel, start](
                 future<StatusOr<spanner_proto::BatchCreateSessionsResponse>>
                     result) {
         if (auto shared_pool = pool.lock()) {
-          shared_pool->HandleBatchCreateSessionsDone(channel,
-                                                     std::move(result).get());
+          shared_pool->creation_latency_.Record(
+              shared_pool->ElapsedSince(start));
+          return shared_pool->HandleBatchCreateSessionsDone(
+              channel, std::move(result).get());
         }
+        return Status(StatusCode::kCancelled, "session pool destroyed");
       });
 }
 
 SessionHolder SessionPool::MakeSessionHolder(std::unique_ptr<Session> session,
                                              bool dissociate_from_pool) {
+  RecordAllocation(dissociate_from_pool);
   if (dissociate_from_pool) {
     // Uses the default deleter; the `Session` is not returned to the pool.
     return {std::move(session)};
   }
+  ++session->channel()->sessions_in_use;
   std::weak_ptr<SessionPool> pool = shared_from_this();
   return SessionHolder(session.release(), [pool](Session* s) {
     std::unique_ptr<Session> session(s);
@@ -406,6 +1181,29 @@ SessionHolder SessionPool::MakeSessionHolder(std::unique_ptr<Session> session,
   });
 }
 
+void SessionPool::RecordAllocation(bool dissociate_from_pool) {
+  ++allocations_;
+  // Dissociated sessions are no longer part of the pool.
+  if (dissociate_from_pool) return;
+  auto const in_use = ++sessions_in_use_;
+  auto peak = peak_sessions_in_use_.load();
+  while (in_use > peak &&
+         !peak_sessions_in_use_.compare_exchange_weak(peak, in_use)) {
+  }
+}
+
+void SessionPool::PrewarmIfExhausted() {
+  if (!options_.adaptive_sizing() || idle_sessions_ > 0) return;
+  std::unique_lock<std::mutex> lk(mu_);
+  if (idle_sessions_ > 0 || create_calls_in_progress_ > 0 ||
+      total_sessions_ >= max_pool_size_) {
+    return;
+  }
+  // Grow by 25% (at least one session) in anticipation of more demand.
+  (void)Grow(lk, (std::max)(1, (total_sessions_ + 3) / 4),
+             WaitForSessionAllocation::kNoWait);
+}
+
 future<StatusOr<spanner_proto::BatchCreateSessionsResponse>>
 SessionPool::AsyncBatchCreateSessions(
     CompletionQueue& cq, std::shared_ptr<SpannerStub> const& stub,
@@ -461,28 +1259,85 @@ future<StatusOr<spanner_proto::Session>> SessionPool::AsyncGetSession(
       std::move(request));
 }
 
+future<StatusOr<spanner_proto::ResultSet>> SessionPool::AsyncSelectOne(
+    CompletionQueue& cq, std::shared_ptr<SpannerStub> const& stub,
+    std::string session_name) {
+  spanner_proto::ExecuteSqlRequest request;
+  request.set_session(std::move(session_name));
+  request.set_sql("SELECT 1");
+  return google::cloud::internal::StartRetryAsyncUnaryRpc(
+      cq, __func__, retry_policy_prototype_->clone(),
+      backoff_policy_prototype_->clone(),
+      /*is_idempotent=*/true,
+      [stub](grpc::ClientContext* context,
+             spanner_proto::ExecuteSqlRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return stub->AsyncExecuteSql(*context, request, cq);
+      },
+      std::move(request));
+}
+
+future<StatusOr<spanner_proto::Transaction>>
+SessionPool::AsyncBeginTransaction(CompletionQueue& cq,
+                                   std::shared_ptr<SpannerStub> const& stub,
+                                   std::string session_name) {
+  spanner_proto::BeginTransactionRequest request;
+  request.set_session(std::move(session_name));
+  *request.mutable_options()->mutable_read_write() =
+      spanner_proto::TransactionOptions::ReadWrite();
+  return google::cloud::internal::StartRetryAsyncUnaryRpc(
+      cq, __func__, retry_policy_prototype_->clone(),
+      backoff_policy_prototype_->clone(),
+      /*is_idempotent=*/true,
+      [stub](grpc::ClientContext* context,
+             spanner_proto::BeginTransactionRequest const& request,
+             grpc::CompletionQueue* cq) {
+        return stub->AsyncBeginTransaction(*context, request, cq);
+      },
+      std::move(request));
+}
+
 Status SessionPool::HandleBatchCreateSessionsDone(
     std::shared_ptr<Channel> const& channel,
     StatusOr<spanner_proto::BatchCreateSessionsResponse> response) {
   std::unique_lock<std::mutex> lk(mu_);
   --create_calls_in_progress_;
   if (!response.ok()) {
+    // Queued `AsyncAllocate()` requests fail if there is no other call that
+    // could satisfy them.
+    std::vector<AsyncCompletion> completions;
+    if (create_calls_in_progress_ == 0) {
+      completions = FailAsyncWaiters(response.status());
+    }
+    // Wake up anyone waiting for this call to complete, so they can retry.
+    lk.unlock();
+    CompleteAsyncWaiters(std::move(completions));
+    cond_.notify_all();
     return response.status();
   }
   // Add sessions to the pool and update counters for `channel` and the pool.
   auto const sessions_created = response->session_size();
   channel->session_count += sessions_created;
   total_sessions_ += sessions_created;
-  sessions_.reserve(sessions_.size() + sessions_created);
-  for (auto& session : *response->mutable_session()) {
-    sessions_.push_back(google::cloud::internal::make_unique<Session>(
-        std::move(*session.mutable_name()), channel, clock_));
+  auto& shard = ShardFor(channel);
+  {
+    std::lock_guard<std::mutex> shard_lk(shard.mu);
+    for (auto& session : *response->mutable_session()) {
+      shard.sessions.push_back(google::cloud::internal::make_unique<Session>(
+          std::move(*session.mutable_name()), channel, clock_));
+    }
+    shard.idle_count += sessions_created;
+    idle_sessions_ += sessions_created;
   }
-  // Shuffle the pool so we distribute returned sessions across channels.
-  std::shuffle(sessions_.begin(), sessions_.end(), random_generator_);
+
+  // Keep growing the pool if there are still queued requests, or the pool is
+  // still below its target size.
+  auto completions = ServeAsyncWaiters();
+  GrowInBackground(lk);
 
   // Wake up anyone who was waiting for a `Session`.
   lk.unlock();
+  CompleteAsyncWaiters(std::move(completions));
   cond_.notify_all();
   return Status();
 }
@@ -18,22 +18,26 @@
 #include "google/cloud/spanner/backoff_policy.h"
 #include "google/cloud/spanner/database.h"
 #include "google/cloud/spanner/internal/channel.h"
+#include "google/cloud/spanner/internal/latency_histogram.h"
 #include "google/cloud/spanner/internal/session.h"
 #include "google/cloud/spanner/internal/spanner_stub.h"
 #include "google/cloud/spanner/retry_policy.h"
+#include "google/cloud/spanner/session_pool_metrics.h"
 #include "google/cloud/spanner/session_pool_options.h"
 #include "google/cloud/spanner/version.h"
 #include "google/cloud/completion_queue.h"
 #include "google/cloud/future.h"
 #include "google/cloud/status_or.h"
 #include <google/spanner/v1/spanner.pb.h>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <map>
 #include <memory>
 #include <mutex>
-#include <random>
 #include <string>
 #include <utility>
 #include <vector>
@@ -45,6 +49,25 @@ inline namespace SPANNER_CLIENT_NS {
 namespace internal {
 struct SessionPoolFriendForTest;
 
+/**
+ * The demand for sessions observed by a `SessionPool`.
+ *
+ * The statistics cover the most recent `SessionPoolOptions::demand_window()`,
+ * and are updated each time the pool runs its background maintenance.
+ */
+struct SessionPoolDemandStats {
+  /// The period covered by these statistics (at most the demand window).
+  std::chrono::seconds observed_period{0};
+  /// The number of sessions allocated during `observed_period`.
+  std::int64_t allocations = 0;
+  /// The average allocation rate during `observed_period`.
+  double allocations_per_second = 0;
+  /// The maximum number of sessions in use at once during `observed_period`.
+  int peak_sessions_in_use = 0;
+  /// The number of sessions the pool is trying to maintain.
+  int target_sessions = 0;
+};
+
 /**
  * Maintains a pool of `Session` objects.
  *
@@ -54,9 +77,28 @@ struct SessionPoolFriendForTest;
  * first time we use a `Transaction`, then return it to the pool when the
  * `Transaction` finishes.
  *
- * Allocation from the pool is LIFO to take advantage of the fact the Spanner
- * backends maintain a cache of sessions which is valid for 30 seconds, so
- * re-using Sessions as quickly as possible has performance advantages.
+ * By default allocation from the pool is LIFO to take advantage of the fact
+ * the Spanner backends maintain a cache of sessions which is valid for 30
+ * seconds, so re-using Sessions as quickly as possible has performance
+ * advantages. `SessionPoolOptions::set_allocation_strategy()` selects FIFO
+ * or per-thread affinity instead.
+ *
+ * Idle sessions are kept in one shard per `Channel`, each with its own mutex.
+ * Allocating an idle session, or releasing one back to the pool, only locks a
+ * single shard (the allocation order is maintained within each shard), so
+ * concurrent callers rarely contend with each other. The pool-wide mutex is
+ * only used when the pool needs to grow, or when a caller must wait for a
+ * session.
+ *
+ * When allocating, the pool prefers idle sessions on the channel with the
+ * fewest sessions in use, so the load is spread across all the channels
+ * (i.e. gRPC connections), instead of concentrating on whichever channel
+ * created the most recently used sessions.
+ *
+ * Optionally (see `SessionPoolOptions::write_sessions_fraction()`) the pool
+ * begins read-write transactions on some idle sessions in the background.
+ * Read-write transactions allocated one of these sessions use the prepared
+ * transaction for their first statement, instead of beginning one inline.
  */
 class SessionPool : public std::enable_shared_from_this<SessionPool> {
  public:
@@ -75,12 +117,33 @@ class SessionPool : public std::enable_shared_from_this<SessionPool> {
   ~SessionPool();
 
   /**
-   * If using the factory method is not possible, call `Initialize()` exactly
-   * once, immediately after constructing the pool. This is necessary because
-   * we are unable to call shared_from_this() in the constructor.
+   * If using the factory method is not possible, call `Initialize()` (or
+   * `InitializeAsync()`) exactly once, immediately after constructing the
+   * pool. This is necessary because we are unable to call shared_from_this()
+   * in the constructor.
+   *
+   * Creates the initial `min_sessions`, blocking until they are in the pool.
+   * All the `BatchCreateSessions` calls needed (at least one per channel, more
+   * if a channel needs more sessions than a single call can create) are made
+   * concurrently, so this takes roughly one round-trip regardless of the pool
+   * size. When more than one call is needed they are made asynchronously, as
+   * in `InitializeAsync()`, and this waits for them, which requires a thread
+   * running the pool's `CompletionQueue`. A single call is made on the calling
+   * thread.
    */
   void Initialize();
 
+  /**
+   * Like `Initialize()`, but returns without waiting for the initial sessions.
+   *
+   * The `BatchCreateSessions` calls are made asynchronously, which requires a
+   * thread running the pool's `CompletionQueue`. The pool may be used at once;
+   * callers that need a session before the calls complete wait for them. The
+   * returned future is satisfied when all the calls have completed, with the
+   * last error, if any call failed.
+   */
+  future<Status> InitializeAsync();
+
   /**
    * Allocate a `Session` from the pool, creating a new one if necessary.
    *
@@ -89,16 +152,55 @@ class SessionPool : public std::enable_shared_from_this<SessionPool> {
    * pool.  This is used in partitioned operations, since we don't know when all
    * parties are done using the session.
    *
+   * If `read_write` is true the pool prefers a session holding a prepared
+   * read-write transaction (see `SessionPoolOptions::write_sessions_fraction`
+   * and `Session::TakePreparedTransaction()`). Otherwise the pool only uses
+   * such a session when it is at its maximum size, and would have to wait or
+   * fail instead. The session keeps the prepared transaction, and returns to
+   * the pool with it, unless the holder takes it.
+   *
    * @return a `SessionHolder` on success (which is guaranteed not to be
    * `nullptr`), or an error.
    */
-  StatusOr<SessionHolder> Allocate(bool dissociate_from_pool = false);
+  StatusOr<SessionHolder> Allocate(bool dissociate_from_pool = false,
+                                   bool read_write = false);
+
+  /**
+   * Asynchronously allocate a `Session` from the pool.
+   *
+   * This never blocks the calling thread. If there are no idle sessions the
+   * pool grows (asynchronously) if it can. If it cannot, and the pool is
+   * configured with `ActionOnExhaustion::kBlock`, the request is queued until
+   * a session is released. Queued requests are satisfied in FIFO order, on a
+   * thread running the pool's `CompletionQueue`.
+   *
+   * @param deadline if no session is available by this time the returned
+   *     future is satisfied with a `kDeadlineExceeded` error.
+   * @param dissociate_from_pool see `Allocate()`.
+   * @param read_write see `Allocate()`.
+   */
+  future<StatusOr<SessionHolder>> AsyncAllocate(
+      std::chrono::system_clock::time_point deadline =
+          (std::chrono::system_clock::time_point::max)(),
+      bool dissociate_from_pool = false, bool read_write = false);
 
   /**
    * Return a `SpannerStub` to be used when making calls using `session`.
    */
   std::shared_ptr<SpannerStub> GetStub(Session const& session);
 
+  /**
+   * Return the number of sessions currently in use on each channel, in the
+   * same order as the stubs given to the constructor.
+   */
+  std::vector<int> SessionsInUsePerChannel() const;
+
+  /// Return the demand statistics used to size the pool.
+  SessionPoolDemandStats DemandStats();
+
+  /// Return a snapshot of the pool's state and metrics.
+  SessionPoolMetrics Metrics();
+
  private:
   // Represents a request to create `session_count` sessions on `channel`
   // See `ComputeCreateCounts` and `CreateSessions`.
@@ -108,9 +210,167 @@ class SessionPool : public std::enable_shared_from_this<SessionPool> {
   };
   enum class WaitForSessionAllocation { kWait, kNoWait };
 
+  // A queued `AsyncAllocate()` request.
+  struct AsyncWaiter {
+    AsyncWaiter(bool d, bool rw, Session::Clock::time_point s)
+        : dissociate_from_pool(d), read_write(rw), start(s) {}
+
+    bool const dissociate_from_pool;
+    bool const read_write;
+    Session::Clock::time_point const start;
+    promise<StatusOr<SessionHolder>> result;
+    bool queued = true;  // GUARDED_BY(mu_)
+    future<void> timer;  // GUARDED_BY(mu_) - the deadline timer, if any.
+  };
+
+  // The outcome for an `AsyncWaiter` that has been removed from the queue.
+  struct AsyncCompletion {
+    std::shared_ptr<AsyncWaiter> waiter;
+    StatusOr<SessionHolder> result;
+    future<void> timer;
+  };
+
+  // The idle sessions associated with a single `Channel`. Each shard has its
+  // own mutex so the common allocate/release paths do not serialize on `mu_`.
+  // Lock ordering: `mu_` may be held while acquiring `Shard::mu`, but never
+  // the other way around.
+  struct Shard {
+    explicit Shard(std::shared_ptr<Channel> c) : channel(std::move(c)) {}
+
+    std::shared_ptr<Channel> const channel;
+    std::mutex mu;
+    // Ordered from the least to the most recently used.
+    std::deque<std::unique_ptr<Session>> sessions;  // GUARDED_BY(mu)
+    // Mirrors `sessions.size()`, but can be read without holding `mu`.
+    std::atomic<int> idle_count{0};
+    // The number of `sessions` holding a prepared read-write transaction.
+    int prepared_count = 0;  // GUARDED_BY(mu)
+    // The number of keep-alive requests in flight on `channel`.
+    std::atomic<int> keep_alives_in_flight{0};
+  };
+
+  // The demand observed in one interval between background maintenance runs.
+  struct DemandSample {
+    Session::Clock::time_point start;
+    Session::Clock::time_point end;
+    std::int64_t allocations;
+    int peak_sessions_in_use;
+  };
+
   // Release session back to the pool.
   void Release(std::unique_ptr<Session> session);
 
+  // Add `session` to the idle sessions, and hand it to a waiter, if any.
+  void AddIdleSession(
+      std::unique_ptr<Session> session);  // LOCKS_EXCLUDED(mu_)
+
+  // Drop `session` (which is bad) from the pool, and replace it.
+  void DiscardSession(Session const& session);  // LOCKS_EXCLUDED(mu_)
+
+  // Whether the pool should prepare another read-write transaction, if so
+  // counts it in `preparing_sessions_`. Does not need `mu_`.
+  bool StartPreparing();
+
+  // Forget the prepared transactions that are too old to use, and prepare
+  // read-write transactions on idle sessions until the pool has enough.
+  void PrepareWriteSessions();  // LOCKS_EXCLUDED(mu_)
+
+  // Begin a read-write transaction on `session` (which is not idle while the
+  // call is in flight), then return it to the idle sessions. The caller must
+  // have counted it with `StartPreparing()`.
+  void PrepareReadWriteTransaction(
+      std::unique_ptr<Session> session);  // LOCKS_EXCLUDED(mu_)
+  void HandleBeginTransactionDone(
+      std::unique_ptr<Session> session,
+      StatusOr<google::spanner::v1::Transaction>
+          transaction);  // LOCKS_EXCLUDED(mu_)
+
+  // Start creating sessions (asynchronously) if the pool is below its target
+  // size, e.g. after dropping bad sessions, or for the queued
+  // `AsyncAllocate()` requests.
+  void GrowInBackground(
+      std::unique_lock<std::mutex>& lk);  // EXCLUSIVE_LOCKS_REQUIRED(mu_)
+
+  // Remove the idle session `session_name` (which the server no longer
+  // recognizes) from `shard`, and replace it.
+  void EvictIdleSession(
+      Shard& shard,
+      std::string const& session_name);  // LOCKS_EXCLUDED(mu_)
+
+  // Remove an idle session from one of the shards, preferring the shard whose
+  // channel has the fewest sessions in use. Returns `nullptr` if there are no
+  // suitable idle sessions. See `Allocate()` for the meaning of `read_write`;
+  // unless `use_prepared` is true, sessions with a prepared transaction are
+  // only returned if `read_write` is true.
+  std::unique_ptr<Session> TryPopIdleSession(
+      bool read_write = false,
+      bool use_prepared = false);  // LOCKS_EXCLUDED(Shard::mu)
+
+  // Like `TryPopIdleSession()` above, for callers holding `mu_`. If the pool
+  // is at its maximum size (so it cannot add a session) read-only callers may
+  // also use a session with a prepared transaction, rather than wait or fail.
+  std::unique_ptr<Session> TryPopIdleSessionLocked(
+      bool read_write);  // EXCLUSIVE_LOCKS_REQUIRED(mu_)
+
+  // The number of idle sessions that `TryPopIdleSession(read_write)` may use.
+  int UsableIdleSessions(bool read_write) const;
+
+  // Remove the next session (in the configured allocation order) from
+  // `shard`, if any, preferring one with a prepared transaction iff
+  // `read_write`.
+  std::unique_ptr<Session> TryPopIdleSession(
+      Shard& shard, bool read_write,
+      bool use_prepared);  // LOCKS_EXCLUDED(shard.mu)
+
+  // With `SessionAllocationStrategy::kThreadAffinity`, remove the session
+  // last released by the calling thread, if it is still idle.
+  std::unique_ptr<Session> TryPopAffinitySession(
+      bool read_write);  // LOCKS_EXCLUDED(Shard::mu)
+
+  // Remove the idle session at `it` from `shard`.
+  std::unique_ptr<Session> PopIdleSession(
+      Shard& shard, std::deque<std::unique_ptr<Session>>::iterator
+                        it);  // EXCLUSIVE_LOCKS_REQUIRED(shard.mu)
+
+  // Adjust the pool and channel counters for a `Session` that will not be
+  // returned to the pool.
+  void RemoveFromCounts(
+      Session const& session);  // EXCLUSIVE_LOCKS_REQUIRED(mu_)
+
+  // Return the `Shard` holding the idle sessions for `channel`, or its index
+  // in `shards_`.
+  Shard& ShardFor(std::shared_ptr<Channel> const& channel);
+  std::size_t ShardIndex(std::shared_ptr<Channel> const& channel) const;
+
+  // Return the index of the first shard the calling thread should try.
+  std::size_t ShardHint() const;
+
+  // Hand idle sessions to queued `AsyncAllocate()` requests, in FIFO order.
+  // The caller must pass the result to `CompleteAsyncWaiters()` after
+  // releasing `mu_`.
+  std::vector<AsyncCompletion>
+  ServeAsyncWaiters();  // EXCLUSIVE_LOCKS_REQUIRED(mu_)
+
+  // Fail all the queued `AsyncAllocate()` requests with `status`.
+  std::vector<AsyncCompletion> FailAsyncWaiters(
+      Status const& status);  // EXCLUSIVE_LOCKS_REQUIRED(mu_)
+
+  // Mark `waiter` as no longer queued, and capture its result.
+  static AsyncCompletion MakeAsyncCompletion(
+      std::shared_ptr<AsyncWaiter> waiter,
+      StatusOr<SessionHolder> result);  // EXCLUSIVE_LOCKS_REQUIRED(mu_)
+
+  // Satisfy the futures returned by `AsyncAllocate()`. The futures are
+  // satisfied on the `CompletionQueue`, so callbacks attached to them do not
+  // run in the thread releasing a session, unless the `CompletionQueue` has
+  // been shut down.
+  void CompleteAsyncWaiters(
+      std::vector<AsyncCompletion> completions);  // LOCKS_EXCLUDED(mu_)
+
+  // Remove `waiter` from the queue (if still there) and fail its request.
+  void ExpireAsyncWaiter(
+      std::shared_ptr<AsyncWaiter> const& waiter);  // LOCKS_EXCLUDED(mu_)
+
   // Called when a thread needs to wait for a `Session` to become available.
   // @p specifies the condition to wait for.
   template <typename Predicate>
@@ -120,6 +380,12 @@ class SessionPool : public std::enable_shared_from_this<SessionPool> {
     --num_waiting_for_session_;
   }
 
+  // Compute the `BatchCreateSessions` calls needed to create `min_sessions`,
+  // and count them as in progress.
+  std::vector<CreateCount> StartInitialization();  // LOCKS_EXCLUDED(mu_)
+  future<Status> CreateInitialSessions(
+      std::vector<CreateCount> const& create_counts);  // LOCKS_EXCLUDED(mu_)
+
   Status Grow(std::unique_lock<std::mutex>& lk, int sessions_to_create,
               WaitForSessionAllocation wait);  // EXCLUSIVE_LOCKS_REQUIRED(mu_)
   StatusOr<std::vector<CreateCount>> ComputeCreateCounts(
@@ -129,13 +395,32 @@ class SessionPool : public std::enable_shared_from_this<SessionPool> {
   Status CreateSessionsSync(std::shared_ptr<Channel> const& channel,
                             std::map<std::string, std::string> const& labels,
                             int num_sessions);  // LOCKS_EXCLUDED(mu_)
-  void CreateSessionsAsync(std::shared_ptr<Channel> const& channel,
-                           std::map<std::string, std::string> const& labels,
-                           int num_sessions);  // LOCKS_EXCLUDED(mu_)
+  future<Status> CreateSessionsAsync(
+      std::shared_ptr<Channel> const& channel,
+      std::map<std::string, std::string> const& labels,
+      int num_sessions);  // LOCKS_EXCLUDED(mu_)
 
   SessionHolder MakeSessionHolder(std::unique_ptr<Session> session,
                                   bool dissociate_from_pool);
 
+  // Return the time elapsed since `start`, for recording in the histograms.
+  std::chrono::microseconds ElapsedSince(Session::Clock::time_point start);
+
+  // Update the counters used to track the demand for sessions.
+  void RecordAllocation(bool dissociate_from_pool);
+
+  // With adaptive sizing, start creating sessions in the background once the
+  // last idle session has been allocated, so the next caller need not wait.
+  void PrewarmIfExhausted();  // LOCKS_EXCLUDED(mu_)
+
+  // Close the current `DemandSample` and recompute `demand_stats_`.
+  void UpdateDemandStats();  // EXCLUSIVE_LOCKS_REQUIRED(mu_)
+
+  // Remove up to `count` of the least recently used idle sessions from the
+  // pool, and delete them on the server.
+  void ShrinkPool(std::unique_lock<std::mutex>& lk,
+                  int count);  // EXCLUSIVE_LOCKS_REQUIRED(mu_)
+
   friend struct SessionPoolFriendForTest;  // To test Async*()
   // Asynchronous calls used to maintain the pool.
   future<StatusOr<google::spanner::v1::BatchCreateSessionsResponse>>
@@ -149,6 +434,16 @@ class SessionPool : public std::enable_shared_from_this<SessionPool> {
   future<StatusOr<google::spanner::v1::Session>> AsyncGetSession(
       CompletionQueue& cq, std::shared_ptr<SpannerStub> const& stub,
       std::string session_name);
+  future<StatusOr<google::spanner::v1::ResultSet>> AsyncSelectOne(
+      CompletionQueue& cq, std::shared_ptr<SpannerStub> const& stub,
+      std::string session_name);
+  future<StatusOr<google::spanner::v1::Transaction>> AsyncBeginTransaction(
+      CompletionQueue& cq, std::shared_ptr<SpannerStub> const& stub,
+      std::string session_name);
+
+  // Keep `session_name` alive, using the method chosen in the options.
+  future<Status> AsyncKeepAlive(std::shared_ptr<SpannerStub> const& stub,
+                                std::string session_name);
 
   Status HandleBatchCreateSessionsDone(
       std::shared_ptr<Channel> const& channel,
@@ -168,16 +463,50 @@ class SessionPool : public std::enable_shared_from_this<SessionPool> {
   std::unique_ptr<BackoffPolicy const> backoff_policy_prototype_;
   std::shared_ptr<Session::Clock> clock_;
   int const max_pool_size_;
-  std::mt19937 random_generator_;
 
   std::mutex mu_;
   std::condition_variable cond_;
-  std::vector<std::unique_ptr<Session>> sessions_;  // GUARDED_BY(mu_)
-  int total_sessions_ = 0;                          // GUARDED_BY(mu_)
-  int create_calls_in_progress_ = 0;                // GUARDED_BY(mu_)
-  int num_waiting_for_session_ = 0;                 // GUARDED_BY(mu_)
+  // Modified with `mu_` held, but read without it by `StartPreparing()`.
+  std::atomic<int> total_sessions_{0};
+  int create_calls_in_progress_ = 0;  // GUARDED_BY(mu_)
+
+  // These are modified with `mu_` held, but read without it on the fast path.
+  // Release() increments `idle_sessions_` before it reads
+  // `num_waiting_for_session_`, and Wait() increments
+  // `num_waiting_for_session_` before it reads `idle_sessions_`, so (with
+  // sequentially consistent atomics) at least one side always observes the
+  // other, and no wakeup is lost.
+  std::atomic<int> idle_sessions_{0};
+  std::atomic<int> num_waiting_for_session_{0};
+
+  // The queued `AsyncAllocate()` requests. `num_async_waiters_` mirrors
+  // `async_waiters_.size()` so `Release()` can check it without `mu_`, it
+  // uses the same protocol as `num_waiting_for_session_` (see above).
+  std::deque<std::shared_ptr<AsyncWaiter>> async_waiters_;  // GUARDED_BY(mu_)
+  std::atomic<int> num_async_waiters_{0};
 
-  // Lower bound on all `sessions_[i]->last_use_time()` values.
+  // The demand for sessions, see `UpdateDemandStats()`. The counters are
+  // updated without `mu_` on every allocation.
+  std::atomic<std::int64_t> allocations_{0};
+  std::atomic<int> sessions_in_use_{0};
+  std::atomic<int> peak_sessions_in_use_{0};
+  std::deque<DemandSample> demand_samples_;  // GUARDED_BY(mu_)
+  Session::Clock::time_point demand_sample_start_ =
+      clock_->Now();                      // GUARDED_BY(mu_)
+  SessionPoolDemandStats demand_stats_;  // GUARDED_BY(mu_)
+
+  // The idle sessions holding a prepared read-write transaction (updated with
+  // the shard mutex held), and the `BeginTransaction` calls in flight. Neither
+  // needs `mu_`, so releasing a session does not contend on it.
+  std::atomic<int> prepared_sessions_{0};
+  std::atomic<int> preparing_sessions_{0};
+
+  // See `SessionPoolMetrics`.
+  std::atomic<std::int64_t> exhaustion_events_{0};
+  LatencyHistogram allocation_wait_;
+  LatencyHistogram creation_latency_;
+
+  // Lower bound on the `last_use_time()` of all idle sessions.
   Session::Clock::time_point last_use_time_lower_bound_ =
       clock_->Now();  // GUARDED_BY(mu_)
 
@@ -189,6 +518,10 @@ class SessionPool : public std::enable_shared_from_this<SessionPool> {
   using ChannelVec = std::vector<std::shared_ptr<Channel>>;
   ChannelVec channels_;                                 // GUARDED_BY(mu_)
   ChannelVec::iterator next_dissociated_stub_channel_;  // GUARDED_BY(mu_)
+
+  // `shards_[i]` holds the idle sessions for `channels_[i]`. Like `channels_`
+  // it is not resized after the constructor runs.
+  std::vector<std::unique_ptr<Shard>> shards_;
 };
 
 /**
@@ -0,0 +1,368 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/latency_histogram.h"
+#include "google/cloud/spanner/internal/session_pool.h"
+#include "google/cloud/spanner/internal/spanner_stub.h"
+#include "google/cloud/internal/background_threads_impl.h"
+#include "google/cloud/internal/make_unique.h"
+#include <benchmark/benchmark.h>
+#include <grpcpp/alarm.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+namespace spanner_proto = ::google::spanner::v1;
+
+/**
+ * An asynchronous `BatchCreateSessions()` call with a canned response.
+ *
+ * The call completes on the `grpc::CompletionQueue` after `latency`, using an
+ * alarm, so no thread is blocked while the call is "in flight".
+ */
+class FakeBatchCreateSessionsReader
+    : public grpc::ClientAsyncResponseReaderInterface<
+          spanner_proto::BatchCreateSessionsResponse> {
+ public:
+  FakeBatchCreateSessionsReader(
+      grpc::CompletionQueue* cq,
+      spanner_proto::BatchCreateSessionsResponse response,
+      std::chrono::microseconds latency)
+      : cq_(cq), response_(std::move(response)), latency_(latency) {}
+
+  void StartCall() override {}
+  void ReadInitialMetadata(void*) override {}
+  void Finish(spanner_proto::BatchCreateSessionsResponse* response,
+              grpc::Status* status, void* tag) override {
+    *response = std::move(response_);
+    *status = grpc::Status::OK;
+    alarm_.Set(cq_, std::chrono::system_clock::now() + latency_, tag);
+  }
+
+ private:
+  grpc::CompletionQueue* cq_;
+  spanner_proto::BatchCreateSessionsResponse response_;
+  std::chrono::microseconds latency_;
+  grpc::Alarm alarm_;
+};
+
+/**
+ * A `SpannerStub` that creates sessions without making any RPCs.
+ *
+ * `BatchCreateSessions()` (and its asynchronous version) takes `latency` to
+ * simulate the round-trip to the service. All other operations fail, the
+ * benchmarks in this file only exercise the session pool.
+ */
+class FakeSpannerStub : public SpannerStub {
+ public:
+  explicit FakeSpannerStub(
+      std::chrono::microseconds latency = std::chrono::microseconds(0))
+      : latency_(latency) {}
+
+  StatusOr<spanner_proto::Session> CreateSession(
+      grpc::ClientContext&,
+      spanner_proto::CreateSessionRequest const&) override {
+    return Unimplemented();
+  }
+  StatusOr<spanner_proto::BatchCreateSessionsResponse> BatchCreateSessions(
+      grpc::ClientContext&,
+      spanner_proto::BatchCreateSessionsRequest const& request) override {
+    if (latency_.count() != 0) std::this_thread::sleep_for(latency_);
+    return MakeResponse(request);
+  }
+  std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+      spanner_proto::BatchCreateSessionsResponse>>
+  AsyncBatchCreateSessions(
+      grpc::ClientContext&,
+      spanner_proto::BatchCreateSessionsRequest const& request,
+      grpc::CompletionQueue* cq) override {
+    return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+        spanner_proto::BatchCreateSessionsResponse>>(
+        new FakeBatchCreateSessionsReader(cq, MakeResponse(request), latency_));
+  }
+  StatusOr<spanner_proto::Session> GetSession(
+      grpc::ClientContext&, spanner_proto::GetSessionRequest const&) override {
+    return Unimplemented();
+  }
+  std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<spanner_proto::Session>>
+  AsyncGetSession(grpc::ClientContext&, spanner_proto::GetSessionRequest const&,
+                  grpc::CompletionQueue*) override {
+    return nullptr;
+  }
+  StatusOr<spanner_proto::ListSessionsResponse> ListSessions(
+      grpc::ClientContext&,
+      spanner_proto::ListSessionsRequest const&) override {
+    return Unimplemented();
+  }
+  Status DeleteSession(grpc::ClientContext&,
+                       spanner_proto::DeleteSessionRequest const&) override {
+    return Unimplemented();
+  }
+  std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<google::protobuf::Empty>>
+  AsyncDeleteSession(grpc::ClientContext&,
+                     spanner_proto::DeleteSessionRequest const&,
+                     grpc::CompletionQueue*) override {
+    return nullptr;
+  }
+  StatusOr<spanner_proto::ResultSet> ExecuteSql(
+      grpc::ClientContext&, spanner_proto::ExecuteSqlRequest const&) override {
+    return Unimplemented();
+  }
+  std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<spanner_proto::ResultSet>>
+  AsyncExecuteSql(grpc::ClientContext&, spanner_proto::ExecuteSqlRequest const&,
+                  grpc::CompletionQueue*) override {
+    return nullptr;
+  }
+  std::unique_ptr<grpc::ClientReaderInterface<spanner_proto::PartialResultSet>>
+  ExecuteStreamingSql(grpc::ClientContext&,
+                      spanner_proto::ExecuteSqlRequest const&) override {
+    return nullptr;
+  }
+  std::unique_ptr<
+      grpc::ClientAsyncReaderInterface<spanner_proto::PartialResultSet>>
+  PrepareAsyncExecuteStreamingSql(grpc::ClientContext&,
+                                  spanner_proto::ExecuteSqlRequest const&,
+                                  grpc::CompletionQueue*) override {
+    return nullptr;
+  }
+  StatusOr<spanner_proto::ExecuteBatchDmlResponse> ExecuteBatchDml(
+      grpc::ClientContext&,
+      spanner_proto::ExecuteBatchDmlRequest const&) override {
+    return Unimplemented();
+  }
+  std::unique_ptr<grpc::ClientReaderInterface<spanner_proto::PartialResultSet>>
+  StreamingRead(grpc::ClientContext&,
+                spanner_proto::ReadRequest const&) override {
+    return nullptr;
+  }
+  std::unique_ptr<
+      grpc::ClientAsyncReaderInterface<spanner_proto::PartialResultSet>>
+  PrepareAsyncStreamingRead(grpc::ClientContext&,
+                            spanner_proto::ReadRequest const&,
+                            grpc::CompletionQueue*) override {
+    return nullptr;
+  }
+  StatusOr<spanner_proto::Transaction> BeginTransaction(
+      grpc::ClientContext&,
+      spanner_proto::BeginTransactionRequest const&) override {
+    return Unimplemented();
+  }
+  std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<spanner_proto::Transaction>>
+  AsyncBeginTransaction(grpc::ClientContext&,
+                        spanner_proto::BeginTransactionRequest const&,
+                        grpc::CompletionQueue*) override {
+    return nullptr;
+  }
+  StatusOr<spanner_proto::CommitResponse> Commit(
+      grpc::ClientContext&, spanner_proto::CommitRequest const&) override {
+    return Unimplemented();
+  }
+  std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<spanner_proto::CommitResponse>>
+  AsyncCommit(grpc::ClientContext&, spanner_proto::CommitRequest const&,
+              grpc::CompletionQueue*) override {
+    return nullptr;
+  }
+  Status Rollback(grpc::ClientContext&,
+                  spanner_proto::RollbackRequest const&) override {
+    return Unimplemented();
+  }
+  std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<google::protobuf::Empty>>
+  AsyncRollback(grpc::ClientContext&, spanner_proto::RollbackRequest const&,
+                grpc::CompletionQueue*) override {
+    return nullptr;
+  }
+  StatusOr<spanner_proto::PartitionResponse> PartitionQuery(
+      grpc::ClientContext&,
+      spanner_proto::PartitionQueryRequest const&) override {
+    return Unimplemented();
+  }
+  StatusOr<spanner_proto::PartitionResponse> PartitionRead(
+      grpc::ClientContext&,
+      spanner_proto::PartitionReadRequest const&) override {
+    return Unimplemented();
+  }
+
+ private:
+  spanner_proto::BatchCreateSessionsResponse MakeResponse(
+      spanner_proto::BatchCreateSessionsRequest const& request) {
+    spanner_proto::BatchCreateSessionsResponse response;
+    for (int i = 0; i != request.session_count(); ++i) {
+      response.add_session()->set_name("session-" +
+                                       std::to_string(++session_id_));
+    }
+    return response;
+  }
+
+  static Status Unimplemented() {
+    return Status(StatusCode::kUnimplemented, "not implemented");
+  }
+
+  std::chrono::microseconds latency_;
+  std::atomic<int> session_id_{0};
+};
+
+std::shared_ptr<SessionPool> MakeBenchmarkPool(
+    int num_channels, SessionPoolOptions options, CompletionQueue cq,
+    std::chrono::microseconds latency = std::chrono::microseconds(0)) {
+  std::vector<std::shared_ptr<SpannerStub>> stubs;
+  for (int i = 0; i != num_channels; ++i) {
+    stubs.push_back(std::make_shared<FakeSpannerStub>(latency));
+  }
+  return MakeSessionPool(
+      Database("project", "instance", "database"), std::move(stubs),
+      std::move(options), std::move(cq),
+      google::cloud::internal::make_unique<LimitedTimeRetryPolicy>(
+          std::chrono::minutes(10)),
+      google::cloud::internal::make_unique<ExponentialBackoffPolicy>(
+          std::chrono::milliseconds(100), std::chrono::minutes(1), 2.0));
+}
+
+// Shared by all the threads in a benchmark; created and destroyed by thread 0.
+// The benchmark framework synchronizes all the threads at the start and end of
+// the timing loop, so the other threads never observe a null pointer.
+std::unique_ptr<google::cloud::internal::AutomaticallyCreatedBackgroundThreads>
+    background_threads;
+std::shared_ptr<SessionPool> pool;
+
+// Measures the cost of allocating an idle session and immediately releasing it
+// back to the pool, with many threads contending for the same pool.
+void BM_SessionPoolAllocateRelease(benchmark::State& state) {
+  int const num_channels = 4;
+  if (state.thread_index == 0) {
+    background_threads = google::cloud::internal::make_unique<
+        google::cloud::internal::AutomaticallyCreatedBackgroundThreads>();
+    // Start with enough sessions for every thread, so the benchmark measures
+    // the allocate/release paths and not session creation.
+    pool = MakeBenchmarkPool(
+        num_channels, SessionPoolOptions{}.set_min_sessions(state.threads),
+        background_threads->cq());
+  }
+  for (auto _ : state) {
+    auto session = pool->Allocate();
+    benchmark::DoNotOptimize(session);
+  }
+  if (state.thread_index == 0) {
+    pool.reset();
+    background_threads.reset();
+  }
+}
+BENCHMARK(BM_SessionPoolAllocateRelease)->ThreadRange(1, 64)->UseRealTime();
+
+std::unique_ptr<LatencyHistogram> allocation_latency;
+
+// Compares the allocation strategies (the argument is a
+// `SessionAllocationStrategy`). The pool holds more sessions than there are
+// threads, so the strategies visit different sessions. Each thread holds its
+// session for a short time, to simulate an operation. Reports the throughput,
+// and the median and tail latency of `Allocate()` (with the power-of-two
+// microsecond resolution of `LatencyHistogram`).
+void BM_SessionPoolAllocationStrategy(benchmark::State& state) {
+  int const num_channels = 4;
+  auto const strategy = static_cast<SessionAllocationStrategy>(state.range(0));
+  if (state.thread_index == 0) {
+    background_threads = google::cloud::internal::make_unique<
+        google::cloud::internal::AutomaticallyCreatedBackgroundThreads>();
+    allocation_latency =
+        google::cloud::internal::make_unique<LatencyHistogram>();
+    pool = MakeBenchmarkPool(num_channels,
+                             SessionPoolOptions{}
+                                 .set_min_sessions(4 * state.threads)
+                                 .set_allocation_strategy(strategy),
+                             background_threads->cq());
+  }
+  for (auto _ : state) {
+    auto const start = std::chrono::steady_clock::now();
+    auto session = pool->Allocate();
+    allocation_latency->Record(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start));
+    for (int i = 0; i != 100; ++i) benchmark::DoNotOptimize(session);
+  }
+  if (state.thread_index == 0) {
+    auto const latency = allocation_latency->Snapshot();
+    state.counters["p50_us"] =
+        static_cast<double>(latency.Percentile(0.5).count());
+    state.counters["p99_us"] =
+        static_cast<double>(latency.Percentile(0.99).count());
+    state.counters["p999_us"] =
+        static_cast<double>(latency.Percentile(0.999).count());
+    pool.reset();
+    background_threads.reset();
+    allocation_latency.reset();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+void AllocationStrategyArguments(benchmark::internal::Benchmark* b) {
+  for (auto strategy :
+       {SessionAllocationStrategy::kLifo, SessionAllocationStrategy::kFifo,
+        SessionAllocationStrategy::kThreadAffinity}) {
+    b->Arg(static_cast<int>(strategy));
+  }
+}
+BENCHMARK(BM_SessionPoolAllocationStrategy)
+    ->Apply(AllocationStrategyArguments)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+
+// Measures the time to create a pool with `min_sessions` (the second argument)
+// spread over `num_channels` (the first argument), when each
+// BatchCreateSessions call takes 10ms. The calls are made concurrently, so the
+// startup time should stay close to a single call as the pool grows.
+void BM_SessionPoolStartup(benchmark::State& state) {
+  auto const num_channels = static_cast<int>(state.range(0));
+  auto const min_sessions = static_cast<int>(state.range(1));
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto const options = SessionPoolOptions{}
+                           .set_min_sessions(min_sessions)
+                           .set_max_sessions_per_channel(min_sessions);
+  for (auto _ : state) {
+    auto p = MakeBenchmarkPool(num_channels, options, threads.cq(),
+                               std::chrono::milliseconds(10));
+    benchmark::DoNotOptimize(p);
+  }
+}
+void StartupArguments(benchmark::internal::Benchmark* b) {
+  for (int num_channels : {1, 4, 16}) {
+    for (int min_sessions : {100, 400, 1600}) {
+      b->Args({num_channels, min_sessions});
+    }
+  }
+}
+BENCHMARK(BM_SessionPoolStartup)
+    ->Apply(StartupArguments)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -24,8 +24,12 @@
 #include "google/cloud/testing_util/mock_async_response_reader.h"
 #include "google/cloud/testing_util/mock_completion_queue.h"
 #include <gmock/gmock.h>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
@@ -42,6 +46,7 @@ using ::google::cloud::testing_util::MockAsyncResponseReader;
 using ::google::cloud::testing_util::MockCompletionQueue;
 using ::testing::_;
 using ::testing::ByMove;
+using ::testing::ElementsAre;
 using ::testing::HasSubstr;
 using ::testing::Invoke;
 using ::testing::Return;
@@ -85,6 +90,51 @@ std::shared_ptr<SessionPool> MakeSessionPool(
       std::move(clock));
 }
 
+using BatchCreateSessionsReader =
+    MockAsyncResponseReader<spanner_proto::BatchCreateSessionsResponse>;
+
+// Sets up @p mock to return @p sessions from one `AsyncBatchCreateSessions()`
+// call. The returned reader must outlive the call.
+std::unique_ptr<BatchCreateSessionsReader> ExpectAsyncCreate(
+    spanner_testing::MockSpannerStub& mock, std::vector<std::string> sessions) {
+  auto reader =
+      google::cloud::internal::make_unique<BatchCreateSessionsReader>();
+  auto* r = reader.get();
+  EXPECT_CALL(mock, AsyncBatchCreateSessions(_, _, _))
+      .WillOnce(Invoke([r](grpc::ClientContext&,
+                           spanner_proto::BatchCreateSessionsRequest const&,
+                           grpc::CompletionQueue*) {
+        // This is safe. See comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            spanner_proto::BatchCreateSessionsResponse>>(r);
+      }));
+  EXPECT_CALL(*r, Finish(_, _, _))
+      .WillOnce(Invoke(
+          [sessions](spanner_proto::BatchCreateSessionsResponse* response,
+                     grpc::Status* status, void*) {
+            *response = MakeSessionsResponse(sessions);
+            *status = grpc::Status::OK;
+          }));
+  return reader;
+}
+
+// Creates a pool whose initial sessions need several (asynchronous) calls,
+// completing them on @p impl until `MakeSessionPool()` returns.
+std::shared_ptr<SessionPool> MakeSessionPoolCompleting(
+    Database const& db, std::vector<std::shared_ptr<SpannerStub>> stubs,
+    SessionPoolOptions const& options,
+    std::shared_ptr<MockCompletionQueue> const& impl) {
+  auto pool = std::async(std::launch::async, [&] {
+    return MakeSessionPool(db, std::move(stubs), options,
+                           CompletionQueue(impl));
+  });
+  while (pool.wait_for(std::chrono::milliseconds(1)) ==
+         std::future_status::timeout) {
+    impl->SimulateCompletion(true);
+  }
+  return pool.get();
+}
+
 TEST(SessionPool, Allocate) {
   auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
   auto db = Database("project", "instance", "database");
@@ -206,6 +256,153 @@ TEST(SessionPool, Lifo) {
   EXPECT_EQ((*session4)->session_name(), "session1");
 }
 
+TEST(SessionPool, Fifo) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto db = Database("project", "instance", "database");
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1", "s2", "s3"}))));
+
+  SessionPoolOptions options;
+  options.set_min_sessions(3).set_allocation_strategy(
+      SessionAllocationStrategy::kFifo);
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto pool = MakeSessionPool(db, {mock}, options, threads.cq());
+
+  // The least recently used session is allocated first, so released sessions
+  // go to the back of the queue.
+  auto session = pool->Allocate();
+  ASSERT_STATUS_OK(session);
+  EXPECT_EQ((*session)->session_name(), "s1");
+  session->reset();
+
+  std::vector<std::string> session_names;
+  std::vector<SessionHolder> sessions;
+  for (int i = 0; i != 3; ++i) {
+    auto s = pool->Allocate();
+    ASSERT_STATUS_OK(s);
+    session_names.push_back((*s)->session_name());
+    sessions.push_back(*std::move(s));
+  }
+  EXPECT_THAT(session_names, ElementsAre("s2", "s3", "s1"));
+}
+
+TEST(SessionPool, ThreadAffinity) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto db = Database("project", "instance", "database");
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1", "s2", "s3"}))));
+
+  SessionPoolOptions options;
+  options.set_min_sessions(3).set_allocation_strategy(
+      SessionAllocationStrategy::kThreadAffinity);
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto pool = MakeSessionPool(db, {mock}, options, threads.cq());
+
+  // Without a previous session the allocation is LIFO.
+  auto mine = pool->Allocate();
+  ASSERT_STATUS_OK(mine);
+  EXPECT_EQ((*mine)->session_name(), "s3");
+  auto theirs = pool->Allocate();
+  ASSERT_STATUS_OK(theirs);
+  EXPECT_EQ((*theirs)->session_name(), "s2");
+
+  // Release "s3" in this thread, then "s2" in another one, which makes "s2"
+  // the most recently used session.
+  mine->reset();
+  std::thread([&theirs] { theirs->reset(); }).join();
+
+  // This thread gets back the session it released, instead of the most
+  // recently used one.
+  auto session = pool->Allocate();
+  ASSERT_STATUS_OK(session);
+  EXPECT_EQ((*session)->session_name(), "s3");
+
+  // Once that session is in use, allocation falls back to LIFO.
+  auto session2 = pool->Allocate();
+  ASSERT_STATUS_OK(session2);
+  EXPECT_EQ((*session2)->session_name(), "s2");
+}
+
+TEST(SessionPool, LifoPerChannel) {
+  auto mock1 = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto mock2 = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto db = Database("project", "instance", "database");
+  auto r1 = ExpectAsyncCreate(*mock1, {"c1s1", "c1s2"});
+  auto r2 = ExpectAsyncCreate(*mock2, {"c2s1", "c2s2"});
+
+  SessionPoolOptions options;
+  options.set_min_sessions(4);
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto pool = MakeSessionPoolCompleting(db, {mock1, mock2}, options, impl);
+
+  // Drain the pool, then release the sessions in a known order.
+  std::vector<SessionHolder> sessions;
+  for (int i = 0; i != 4; ++i) {
+    auto session = pool->Allocate();
+    ASSERT_STATUS_OK(session);
+    sessions.push_back(*std::move(session));
+  }
+  std::sort(sessions.begin(), sessions.end(),
+            [](SessionHolder const& a, SessionHolder const& b) {
+              return a->session_name() < b->session_name();
+            });
+  for (auto& s : sessions) s.reset();
+
+  // Each channel's sessions come back in LIFO order, regardless of which
+  // channel is visited first.
+  std::vector<std::string> names;
+  for (int i = 0; i != 4; ++i) {
+    auto session = pool->Allocate();
+    ASSERT_STATUS_OK(session);
+    names.push_back((*session)->session_name());
+    sessions[i] = *std::move(session);
+  }
+  auto pos = [&names](std::string const& name) {
+    return std::find(names.begin(), names.end(), name) - names.begin();
+  };
+  EXPECT_LT(pos("c1s2"), pos("c1s1"));
+  EXPECT_LT(pos("c2s2"), pos("c2s1"));
+}
+
+TEST(SessionPool, ConcurrentAllocateRelease) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto db = Database("project", "instance", "database");
+  std::atomic<int> session_id{0};
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillRepeatedly(
+          [&session_id](grpc::ClientContext&,
+                        spanner_proto::BatchCreateSessionsRequest const& r) {
+            std::vector<std::string> names;
+            for (int i = 0; i != r.session_count(); ++i) {
+              names.push_back("s" + std::to_string(++session_id));
+            }
+            return MakeSessionsResponse(std::move(names));
+          });
+
+  int const max_sessions_per_channel = 4;
+  SessionPoolOptions options;
+  options.set_max_sessions_per_channel(max_sessions_per_channel)
+      .set_action_on_exhaustion(ActionOnExhaustion::kBlock);
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto pool = MakeSessionPool(db, {mock, mock}, options, threads.cq());
+
+  // Many more threads than sessions, so some threads must wait for others to
+  // release their sessions.
+  auto const thread_count = 16;
+  auto const iterations = 500;
+  std::vector<std::thread> workers;
+  for (int t = 0; t != thread_count; ++t) {
+    workers.emplace_back([&pool] {
+      for (int i = 0; i != iterations; ++i) {
+        auto session = pool->Allocate();
+        ASSERT_STATUS_OK(session);
+      }
+    });
+  }
+  for (auto& t : workers) t.join();
+  EXPECT_LE(session_id.load(), 2 * max_sessions_per_channel);
+}
+
 TEST(SessionPool, MinSessionsEagerAllocation) {
   int const min_sessions = 3;
   auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
@@ -303,6 +500,169 @@ TEST(SessionPool, MaxSessionsBlockUntilRelease) {
   t.join();
 }
 
+TEST(SessionPool, AsyncAllocate) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto db = Database("project", "instance", "database");
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1"}))));
+
+  SessionPoolOptions options;
+  options.set_min_sessions(1);
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto pool = MakeSessionPool(db, {mock}, options, threads.cq());
+  auto session = pool->AsyncAllocate().get();
+  ASSERT_STATUS_OK(session);
+  EXPECT_EQ((*session)->session_name(), "s1");
+}
+
+TEST(SessionPool, AsyncAllocateFifoUntilRelease) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto db = Database("project", "instance", "database");
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1"}))));
+
+  SessionPoolOptions options;
+  options.set_max_sessions_per_channel(1).set_action_on_exhaustion(
+      ActionOnExhaustion::kBlock);
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto pool = MakeSessionPool(db, {mock}, options, threads.cq());
+  auto session = pool->Allocate();
+  ASSERT_STATUS_OK(session);
+
+  // The pool is exhausted, so both requests are queued.
+  auto f1 = pool->AsyncAllocate();
+  auto f2 = pool->AsyncAllocate();
+  EXPECT_EQ(std::future_status::timeout,
+            f1.wait_for(std::chrono::milliseconds(0)));
+  EXPECT_EQ(std::future_status::timeout,
+            f2.wait_for(std::chrono::milliseconds(0)));
+
+  // Releasing the session satisfies the oldest request first.
+  session->reset();
+  auto s1 = f1.get();
+  ASSERT_STATUS_OK(s1);
+  EXPECT_EQ((*s1)->session_name(), "s1");
+  EXPECT_EQ(std::future_status::timeout,
+            f2.wait_for(std::chrono::milliseconds(0)));
+
+  s1->reset();
+  auto s2 = f2.get();
+  ASSERT_STATUS_OK(s2);
+  EXPECT_EQ((*s2)->session_name(), "s1");
+}
+
+TEST(SessionPool, AsyncAllocateFailOnExhaustion) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto db = Database("project", "instance", "database");
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1"}))));
+
+  SessionPoolOptions options;
+  options.set_max_sessions_per_channel(1).set_action_on_exhaustion(
+      ActionOnExhaustion::kFail);
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto pool = MakeSessionPool(db, {mock}, options, threads.cq());
+  auto session = pool->Allocate();
+  ASSERT_STATUS_OK(session);
+  auto s2 = pool->AsyncAllocate().get();
+  EXPECT_EQ(s2.status().code(), StatusCode::kResourceExhausted);
+}
+
+TEST(SessionPool, AsyncAllocateDeadline) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto db = Database("project", "instance", "database");
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1"}))));
+
+  SessionPoolOptions options;
+  options.set_max_sessions_per_channel(1).set_action_on_exhaustion(
+      ActionOnExhaustion::kBlock);
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto pool = MakeSessionPool(db, {mock}, options, threads.cq());
+  auto session = pool->Allocate();
+  ASSERT_STATUS_OK(session);
+
+  auto s2 = pool->AsyncAllocate(std::chrono::system_clock::now() +
+                                std::chrono::milliseconds(10))
+                .get();
+  EXPECT_EQ(s2.status().code(), StatusCode::kDeadlineExceeded);
+
+  // The expired request no longer holds a place in the queue.
+  session->reset();
+  auto s3 = pool->AsyncAllocate().get();
+  ASSERT_STATUS_OK(s3);
+  EXPECT_EQ((*s3)->session_name(), "s1");
+}
+
+TEST(SessionPool, AsyncAllocateAfterShutdown) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto db = Database("project", "instance", "database");
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1"}))));
+
+  SessionPoolOptions options;
+  options.set_max_sessions_per_channel(1).set_action_on_exhaustion(
+      ActionOnExhaustion::kBlock);
+  CompletionQueue cq;
+  std::thread t([&cq] { cq.Run(); });
+  auto pool = MakeSessionPool(db, {mock}, options, cq);
+  auto session = pool->Allocate();
+  ASSERT_STATUS_OK(session);
+  auto f = pool->AsyncAllocate();
+
+  cq.CancelAll();
+  cq.Shutdown();
+  t.join();
+
+  // The `CompletionQueue` cannot run any callbacks, so the request is
+  // satisfied in this thread.
+  session->reset();
+  ASSERT_EQ(std::future_status::ready,
+            f.wait_for(std::chrono::milliseconds(0)));
+  auto s2 = f.get();
+  ASSERT_STATUS_OK(s2);
+  EXPECT_EQ((*s2)->session_name(), "s1");
+}
+
+TEST(SessionPool, AsyncAllocateGrowsPool) {
+  auto mock = std::make_shared<StrictMock<spanner_testing::MockSpannerStub>>();
+  auto reader = google::cloud::internal::make_unique<StrictMock<
+      MockAsyncResponseReader<spanner_proto::BatchCreateSessionsResponse>>>();
+  EXPECT_CALL(*mock, AsyncBatchCreateSessions(_, _, _))
+      .WillOnce(Invoke(
+          [&reader](grpc::ClientContext&,
+                    spanner_proto::BatchCreateSessionsRequest const& request,
+                    grpc::CompletionQueue*) {
+            EXPECT_EQ(1, request.session_count());
+            // This is safe. See comments in MockAsyncResponseReader.
+            return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+                spanner_proto::BatchCreateSessionsResponse>>(reader.get());
+          }));
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce(Invoke([](spanner_proto::BatchCreateSessionsResponse* response,
+                          grpc::Status* status, void*) {
+        response->add_session()->set_name("s1");
+        *status = grpc::Status::OK;
+      }));
+
+  auto db = Database("project", "instance", "database");
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto pool = MakeSessionPool(db, {mock}, {}, CompletionQueue(impl));
+
+  // The pool is empty, so this starts an asynchronous BatchCreateSessions().
+  auto f = pool->AsyncAllocate();
+  EXPECT_EQ(std::future_status::timeout,
+            f.wait_for(std::chrono::milliseconds(0)));
+
+  // Complete the BatchCreateSessions() call, and then the callback that
+  // satisfies the future.
+  impl->SimulateCompletion(true);
+  impl->SimulateCompletion(true);
+  auto session = f.get();
+  ASSERT_STATUS_OK(session);
+  EXPECT_EQ((*session)->session_name(), "s1");
+}
+
 TEST(SessionPool, Labels) {
   auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
   auto db = Database("project", "instance", "database");
@@ -347,17 +707,56 @@ TEST(SessionPool, MultipleChannels) {
                                                   "c2s1", "c2s2", "c2s3"));
 }
 
+TEST(SessionPool, BalanceSessionsInUseAcrossChannels) {
+  auto mock1 = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto mock2 = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto db = Database("project", "instance", "database");
+  auto r1 = ExpectAsyncCreate(*mock1, {"c1s1", "c1s2"});
+  auto r2 = ExpectAsyncCreate(*mock2, {"c2s1", "c2s2"});
+
+  SessionPoolOptions options;
+  options.set_min_sessions(4);
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto pool = MakeSessionPoolCompleting(db, {mock1, mock2}, options, impl);
+  EXPECT_THAT(pool->SessionsInUsePerChannel(), ElementsAre(0, 0));
+
+  // Whichever channel the first session comes from, the second one must come
+  // from the other (less loaded) channel.
+  auto s1 = pool->Allocate();
+  ASSERT_STATUS_OK(s1);
+  auto s2 = pool->Allocate();
+  ASSERT_STATUS_OK(s2);
+  EXPECT_NE(pool->GetStub(**s1), pool->GetStub(**s2));
+  EXPECT_THAT(pool->SessionsInUsePerChannel(), ElementsAre(1, 1));
+
+  auto s3 = pool->Allocate();
+  ASSERT_STATUS_OK(s3);
+  auto s4 = pool->Allocate();
+  ASSERT_STATUS_OK(s4);
+  EXPECT_THAT(pool->SessionsInUsePerChannel(), ElementsAre(2, 2));
+
+  // Releasing sessions updates the counters.
+  auto const s1_stub = pool->GetStub(**s1);
+  s1->reset();
+  if (s1_stub == mock1) {
+    EXPECT_THAT(pool->SessionsInUsePerChannel(), ElementsAre(1, 2));
+  } else {
+    EXPECT_THAT(pool->SessionsInUsePerChannel(), ElementsAre(2, 1));
+  }
+  s2->reset();
+  s3->reset();
+  s4->reset();
+  EXPECT_THAT(pool->SessionsInUsePerChannel(), ElementsAre(0, 0));
+}
+
 TEST(SessionPool, MultipleChannelsPreAllocation) {
   auto mock1 = std::make_shared<spanner_testing::MockSpannerStub>();
   auto mock2 = std::make_shared<spanner_testing::MockSpannerStub>();
   auto mock3 = std::make_shared<spanner_testing::MockSpannerStub>();
   auto db = Database("project", "instance", "database");
-  EXPECT_CALL(*mock1, BatchCreateSessions(_, _))
-      .WillOnce(Return(ByMove(MakeSessionsResponse({"c1s1", "c1s2", "c1s3"}))));
-  EXPECT_CALL(*mock2, BatchCreateSessions(_, _))
-      .WillOnce(Return(ByMove(MakeSessionsResponse({"c2s1", "c2s2", "c2s3"}))));
-  EXPECT_CALL(*mock3, BatchCreateSessions(_, _))
-      .WillOnce(Return(ByMove(MakeSessionsResponse({"c3s1", "c3s2", "c3s3"}))));
+  auto r1 = ExpectAsyncCreate(*mock1, {"c1s1", "c1s2", "c1s3"});
+  auto r2 = ExpectAsyncCreate(*mock2, {"c2s1", "c2s2", "c2s3"});
+  auto r3 = ExpectAsyncCreate(*mock3, {"c3s1", "c3s2", "c3s3"});
 
   SessionPoolOptions options;
   // note that min_sessions will effectively be reduced to 9
@@ -365,8 +764,9 @@ TEST(SessionPool, MultipleChannelsPreAllocation) {
   options.set_min_sessions(20)
       .set_max_sessions_per_channel(3)
       .set_action_on_exhaustion(ActionOnExhaustion::kFail);
-  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
-  auto pool = MakeSessionPool(db, {mock1, mock2, mock3}, options, threads.cq());
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto pool =
+      MakeSessionPoolCompleting(db, {mock1, mock2, mock3}, options, impl);
   std::vector<SessionHolder> sessions;
   std::vector<std::string> session_names;
   for (int i = 1; i <= 9; ++i) {
@@ -453,6 +853,813 @@ TEST(SessionPool, SessionRefresh) {
   impl->SimulateCompletion(true);
 }
 
+TEST(SessionPool, MaintainPoolSizeRestoresMinSessions) {
+  auto mock = std::make_shared<StrictMock<spanner_testing::MockSpannerStub>>();
+  // The initial (synchronous) attempt to create `min_sessions` fails.
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(Status(StatusCode::kPermissionDenied, "uh-oh"))));
+
+  auto reader = google::cloud::internal::make_unique<StrictMock<
+      MockAsyncResponseReader<spanner_proto::BatchCreateSessionsResponse>>>();
+  EXPECT_CALL(*mock, AsyncBatchCreateSessions(_, _, _))
+      .WillOnce(Invoke(
+          [&reader](grpc::ClientContext&,
+                    spanner_proto::BatchCreateSessionsRequest const& request,
+                    grpc::CompletionQueue*) {
+            EXPECT_EQ(2, request.session_count());
+            // This is safe. See comments in MockAsyncResponseReader.
+            return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+                spanner_proto::BatchCreateSessionsResponse>>(reader.get());
+          }));
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce(Invoke([](spanner_proto::BatchCreateSessionsResponse* response,
+                          grpc::Status* status, void*) {
+        response->add_session()->set_name("s1");
+        response->add_session()->set_name("s2");
+        *status = grpc::Status::OK;
+      }));
+
+  auto db = Database("project", "instance", "database");
+  SessionPoolOptions options;
+  options.set_min_sessions(2);
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto pool = MakeSessionPool(db, {mock}, options, CompletionQueue(impl));
+
+  // Run the background maintenance, which starts creating the missing
+  // sessions, then complete that call.
+  impl->SimulateCompletion(true);
+  impl->SimulateCompletion(true);
+
+  // Both sessions are now in the pool, so no further calls are made.
+  auto s1 = pool->Allocate();
+  ASSERT_STATUS_OK(s1);
+  auto s2 = pool->Allocate();
+  ASSERT_STATUS_OK(s2);
+  EXPECT_THAT(std::vector<std::string>({(*s1)->session_name(),
+                                        (*s2)->session_name()}),
+              UnorderedElementsAre("s1", "s2"));
+}
+
+TEST(SessionPool, ReplaceBadSessions) {
+  auto mock = std::make_shared<StrictMock<spanner_testing::MockSpannerStub>>();
+  std::vector<std::string> initial_names;
+  for (int i = 1; i <= 10; ++i) {
+    initial_names.push_back("s" + std::to_string(i));
+  }
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse(initial_names))));
+
+  using MockReader = StrictMock<
+      MockAsyncResponseReader<spanner_proto::BatchCreateSessionsResponse>>;
+  auto reader1 = google::cloud::internal::make_unique<MockReader>();
+  auto reader2 = google::cloud::internal::make_unique<MockReader>();
+  // The first bad session starts a replacement, the others are replaced
+  // together once that call completes.
+  EXPECT_CALL(*mock, AsyncBatchCreateSessions(_, SessionCountIs(1), _))
+      .WillOnce(Invoke(
+          [&reader1](grpc::ClientContext&,
+                     spanner_proto::BatchCreateSessionsRequest const&,
+                     grpc::CompletionQueue*) {
+            // This is safe. See comments in MockAsyncResponseReader.
+            return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+                spanner_proto::BatchCreateSessionsResponse>>(reader1.get());
+          }));
+  EXPECT_CALL(*mock, AsyncBatchCreateSessions(_, SessionCountIs(9), _))
+      .WillOnce(Invoke(
+          [&reader2](grpc::ClientContext&,
+                     spanner_proto::BatchCreateSessionsRequest const&,
+                     grpc::CompletionQueue*) {
+            // This is safe. See comments in MockAsyncResponseReader.
+            return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+                spanner_proto::BatchCreateSessionsResponse>>(reader2.get());
+          }));
+  EXPECT_CALL(*reader1, Finish(_, _, _))
+      .WillOnce(Invoke([](spanner_proto::BatchCreateSessionsResponse* response,
+                          grpc::Status* status, void*) {
+        response->add_session()->set_name("r1");
+        *status = grpc::Status::OK;
+      }));
+  EXPECT_CALL(*reader2, Finish(_, _, _))
+      .WillOnce(Invoke([](spanner_proto::BatchCreateSessionsResponse* response,
+                          grpc::Status* status, void*) {
+        for (int i = 2; i <= 10; ++i) {
+          response->add_session()->set_name("r" + std::to_string(i));
+        }
+        *status = grpc::Status::OK;
+      }));
+
+  auto db = Database("project", "instance", "database");
+  SessionPoolOptions options;
+  options.set_min_sessions(10);
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto pool = MakeSessionPool(db, {mock}, options, CompletionQueue(impl));
+
+  {
+    std::vector<SessionHolder> sessions;
+    for (int i = 0; i != 10; ++i) {
+      auto session = pool->Allocate();
+      ASSERT_STATUS_OK(session);
+      (*session)->set_bad();
+      sessions.push_back(*std::move(session));
+    }
+  }
+  EXPECT_EQ(0, pool->Metrics().total_sessions);
+
+  // Complete the replacement calls, without blocking any callers.
+  impl->SimulateCompletion(true);
+  impl->SimulateCompletion(true);
+  impl->SimulateCompletion(true);
+  auto metrics = pool->Metrics();
+  EXPECT_EQ(10, metrics.total_sessions);
+  EXPECT_EQ(10, metrics.idle_sessions);
+  EXPECT_EQ(0, metrics.create_calls_in_progress);
+
+  auto session = pool->Allocate();
+  ASSERT_STATUS_OK(session);
+  EXPECT_EQ('r', (*session)->session_name()[0]);
+}
+
+TEST(SessionPool, EvictSessionNotFoundOnKeepAlive) {
+  auto mock = std::make_shared<StrictMock<spanner_testing::MockSpannerStub>>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1"}))));
+
+  auto get_reader = google::cloud::internal::make_unique<
+      StrictMock<MockAsyncResponseReader<spanner_proto::Session>>>();
+  EXPECT_CALL(*mock, AsyncGetSession(_, _, _))
+      .WillOnce(Invoke([&get_reader](grpc::ClientContext&,
+                                     spanner_proto::GetSessionRequest const&,
+                                     grpc::CompletionQueue*) {
+        // This is safe. See comments in MockAsyncResponseReader.
+        return std::unique_ptr<
+            grpc::ClientAsyncResponseReaderInterface<spanner_proto::Session>>(
+            get_reader.get());
+      }));
+  EXPECT_CALL(*get_reader, Finish(_, _, _))
+      .WillOnce(Invoke([](spanner_proto::Session*, grpc::Status* status,
+                          void*) {
+        *status = grpc::Status(grpc::StatusCode::NOT_FOUND,
+                               "Session not found: s1");
+      }));
+
+  auto create_reader = google::cloud::internal::make_unique<StrictMock<
+      MockAsyncResponseReader<spanner_proto::BatchCreateSessionsResponse>>>();
+  EXPECT_CALL(*mock, AsyncBatchCreateSessions(_, SessionCountIs(1), _))
+      .WillOnce(Invoke(
+          [&create_reader](
+              grpc::ClientContext&,
+              spanner_proto::BatchCreateSessionsRequest const&,
+              grpc::CompletionQueue*) {
+            // This is safe. See comments in MockAsyncResponseReader.
+            return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+                spanner_proto::BatchCreateSessionsResponse>>(
+                create_reader.get());
+          }));
+  EXPECT_CALL(*create_reader, Finish(_, _, _))
+      .WillOnce(Invoke([](spanner_proto::BatchCreateSessionsResponse* response,
+                          grpc::Status* status, void*) {
+        response->add_session()->set_name("s2");
+        *status = grpc::Status::OK;
+      }));
+
+  auto db = Database("project", "instance", "database");
+  SessionPoolOptions options;
+  options.set_min_sessions(1);
+  options.set_keep_alive_interval(std::chrono::seconds(1));
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto clock = std::make_shared<FakeSteadyClock>();
+  auto pool =
+      MakeSessionPool(db, {mock}, options, CompletionQueue(impl), clock);
+  clock->AdvanceTime(options.keep_alive_interval() * 2);
+
+  // Run the keep-alive, which evicts "s1" and starts creating its
+  // replacement, then complete that call.
+  impl->SimulateCompletion(true);
+  impl->SimulateCompletion(true);
+  impl->SimulateCompletion(true);
+
+  auto session = pool->Allocate();
+  ASSERT_STATUS_OK(session);
+  EXPECT_EQ("s2", (*session)->session_name());
+}
+
+TEST(SessionPool, DemandStats) {
+  auto mock = std::make_shared<StrictMock<spanner_testing::MockSpannerStub>>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1", "s2"}))));
+
+  auto db = Database("project", "instance", "database");
+  SessionPoolOptions options;
+  options.set_min_sessions(2);
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto clock = std::make_shared<FakeSteadyClock>();
+  auto pool =
+      MakeSessionPool(db, {mock}, options, CompletionQueue(impl), clock);
+
+  for (int i = 0; i != 3; ++i) {
+    auto s1 = pool->Allocate();
+    ASSERT_STATUS_OK(s1);
+    auto s2 = pool->Allocate();
+    ASSERT_STATUS_OK(s2);
+  }
+  auto s3 = pool->Allocate();
+  ASSERT_STATUS_OK(s3);
+
+  // Run the background maintenance, which computes the statistics.
+  clock->AdvanceTime(std::chrono::seconds(5));
+  impl->SimulateCompletion(true);
+  auto stats = pool->DemandStats();
+  EXPECT_EQ(std::chrono::seconds(5), stats.observed_period);
+  EXPECT_EQ(7, stats.allocations);
+  EXPECT_DOUBLE_EQ(1.4, stats.allocations_per_second);
+  EXPECT_EQ(2, stats.peak_sessions_in_use);
+  // Without adaptive sizing the target is always `min_sessions`.
+  EXPECT_EQ(2, stats.target_sessions);
+
+  // The next sample starts with the session still in use.
+  clock->AdvanceTime(std::chrono::seconds(5));
+  impl->SimulateCompletion(true);
+  stats = pool->DemandStats();
+  EXPECT_EQ(std::chrono::seconds(10), stats.observed_period);
+  EXPECT_EQ(7, stats.allocations);
+  EXPECT_EQ(2, stats.peak_sessions_in_use);
+}
+
+TEST(SessionPool, AdaptiveSizing) {
+  auto mock = std::make_shared<StrictMock<spanner_testing::MockSpannerStub>>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1"}))));
+
+  // Allocating the last idle session starts creating another one.
+  auto create_reader = google::cloud::internal::make_unique<StrictMock<
+      MockAsyncResponseReader<spanner_proto::BatchCreateSessionsResponse>>>();
+  EXPECT_CALL(*mock, AsyncBatchCreateSessions(_, _, _))
+      .WillOnce(Invoke(
+          [&create_reader](
+              grpc::ClientContext&,
+              spanner_proto::BatchCreateSessionsRequest const& request,
+              grpc::CompletionQueue*) {
+            EXPECT_EQ(1, request.session_count());
+            // This is safe. See comments in MockAsyncResponseReader.
+            return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+                spanner_proto::BatchCreateSessionsResponse>>(
+                create_reader.get());
+          }));
+  EXPECT_CALL(*create_reader, Finish(_, _, _))
+      .WillOnce(Invoke([](spanner_proto::BatchCreateSessionsResponse* response,
+                          grpc::Status* status, void*) {
+        response->add_session()->set_name("s2");
+        *status = grpc::Status::OK;
+      }));
+
+  // After a full window without demand, the least recently used session is
+  // deleted.
+  auto delete_reader = google::cloud::internal::make_unique<
+      StrictMock<MockAsyncResponseReader<google::protobuf::Empty>>>();
+  EXPECT_CALL(*mock, AsyncDeleteSession(_, _, _))
+      .WillOnce(Invoke(
+          [&delete_reader](grpc::ClientContext&,
+                           spanner_proto::DeleteSessionRequest const& request,
+                           grpc::CompletionQueue*) {
+            EXPECT_EQ("s1", request.name());
+            // This is safe. See comments in MockAsyncResponseReader.
+            return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+                google::protobuf::Empty>>(delete_reader.get());
+          }));
+  EXPECT_CALL(*delete_reader, Finish(_, _, _))
+      .WillOnce(
+          Invoke([](google::protobuf::Empty*, grpc::Status* status, void*) {
+            *status = grpc::Status::OK;
+          }));
+
+  auto db = Database("project", "instance", "database");
+  SessionPoolOptions options;
+  options.set_adaptive_sizing(true)
+      .set_demand_window(std::chrono::seconds(10))
+      .set_max_idle_sessions(1);
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto clock = std::make_shared<FakeSteadyClock>();
+  auto pool =
+      MakeSessionPool(db, {mock}, options, CompletionQueue(impl), clock);
+
+  {
+    auto s1 = pool->Allocate();
+    ASSERT_STATUS_OK(s1);
+    EXPECT_EQ("s1", (*s1)->session_name());
+  }
+
+  // Run the background maintenance and complete the creation of "s2".
+  clock->AdvanceTime(std::chrono::seconds(5));
+  impl->SimulateCompletion(true);
+  auto stats = pool->DemandStats();
+  EXPECT_EQ(1, stats.peak_sessions_in_use);
+  EXPECT_EQ(2, stats.target_sessions);
+
+  // The demand is still within the window, so the pool does not shrink.
+  clock->AdvanceTime(std::chrono::seconds(5));
+  impl->SimulateCompletion(true);
+  EXPECT_EQ(2, pool->DemandStats().target_sessions);
+
+  // A full window without demand, the pool shrinks to `max_idle_sessions`.
+  clock->AdvanceTime(std::chrono::seconds(10));
+  impl->SimulateCompletion(true);
+  stats = pool->DemandStats();
+  EXPECT_EQ(0, stats.peak_sessions_in_use);
+  EXPECT_EQ(0, stats.target_sessions);
+
+  // Complete the AsyncDeleteSession() call.
+  impl->SimulateCompletion(true);
+}
+
+TEST(SessionPool, InitializeSplitsLargeRequests) {
+  auto mock = std::make_shared<StrictMock<spanner_testing::MockSpannerStub>>();
+  std::vector<std::unique_ptr<BatchCreateSessionsReader>> readers;
+  std::mutex mu;
+  auto create = [&readers, &mu](
+                    grpc::ClientContext&,
+                    spanner_proto::BatchCreateSessionsRequest const& request,
+                    grpc::CompletionQueue*) {
+    static std::atomic<int> id{0};
+    std::vector<std::string> names;
+    for (int i = 0; i != request.session_count(); ++i) {
+      names.push_back("s" + std::to_string(++id));
+    }
+    auto reader =
+        google::cloud::internal::make_unique<BatchCreateSessionsReader>();
+    EXPECT_CALL(*reader, Finish(_, _, _))
+        .WillOnce(Invoke(
+            [names](spanner_proto::BatchCreateSessionsResponse* response,
+                    grpc::Status* status, void*) {
+              *response = MakeSessionsResponse(names);
+              *status = grpc::Status::OK;
+            }));
+    std::lock_guard<std::mutex> lk(mu);
+    readers.push_back(std::move(reader));
+    // This is safe. See comments in MockAsyncResponseReader.
+    return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+        spanner_proto::BatchCreateSessionsResponse>>(readers.back().get());
+  };
+  // The server limits the sessions created in each call, so the initial 250
+  // sessions require 3 (concurrent) calls.
+  EXPECT_CALL(*mock, AsyncBatchCreateSessions(_, SessionCountIs(100), _))
+      .Times(2)
+      .WillRepeatedly(Invoke(create));
+  EXPECT_CALL(*mock, AsyncBatchCreateSessions(_, SessionCountIs(50), _))
+      .WillOnce(Invoke(create));
+
+  auto db = Database("project", "instance", "database");
+  SessionPoolOptions options;
+  options.set_min_sessions(250).set_max_sessions_per_channel(250);
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto pool = MakeSessionPoolCompleting(db, {mock}, options, impl);
+
+  // All the sessions are in the pool, no more calls are needed.
+  std::vector<SessionHolder> sessions;
+  for (int i = 0; i != 250; ++i) {
+    auto session = pool->Allocate();
+    ASSERT_STATUS_OK(session);
+    sessions.push_back(*std::move(session));
+  }
+}
+
+TEST(SessionPool, InitializeAsync) {
+  using MockReader = StrictMock<
+      MockAsyncResponseReader<spanner_proto::BatchCreateSessionsResponse>>;
+  std::vector<std::shared_ptr<SpannerStub>> stubs;
+  std::vector<std::unique_ptr<MockReader>> readers;
+  for (int i = 0; i != 2; ++i) {
+    auto mock =
+        std::make_shared<StrictMock<spanner_testing::MockSpannerStub>>();
+    readers.push_back(google::cloud::internal::make_unique<MockReader>());
+    auto* reader = readers.back().get();
+    EXPECT_CALL(*mock, AsyncBatchCreateSessions(_, SessionCountIs(2), _))
+        .WillOnce(Invoke(
+            [reader](grpc::ClientContext&,
+                     spanner_proto::BatchCreateSessionsRequest const&,
+                     grpc::CompletionQueue*) {
+              // This is safe. See comments in MockAsyncResponseReader.
+              return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+                  spanner_proto::BatchCreateSessionsResponse>>(reader);
+            }));
+    EXPECT_CALL(*reader, Finish(_, _, _))
+        .WillOnce(
+            Invoke([i](spanner_proto::BatchCreateSessionsResponse* response,
+                       grpc::Status* status, void*) {
+              auto const prefix = "c" + std::to_string(i + 1);
+              response->add_session()->set_name(prefix + "s1");
+              response->add_session()->set_name(prefix + "s2");
+              *status = grpc::Status::OK;
+            }));
+    stubs.push_back(std::move(mock));
+  }
+
+  auto db = Database("project", "instance", "database");
+  SessionPoolOptions options;
+  options.set_min_sessions(4);
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto pool = std::make_shared<SessionPool>(
+      db, std::move(stubs), options, CompletionQueue(impl),
+      google::cloud::internal::make_unique<LimitedTimeRetryPolicy>(
+          std::chrono::minutes(10)),
+      google::cloud::internal::make_unique<ExponentialBackoffPolicy>(
+          std::chrono::milliseconds(100), std::chrono::minutes(1), 2.0),
+      std::make_shared<SteadyClock>());
+
+  // Both calls are started immediately, and the pool is ready once they
+  // complete.
+  auto ready = pool->InitializeAsync();
+  EXPECT_EQ(std::future_status::timeout,
+            ready.wait_for(std::chrono::milliseconds(0)));
+  impl->SimulateCompletion(true);
+  EXPECT_STATUS_OK(ready.get());
+
+  std::vector<std::string> session_names;
+  std::vector<SessionHolder> sessions;
+  for (int i = 0; i != 4; ++i) {
+    auto session = pool->Allocate();
+    ASSERT_STATUS_OK(session);
+    session_names.push_back((*session)->session_name());
+    sessions.push_back(*std::move(session));
+  }
+  EXPECT_THAT(session_names,
+              UnorderedElementsAre("c1s1", "c1s2", "c2s1", "c2s2"));
+}
+
+TEST(SessionPool, SessionRefreshConcurrencyLimit) {
+  auto mock = std::make_shared<StrictMock<spanner_testing::MockSpannerStub>>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1", "s2", "s3"}))));
+
+  auto reader = google::cloud::internal::make_unique<
+      StrictMock<MockAsyncResponseReader<spanner_proto::Session>>>();
+  std::vector<std::string> refreshed;
+  EXPECT_CALL(*mock, AsyncGetSession(_, _, _))
+      .Times(3)
+      .WillRepeatedly(Invoke(
+          [&reader, &refreshed](grpc::ClientContext&,
+                                spanner_proto::GetSessionRequest const& request,
+                                grpc::CompletionQueue*) {
+            refreshed.push_back(request.name());
+            // This is safe. See comments in MockAsyncResponseReader.
+            return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+                spanner_proto::Session>>(reader.get());
+          }));
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .Times(3)
+      .WillRepeatedly(Invoke(
+          [](spanner_proto::Session*, grpc::Status* status, void*) {
+            *status = grpc::Status::OK;
+          }));
+
+  auto db = Database("project", "instance", "database");
+  SessionPoolOptions options;
+  options.set_min_sessions(3)
+      .set_keep_alive_interval(std::chrono::seconds(1))
+      .set_keep_alive_concurrency(1);
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto clock = std::make_shared<FakeSteadyClock>();
+  auto pool =
+      MakeSessionPool(db, {mock}, options, CompletionQueue(impl), clock);
+
+  // All three sessions need refreshing, but only one call is started in each
+  // pass.
+  clock->AdvanceTime(options.keep_alive_interval() * 2);
+  impl->SimulateCompletion(true);
+  EXPECT_EQ(1U, refreshed.size());
+
+  // Each pass completes the pending call, so the remaining sessions are
+  // refreshed in later passes.
+  for (int i = 0; i != 10 && refreshed.size() != 3U; ++i) {
+    impl->SimulateCompletion(true);
+  }
+  EXPECT_THAT(refreshed, UnorderedElementsAre("s1", "s2", "s3"));
+  impl->SimulateCompletion(true);
+}
+
+TEST(SessionPool, SessionRefreshWithSelect) {
+  auto mock = std::make_shared<StrictMock<spanner_testing::MockSpannerStub>>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1"}))));
+
+  auto reader = google::cloud::internal::make_unique<
+      StrictMock<MockAsyncResponseReader<spanner_proto::ResultSet>>>();
+  EXPECT_CALL(*mock, AsyncExecuteSql(_, _, _))
+      .WillOnce(Invoke(
+          [&reader](grpc::ClientContext&,
+                    spanner_proto::ExecuteSqlRequest const& request,
+                    grpc::CompletionQueue*) {
+            EXPECT_EQ("s1", request.session());
+            EXPECT_EQ("SELECT 1", request.sql());
+            // This is safe. See comments in MockAsyncResponseReader.
+            return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+                spanner_proto::ResultSet>>(reader.get());
+          }));
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce(Invoke(
+          [](spanner_proto::ResultSet*, grpc::Status* status, void*) {
+            *status = grpc::Status::OK;
+          }));
+
+  auto db = Database("project", "instance", "database");
+  SessionPoolOptions options;
+  options.set_min_sessions(1)
+      .set_keep_alive_interval(std::chrono::seconds(1))
+      .set_keep_alive_with_select(true);
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto clock = std::make_shared<FakeSteadyClock>();
+  auto pool =
+      MakeSessionPool(db, {mock}, options, CompletionQueue(impl), clock);
+
+  // Run the refresh, then complete the `SELECT 1` call.
+  clock->AdvanceTime(options.keep_alive_interval() * 2);
+  impl->SimulateCompletion(true);
+  impl->SimulateCompletion(true);
+}
+
+TEST(SessionPool, PrepareWriteSessions) {
+  auto mock = std::make_shared<StrictMock<spanner_testing::MockSpannerStub>>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1", "s2"}))));
+
+  auto reader = google::cloud::internal::make_unique<
+      StrictMock<MockAsyncResponseReader<spanner_proto::Transaction>>>();
+  EXPECT_CALL(*mock, AsyncBeginTransaction(_, _, _))
+      .WillOnce(Invoke(
+          [&reader](grpc::ClientContext&,
+                    spanner_proto::BeginTransactionRequest const& request,
+                    grpc::CompletionQueue*) {
+            // The least recently used session is prepared.
+            EXPECT_EQ("s1", request.session());
+            EXPECT_TRUE(request.options().has_read_write());
+            // This is safe. See comments in MockAsyncResponseReader.
+            return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+                spanner_proto::Transaction>>(reader.get());
+          }));
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce(Invoke([](spanner_proto::Transaction* transaction,
+                          grpc::Status* status, void*) {
+        transaction->set_id("txn1");
+        *status = grpc::Status::OK;
+      }));
+
+  auto db = Database("project", "instance", "database");
+  SessionPoolOptions options;
+  options.set_min_sessions(2).set_write_sessions_fraction(0.5);
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto clock = std::make_shared<FakeSteadyClock>();
+  auto pool =
+      MakeSessionPool(db, {mock}, options, CompletionQueue(impl), clock);
+
+  // Run the background work, which prepares one session, then complete the
+  // BeginTransaction() call. Later runs have nothing to prepare.
+  impl->SimulateCompletion(true);
+  impl->SimulateCompletion(true);
+  impl->SimulateCompletion(true);
+  EXPECT_EQ(1, pool->Metrics().prepared_sessions);
+
+  // Read-write transactions get the prepared session, others do not.
+  auto s1 = pool->Allocate(/*dissociate_from_pool=*/false,
+                           /*read_write=*/true);
+  ASSERT_STATUS_OK(s1);
+  EXPECT_EQ("s1", (*s1)->session_name());
+  auto s2 = pool->Allocate();
+  ASSERT_STATUS_OK(s2);
+  EXPECT_EQ("s2", (*s2)->session_name());
+  EXPECT_EQ("", (*s2)->TakePreparedTransaction());
+  EXPECT_EQ("txn1", (*s1)->TakePreparedTransaction());
+  // The transaction can only be used once.
+  EXPECT_EQ("", (*s1)->TakePreparedTransaction());
+  EXPECT_EQ(0, pool->Metrics().prepared_sessions);
+
+  // Destroy the pool first, so releasing the sessions does not start
+  // preparing them again.
+  pool.reset();
+}
+
+TEST(SessionPool, PrepareWriteSessionOnRelease) {
+  auto mock = std::make_shared<StrictMock<spanner_testing::MockSpannerStub>>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1"}))));
+
+  auto reader = google::cloud::internal::make_unique<
+      StrictMock<MockAsyncResponseReader<spanner_proto::Transaction>>>();
+  EXPECT_CALL(*mock, AsyncBeginTransaction(_, _, _))
+      .WillOnce(Invoke([&reader](grpc::ClientContext&,
+                                 spanner_proto::BeginTransactionRequest const&,
+                                 grpc::CompletionQueue*) {
+        // This is safe. See comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            spanner_proto::Transaction>>(reader.get());
+      }));
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce(Invoke([](spanner_proto::Transaction* transaction,
+                          grpc::Status* status, void*) {
+        transaction->set_id("txn1");
+        *status = grpc::Status::OK;
+      }));
+
+  auto db = Database("project", "instance", "database");
+  SessionPoolOptions options;
+  options.set_write_sessions_fraction(1.0);
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto clock = std::make_shared<FakeSteadyClock>();
+  auto pool =
+      MakeSessionPool(db, {mock}, options, CompletionQueue(impl), clock);
+
+  // Releasing the session starts preparing it, it is not idle until the
+  // BeginTransaction() call completes.
+  auto session = pool->Allocate();
+  ASSERT_STATUS_OK(session);
+  session->reset();
+  EXPECT_EQ(0, pool->Metrics().idle_sessions);
+  impl->SimulateCompletion(true);
+  impl->SimulateCompletion(true);
+  auto metrics = pool->Metrics();
+  EXPECT_EQ(1, metrics.idle_sessions);
+  EXPECT_EQ(1, metrics.prepared_sessions);
+
+  // A prepared transaction that is too old is not used.
+  clock->AdvanceTime(std::chrono::seconds(10));
+  session = pool->Allocate(/*dissociate_from_pool=*/false,
+                           /*read_write=*/true);
+  ASSERT_STATUS_OK(session);
+  EXPECT_EQ("", (*session)->TakePreparedTransaction());
+
+  // Destroy the pool first, so releasing the session does not start
+  // preparing it again.
+  pool.reset();
+}
+
+// Returns a mock stub whose `AsyncBeginTransaction()` call returns `txn1`.
+std::shared_ptr<StrictMock<spanner_testing::MockSpannerStub>>
+MakePreparingStub(
+    std::unique_ptr<
+        StrictMock<MockAsyncResponseReader<spanner_proto::Transaction>>>&
+        reader) {
+  auto mock = std::make_shared<StrictMock<spanner_testing::MockSpannerStub>>();
+  reader = google::cloud::internal::make_unique<
+      StrictMock<MockAsyncResponseReader<spanner_proto::Transaction>>>();
+  auto* r = reader.get();
+  EXPECT_CALL(*mock, AsyncBeginTransaction(_, _, _))
+      .WillOnce(Invoke([r](grpc::ClientContext&,
+                           spanner_proto::BeginTransactionRequest const&,
+                           grpc::CompletionQueue*) {
+        // This is safe. See comments in MockAsyncResponseReader.
+        return std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+            spanner_proto::Transaction>>(r);
+      }));
+  EXPECT_CALL(*reader, Finish(_, _, _))
+      .WillOnce(Invoke([](spanner_proto::Transaction* transaction,
+                          grpc::Status* status, void*) {
+        transaction->set_id("txn1");
+        *status = grpc::Status::OK;
+      }));
+  return mock;
+}
+
+TEST(SessionPool, ReadOnlyAllocationAvoidsPreparedSession) {
+  std::unique_ptr<
+      StrictMock<MockAsyncResponseReader<spanner_proto::Transaction>>>
+      reader;
+  auto mock = MakePreparingStub(reader);
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1"}))))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s2"}))));
+
+  auto db = Database("project", "instance", "database");
+  SessionPoolOptions options;
+  options.set_write_sessions_fraction(1.0).set_max_sessions_per_channel(2);
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto clock = std::make_shared<FakeSteadyClock>();
+  auto pool =
+      MakeSessionPool(db, {mock}, options, CompletionQueue(impl), clock);
+
+  // Prepare "s1" by releasing it.
+  auto session = pool->Allocate();
+  ASSERT_STATUS_OK(session);
+  session->reset();
+  impl->SimulateCompletion(true);
+  impl->SimulateCompletion(true);
+  EXPECT_EQ(1, pool->Metrics().prepared_sessions);
+
+  // The pool can grow, so a read-only allocation gets a new session.
+  auto s2 = pool->Allocate();
+  ASSERT_STATUS_OK(s2);
+  EXPECT_EQ("s2", (*s2)->session_name());
+  EXPECT_EQ(1, pool->Metrics().prepared_sessions);
+
+  // Now the pool is at its maximum size, so the prepared session is used
+  // instead of waiting.
+  auto s1 = pool->Allocate();
+  ASSERT_STATUS_OK(s1);
+  EXPECT_EQ("s1", (*s1)->session_name());
+  EXPECT_EQ(0, pool->Metrics().prepared_sessions);
+
+  // The read-only holder did not use the transaction, so the session returns
+  // to the pool with it. The (strict) mock rejects another BeginTransaction()
+  // call.
+  s1->reset();
+  EXPECT_EQ(1, pool->Metrics().prepared_sessions);
+  s1 = pool->Allocate(/*dissociate_from_pool=*/false, /*read_write=*/true);
+  ASSERT_STATUS_OK(s1);
+  EXPECT_EQ("s1", (*s1)->session_name());
+  EXPECT_EQ("txn1", (*s1)->TakePreparedTransaction());
+
+  // Destroy the pool first, so releasing the sessions does not start
+  // preparing them again.
+  pool.reset();
+}
+
+TEST(SessionPool, AsyncAllocatePreparedSession) {
+  std::unique_ptr<
+      StrictMock<MockAsyncResponseReader<spanner_proto::Transaction>>>
+      reader;
+  auto mock = MakePreparingStub(reader);
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1"}))));
+
+  auto db = Database("project", "instance", "database");
+  SessionPoolOptions options;
+  options.set_write_sessions_fraction(1.0);
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto clock = std::make_shared<FakeSteadyClock>();
+  auto pool =
+      MakeSessionPool(db, {mock}, options, CompletionQueue(impl), clock);
+
+  auto session = pool->Allocate();
+  ASSERT_STATUS_OK(session);
+  session->reset();
+  impl->SimulateCompletion(true);
+  impl->SimulateCompletion(true);
+  EXPECT_EQ(1, pool->Metrics().prepared_sessions);
+
+  auto f = pool->AsyncAllocate((std::chrono::system_clock::time_point::max)(),
+                               /*dissociate_from_pool=*/false,
+                               /*read_write=*/true);
+  ASSERT_EQ(std::future_status::ready,
+            f.wait_for(std::chrono::milliseconds(0)));
+  auto s1 = f.get();
+  ASSERT_STATUS_OK(s1);
+  EXPECT_EQ("s1", (*s1)->session_name());
+  EXPECT_EQ("txn1", (*s1)->TakePreparedTransaction());
+
+  // Destroy the pool first, so releasing the session does not start
+  // preparing it again.
+  pool.reset();
+}
+
+TEST(SessionPool, Metrics) {
+  auto mock = std::make_shared<StrictMock<spanner_testing::MockSpannerStub>>();
+  auto clock = std::make_shared<FakeSteadyClock>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce([&clock](grpc::ClientContext&,
+                         spanner_proto::BatchCreateSessionsRequest const&) {
+        clock->AdvanceTime(std::chrono::milliseconds(20));
+        return MakeSessionsResponse({"s1"});
+      });
+
+  auto db = Database("project", "instance", "database");
+  SessionPoolOptions options;
+  options.set_max_sessions_per_channel(1).set_action_on_exhaustion(
+      ActionOnExhaustion::kFail);
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto pool = MakeSessionPool(db, {mock}, options, threads.cq(), clock);
+
+  auto metrics = pool->Metrics();
+  EXPECT_EQ(0, metrics.total_sessions);
+  EXPECT_EQ(0, metrics.allocation_wait.count);
+
+  auto s1 = pool->Allocate();
+  ASSERT_STATUS_OK(s1);
+  auto s2 = pool->Allocate();
+  EXPECT_EQ(StatusCode::kResourceExhausted, s2.status().code());
+
+  metrics = pool->Metrics();
+  EXPECT_EQ(1, metrics.total_sessions);
+  EXPECT_EQ(0, metrics.idle_sessions);
+  EXPECT_EQ(0, metrics.create_calls_in_progress);
+  EXPECT_EQ(0, metrics.threads_waiting);
+  EXPECT_EQ(0, metrics.async_waiters);
+  ASSERT_EQ(1U, metrics.channels.size());
+  EXPECT_EQ(1, metrics.channels[0].session_count);
+  EXPECT_EQ(1, metrics.channels[0].sessions_in_use);
+  EXPECT_EQ(0, metrics.channels[0].idle_sessions);
+  EXPECT_EQ(1, metrics.exhaustion_events);
+
+  // The first allocation waited for the session to be created, the second
+  // failed immediately.
+  EXPECT_EQ(2, metrics.allocation_wait.count);
+  EXPECT_EQ(std::chrono::milliseconds(20), metrics.allocation_wait.sum);
+  EXPECT_EQ(1, metrics.creation_latency.count);
+  EXPECT_EQ(std::chrono::milliseconds(20), metrics.creation_latency.sum);
+
+  s1->reset();
+  metrics = pool->Metrics();
+  EXPECT_EQ(1, metrics.idle_sessions);
+  EXPECT_EQ(0, metrics.channels[0].sessions_in_use);
+  EXPECT_EQ(1, metrics.channels[0].idle_sessions);
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace SPANNER_CLIENT_NS
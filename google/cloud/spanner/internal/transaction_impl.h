@@ -17,13 +17,17 @@
 
 #include "google/cloud/spanner/internal/session.h"
 #include "google/cloud/spanner/version.h"
+#include "google/cloud/future.h"
 #include "google/cloud/internal/invoke_result.h"
 #include "google/cloud/internal/port_platform.h"
 #include <google/spanner/v1/transaction.pb.h>
 #include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <type_traits>
 
 namespace google {
 namespace cloud {
@@ -36,10 +40,24 @@ using VisitInvokeResult = ::google::cloud::internal::invoke_result_t<
     Functor, SessionHolder&, google::spanner::v1::TransactionSelector&,
     std::int64_t>;
 
+template <typename T>
+struct IsFuture : public std::false_type {};
+template <typename T>
+struct IsFuture<future<T>> : public std::true_type {};
+
+template <typename T>
+struct FutureValueType {};
+template <typename T>
+struct FutureValueType<future<T>> {
+  using type = T;
+};
+
 /**
  * The internal representation of a google::cloud::spanner::Transaction.
+ *
+ * Instances must be owned by a `std::shared_ptr`, see `AsyncVisit()`.
  */
-class TransactionImpl {
+class TransactionImpl : public std::enable_shared_from_this<TransactionImpl> {
  public:
   explicit TransactionImpl(google::spanner::v1::TransactionSelector selector)
       : TransactionImpl(/*session=*/{}, std::move(selector)) {}
@@ -92,31 +110,102 @@ class TransactionImpl {
     try {
 #endif
       auto r = f(session_, selector_, seqno);
-      bool done = false;
-      {
-        std::lock_guard<std::mutex> lock(mu_);
-        state_ = selector_.has_begin() ? State::kBegin : State::kDone;
-        done = (state_ == State::kDone);
-      }
-      if (done) {
-        cond_.notify_all();
-      } else {
-        cond_.notify_one();
-      }
+      std::unique_lock<std::mutex> lock(mu_);
+      state_ = selector_.has_begin() ? State::kBegin : State::kDone;
+      Release(std::move(lock));
       return r;
 #if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
     } catch (...) {
-      {
-        std::lock_guard<std::mutex> lock(mu_);
-        state_ = State::kBegin;
-      }
-      cond_.notify_one();
+      std::unique_lock<std::mutex> lock(mu_);
+      state_ = State::kBegin;
+      Release(std::move(lock));
       throw;
     }
 #endif
   }
 
+  // Like `Visit()`, but the functor returns a `future<T>`, and it may use the
+  // SessionHolder and TransactionSelector until that future is satisfied (the
+  // transaction is kept alive until then).
+  //
+  // This never blocks. If another visitor is assigning the transaction ID the
+  // functor is called once that visitor is done, on the thread that completes
+  // it.
+  template <typename Functor>
+  VisitInvokeResult<Functor> AsyncVisit(Functor&& f) {
+    static_assert(IsFuture<VisitInvokeResult<Functor>>::value,
+                  "TransactionImpl::AsyncVisit() functor must return a future");
+    std::unique_lock<std::mutex> lock(mu_);
+    auto const seqno = ++seqno_;
+    return AsyncVisit(std::forward<Functor>(f), seqno, std::move(lock));
+  }
+
  private:
+  template <typename Functor>
+  VisitInvokeResult<Functor> AsyncVisit(Functor&& f, std::int64_t seqno,
+                                        std::unique_lock<std::mutex> lock) {
+    using T = typename FutureValueType<VisitInvokeResult<Functor>>::type;
+    auto self = shared_from_this();
+    if (state_ == State::kDone) {
+      lock.unlock();
+      return f(session_, selector_, seqno).then([self](future<T> r) {
+        return r.get();
+      });
+    }
+    if (state_ == State::kPending) {
+      // Queue the visitor instead of blocking, see `Release()`.
+      auto fn = std::make_shared<typename std::decay<Functor>::type>(
+          std::forward<Functor>(f));
+      auto p = std::make_shared<promise<T>>();
+      deferred_.push_back(
+          [self, fn, p, seqno](std::unique_lock<std::mutex> lk) {
+            self->AsyncVisit(std::move(*fn), seqno, std::move(lk))
+                .then([p](future<T> r) { p->set_value(r.get()); });
+          });
+      return p->get_future();
+    }
+    // selector_.has_begin(), but only one visitor active at a time.
+    state_ = State::kPending;
+    lock.unlock();
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+    try {
+#endif
+      return f(session_, selector_, seqno).then([self](future<T> r) {
+        std::unique_lock<std::mutex> lk(self->mu_);
+        self->state_ =
+            self->selector_.has_begin() ? State::kBegin : State::kDone;
+        self->Release(std::move(lk));
+        return r.get();
+      });
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+    } catch (...) {
+      lock.lock();
+      state_ = State::kBegin;
+      Release(std::move(lock));
+      throw;
+    }
+#endif
+  }
+
+  // Called with `mu_` held once the active visitor is done. Starts the queued
+  // asynchronous visitors until one of them becomes the active visitor, and
+  // wakes the blocked ones.
+  void Release(std::unique_lock<std::mutex> lock) {
+    while (state_ != State::kPending && !deferred_.empty()) {
+      auto next = std::move(deferred_.front());
+      deferred_.pop_front();
+      next(std::move(lock));
+      lock = std::unique_lock<std::mutex>(mu_);
+    }
+    bool const done = (state_ == State::kDone);
+    lock.unlock();
+    if (done) {
+      cond_.notify_all();
+    } else {
+      cond_.notify_one();
+    }
+  }
+
   enum class State {
     kBegin,    // waiting for a future visitor to assign a transaction ID
     kPending,  // waiting for an active visitor to assign a transaction ID
@@ -129,6 +218,8 @@ class TransactionImpl {
   SessionHolder session_;
   google::spanner::v1::TransactionSelector selector_;
   std::int64_t seqno_;
+  // Asynchronous visitors waiting for the active visitor.
+  std::deque<std::function<void(std::unique_lock<std::mutex>)>> deferred_;
 };
 
 }  // namespace internal
@@ -15,6 +15,7 @@
 #include "google/cloud/spanner/internal/transaction_impl.h"
 #include "google/cloud/spanner/timestamp.h"
 #include "google/cloud/spanner/transaction.h"
+#include "google/cloud/future.h"
 #include "google/cloud/internal/make_unique.h"
 #include "google/cloud/internal/port_platform.h"
 #include <gmock/gmock.h>
@@ -213,6 +214,76 @@ TEST(InternalTransaction, ReadFails) {
   EXPECT_EQ(128, MultiThreadedRead(128, &client, 1562361252, "sess-2", "tx-2"));
 }
 
+bool IsReady(future<std::string>& f) {
+  return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+// An asynchronous visitor that returns the transaction ID it used.
+future<std::string> VisitWithId(SessionHolder& session,
+                                TransactionSelector& selector, std::int64_t) {
+  EXPECT_THAT(session, NotNull());
+  EXPECT_FALSE(selector.has_begin());
+  return make_ready_future(selector.id());
+}
+
+TEST(InternalTransaction, AsyncVisitWaitsForBegin) {
+  auto txn = MakeReadWriteTransaction();
+  promise<std::string> begin;
+  auto first = internal::AsyncVisit(
+      txn, [&begin](SessionHolder& session, TransactionSelector& selector,
+                    std::int64_t) {
+        EXPECT_TRUE(selector.has_begin());
+        return begin.get_future().then(
+            [&session, &selector](future<std::string> f) {
+              auto id = f.get();
+              session = internal::MakeDissociatedSessionHolder("sess-0");
+              selector.set_id(id);
+              return id;
+            });
+      });
+
+  // The visitors are queued, without blocking this thread.
+  std::vector<future<std::string>> visits;
+  for (int i = 0; i != 3; ++i) {
+    visits.push_back(internal::AsyncVisit(txn, VisitWithId));
+  }
+  for (auto& v : visits) EXPECT_FALSE(IsReady(v));
+
+  begin.set_value("tx-0");
+  EXPECT_EQ("tx-0", first.get());
+  for (auto& v : visits) EXPECT_EQ("tx-0", v.get());
+  EXPECT_EQ("tx-0", internal::Visit(txn, VisitWithId).get());
+}
+
+TEST(InternalTransaction, AsyncVisitBeginFails) {
+  auto txn = MakeReadWriteTransaction();
+  promise<std::string> begin;
+  // The first visitor fails, leaving the selector unchanged.
+  auto first = internal::AsyncVisit(
+      txn, [&begin](SessionHolder&, TransactionSelector& selector,
+                    std::int64_t) {
+        EXPECT_TRUE(selector.has_begin());
+        return begin.get_future();
+      });
+  // So the next visitor must begin the transaction.
+  auto second = internal::AsyncVisit(
+      txn, [](SessionHolder& session, TransactionSelector& selector,
+              std::int64_t) {
+        EXPECT_TRUE(selector.has_begin());
+        session = internal::MakeDissociatedSessionHolder("sess-0");
+        selector.set_id("tx-1");
+        return make_ready_future(std::string("tx-1"));
+      });
+  auto third = internal::AsyncVisit(txn, VisitWithId);
+  EXPECT_FALSE(IsReady(second));
+  EXPECT_FALSE(IsReady(third));
+
+  begin.set_value("failed");
+  EXPECT_EQ("failed", first.get());
+  EXPECT_EQ("tx-1", second.get());
+  EXPECT_EQ("tx-1", third.get());
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace SPANNER_CLIENT_NS
@@ -56,6 +56,15 @@ class MockConnection : public spanner::Connection {
                StatusOr<spanner::BatchDmlResult>(ExecuteBatchDmlParams));
   MOCK_METHOD1(Commit, StatusOr<spanner::CommitResult>(CommitParams));
   MOCK_METHOD1(Rollback, Status(RollbackParams));
+  MOCK_METHOD1(AsyncRead, future<spanner::RowStream>(ReadParams));
+  MOCK_METHOD1(AsyncExecuteQuery, future<spanner::RowStream>(SqlParams));
+  MOCK_METHOD1(AsyncExecuteDml,
+               future<StatusOr<spanner::DmlResult>>(SqlParams));
+  MOCK_METHOD1(AsyncCommit,
+               future<StatusOr<spanner::CommitResult>>(CommitParams));
+  MOCK_METHOD1(AsyncRollback, future<Status>(RollbackParams));
+  MOCK_METHOD0(GetSessionPoolMetrics,
+               StatusOr<spanner::SessionPoolMetrics>());
 };
 
 /**
@@ -17,6 +17,7 @@
 
 #include "google/cloud/spanner/version.h"
 #include "google/cloud/optional.h"
+#include <cstddef>
 #include <string>
 
 namespace google {
@@ -26,7 +27,7 @@ inline namespace SPANNER_CLIENT_NS {
 
 /**
  * These QueryOptions allow users to configure features about how their SQL
- * queries executes on the server.
+ * queries executes on the server, and how the client receives the results.
  */
 class QueryOptions {
  public:
@@ -51,8 +52,25 @@ class QueryOptions {
     return *this;
   }
 
+  /// Returns the prefetch buffer size, in bytes
+  optional<std::size_t> const& prefetch_buffer_bytes() const {
+    return prefetch_buffer_bytes_;
+  }
+
+  /**
+   * Prefetches the results in the background, buffering up to @p bytes of
+   * responses while the application consumes the rows. This overlaps the
+   * network round trips with decoding the rows, at the cost of memory. Setting
+   * it to 0 reads the results only as the rows are consumed.
+   */
+  QueryOptions& set_prefetch_buffer_bytes(optional<std::size_t> bytes) {
+    prefetch_buffer_bytes_ = std::move(bytes);
+    return *this;
+  }
+
   friend bool operator==(QueryOptions const& a, QueryOptions const& b) {
-    return a.optimizer_version_ == b.optimizer_version_;
+    return a.optimizer_version_ == b.optimizer_version_ &&
+           a.prefetch_buffer_bytes_ == b.prefetch_buffer_bytes_;
   }
 
   friend bool operator!=(QueryOptions const& a, QueryOptions const& b) {
@@ -61,6 +79,7 @@ class QueryOptions {
 
  private:
   optional<std::string> optimizer_version_;
+  optional<std::size_t> prefetch_buffer_bytes_;
 };
 
 }  // namespace SPANNER_CLIENT_NS
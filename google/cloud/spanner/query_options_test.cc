@@ -38,6 +38,21 @@ TEST(QueryOptionsTest, OptimizerVersion) {
   EXPECT_EQ(copy, default_constructed);
 }
 
+TEST(QueryOptionsTest, PrefetchBufferBytes) {
+  QueryOptions const default_constructed{};
+  EXPECT_FALSE(default_constructed.prefetch_buffer_bytes().has_value());
+
+  auto copy = default_constructed;
+  copy.set_prefetch_buffer_bytes(0);
+  EXPECT_NE(copy, default_constructed);
+  copy.set_prefetch_buffer_bytes(1024 * 1024);
+  EXPECT_NE(copy, default_constructed);
+  EXPECT_EQ(1024 * 1024, *copy.prefetch_buffer_bytes());
+
+  copy.set_prefetch_buffer_bytes(optional<std::size_t>{});
+  EXPECT_EQ(copy, default_constructed);
+}
+
 }  // namespace
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner
@@ -17,6 +17,7 @@
 
 #include "google/cloud/spanner/version.h"
 #include <google/spanner/v1/spanner.pb.h>
+#include <cstddef>
 #include <string>
 
 namespace google {
@@ -38,10 +39,19 @@ struct ReadOptions {
    * A limit cannot be specified when calling `PartitionRead`.
    */
   std::int64_t limit = 0;
+
+  /**
+   * If non-zero, the results are prefetched in the background, buffering up
+   * to this many bytes of responses while the application consumes the rows.
+   * This overlaps the network round trips with decoding the rows, at the cost
+   * of memory. This option is not part of a `ReadPartition`.
+   */
+  std::size_t prefetch_buffer_bytes = 0;
 };
 
 inline bool operator==(ReadOptions const& lhs, ReadOptions const& rhs) {
-  return lhs.limit == rhs.limit && lhs.index_name == rhs.index_name;
+  return lhs.limit == rhs.limit && lhs.index_name == rhs.index_name &&
+         lhs.prefetch_buffer_bytes == rhs.prefetch_buffer_bytes;
 }
 
 inline bool operator!=(ReadOptions const& lhs, ReadOptions const& rhs) {
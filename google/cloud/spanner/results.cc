@@ -18,6 +18,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -65,6 +66,73 @@ optional<spanner::ExecutionPlan> GetExecutionPlan(
 }
 }  // namespace
 
+namespace internal {
+
+StatusOr<ColumnBatch> ResultSourceInterface::NextBatch(std::size_t max_rows) {
+  if (!batch_status_.ok()) {
+    auto status = std::move(batch_status_);
+    batch_status_ = Status();
+    return status;
+  }
+  auto row = NextRow();
+  if (!row) return std::move(row).status();
+  if (row->size() == 0) return ColumnBatch{};
+
+  std::vector<google::spanner::v1::TypeCode> type_codes;
+  for (auto const& v : row->values()) {
+    type_codes.push_back(ToProto(v).first.code());
+  }
+  auto builder = ColumnBatchBuilder::Create(
+      std::make_shared<std::vector<std::string>>(row->columns()), type_codes);
+  if (!builder) return std::move(builder).status();
+
+  for (;;) {
+    std::size_t column = 0;
+    for (auto& v : std::move(*row).values()) {
+      auto status = builder->Append(column++, ToProto(std::move(v)).second);
+      if (status.ok()) continue;
+      // The builder discarded the partial row, the rows before it are
+      // returned now, and the error by the next call.
+      if (builder->size() == 0) return status;
+      batch_status_ = std::move(status);
+      return std::move(*builder).Build();
+    }
+    if (builder->size() >= max_rows) break;
+    row = NextRow();
+    if (!row) return std::move(row).status();
+    if (row->size() == 0) break;
+  }
+  return std::move(*builder).Build();
+}
+
+StatusOr<std::vector<Row>> ResultSourceInterface::NextRows(
+    std::size_t max_rows) {
+  std::vector<Row> rows;
+  while (rows.size() < max_rows) {
+    auto row = NextRow();
+    if (!row) return std::move(row).status();
+    if (row->size() == 0) break;
+    rows.push_back(*std::move(row));
+  }
+  return rows;
+}
+
+}  // namespace internal
+
+StatusOr<ColumnBatch> RowStream::NextBatch(std::size_t max_rows) {
+  if (max_rows == 0) {
+    return Status(StatusCode::kInvalidArgument, "max_rows must be positive");
+  }
+  return source_->NextBatch(max_rows);
+}
+
+StatusOr<std::vector<Row>> RowStream::NextRows(std::size_t max_rows) {
+  if (max_rows == 0) {
+    return Status(StatusCode::kInvalidArgument, "max_rows must be positive");
+  }
+  return source_->NextRows(max_rows);
+}
+
 optional<Timestamp> RowStream::ReadTimestamp() const {
   return GetReadTimestamp(source_);
 }
@@ -15,13 +15,17 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_RESULTS_H
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_RESULTS_H
 
+#include "google/cloud/spanner/column_batch.h"
 #include "google/cloud/spanner/row.h"
 #include "google/cloud/spanner/timestamp.h"
+#include "google/cloud/future.h"
 #include "google/cloud/optional.h"
+#include "google/cloud/status.h"
 #include <google/spanner/v1/spanner.pb.h>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -47,6 +51,23 @@ class ResultSourceInterface {
   virtual StatusOr<Row> NextRow() = 0;
   virtual optional<google::spanner::v1::ResultSetMetadata> Metadata() = 0;
   virtual optional<google::spanner::v1::ResultSetStats> Stats() const = 0;
+  // Returns up to `max_rows` rows, an empty batch indicates end-of-stream. The
+  // default implementation is built on top of `NextRow()`.
+  virtual StatusOr<ColumnBatch> NextBatch(std::size_t max_rows);
+  // Returns up to `max_rows` rows, an empty vector indicates end-of-stream.
+  // The default implementation calls `NextRow()` for each row.
+  virtual StatusOr<std::vector<Row>> NextRows(std::size_t max_rows);
+  // Returns the interface to read the rows as protos, or nullptr if this
+  // source does not support it.
+  virtual ProtoRowSource* AsProtoRowSource() { return nullptr; }
+  // Returns a future satisfied when `NextRow()` would not block. The default
+  // implementation returns a satisfied future.
+  virtual future<void> WhenRowReady() { return make_ready_future(); }
+
+ private:
+  // An error found by the default `NextBatch()` after it decoded some rows,
+  // it is returned by the next call.
+  Status batch_status_;
 };
 }  // namespace internal
 
@@ -77,13 +98,70 @@ class RowStream {
 
   /// Returns a `RowStreamIterator` defining the beginning of this range.
   RowStreamIterator begin() {
-    return RowStreamIterator([this]() mutable { return source_->NextRow(); });
+    return RowStreamIterator([this]() mutable { return source_->NextRow(); },
+                             source_->AsProtoRowSource());
   }
 
   /// Returns a `RowStreamIterator` defining the end of this range.
   // NOLINTNEXTLINE(readability-convert-member-functions-to-static)
   RowStreamIterator end() { return {}; }
 
+  /**
+   * Returns up to @p max_rows of the remaining rows, decoded column by column.
+   *
+   * The values are decoded directly from the streaming RPC responses into the
+   * contiguous containers of a `ColumnBatch`, without creating a `Row` or
+   * `Value` for each row. The returned batch has fewer than @p max_rows rows
+   * only when the stream ends, or when the next row has a value that cannot
+   * be decoded, and it is empty once all the rows have been returned.
+   *
+   * A row with a value that cannot be decoded is skipped, and the call that
+   * reaches it returns an error. The rows before it are returned by the
+   * previous call, and the next call continues after it.
+   *
+   * `NextBatch()` and iteration consume rows from the same stream, so callers
+   * may mix them, but each row is returned only once.
+   *
+   * Returns an error if @p max_rows is zero, if the stream fails, or if the
+   * result set has `ARRAY` or `STRUCT` columns, which `ColumnBatch` does not
+   * support.
+   */
+  StatusOr<ColumnBatch> NextBatch(std::size_t max_rows);
+
+  /**
+   * Returns up to @p max_rows of the remaining rows.
+   *
+   * This is equivalent to iterating over the stream, but the rows already
+   * received are extracted together, which is cheaper for small rows. The
+   * returned vector has fewer than @p max_rows rows only when the stream ends,
+   * and it is empty once all the rows have been returned.
+   *
+   * `NextRows()`, `NextBatch()` and iteration consume rows from the same
+   * stream, so callers may mix them, but each row is returned only once.
+   *
+   * Returns an error if @p max_rows is zero, or if the stream fails.
+   */
+  StatusOr<std::vector<Row>> NextRows(std::size_t max_rows);
+
+  /**
+   * Returns a future satisfied when the next row, or the end of the stream,
+   * can be consumed without blocking.
+   *
+   * Only the streams that receive their responses in the background, those
+   * returned by `Client::AsyncRead()` and `Client::AsyncExecuteQuery()`, or
+   * using the `prefetch_buffer_bytes` option, can wait without blocking. For
+   * other streams this function blocks until the next row arrives, and
+   * returns a satisfied future.
+   *
+   * When those streams fail with a transient error the returned future is
+   * also satisfied without blocking: the backoff before resuming the stream
+   * waits on a timer in the `CompletionQueue` of the `Connection`.
+   *
+   * This allows applications to consume the rows from callbacks or coroutines
+   * without tying up a thread while the data is in flight.
+   */
+  future<void> WhenRowReady() { return source_->WhenRowReady(); }
+
   /**
    * Retrieves the timestamp at which the read occurred.
    *
@@ -160,7 +238,8 @@ class ProfileQueryResult {
 
   /// Returns a `RowStreamIterator` defining the beginning of this result set.
   RowStreamIterator begin() {
-    return RowStreamIterator([this]() mutable { return source_->NextRow(); });
+    return RowStreamIterator([this]() mutable { return source_->NextRow(); },
+                             source_->AsProtoRowSource());
   }
 
   /// Returns a `RowStreamIterator` defining the end of this result set.
@@ -35,6 +35,7 @@ namespace spanner_proto = ::google::spanner::v1;
 using ::google::cloud::internal::make_unique;
 using ::google::cloud::spanner_mocks::MockResultSetSource;
 using ::google::protobuf::TextFormat;
+using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::Return;
 using ::testing::UnorderedPointwise;
@@ -118,6 +119,121 @@ TEST(RowStream, IterateError) {
   EXPECT_EQ(num_rows, 2);
 }
 
+TEST(RowStream, NextBatch) {
+  auto mock_source = make_unique<MockResultSetSource>();
+  EXPECT_CALL(*mock_source, NextRow())
+      .WillOnce(Return(MakeTestRow(5, true, "foo")))
+      .WillOnce(Return(MakeTestRow(10, false, "bar")))
+      .WillOnce(Return(MakeTestRow(15, true, "baz")))
+      .WillRepeatedly(Return(Row()));
+
+  RowStream rows(std::move(mock_source));
+  EXPECT_EQ(StatusCode::kInvalidArgument, rows.NextBatch(0).status().code());
+
+  auto batch = rows.NextBatch(2);
+  ASSERT_STATUS_OK(batch);
+  ASSERT_EQ(2, batch->size());
+  EXPECT_THAT(batch->column(0).int64_values(), ElementsAre(5, 10));
+  EXPECT_THAT(batch->column(1).bool_values(), ElementsAre(1, 0));
+  EXPECT_EQ("foobar", batch->column(2).string_data());
+
+  batch = rows.NextBatch(2);
+  ASSERT_STATUS_OK(batch);
+  EXPECT_THAT(batch->column(0).int64_values(), ElementsAre(15));
+
+  batch = rows.NextBatch(2);
+  ASSERT_STATUS_OK(batch);
+  EXPECT_TRUE(batch->empty());
+}
+
+TEST(RowStream, NextBatchError) {
+  auto mock_source = make_unique<MockResultSetSource>();
+  EXPECT_CALL(*mock_source, NextRow())
+      .WillOnce(Return(MakeTestRow(5, true, "foo")))
+      .WillOnce(Return(Status(StatusCode::kUnknown, "oops")));
+
+  RowStream rows(std::move(mock_source));
+  auto batch = rows.NextBatch(10);
+  EXPECT_EQ(StatusCode::kUnknown, batch.status().code());
+  EXPECT_EQ("oops", batch.status().message());
+}
+
+TEST(RowStream, NextBatchBadValue) {
+  google::protobuf::Value not_a_number;
+  not_a_number.set_string_value("not-a-number");
+  auto bad_id =
+      internal::FromProto(internal::ToProto(Value(0)).first, not_a_number);
+
+  auto mock_source = make_unique<MockResultSetSource>();
+  EXPECT_CALL(*mock_source, NextRow())
+      .WillOnce(Return(MakeTestRow(
+          {{"UserName", Value("user10")}, {"UserId", Value(10)}})))
+      .WillOnce(Return(
+          MakeTestRow({{"UserName", Value("user22")}, {"UserId", bad_id}})))
+      .WillOnce(Return(MakeTestRow(
+          {{"UserName", Value("user99")}, {"UserId", Value(99)}})))
+      .WillRepeatedly(Return(Row()));
+
+  // The rows before the bad value are returned first, then the error, and
+  // then the rows after it.
+  RowStream rows(std::move(mock_source));
+  auto batch = rows.NextBatch(10);
+  ASSERT_STATUS_OK(batch);
+  ASSERT_EQ(1, batch->size());
+  EXPECT_EQ("user10", batch->column(0).string_data());
+  EXPECT_THAT(batch->column(1).int64_values(), ElementsAre(10));
+
+  batch = rows.NextBatch(10);
+  EXPECT_FALSE(batch.ok());
+
+  batch = rows.NextBatch(10);
+  ASSERT_STATUS_OK(batch);
+  ASSERT_EQ(1, batch->size());
+  EXPECT_EQ("user99", batch->column(0).string_data());
+  EXPECT_THAT(batch->column(1).int64_values(), ElementsAre(99));
+
+  batch = rows.NextBatch(10);
+  ASSERT_STATUS_OK(batch);
+  EXPECT_TRUE(batch->empty());
+}
+
+TEST(RowStream, NextRows) {
+  auto mock_source = make_unique<MockResultSetSource>();
+  EXPECT_CALL(*mock_source, NextRow())
+      .WillOnce(Return(MakeTestRow(5, true, "foo")))
+      .WillOnce(Return(MakeTestRow(10, false, "bar")))
+      .WillOnce(Return(MakeTestRow(15, true, "baz")))
+      .WillRepeatedly(Return(Row()));
+
+  RowStream rows(std::move(mock_source));
+  EXPECT_EQ(StatusCode::kInvalidArgument, rows.NextRows(0).status().code());
+
+  auto next = rows.NextRows(2);
+  ASSERT_STATUS_OK(next);
+  EXPECT_THAT(*next, ElementsAre(MakeTestRow(5, true, "foo"),
+                                 MakeTestRow(10, false, "bar")));
+
+  next = rows.NextRows(2);
+  ASSERT_STATUS_OK(next);
+  EXPECT_THAT(*next, ElementsAre(MakeTestRow(15, true, "baz")));
+
+  next = rows.NextRows(2);
+  ASSERT_STATUS_OK(next);
+  EXPECT_TRUE(next->empty());
+}
+
+TEST(RowStream, NextRowsError) {
+  auto mock_source = make_unique<MockResultSetSource>();
+  EXPECT_CALL(*mock_source, NextRow())
+      .WillOnce(Return(MakeTestRow(5, true, "foo")))
+      .WillOnce(Return(Status(StatusCode::kUnknown, "oops")));
+
+  RowStream rows(std::move(mock_source));
+  auto next = rows.NextRows(10);
+  EXPECT_EQ(StatusCode::kUnknown, next.status().code());
+  EXPECT_EQ("oops", next.status().message());
+}
+
 TEST(RowStream, TimestampNoTransaction) {
   auto mock_source = make_unique<MockResultSetSource>();
   spanner_proto::ResultSetMetadata no_transaction;
@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <cassert>
 #include <iterator>
+#include <memory>
 #include <utility>
 
 namespace google {
@@ -27,10 +28,28 @@ namespace spanner {
 inline namespace SPANNER_CLIENT_NS {
 
 namespace internal {
+std::shared_ptr<ColumnPositions const> MakeColumnPositions(
+    std::vector<std::string> const& columns) {
+  auto positions = std::make_shared<ColumnPositions>();
+  positions->reserve(columns.size());
+  for (std::size_t i = 0; i != columns.size(); ++i) {
+    positions->emplace(columns[i], i);  // Keeps the first position.
+  }
+  return positions;
+}
+
 Row MakeRow(std::vector<Value> values,
             std::shared_ptr<const std::vector<std::string>> columns) {
   return Row(std::move(values), std::move(columns));
 }
+
+Row MakeRow(std::vector<google::protobuf::Value> protos,
+            std::shared_ptr<ColumnTypes const> types,
+            std::shared_ptr<const std::vector<std::string>> columns,
+            std::shared_ptr<ColumnPositions const> positions) {
+  return Row(std::move(protos), std::move(types), std::move(columns),
+             std::move(positions));
+}
 }  // namespace internal
 
 Row MakeTestRow(std::vector<std::pair<std::string, Value>> pairs) {
@@ -54,21 +73,142 @@ Row::Row(std::vector<Value> values,
   }
 }
 
+Row::Row(std::vector<google::protobuf::Value> protos,
+         std::shared_ptr<internal::ColumnTypes const> types,
+         std::shared_ptr<const std::vector<std::string>> columns,
+         std::shared_ptr<internal::ColumnPositions const> positions)
+    : protos_(std::move(protos)),
+      types_(std::move(types)),
+      columns_(std::move(columns)),
+      positions_(std::move(positions)) {
+  if (protos_.size() != columns_->size() ||
+      types_->size() != columns_->size()) {
+    GCP_LOG(FATAL) << "Row's value, type, and column sizes do not match: "
+                   << protos_.size() << " vs " << types_->size() << " vs "
+                   << columns_->size();
+  }
+}
+
+// The copy creates its own `Value`s, if needed, there is no need to copy them
+// from a lazy row.
+Row::Row(Row const& rhs)
+    : protos_(rhs.protos_),
+      types_(rhs.types_),
+      values_(rhs.values_),
+      columns_(rhs.columns_),
+      positions_(rhs.positions_) {}
+
+Row& Row::operator=(Row const& rhs) {
+  Row tmp(rhs);
+  return *this = std::move(tmp);
+}
+
+// Moving from a `Row` requires exclusive access, so the published `Value`s can
+// be transferred without further synchronization.
+Row::Row(Row&& rhs) noexcept
+    : protos_(std::move(rhs.protos_)),
+      types_(std::move(rhs.types_)),
+      lazy_values_(rhs.lazy_values_.exchange(nullptr)),
+      values_(std::move(rhs.values_)),
+      columns_(std::move(rhs.columns_)),
+      positions_(std::move(rhs.positions_)) {}
+
+Row& Row::operator=(Row&& rhs) noexcept {
+  protos_ = std::move(rhs.protos_);
+  types_ = std::move(rhs.types_);
+  delete lazy_values_.exchange(rhs.lazy_values_.exchange(nullptr));
+  values_ = std::move(rhs.values_);
+  columns_ = std::move(rhs.columns_);
+  positions_ = std::move(rhs.positions_);
+  return *this;
+}
+
+Row::~Row() { delete lazy_values_.load(); }
+
+std::vector<Value> const& Row::values() const& {
+  if (!types_) return values_;
+  auto* published = lazy_values_.load(std::memory_order_acquire);
+  if (published != nullptr) return *published;
+
+  std::unique_ptr<std::vector<Value>> values(new std::vector<Value>);
+  values->reserve(protos_.size());
+  for (std::size_t i = 0; i != protos_.size(); ++i) {
+    values->push_back(internal::FromProto((*types_)[i], protos_[i]));
+  }
+  // If another thread published its `Value`s first, use those instead.
+  if (!lazy_values_.compare_exchange_strong(published, values.get(),
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_acquire)) {
+    return *published;
+  }
+  return *values.release();
+}
+
+std::vector<Value>&& Row::values() && {
+  if (!types_) return std::move(values_);
+  auto* published = lazy_values_.load();
+  if (published != nullptr) return std::move(*published);
+  values_.reserve(protos_.size());
+  for (std::size_t i = 0; i != protos_.size(); ++i) {
+    values_.push_back(internal::FromProto((*types_)[i], std::move(protos_[i])));
+  }
+  return std::move(values_);
+}
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 StatusOr<Value> Row::get(std::size_t pos) const {
-  if (pos < values_.size()) return values_[pos];
-  return Status(StatusCode::kInvalidArgument, "position out of range");
+  auto p = Position(pos);
+  if (!p) return std::move(p).status();
+  if (!types_) return values_[pos];
+  return internal::FromProto((*types_)[pos], protos_[pos]);
 }
 
 // NOLINTNEXTLINE(readability-identifier-naming)
 StatusOr<Value> Row::get(std::string const& name) const {
-  auto it = std::find(columns_->begin(), columns_->end(), name);
-  if (it != columns_->end()) return get(std::distance(columns_->begin(), it));
+  auto pos = Position(name);
+  if (!pos) return std::move(pos).status();
+  return get(*pos);
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+StatusOr<Value> Row::get(ColumnIndex const& index) const {
+  auto pos = Position(index);
+  if (!pos) return std::move(pos).status();
+  return get(*pos);
+}
+
+StatusOr<ColumnIndex> Row::column_index(std::string name) const {
+  auto pos = Position(name);
+  if (!pos) return std::move(pos).status();
+  return ColumnIndex(std::move(name), columns_, *pos);
+}
+
+StatusOr<std::size_t> Row::Position(std::size_t pos) const {
+  if (pos < size()) return pos;
+  return Status(StatusCode::kInvalidArgument, "position out of range");
+}
+
+StatusOr<std::size_t> Row::Position(std::string const& name) const {
+  if (positions_) {
+    auto it = positions_->find(name);
+    if (it != positions_->end()) return it->second;
+  } else {
+    auto it = std::find(columns_->begin(), columns_->end(), name);
+    if (it != columns_->end()) {
+      return static_cast<std::size_t>(std::distance(columns_->begin(), it));
+    }
+  }
   return Status(StatusCode::kInvalidArgument, "column name not found");
 }
 
+StatusOr<std::size_t> Row::Position(ColumnIndex const& index) const {
+  // Rows in the same result set share their columns.
+  if (index.columns_ == columns_) return index.pos_;
+  return Position(index.name_);
+}
+
 bool operator==(Row const& a, Row const& b) {
-  return a.values_ == b.values_ && *a.columns_ == *b.columns_;
+  return *a.columns_ == *b.columns_ && a.values() == b.values();
 }
 
 //
@@ -82,6 +222,12 @@ RowStreamIterator::RowStreamIterator(Source source)
   ++*this;
 }
 
+RowStreamIterator::RowStreamIterator(Source source,
+                                     internal::ProtoRowSource* proto_source)
+    : RowStreamIterator(std::move(source)) {
+  proto_source_ = proto_source;
+}
+
 RowStreamIterator& RowStreamIterator::operator++() {
   if (!row_) {
     source_ = nullptr;  // Last row was an error; become "end"
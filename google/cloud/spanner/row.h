@@ -21,11 +21,13 @@
 #include "google/cloud/status.h"
 #include "google/cloud/status_or.h"
 #include <functional>
+#include <atomic>
 #include <iterator>
 #include <memory>
 #include <string>
 #include <tuple>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -36,10 +38,94 @@ inline namespace SPANNER_CLIENT_NS {
 
 class Row;
 namespace internal {
+/// The (shared) type of each column in a result set.
+using ColumnTypes =
+    std::vector<std::shared_ptr<google::spanner::v1::Type const>>;
+
+/// The position of each column in a result set, indexed by the column name.
+using ColumnPositions = std::unordered_map<std::string, std::size_t>;
+
+/**
+ * Returns the position of each name in @p columns. If a name appears more than
+ * once the first position is used, which matches a linear search.
+ */
+std::shared_ptr<ColumnPositions const> MakeColumnPositions(
+    std::vector<std::string> const& columns);
+
 Row MakeRow(std::vector<Value>,
             std::shared_ptr<const std::vector<std::string>>);
+Row MakeRow(std::vector<google::protobuf::Value>,
+            std::shared_ptr<ColumnTypes const>,
+            std::shared_ptr<const std::vector<std::string>>,
+            std::shared_ptr<ColumnPositions const>);
+
+/**
+ * Implemented by the row sources that can return the (undecoded) protos of
+ * each row. `TupleStreamIterator` uses this interface to decode the protos
+ * directly into the elements of its `std::tuple`.
+ */
+class ProtoRowSource {
+ public:
+  virtual ~ProtoRowSource() = default;
+
+  /// Returns the type of each row, or `nullptr` if it is not known yet.
+  virtual google::spanner::v1::StructType const* RowType() = 0;
+
+  /**
+   * Replaces the contents of @p values with the protos of the next row.
+   * Returns false, and leaves @p values unspecified, at the end of the stream.
+   *
+   * The protos are owned by the source, the caller may modify (or move from)
+   * them until the next call.
+   */
+  virtual StatusOr<bool> NextRowProtos(
+      std::vector<google::protobuf::Value*>& values) = 0;
+};
 }  // namespace internal
 
+/**
+ * A column name resolved to its position in the rows of a result set.
+ *
+ * Getting a column by name from a `Row` requires a lookup of the name. A
+ * `ColumnIndex`, obtained from any row via `Row::column_index()`, performs that
+ * lookup once, and can then be passed to `Row::get()` for every row in the
+ * same result set. With rows from a different result set the `ColumnIndex`
+ * falls back to looking up its name.
+ *
+ * @par Example
+ *
+ * @code
+ * optional<ColumnIndex> last_name;
+ * for (auto& row : client.ExecuteQuery(...)) {
+ *   if (!row) return row.status();
+ *   if (!last_name) last_name = row->column_index("LastName").value();
+ *   if (StatusOr<std::string> x = row->get<std::string>(*last_name)) {
+ *     std::cout << "LastName=" << *x << "\n";
+ *   }
+ * }
+ * @endcode
+ */
+class ColumnIndex {
+ public:
+  /// Creates an index that looks up the column named @p name in each row.
+  explicit ColumnIndex(std::string name) : name_(std::move(name)) {}
+
+  /// Returns the name of the column.
+  std::string const& name() const { return name_; }
+
+ private:
+  friend class Row;
+  ColumnIndex(std::string name,
+              std::shared_ptr<const std::vector<std::string>> columns,
+              std::size_t pos)
+      : name_(std::move(name)), columns_(std::move(columns)), pos_(pos) {}
+
+  std::string name_;
+  // The columns of the rows where `pos_` is valid, compared by address.
+  std::shared_ptr<const std::vector<std::string>> columns_;
+  std::size_t pos_ = 0;
+};
+
 /**
  * A `Row` is a sequence of columns each with a name and an associated `Value`.
  *
@@ -62,6 +148,13 @@ Row MakeRow(std::vector<Value>,
  * calling `get` with a `std::size_t` 0-indexed position, or a `std::string`
  * column name. Furthermore, callers may directly extract the native C++ type
  * by specifying the C++ type along with the column's position or name.
+ * When the same column is read from many rows, resolve its name only once with
+ * `column_index()`.
+ *
+ * The rows returned by queries and reads are decoded lazily, each column is
+ * converted to its C++ type only when it is accessed. Extracting the native
+ * C++ types with `get<T>()` is therefore the cheapest option, while the first
+ * call to `values()` creates a `Value` for every column.
  *
  * @par Example
  *
@@ -82,12 +175,14 @@ class Row {
 
   /// @name Copy and move.
   ///@{
-  Row(Row const&) = default;
-  Row& operator=(Row const&) = default;
-  Row(Row&&) = default;
-  Row& operator=(Row&&) = default;
+  Row(Row const&);
+  Row& operator=(Row const&);
+  Row(Row&&) noexcept;
+  Row& operator=(Row&&) noexcept;
   ///@}
 
+  ~Row();
+
   /// Returns the number of columns in the row.
   std::size_t size() const { return columns_->size(); }
 
@@ -95,10 +190,10 @@ class Row {
   std::vector<std::string> const& columns() const { return *columns_; }
 
   /// Returns the `Value` objects in the given row.
-  std::vector<Value> const& values() const& { return values_; }
+  std::vector<Value> const& values() const&;
 
   /// Returns the `Value` objects in the given row.
-  std::vector<Value>&& values() && { return std::move(values_); }
+  std::vector<Value>&& values() &&;
 
   /// Returns the `Value` at the given @p pos.
   StatusOr<Value> get(std::size_t pos) const;
@@ -106,17 +201,28 @@ class Row {
   /// Returns the `Value` in the column with @p name
   StatusOr<Value> get(std::string const& name) const;
 
+  /// Returns the `Value` in the column identified by @p index.
+  StatusOr<Value> get(ColumnIndex const& index) const;
+
   /**
-   * Returns the native C++ value at the given position or column name.
+   * Returns a `ColumnIndex` for the column with @p name, which can be used to
+   * get that column from this and any other row in the same result set.
+   */
+  StatusOr<ColumnIndex> column_index(std::string name) const;
+
+  /**
+   * Returns the native C++ value at the given position, column name, or
+   * `ColumnIndex`.
    *
    * @tparam T the native C++ type, e.g., std::int64_t or std::string
-   * @tparam Arg a deduced parameter convertible to a std::size_t or std::string
+   * @tparam Arg a deduced parameter convertible to a std::size_t, std::string,
+   *     or `ColumnIndex`
    */
   template <typename T, typename Arg>
   StatusOr<T> get(Arg&& arg) const {
-    auto v = get(std::forward<Arg>(arg));
-    if (v) return v->template get<T>();
-    return v.status();
+    auto pos = Position(std::forward<Arg>(arg));
+    if (!pos) return std::move(pos).status();
+    return GetAt<T>(*pos);
   }
 
   /**
@@ -132,9 +238,9 @@ class Row {
       return Status(StatusCode::kInvalidArgument, msg);
     }
     Tuple tup;
-    auto it = values_.begin();
+    std::size_t pos = 0;
     Status status;
-    internal::ForEach(tup, ExtractValue{status}, it);
+    internal::ForEach(tup, ExtractValue<Row const&>{*this, status}, pos);
     if (!status.ok()) return status;
     return tup;
   }
@@ -152,9 +258,9 @@ class Row {
       return Status(StatusCode::kInvalidArgument, msg);
     }
     Tuple tup;
-    auto it = std::make_move_iterator(values_.begin());
+    std::size_t pos = 0;
     Status status;
-    internal::ForEach(tup, ExtractValue{status}, it);
+    internal::ForEach(tup, ExtractValue<Row&&>{std::move(*this), status}, pos);
     if (!status.ok()) return status;
     return tup;
   }
@@ -168,11 +274,18 @@ class Row {
  private:
   friend Row internal::MakeRow(std::vector<Value>,
                                std::shared_ptr<const std::vector<std::string>>);
+  friend Row internal::MakeRow(
+      std::vector<google::protobuf::Value>,
+      std::shared_ptr<internal::ColumnTypes const>,
+      std::shared_ptr<const std::vector<std::string>>,
+      std::shared_ptr<internal::ColumnPositions const>);
+  template <typename R>
   struct ExtractValue {
+    R&& row;
     Status& status;
-    template <typename T, typename It>
-    void operator()(T& t, It& it) const {
-      auto x = it++->template get<T>();
+    template <typename T>
+    void operator()(T& t, std::size_t& pos) const {
+      auto x = std::forward<R>(row).template GetAt<T>(pos++);
       if (!x) {
         status = std::move(x).status();
       } else {
@@ -190,8 +303,48 @@ class Row {
   Row(std::vector<Value> values,
       std::shared_ptr<const std::vector<std::string>> columns);
 
+  /**
+   * Constructs a `Row` that decodes the @p protos, of the given @p types, only
+   * when they are accessed.
+   *
+   * @note types, columns, and positions must not be nullptr
+   * @note columns.size() must equal types.size() and protos.size()
+   */
+  Row(std::vector<google::protobuf::Value> protos,
+      std::shared_ptr<internal::ColumnTypes const> types,
+      std::shared_ptr<const std::vector<std::string>> columns,
+      std::shared_ptr<internal::ColumnPositions const> positions);
+
+  StatusOr<std::size_t> Position(std::size_t pos) const;
+  StatusOr<std::size_t> Position(std::string const& name) const;
+  StatusOr<std::size_t> Position(ColumnIndex const& index) const;
+
+  // Decodes the column at `pos`, which must be in range.
+  template <typename T>
+  StatusOr<T> GetAt(std::size_t pos) const& {
+    if (!types_) return values_[pos].template get<T>();
+    return internal::ValueAccess::Get<T>(protos_[pos], *(*types_)[pos]);
+  }
+  template <typename T>
+  StatusOr<T> GetAt(std::size_t pos) && {
+    if (!types_) return std::move(values_[pos]).template get<T>();
+    return internal::ValueAccess::Get<T>(std::move(protos_[pos]),
+                                         *(*types_)[pos]);
+  }
+
+  // A lazily decoded row has `types_`, and keeps its cells in `protos_`. The
+  // first call to `values()` creates the `Value`s, from copies of `protos_`,
+  // and publishes them in `lazy_values_`. A concurrent call may create them
+  // too, but only one is published, so there is no need for a lock. Rows that
+  // are not lazy keep their cells in `values_`, and `protos_` is empty.
+  std::vector<google::protobuf::Value> protos_;
+  std::shared_ptr<internal::ColumnTypes const> types_;
+  mutable std::atomic<std::vector<Value>*> lazy_values_{nullptr};  // owned
   std::vector<Value> values_;
   std::shared_ptr<const std::vector<std::string>> columns_;
+  // Shared by all the rows of a result set, `nullptr` in rows created from
+  // `Value` objects, which look up names with a linear search instead.
+  std::shared_ptr<internal::ColumnPositions const> positions_;
 };
 
 /**
@@ -269,6 +422,15 @@ class RowStreamIterator {
    */
   explicit RowStreamIterator(Source source);
 
+  /**
+   * Constructs a `RowStreamIterator` that will consume rows from the given
+   * @p source, which must not be `nullptr`.
+   *
+   * The rows may also be consumed as protos from @p proto_source, which must
+   * read from the same stream as @p source. It may be `nullptr`.
+   */
+  RowStreamIterator(Source source, internal::ProtoRowSource* proto_source);
+
   reference operator*() { return row_; }
   pointer operator->() { return &row_; }
 
@@ -282,8 +444,12 @@ class RowStreamIterator {
   friend bool operator!=(RowStreamIterator const&, RowStreamIterator const&);
 
  private:
+  template <typename Tuple>
+  friend class TupleStreamIterator;
+
   value_type row_;
   Source source_;  // nullptr means "end"
+  internal::ProtoRowSource* proto_source_ = nullptr;
 };
 
 /**
@@ -326,6 +492,7 @@ class TupleStreamIterator {
   TupleStreamIterator(RowStreamIterator begin, RowStreamIterator end)
       : it_(std::move(begin)), end_(std::move(end)) {
     ParseTuple();
+    if (it_ != end_) row_type_ = MatchingRowType(it_.proto_source_);
   }
 
   reference operator*() { return tup_; }
@@ -339,6 +506,10 @@ class TupleStreamIterator {
       it_ = end_;
       return *this;
     }
+    if (row_type_ != nullptr) {
+      DecodeTuple();
+      return *this;
+    }
     ++it_;
     ParseTuple();
     return *this;
@@ -366,9 +537,75 @@ class TupleStreamIterator {
     tup_ = *it_ ? std::move(*it_)->template get<Tuple>() : it_->status();
   }
 
+  // Returns the row type of `source` if every column can be decoded into the
+  // corresponding `Tuple` element, and `nullptr` otherwise. The check is done
+  // once, so the rows that follow skip the `Row` and `Value` objects and
+  // their per-cell type checks.
+  static google::spanner::v1::StructType const* MatchingRowType(
+      internal::ProtoRowSource* source) {
+    if (source == nullptr) return nullptr;
+    auto const* row_type = source->RowType();
+    if (row_type == nullptr) return nullptr;
+    auto const size = static_cast<std::size_t>(row_type->fields_size());
+    if (size != std::tuple_size<Tuple>::value) return nullptr;
+    bool matches = true;
+    auto field = row_type->fields().begin();
+    internal::ForEach(Tuple{}, CheckType{matches}, field);
+    return matches ? row_type : nullptr;
+  }
+
+  void DecodeTuple() {
+    auto next = it_.proto_source_->NextRowProtos(protos_);
+    if (!next) {
+      tup_ = std::move(next).status();
+      return;
+    }
+    if (!*next) {
+      it_ = end_;
+      return;
+    }
+    Tuple tup;
+    Status status;
+    auto field = row_type_->fields().begin();
+    auto proto = protos_.begin();
+    internal::ForEach(tup, DecodeValue{status}, field, proto);
+    if (!status.ok()) {
+      tup_ = std::move(status);
+      return;
+    }
+    tup_ = std::move(tup);
+  }
+
+  struct CheckType {
+    bool& matches;
+    template <typename T, typename It>
+    void operator()(T const&, It& field) const {
+      matches = matches && internal::ValueAccess::TypeProtoIs<T>(
+                               field++->type());
+    }
+  };
+
+  struct DecodeValue {
+    Status& status;
+    template <typename T, typename FieldIt, typename ProtoIt>
+    void operator()(T& t, FieldIt& field, ProtoIt& proto) const {
+      auto const& type = field++->type();
+      auto& pv = **proto++;
+      if (!status.ok()) return;
+      auto x = internal::ValueAccess::GetValue<T>(std::move(pv), type);
+      if (!x) {
+        status = std::move(x).status();
+      } else {
+        t = *std::move(x);
+      }
+    }
+  };
+
   value_type tup_;
   RowStreamIterator it_;
   RowStreamIterator end_;
+  google::spanner::v1::StructType const* row_type_ = nullptr;
+  std::vector<google::protobuf::Value*> protos_;
 };
 
 /**
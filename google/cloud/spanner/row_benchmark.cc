@@ -14,6 +14,11 @@
 
 #include "google/cloud/spanner/row.h"
 #include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -58,6 +63,62 @@ void BM_RowGetByColumnName(benchmark::State& state) {
 }
 BENCHMARK(BM_RowGetByColumnName);
 
+// Returns a row with `state.range(0)` INT64 columns, named "c0", "c1", etc.
+// Rows created by queries find their columns with a hash index, while rows
+// created from `Value` objects use a linear search.
+Row MakeWideRow(benchmark::State const& state, bool from_query) {
+  auto const count = static_cast<std::size_t>(state.range(0));
+  std::vector<std::pair<std::string, Value>> pairs;
+  for (std::size_t i = 0; i != count; ++i) {
+    pairs.emplace_back("c" + std::to_string(i),
+                       Value(static_cast<std::int64_t>(i)));
+  }
+  if (!from_query) return MakeTestRow(std::move(pairs));
+
+  auto columns = std::make_shared<std::vector<std::string>>();
+  auto types = std::make_shared<internal::ColumnTypes>();
+  std::vector<google::protobuf::Value> protos;
+  for (auto& p : pairs) {
+    auto tv = internal::ToProto(std::move(p.second));
+    columns->push_back(std::move(p.first));
+    types->push_back(std::make_shared<google::spanner::v1::Type const>(
+        std::move(tv.first)));
+    protos.push_back(std::move(tv.second));
+  }
+  auto positions = internal::MakeColumnPositions(*columns);
+  return internal::MakeRow(std::move(protos), std::move(types),
+                           std::move(columns), std::move(positions));
+}
+
+// Reads the last column, the worst case for a linear search.
+void BM_RowGetWideByColumnNameLinear(benchmark::State& state) {
+  Row row = MakeWideRow(state, false);
+  auto const name = "c" + std::to_string(state.range(0) - 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(row.get<std::int64_t>(name));
+  }
+}
+BENCHMARK(BM_RowGetWideByColumnNameLinear)->Arg(10)->Arg(200);
+
+void BM_RowGetWideByColumnNameHashed(benchmark::State& state) {
+  Row row = MakeWideRow(state, true);
+  auto const name = "c" + std::to_string(state.range(0) - 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(row.get<std::int64_t>(name));
+  }
+}
+BENCHMARK(BM_RowGetWideByColumnNameHashed)->Arg(10)->Arg(200);
+
+void BM_RowGetWideByColumnIndex(benchmark::State& state) {
+  Row row = MakeWideRow(state, true);
+  auto const index =
+      row.column_index("c" + std::to_string(state.range(0) - 1)).value();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(row.get<std::int64_t>(index));
+  }
+}
+BENCHMARK(BM_RowGetWideByColumnIndex)->Arg(10)->Arg(200);
+
 }  // namespace
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner
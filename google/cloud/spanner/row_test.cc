@@ -15,8 +15,12 @@
 #include "google/cloud/spanner/row.h"
 #include "google/cloud/testing_util/assert_ok.h"
 #include <gmock/gmock.h>
+#include <memory>
+#include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -44,6 +48,65 @@ RowStreamIterator::Source MakeRowStreamIteratorSource(
       std::vector<StatusOr<Row>>(rows.begin(), rows.end()));
 }
 
+// A `ProtoRowSource` that returns the protos of the given rows. The row type
+// is taken from the first row.
+class FakeProtoRowSource : public internal::ProtoRowSource {
+ public:
+  explicit FakeProtoRowSource(std::vector<Row> const& rows) {
+    for (auto const& row : rows) {
+      std::vector<google::protobuf::Value> protos;
+      for (auto const& v : row.values()) {
+        protos.push_back(internal::ToProto(v).second);
+      }
+      rows_.push_back(std::move(protos));
+    }
+    if (rows.empty()) return;
+    for (std::size_t i = 0; i != rows[0].size(); ++i) {
+      auto& field = *row_type_.add_fields();
+      field.set_name(rows[0].columns()[i]);
+      *field.mutable_type() = internal::ToProto(rows[0].values()[i]).first;
+    }
+  }
+
+  google::spanner::v1::StructType const* RowType() override {
+    return &row_type_;
+  }
+
+  StatusOr<bool> NextRowProtos(
+      std::vector<google::protobuf::Value*>& values) override {
+    ++calls_;
+    if (index_ == rows_.size()) return false;
+    values.clear();
+    for (auto& v : rows_[index_]) values.push_back(&v);
+    ++index_;
+    return true;
+  }
+
+  int calls() const { return calls_; }
+
+ private:
+  google::spanner::v1::StructType row_type_;
+  std::vector<std::vector<google::protobuf::Value>> rows_;
+  std::size_t index_ = 0;
+  int calls_ = 0;
+};
+
+// Returns a lazily decoded copy of `row`, like the rows returned by queries.
+Row MakeLazyRow(Row const& row) {
+  std::vector<google::protobuf::Value> protos;
+  auto types = std::make_shared<internal::ColumnTypes>();
+  for (auto const& v : row.values()) {
+    auto p = internal::ToProto(v);
+    types->push_back(std::make_shared<google::spanner::v1::Type const>(
+        std::move(p.first)));
+    protos.push_back(std::move(p.second));
+  }
+  return internal::MakeRow(
+      std::move(protos), std::move(types),
+      std::make_shared<std::vector<std::string>>(row.columns()),
+      internal::MakeColumnPositions(row.columns()));
+}
+
 class RowRange {
  public:
   explicit RowRange(RowStreamIterator::Source s) : s_(std::move(s)) {}
@@ -187,6 +250,145 @@ TEST(Row, TemplatedGetAsTuple) {
   EXPECT_EQ(std::make_tuple(1, "blah", true), *std::move(row).get<RowType>());
 }
 
+TEST(Row, LazyTemplatedGet) {
+  Row const row = MakeLazyRow(
+      MakeTestRow({{"a", Value(1)}, {"b", Value("blah")}, {"c", Value(true)}}));
+  EXPECT_EQ(3, row.size());
+  EXPECT_EQ(1, *row.get<std::int64_t>(0));
+  EXPECT_EQ("blah", *row.get<std::string>(1));
+  EXPECT_EQ(true, *row.get<bool>("c"));
+  EXPECT_EQ("blah", *row.get<std::string>("b"));
+  EXPECT_EQ(Value(true), *row.get(2));
+  EXPECT_EQ(Value(1), *row.get("a"));
+
+  EXPECT_THAT(row.get<std::string>(0).status().message(),
+              HasSubstr("wrong type"));
+  EXPECT_THAT(row.get<bool>(3).status().message(), HasSubstr("out of range"));
+  EXPECT_THAT(row.get<bool>("d").status().message(), HasSubstr("not found"));
+  EXPECT_FALSE(row.get(3).ok());
+  EXPECT_FALSE(row.get("d").ok());
+}
+
+TEST(Row, LazyNull) {
+  Row const row = MakeLazyRow(MakeTestRow(MakeNullValue<std::int64_t>()));
+  EXPECT_EQ(optional<std::int64_t>(), *row.get<optional<std::int64_t>>(0));
+  EXPECT_THAT(row.get<std::int64_t>(0).status().message(),
+              HasSubstr("null value"));
+}
+
+TEST(Row, LazyGetAsTuple) {
+  Row row = MakeLazyRow(MakeTestRow(1, "blah", true));
+
+  using RowType = std::tuple<std::int64_t, std::string, bool>;
+  EXPECT_EQ(std::make_tuple(1, "blah", true), *row.get<RowType>());
+
+  using WrongType = std::tuple<std::int64_t, std::string, std::int64_t>;
+  EXPECT_FALSE(row.get<WrongType>().ok());
+
+  EXPECT_EQ(std::make_tuple(1, "blah", true), *std::move(row).get<RowType>());
+}
+
+TEST(Row, LazyValues) {
+  Row const expected = MakeTestRow(1, "blah", MakeNullValue<bool>());
+  Row const row = MakeLazyRow(expected);
+  EXPECT_EQ(expected.values(), row.values());
+  EXPECT_EQ(expected, row);
+  EXPECT_EQ(row, expected);
+  // The values are still available to the typed accessors.
+  EXPECT_EQ("blah", *row.get<std::string>(1));
+
+  Row copy = row;
+  EXPECT_EQ(expected, copy);
+  Row lazy = MakeLazyRow(expected);
+  EXPECT_EQ(expected.values(), std::move(lazy).values());
+}
+
+TEST(Row, LazyValuesConcurrent) {
+  Row const expected = MakeTestRow(1, "blah", true);
+  Row const row = MakeLazyRow(expected);
+
+  // Every thread gets the same `Value`s, whichever thread created them.
+  std::vector<std::vector<Value> const*> results(8);
+  std::vector<std::thread> threads;
+  for (auto& r : results) {
+    threads.emplace_back([&row, &r] { r = &row.values(); });
+  }
+  for (auto& t : threads) t.join();
+  for (auto const* r : results) {
+    EXPECT_EQ(results[0], r);
+    EXPECT_EQ(expected.values(), *r);
+  }
+}
+
+TEST(Row, LazyValueSemantics) {
+  Row const row = MakeLazyRow(MakeTestRow(1, "blah", true));
+
+  Row copy = row;
+  EXPECT_EQ(copy, row);
+  EXPECT_EQ(1, *copy.get<std::int64_t>(0));
+
+  copy = MakeTestRow(2, "foo", false);
+  EXPECT_NE(copy, row);
+  copy = row;
+  EXPECT_EQ(copy, row);
+
+  Row moved = std::move(copy);
+  EXPECT_EQ(moved, row);
+  EXPECT_EQ("blah", *moved.get<std::string>(1));
+}
+
+TEST(Row, ColumnIndex) {
+  Row const row = MakeTestRow({{"a", Value(1)}, {"b", Value("blah")}});
+  auto b = row.column_index("b");
+  ASSERT_STATUS_OK(b);
+  EXPECT_EQ("b", b->name());
+  EXPECT_EQ(Value("blah"), *row.get(*b));
+  EXPECT_EQ("blah", *row.get<std::string>(*b));
+  EXPECT_FALSE(row.get<std::int64_t>(*b).ok());
+
+  auto missing = row.column_index("c");
+  EXPECT_THAT(missing.status().message(), HasSubstr("not found"));
+  EXPECT_FALSE(row.get(ColumnIndex("c")).ok());
+
+  // An unresolved index, or one from a different row, looks up the name.
+  Row const other = MakeTestRow({{"b", Value(42)}, {"a", Value(2)}});
+  EXPECT_EQ(42, *other.get<std::int64_t>(*b));
+  EXPECT_EQ(2, *other.get<std::int64_t>(ColumnIndex("a")));
+}
+
+TEST(Row, ColumnIndexSharedColumns) {
+  // Rows from the same result set share their columns and positions.
+  auto columns = std::make_shared<std::vector<std::string>>(
+      std::vector<std::string>{"a", "b", "a"});
+  auto positions = internal::MakeColumnPositions(*columns);
+  auto const int64_type = std::make_shared<google::spanner::v1::Type const>(
+      internal::ToProto(Value(0)).first);
+  auto types = std::make_shared<internal::ColumnTypes>(3, int64_type);
+  std::vector<Row> rows;
+  for (std::int64_t i = 0; i != 3; ++i) {
+    std::vector<google::protobuf::Value> protos;
+    for (auto const& v : {Value(i), Value(10 * i), Value(100 * i)}) {
+      protos.push_back(internal::ToProto(v).second);
+    }
+    rows.push_back(
+        internal::MakeRow(std::move(protos), types, columns, positions));
+  }
+
+  // The first of the duplicate names is used, like a linear search.
+  auto a = rows[0].column_index("a");
+  ASSERT_STATUS_OK(a);
+  auto b = rows[0].column_index("b");
+  ASSERT_STATUS_OK(b);
+  for (std::int64_t i = 0; i != 3; ++i) {
+    auto const& row = rows[static_cast<std::size_t>(i)];
+    EXPECT_EQ(i, *row.get<std::int64_t>(*a));
+    EXPECT_EQ(i, *row.get<std::int64_t>("a"));
+    EXPECT_EQ(10 * i, *row.get<std::int64_t>(*b));
+    EXPECT_EQ(10 * i, *row.get<std::int64_t>("b"));
+  }
+  EXPECT_FALSE(rows[0].get("c").ok());
+}
+
 TEST(MakeTestRow, ExplicitColumNames) {
   auto row = MakeTestRow({{"a", Value(42)}, {"b", Value(52)}});
   EXPECT_EQ(Value(42), *row.get("a"));
@@ -402,6 +604,87 @@ TEST(TupleStreamIterator, Error) {
   EXPECT_EQ(it, end);
 }
 
+TEST(TupleStreamIterator, ProtoRowSource) {
+  std::vector<Row> rows;
+  rows.emplace_back(MakeTestRow(1, "foo", true));
+  rows.emplace_back(MakeTestRow(2, "bar", MakeNullValue<bool>()));
+  rows.emplace_back(MakeTestRow(3, "baz", true));
+
+  // The first row comes from the `RowStreamIterator::Source`, the rest are
+  // decoded from the protos.
+  FakeProtoRowSource protos({rows[1], rows[2]});
+  using RowType = std::tuple<std::int64_t, std::string, optional<bool>>;
+  using TupleIterator = TupleStreamIterator<RowType>;
+  auto source = MakeRowStreamIteratorSource(std::vector<Row>{rows[0]});
+  auto it = TupleIterator(RowStreamIterator(std::move(source), &protos),
+                          RowStreamIterator());
+  auto end = TupleIterator();
+
+  ASSERT_NE(it, end);
+  ASSERT_STATUS_OK(*it);
+  EXPECT_EQ(std::make_tuple(1, "foo", true), **it);
+
+  ++it;
+  ASSERT_NE(it, end);
+  ASSERT_STATUS_OK(*it);
+  EXPECT_EQ(std::make_tuple(2, "bar", optional<bool>()), **it);
+
+  ++it;
+  ASSERT_NE(it, end);
+  ASSERT_STATUS_OK(*it);
+  EXPECT_EQ(std::make_tuple(3, "baz", true), **it);
+
+  ++it;
+  EXPECT_EQ(it, end);
+  EXPECT_EQ(3, protos.calls());
+}
+
+TEST(TupleStreamIterator, ProtoRowSourceDecodeError) {
+  std::vector<Row> rows;
+  rows.emplace_back(MakeTestRow(1, "foo", true));
+  rows.emplace_back(MakeTestRow(2, "bar", MakeNullValue<bool>()));
+  rows.emplace_back(MakeTestRow(3, "baz", true));
+
+  FakeProtoRowSource protos({rows[1], rows[2]});
+  using RowType = std::tuple<std::int64_t, std::string, bool>;
+  using TupleIterator = TupleStreamIterator<RowType>;
+  auto source = MakeRowStreamIteratorSource(std::vector<Row>{rows[0]});
+  auto it = TupleIterator(RowStreamIterator(std::move(source), &protos),
+                          RowStreamIterator());
+  auto end = TupleIterator();
+
+  ASSERT_STATUS_OK(*it);
+  ++it;
+  ASSERT_NE(it, end);
+  EXPECT_FALSE(it->ok());  // The `bool` column is null.
+
+  ++it;  // Due to the previous error, jumps straight to "end"
+  EXPECT_EQ(it, end);
+  EXPECT_EQ(1, protos.calls());
+}
+
+TEST(TupleStreamIterator, ProtoRowSourceTypeMismatch) {
+  std::vector<Row> rows;
+  rows.emplace_back(MakeTestRow(1, "foo", true));
+  rows.emplace_back(MakeTestRow(2, "bar", true));
+
+  // The row type does not match the tuple, so the protos are never used and
+  // the rows are parsed (and rejected) one by one.
+  FakeProtoRowSource protos(rows);
+  using RowType = std::tuple<std::int64_t, std::string, std::string>;
+  using TupleIterator = TupleStreamIterator<RowType>;
+  auto it = TupleIterator(
+      RowStreamIterator(MakeRowStreamIteratorSource(rows), &protos),
+      RowStreamIterator());
+  auto end = TupleIterator();
+
+  ASSERT_NE(it, end);
+  EXPECT_FALSE(it->ok());
+  ++it;
+  EXPECT_EQ(it, end);
+  EXPECT_EQ(0, protos.calls());
+}
+
 TEST(TupleStream, Basics) {
   std::vector<Row> rows;
   rows.emplace_back(MakeTestRow(1, "foo", true));
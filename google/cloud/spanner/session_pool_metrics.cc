@@ -0,0 +1,42 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/session_pool_metrics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+std::chrono::microseconds LatencyHistogramSnapshot::Percentile(
+    double p) const {
+  if (count == 0 || buckets.empty()) return std::chrono::microseconds(0);
+  p = (std::min)((std::max)(p, 0.0), 1.0);
+  auto const rank = (std::max)(
+      std::int64_t{1},
+      static_cast<std::int64_t>(std::ceil(p * static_cast<double>(count))));
+  std::int64_t seen = 0;
+  for (std::size_t i = 0; i != buckets.size(); ++i) {
+    seen += buckets[i];
+    if (seen >= rank) return UpperBound(i);
+  }
+  return UpperBound(buckets.size() - 1);
+}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,98 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_SESSION_POOL_METRICS_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_SESSION_POOL_METRICS_H
+
+#include "google/cloud/spanner/version.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+/**
+ * A point-in-time copy of a latency histogram with exponentially sized
+ * buckets.
+ *
+ * `buckets[i]` counts the samples below `UpperBound(i)` (and at or above the
+ * previous bound). The last bucket has no upper bound.
+ */
+struct LatencyHistogramSnapshot {
+  std::int64_t count = 0;
+  std::chrono::microseconds sum{0};
+  std::vector<std::int64_t> buckets;
+
+  /// The (exclusive) upper bound of bucket @p i, which is `2^i` microseconds.
+  static std::chrono::microseconds UpperBound(std::size_t i) {
+    return std::chrono::microseconds(std::int64_t{1} << i);
+  }
+
+  /**
+   * Return an upper bound for the @p p percentile (in `[0.0, 1.0]`), i.e.,
+   * the upper bound of the bucket containing that sample. Returns zero if
+   * there are no samples.
+   */
+  std::chrono::microseconds Percentile(double p) const;
+};
+
+/**
+ * A snapshot of the state of the session pool used by a `Connection`, and of
+ * the metrics it collects.
+ *
+ * The counters and histograms are cumulative since the pool was created, so
+ * exporters should compute rates from the difference between snapshots.
+ *
+ * @see `Client::GetSessionPoolMetrics()`
+ */
+struct SessionPoolMetrics {
+  /// The state of a single channel.
+  struct ChannelMetrics {
+    /// The sessions associated with the channel, idle or in use.
+    int session_count = 0;
+    int sessions_in_use = 0;
+    int idle_sessions = 0;
+  };
+
+  int total_sessions = 0;
+  int idle_sessions = 0;
+  int create_calls_in_progress = 0;
+  /// Idle sessions holding a prepared read-write transaction.
+  int prepared_sessions = 0;
+  /// The number of threads blocked waiting for a session.
+  int threads_waiting = 0;
+  /// The number of queued asynchronous requests for a session.
+  int async_waiters = 0;
+  /// One entry per channel (i.e. gRPC connection) used by the pool.
+  std::vector<ChannelMetrics> channels;
+
+  /// The number of times a session was needed while the pool was at its
+  /// maximum size (whether the request then failed or waited).
+  std::int64_t exhaustion_events = 0;
+  /// The time from requesting a session until it (or an error) is returned.
+  LatencyHistogramSnapshot allocation_wait;
+  /// The duration of each `BatchCreateSessions` call, including retries.
+  LatencyHistogramSnapshot creation_latency;
+};
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_SESSION_POOL_METRICS_H
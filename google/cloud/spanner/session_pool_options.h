@@ -29,6 +29,21 @@ inline namespace SPANNER_CLIENT_NS {
 // What action to take if the session pool is exhausted.
 enum class ActionOnExhaustion { kBlock, kFail };
 
+/**
+ * The order in which the session pool hands out idle sessions.
+ *
+ * - `kLifo`: the most recently used session first. The Spanner backends keep
+ *   recently used sessions in a cache, so this is usually the fastest, but a
+ *   pool larger than the working set leaves some sessions idle until they
+ *   need a keep-alive refresh.
+ * - `kFifo`: the least recently used session first, which spreads the load
+ *   over all the sessions, and keeps them all fresh.
+ * - `kThreadAffinity`: the session last released by the calling thread, if it
+ *   is still idle, otherwise the most recently used one. Threads that run one
+ *   transaction at a time tend to reuse the same session.
+ */
+enum class SessionAllocationStrategy { kLifo, kFifo, kThreadAffinity };
+
 /**
  * Controls the session pool maintained by a `spanner::Client`.
  *
@@ -61,6 +76,10 @@ class SessionPoolOptions {
     min_sessions_ =
         (std::min)(min_sessions_, max_sessions_per_channel_ * num_channels);
     max_idle_sessions_ = (std::max)(max_idle_sessions_, 0);
+    demand_window_ = (std::max)(demand_window_, std::chrono::seconds(1));
+    keep_alive_concurrency_ = (std::max)(keep_alive_concurrency_, 1);
+    write_sessions_fraction_ =
+        (std::min)((std::max)(write_sessions_fraction_, 0.0), 1.0);
     return *this;
   }
 
@@ -102,6 +121,18 @@ class SessionPoolOptions {
   /// Return the maximum number of idle sessions to keep in the pool.
   int max_idle_sessions() const { return max_idle_sessions_; }
 
+  /// Set the order in which idle sessions are allocated.
+  SessionPoolOptions& set_allocation_strategy(
+      SessionAllocationStrategy strategy) {
+    allocation_strategy_ = strategy;
+    return *this;
+  }
+
+  /// Return the order in which idle sessions are allocated.
+  SessionAllocationStrategy allocation_strategy() const {
+    return allocation_strategy_;
+  }
+
   /// Set whether to block or fail on pool exhaustion.
   SessionPoolOptions& set_action_on_exhaustion(ActionOnExhaustion action) {
     action_on_exhaustion_ = action;
@@ -132,6 +163,79 @@ class SessionPoolOptions {
     return keep_alive_interval_;
   }
 
+  /**
+   * Set the maximum number of keep-alive requests in flight on each channel.
+   * Sessions that are due for a refresh beyond this limit are refreshed in a
+   * later pass. Values <= 0 are treated as 1.
+   */
+  SessionPoolOptions& set_keep_alive_concurrency(int count) {
+    keep_alive_concurrency_ = count;
+    return *this;
+  }
+
+  /// Return the maximum number of keep-alive requests in flight per channel.
+  int keep_alive_concurrency() const { return keep_alive_concurrency_; }
+
+  /**
+   * Refresh idle sessions by running `SELECT 1` on them (instead of calling
+   * `GetSession`). This also keeps the session warm in the backend.
+   */
+  SessionPoolOptions& set_keep_alive_with_select(bool enabled) {
+    keep_alive_with_select_ = enabled;
+    return *this;
+  }
+
+  /// Return whether idle sessions are refreshed by running `SELECT 1`.
+  bool keep_alive_with_select() const { return keep_alive_with_select_; }
+
+  /**
+   * Enable (or disable) adaptive sizing of the pool.
+   *
+   * When enabled the pool tracks the rate of session allocations and the peak
+   * number of sessions in use over a sliding window (see `demand_window()`).
+   * It creates sessions in the background ahead of the observed demand, so
+   * traffic spikes do not wait for sessions to be created, and shrinks toward
+   * `max_idle_sessions()` after the demand has been low for a full window.
+   * The pool never shrinks below `min_sessions()`.
+   */
+  SessionPoolOptions& set_adaptive_sizing(bool enabled) {
+    adaptive_sizing_ = enabled;
+    return *this;
+  }
+
+  /// Return whether the pool adapts its size to the observed demand.
+  bool adaptive_sizing() const { return adaptive_sizing_; }
+
+  /**
+   * Set the length of the sliding window used to track the demand for
+   * sessions. Values below one second are treated as one second.
+   */
+  SessionPoolOptions& set_demand_window(std::chrono::seconds window) {
+    demand_window_ = window;
+    return *this;
+  }
+
+  /// Return the length of the sliding window used to track the demand.
+  std::chrono::seconds demand_window() const { return demand_window_; }
+
+  /**
+   * Set the fraction of the sessions in the pool that hold a read-write
+   * transaction begun in the background. Values are clamped to `[0.0, 1.0]`.
+   *
+   * The first statement of a read-write transaction that gets one of these
+   * sessions uses the prepared transaction, instead of beginning one inline.
+   * Other operations prefer sessions without a prepared transaction. The
+   * server aborts read-write transactions that stay idle for too long, so
+   * the pool periodically re-prepares the sessions that are not used.
+   */
+  SessionPoolOptions& set_write_sessions_fraction(double fraction) {
+    write_sessions_fraction_ = fraction;
+    return *this;
+  }
+
+  /// Return the fraction of sessions with a prepared read-write transaction.
+  double write_sessions_fraction() const { return write_sessions_fraction_; }
+
   /**
    * Set the labels used when creating sessions within the pool.
    *  * Label keys must match `[a-z]([-a-z0-9]{0,61}[a-z0-9])?`.
@@ -151,7 +255,14 @@ class SessionPoolOptions {
   int max_sessions_per_channel_ = 100;
   int max_idle_sessions_ = 0;
   ActionOnExhaustion action_on_exhaustion_ = ActionOnExhaustion::kBlock;
+  SessionAllocationStrategy allocation_strategy_ =
+      SessionAllocationStrategy::kLifo;
   std::chrono::seconds keep_alive_interval_ = std::chrono::minutes(55);
+  int keep_alive_concurrency_ = 10;
+  bool keep_alive_with_select_ = false;
+  bool adaptive_sizing_ = false;
+  std::chrono::seconds demand_window_ = std::chrono::minutes(5);
+  double write_sessions_fraction_ = 0.0;
   std::map<std::string, std::string> labels_;
 };
 
@@ -42,6 +42,32 @@ TEST(SessionPoolOptionsTest, MaxIdleSessions) {
   EXPECT_EQ(0, options.max_idle_sessions());
 }
 
+TEST(SessionPoolOptionsTest, DemandWindow) {
+  SessionPoolOptions options;
+  EXPECT_FALSE(options.adaptive_sizing());
+  options.set_demand_window(std::chrono::seconds(0))
+      .EnforceConstraints(/*num_channels=*/1);
+  EXPECT_EQ(std::chrono::seconds(1), options.demand_window());
+}
+
+TEST(SessionPoolOptionsTest, KeepAliveConcurrency) {
+  SessionPoolOptions options;
+  options.set_keep_alive_concurrency(0).EnforceConstraints(
+      /*num_channels=*/1);
+  EXPECT_EQ(1, options.keep_alive_concurrency());
+}
+
+TEST(SessionPoolOptionsTest, WriteSessionsFraction) {
+  SessionPoolOptions options;
+  EXPECT_EQ(0.0, options.write_sessions_fraction());
+  options.set_write_sessions_fraction(-0.5).EnforceConstraints(
+      /*num_channels=*/1);
+  EXPECT_EQ(0.0, options.write_sessions_fraction());
+  options.set_write_sessions_fraction(1.5).EnforceConstraints(
+      /*num_channels=*/1);
+  EXPECT_EQ(1.0, options.write_sessions_fraction());
+}
+
 TEST(SessionPoolOptionsTest, MaxMinSessionsConflict) {
   SessionPoolOptions options;
   options.set_min_sessions(10)
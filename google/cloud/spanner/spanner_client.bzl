@@ -17,15 +17,18 @@
 """Automatically generated source lists for spanner_client - DO NOT EDIT."""
 
 spanner_client_hdrs = [
+    "background_thread_pool.h",
     "backoff_policy.h",
     "backup.h",
     "batch_dml_result.h",
     "bytes.h",
     "client.h",
     "client_options.h",
+    "column_batch.h",
     "commit_result.h",
     "connection.h",
     "connection_options.h",
+    "coroutine.h",
     "create_instance_request_builder.h",
     "database.h",
     "database_admin_client.h",
@@ -36,6 +39,9 @@ spanner_client_hdrs = [
     "instance_admin_client.h",
     "instance_admin_connection.h",
     "internal/api_client_header.h",
+    "internal/async_partial_result_set_reader.h",
+    "internal/async_polling_loop.h",
+    "internal/async_retry_loop.h",
     "internal/build_info.h",
     "internal/channel.h",
     "internal/clock.h",
@@ -48,11 +54,13 @@ spanner_client_hdrs = [
     "internal/instance_admin_logging.h",
     "internal/instance_admin_metadata.h",
     "internal/instance_admin_stub.h",
+    "internal/latency_histogram.h",
     "internal/log_wrapper.h",
     "internal/logging_result_set_reader.h",
     "internal/logging_spanner_stub.h",
     "internal/merge_chunk.h",
     "internal/metadata_spanner_stub.h",
+    "internal/numeric_parse.h",
     "internal/partial_result_set_reader.h",
     "internal/partial_result_set_resume.h",
     "internal/partial_result_set_source.h",
@@ -78,6 +86,7 @@ spanner_client_hdrs = [
     "results.h",
     "retry_policy.h",
     "row.h",
+    "session_pool_metrics.h",
     "session_pool_options.h",
     "sql_statement.h",
     "timestamp.h",
@@ -90,9 +99,12 @@ spanner_client_hdrs = [
 ]
 
 spanner_client_srcs = [
+    "background_thread_pool.cc",
     "backup.cc",
     "bytes.cc",
     "client.cc",
+    "column_batch.cc",
+    "connection.cc",
     "connection_options.cc",
     "database.cc",
     "database_admin_client.cc",
@@ -102,6 +114,8 @@ spanner_client_srcs = [
     "instance_admin_client.cc",
     "instance_admin_connection.cc",
     "internal/api_client_header.cc",
+    "internal/async_partial_result_set_reader.cc",
+    "internal/async_polling_loop.cc",
     "internal/compiler_info.cc",
     "internal/connection_impl.cc",
     "internal/database_admin_logging.cc",
@@ -111,11 +125,13 @@ spanner_client_srcs = [
     "internal/instance_admin_logging.cc",
     "internal/instance_admin_metadata.cc",
     "internal/instance_admin_stub.cc",
+    "internal/latency_histogram.cc",
     "internal/log_wrapper.cc",
     "internal/logging_result_set_reader.cc",
     "internal/logging_spanner_stub.cc",
     "internal/merge_chunk.cc",
     "internal/metadata_spanner_stub.cc",
+    "internal/numeric_parse.cc",
     "internal/partial_result_set_resume.cc",
     "internal/partial_result_set_source.cc",
     "internal/retry_loop.cc",
@@ -132,6 +148,7 @@ spanner_client_srcs = [
     "read_partition.cc",
     "results.cc",
     "row.cc",
+    "session_pool_metrics.cc",
     "sql_statement.cc",
     "timestamp.cc",
     "transaction.cc",
@@ -20,6 +20,9 @@ spanner_client_benchmarks = [
     "bytes_benchmark.cc",
     "internal/date_benchmark.cc",
     "internal/merge_chunk_benchmark.cc",
+    "internal/numeric_parse_benchmark.cc",
+    "internal/partial_result_set_source_benchmark.cc",
+    "internal/session_pool_benchmark.cc",
     "internal/time_format_benchmark.cc",
     "row_benchmark.cc",
 ]
@@ -17,11 +17,14 @@
 """Automatically generated unit tests list - DO NOT EDIT."""
 
 spanner_client_unit_tests = [
+    "background_thread_pool_test.cc",
     "backup_test.cc",
     "bytes_test.cc",
     "client_options_test.cc",
     "client_test.cc",
+    "column_batch_test.cc",
     "connection_options_test.cc",
+    "coroutine_test.cc",
     "create_instance_request_builder_test.cc",
     "database_admin_client_test.cc",
     "database_admin_connection_test.cc",
@@ -31,6 +34,9 @@ spanner_client_unit_tests = [
     "instance_admin_connection_test.cc",
     "instance_test.cc",
     "internal/api_client_header_test.cc",
+    "internal/async_partial_result_set_reader_test.cc",
+    "internal/async_polling_loop_test.cc",
+    "internal/async_retry_loop_test.cc",
     "internal/build_info_test.cc",
     "internal/clock_test.cc",
     "internal/compiler_info_test.cc",
@@ -40,11 +46,13 @@ spanner_client_unit_tests = [
     "internal/date_test.cc",
     "internal/instance_admin_logging_test.cc",
     "internal/instance_admin_metadata_test.cc",
+    "internal/latency_histogram_test.cc",
     "internal/log_wrapper_test.cc",
     "internal/logging_result_set_reader_test.cc",
     "internal/logging_spanner_stub_test.cc",
     "internal/merge_chunk_test.cc",
     "internal/metadata_spanner_stub_test.cc",
+    "internal/numeric_parse_test.cc",
     "internal/partial_result_set_resume_test.cc",
     "internal/partial_result_set_source_test.cc",
     "internal/polling_loop_test.cc",
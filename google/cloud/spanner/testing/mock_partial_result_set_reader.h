@@ -30,6 +30,7 @@ class MockPartialResultSetReader
   MOCK_METHOD0(TryCancel, void());
   MOCK_METHOD0(Read, optional<google::spanner::v1::PartialResultSet>());
   MOCK_METHOD0(Finish, Status());
+  MOCK_METHOD0(WhenReadable, future<void>());
 };
 
 }  // namespace SPANNER_CLIENT_NS
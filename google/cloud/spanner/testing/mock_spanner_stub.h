@@ -75,12 +75,26 @@ class MockSpannerStub : public google::cloud::spanner::internal::SpannerStub {
                                grpc::ClientContext&,
                                google::spanner::v1::ExecuteSqlRequest const&));
 
+  MOCK_METHOD3(AsyncExecuteSql,
+               std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+                   google::spanner::v1::ResultSet>>(
+                   grpc::ClientContext&,
+                   google::spanner::v1::ExecuteSqlRequest const&,
+                   grpc::CompletionQueue*));
+
   MOCK_METHOD2(
       ExecuteStreamingSql,
       std::unique_ptr<
           grpc::ClientReaderInterface<google::spanner::v1::PartialResultSet>>(
           grpc::ClientContext&, google::spanner::v1::ExecuteSqlRequest const&));
 
+  MOCK_METHOD3(PrepareAsyncExecuteStreamingSql,
+               std::unique_ptr<grpc::ClientAsyncReaderInterface<
+                   google::spanner::v1::PartialResultSet>>(
+                   grpc::ClientContext&,
+                   google::spanner::v1::ExecuteSqlRequest const&,
+                   grpc::CompletionQueue*));
+
   MOCK_METHOD2(ExecuteBatchDml,
                StatusOr<google::spanner::v1::ExecuteBatchDmlResponse>(
                    grpc::ClientContext&,
@@ -96,18 +110,46 @@ class MockSpannerStub : public google::cloud::spanner::internal::SpannerStub {
           grpc::ClientReaderInterface<google::spanner::v1::PartialResultSet>>(
           grpc::ClientContext&, google::spanner::v1::ReadRequest const&));
 
+  MOCK_METHOD3(PrepareAsyncStreamingRead,
+               std::unique_ptr<grpc::ClientAsyncReaderInterface<
+                   google::spanner::v1::PartialResultSet>>(
+                   grpc::ClientContext&,
+                   google::spanner::v1::ReadRequest const&,
+                   grpc::CompletionQueue*));
+
   MOCK_METHOD2(BeginTransaction,
                StatusOr<google::spanner::v1::Transaction>(
                    grpc::ClientContext&,
                    google::spanner::v1::BeginTransactionRequest const&));
 
+  MOCK_METHOD3(AsyncBeginTransaction,
+               std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+                   google::spanner::v1::Transaction>>(
+                   grpc::ClientContext&,
+                   google::spanner::v1::BeginTransactionRequest const&,
+                   grpc::CompletionQueue*));
+
   MOCK_METHOD2(Commit, StatusOr<google::spanner::v1::CommitResponse>(
                            grpc::ClientContext&,
                            google::spanner::v1::CommitRequest const&));
 
+  MOCK_METHOD3(AsyncCommit,
+               std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+                   google::spanner::v1::CommitResponse>>(
+                   grpc::ClientContext&,
+                   google::spanner::v1::CommitRequest const&,
+                   grpc::CompletionQueue*));
+
   MOCK_METHOD2(Rollback, Status(grpc::ClientContext&,
                                 google::spanner::v1::RollbackRequest const&));
 
+  MOCK_METHOD3(
+      AsyncRollback,
+      std::unique_ptr<
+          grpc::ClientAsyncResponseReaderInterface<google::protobuf::Empty>>(
+          grpc::ClientContext&, google::spanner::v1::RollbackRequest const&,
+          grpc::CompletionQueue*));
+
   MOCK_METHOD2(PartitionQuery,
                StatusOr<google::spanner::v1::PartitionResponse>(
                    grpc::ClientContext&,
@@ -14,11 +14,9 @@
 
 #include "google/cloud/spanner/value.h"
 #include "google/cloud/spanner/internal/date.h"
+#include "google/cloud/spanner/internal/numeric_parse.h"
 #include "google/cloud/log.h"
-#include <cerrno>
 #include <cmath>
-#include <cstdlib>
-#include <cstring>
 #include <ios>
 #include <string>
 
@@ -180,21 +178,78 @@ std::ostream& StreamHelper(std::ostream& os, google::protobuf::Value const& v,
 namespace internal {
 
 Value FromProto(google::spanner::v1::Type t, google::protobuf::Value v) {
+  return Value(std::make_shared<google::spanner::v1::Type const>(std::move(t)),
+               std::move(v));
+}
+
+Value FromProto(std::shared_ptr<google::spanner::v1::Type const> t,
+                google::protobuf::Value v) {
   return Value(std::move(t), std::move(v));
 }
 
 std::pair<google::spanner::v1::Type, google::protobuf::Value> ToProto(Value v) {
-  return std::make_pair(std::move(v.type_), std::move(v.value_));
+  return std::make_pair(v.type_proto(), std::move(v.value_));
 }
 
 }  // namespace internal
 
 bool operator==(Value const& a, Value const& b) {
-  return Equal(a.type_, a.value_, b.type_, b.value_);
+  return Equal(a.type_proto(), a.value_, b.type_proto(), b.value_);
 }
 
 std::ostream& operator<<(std::ostream& os, Value const& v) {
-  return StreamHelper(os, v.value_, v.type_, StreamMode::kScalar);
+  return StreamHelper(os, v.value_, v.type_proto(), StreamMode::kScalar);
+}
+
+google::spanner::v1::Type const& Value::type_proto() const {
+  if (type_) return *type_;
+  static auto const* const kDefault = new google::spanner::v1::Type;
+  return *kDefault;
+}
+
+//
+// Value::MakeSharedTypeProto
+//
+
+Value::SharedType Value::MakeSharedTypeProto(bool) {
+  static auto const kType = MakeSharedTypeProto<bool>(bool{});
+  return kType;
+}
+
+Value::SharedType Value::MakeSharedTypeProto(std::int64_t) {
+  static auto const kType = MakeSharedTypeProto<std::int64_t>(0);
+  return kType;
+}
+
+Value::SharedType Value::MakeSharedTypeProto(double) {
+  static auto const kType = MakeSharedTypeProto<double>(0.0);
+  return kType;
+}
+
+Value::SharedType Value::MakeSharedTypeProto(std::string const&) {
+  static auto const kType = MakeSharedTypeProto<std::string>(std::string{});
+  return kType;
+}
+
+Value::SharedType Value::MakeSharedTypeProto(Bytes const&) {
+  static auto const kType = MakeSharedTypeProto<Bytes>(Bytes{});
+  return kType;
+}
+
+Value::SharedType Value::MakeSharedTypeProto(Timestamp) {
+  static auto const kType = MakeSharedTypeProto<Timestamp>(Timestamp{});
+  return kType;
+}
+
+Value::SharedType Value::MakeSharedTypeProto(CommitTimestamp) {
+  static auto const kType =
+      MakeSharedTypeProto<CommitTimestamp>(CommitTimestamp{});
+  return kType;
+}
+
+Value::SharedType Value::MakeSharedTypeProto(Date) {
+  static auto const kType = MakeSharedTypeProto<Date>(Date{});
+  return kType;
 }
 
 //
@@ -379,21 +434,7 @@ StatusOr<std::int64_t> Value::GetValue(std::int64_t,
   if (pv.kind_case() != google::protobuf::Value::kStringValue) {
     return Status(StatusCode::kUnknown, "missing INT64");
   }
-  auto const& s = pv.string_value();
-  char* end = nullptr;
-  errno = 0;
-  std::int64_t x = {std::strtoll(s.c_str(), &end, 10)};
-  if (errno != 0) {
-    auto const err = std::string(std::strerror(errno));
-    return Status(StatusCode::kUnknown, err + ": \"" + s + "\"");
-  }
-  if (end == s.c_str()) {
-    return Status(StatusCode::kUnknown, "No numeric conversion: \"" + s + "\"");
-  }
-  if (*end != '\0') {
-    return Status(StatusCode::kUnknown, "Trailing data: \"" + s + "\"");
-  }
-  return x;
+  return internal::ParseInt64(pv.string_value());
 }
 
 StatusOr<double> Value::GetValue(double, google::protobuf::Value const& pv,
@@ -404,12 +445,7 @@ StatusOr<double> Value::GetValue(double, google::protobuf::Value const& pv,
   if (pv.kind_case() != google::protobuf::Value::kStringValue) {
     return Status(StatusCode::kUnknown, "missing FLOAT64");
   }
-  std::string const& s = pv.string_value();
-  auto const inf = std::numeric_limits<double>::infinity();
-  if (s == "-Infinity") return -inf;
-  if (s == "Infinity") return inf;
-  if (s == "NaN") return std::nan("");
-  return Status(StatusCode::kUnknown, "bad FLOAT64 data: \"" + s + "\"");
+  return internal::ParseFloat64(pv.string_value());
 }
 
 StatusOr<std::string> Value::GetValue(std::string const&,
@@ -26,6 +26,7 @@
 #include <google/protobuf/struct.pb.h>
 #include <google/protobuf/util/message_differencer.h>
 #include <google/spanner/v1/type.pb.h>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <tuple>
@@ -42,7 +43,10 @@ class Value;  // Defined later in this file.
 // Internal implementation details that callers should not use.
 namespace internal {
 Value FromProto(google::spanner::v1::Type t, google::protobuf::Value v);
+Value FromProto(std::shared_ptr<google::spanner::v1::Type const> t,
+                google::protobuf::Value v);
 std::pair<google::spanner::v1::Type, google::protobuf::Value> ToProto(Value v);
+struct ValueAccess;
 }  // namespace internal
 
 /**
@@ -69,6 +73,12 @@ std::pair<google::spanner::v1::Type, google::protobuf::Value> ToProto(Value v);
  * [1] The type `T` may be any of the other supported types, except for
  *     ARRAY/`std::vector`.
  *
+ * Spanner sends INT64 values, and non-finite FLOAT64 values, as strings. An
+ * INT64 string must be an optional sign followed by decimal digits, and a
+ * FLOAT64 string must be one of "NaN", "Infinity", or "-Infinity". Unlike
+ * `std::strtoll()`, leading (or trailing) whitespace is rejected when
+ * decoding these strings.
+ *
  * Value is a regular C++ value type with support for copy, move, equality,
  * etc. A default-constructed Value represents an empty value with no type.
  *
@@ -284,26 +294,26 @@ class Value {
    */
   template <typename T>
   StatusOr<T> get() const& {
-    if (!TypeProtoIs(T{}, type_))
+    if (!TypeProtoIs(T{}, type_proto()))
       return Status(StatusCode::kUnknown, "wrong type");
     if (value_.kind_case() == google::protobuf::Value::kNullValue) {
       if (IsOptional<T>::value) return T{};
       return Status(StatusCode::kUnknown, "null value");
     }
-    return GetValue(T{}, value_, type_);
+    return GetValue(T{}, value_, type_proto());
   }
 
   /// @copydoc get()
   template <typename T>
   StatusOr<T> get() && {
-    if (!TypeProtoIs(T{}, type_))
+    if (!TypeProtoIs(T{}, type_proto()))
       return Status(StatusCode::kUnknown, "wrong type");
     if (value_.kind_case() == google::protobuf::Value::kNullValue) {
       if (IsOptional<T>::value) return T{};
       return Status(StatusCode::kUnknown, "null value");
     }
     auto tag = T{};  // Works around an odd msvc issue
-    return GetValue(std::move(tag), std::move(value_), type_);
+    return GetValue(std::move(tag), std::move(value_), type_proto());
   }
 
   /**
@@ -446,6 +456,33 @@ class Value {
     }
   };
 
+  // Like `MakeTypeProto()`, but returns a `Type` that may be shared by many
+  // `Value` objects. The scalar types are created once and reused, so
+  // constructing a scalar `Value` does not allocate its type.
+  using SharedType = std::shared_ptr<google::spanner::v1::Type const>;
+  static SharedType MakeSharedTypeProto(bool);
+  static SharedType MakeSharedTypeProto(std::int64_t);
+  static SharedType MakeSharedTypeProto(double);
+  static SharedType MakeSharedTypeProto(std::string const&);
+  static SharedType MakeSharedTypeProto(Bytes const&);
+  static SharedType MakeSharedTypeProto(Timestamp);
+  static SharedType MakeSharedTypeProto(CommitTimestamp);
+  static SharedType MakeSharedTypeProto(Date);
+  static SharedType MakeSharedTypeProto(int) {
+    return MakeSharedTypeProto(std::int64_t{});
+  }
+  static SharedType MakeSharedTypeProto(char const*) {
+    return MakeSharedTypeProto(std::string{});
+  }
+  template <typename T>
+  static SharedType MakeSharedTypeProto(optional<T> const&) {
+    return MakeSharedTypeProto(T{});
+  }
+  template <typename T>
+  static SharedType MakeSharedTypeProto(T const& t) {
+    return std::make_shared<google::spanner::v1::Type const>(MakeTypeProto(t));
+  }
+
   // Encodes the argument as a protobuf according to the rules described in
   // https://github.com/googleapis/googleapis/blob/master/google/spanner/v1/type.proto
   static google::protobuf::Value MakeValueProto(bool b);
@@ -538,6 +575,7 @@ class Value {
       return Status(StatusCode::kUnknown, "missing ARRAY");
     }
     std::vector<T> v;
+    v.reserve(static_cast<std::size_t>(pv.list_value().values().size()));
     for (int i = 0; i < pv.list_value().values().size(); ++i) {
       auto&& e = GetProtoListValueElement(std::forward<V>(pv), i);
       using ET = decltype(e);
@@ -618,17 +656,26 @@ class Value {
   struct PrivateConstructor {};
   template <typename T>
   Value(PrivateConstructor, T&& t)
-      : type_(MakeTypeProto(t)), value_(MakeValueProto(std::forward<T>(t))) {}
+      : type_(MakeSharedTypeProto(t)),
+        value_(MakeValueProto(std::forward<T>(t))) {}
 
-  Value(google::spanner::v1::Type t, google::protobuf::Value v)
+  Value(SharedType t, google::protobuf::Value v)
       : type_(std::move(t)), value_(std::move(v)) {}
 
+  // Returns the type of this value. A default-constructed (or moved-from)
+  // `Value` has no type, and reports the default `Type` proto.
+  google::spanner::v1::Type const& type_proto() const;
+
   friend Value internal::FromProto(google::spanner::v1::Type,
                                    google::protobuf::Value);
+  friend Value internal::FromProto(SharedType, google::protobuf::Value);
   friend std::pair<google::spanner::v1::Type, google::protobuf::Value>
       internal::ToProto(Value);
+  friend struct internal::ValueAccess;
 
-  google::spanner::v1::Type type_;
+  // The type is immutable and shared, all the values in a column of a result
+  // set refer to the same `Type` proto.
+  SharedType type_;
   google::protobuf::Value value_;
 };
 
@@ -644,6 +691,40 @@ Value MakeNullValue() {
   return Value(optional<T>{});
 }
 
+namespace internal {
+
+// Exposes the type checks and the decoding functions of `Value`, so the
+// protos in a result set can be decoded into C++ types without first
+// wrapping each of them in a `Value`.
+struct ValueAccess {
+  // Returns true if a column of type `t` can be decoded into a `T`.
+  template <typename T>
+  static bool TypeProtoIs(google::spanner::v1::Type const& t) {
+    return Value::TypeProtoIs(T{}, t);
+  }
+
+  // Decodes `pv` into a `T`, the caller must have verified the type with
+  // `TypeProtoIs<T>()`.
+  template <typename T, typename V>
+  static StatusOr<T> GetValue(V&& pv, google::spanner::v1::Type const& t) {
+    if (pv.kind_case() == google::protobuf::Value::kNullValue) {
+      if (Value::IsOptional<T>::value) return T{};
+      return Status(StatusCode::kUnknown, "null value");
+    }
+    auto tag = T{};  // Works around an odd msvc issue
+    return Value::GetValue(std::move(tag), std::forward<V>(pv), t);
+  }
+
+  // Decodes `pv` into a `T` with the same checks as `Value::get<T>()`.
+  template <typename T, typename V>
+  static StatusOr<T> Get(V&& pv, google::spanner::v1::Type const& t) {
+    if (!TypeProtoIs<T>(t)) return Status(StatusCode::kUnknown, "wrong type");
+    return GetValue<T>(std::forward<V>(pv), t);
+  }
+};
+
+}  // namespace internal
+
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner
 }  // namespace cloud
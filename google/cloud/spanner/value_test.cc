@@ -23,6 +23,7 @@
 #include <cmath>
 #include <ios>
 #include <limits>
+#include <memory>
 #include <string>
 #include <tuple>
 #include <type_traits>
@@ -725,6 +726,39 @@ TEST(Value, ProtoConversionStruct) {
   EXPECT_EQ("42", p.second.list_value().values(1).string_value());
 }
 
+TEST(Value, ProtoConversionSharedType) {
+  auto const type = std::make_shared<google::spanner::v1::Type const>(
+      internal::ToProto(Value(std::int64_t{})).first);
+  std::vector<Value> column;
+  for (std::int64_t i = 0; i != 3; ++i) {
+    auto p = internal::ToProto(Value(i));
+    column.push_back(internal::FromProto(type, std::move(p.second)));
+  }
+  std::int64_t expected = 0;
+  for (auto const& v : column) {
+    EXPECT_EQ(Value(expected), v);
+    EXPECT_STATUS_OK(v.get<std::int64_t>());
+    EXPECT_EQ(expected, *v.get<std::int64_t>());
+    EXPECT_EQ(google::spanner::v1::TypeCode::INT64,
+              internal::ToProto(v).first.code());
+    ++expected;
+  }
+}
+
+TEST(Value, DefaultAndMovedFrom) {
+  Value const empty;
+  EXPECT_EQ(empty, Value());
+  EXPECT_FALSE(empty.get<std::int64_t>().ok());
+  EXPECT_EQ(google::spanner::v1::TypeCode::TYPE_CODE_UNSPECIFIED,
+            internal::ToProto(empty).first.code());
+
+  Value v(42);
+  Value moved = std::move(v);
+  EXPECT_EQ(Value(42), moved);
+  v = Value("foo");  // A moved-from `Value` can be reassigned.
+  EXPECT_EQ("foo", *v.get<std::string>());
+}
+
 void SetProtoKind(Value& v, google::protobuf::NullValue x) {
   auto p = internal::ToProto(v);
   p.second.set_null_value(x);